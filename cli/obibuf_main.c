@@ -287,7 +287,7 @@ static int handle_topology_commands(obibuf_cli_context_t *ctx, int argc, char *a
         printf("Topology layer commands:\n");
         printf("  obibuf topology network <type>      - Configure network topology\n");
         printf("  obibuf topology governance <zone>   - Set governance zone\n");
-        printf("  obibuf topology failover <enable>   - Configure failover\n");
+        printf("  obibuf topology failover <on|off>   - Configure failover\n");
         printf("  obibuf topology metrics             - Show network metrics\n");
         return OBIBUF_ERROR;
     }
@@ -305,8 +305,11 @@ static int handle_topology_commands(obibuf_cli_context_t *ctx, int argc, char *a
         
         obi_topology_type_t type;
         if (strcmp(argv[2], "p2p") == 0) type = OBI_TOPOLOGY_P2P;
-        else if (strcmp(argv[2], "mesh") == 0) type = OBI_TOPOLOGY_MESH;
+        else if (strcmp(argv[2], "bus") == 0) type = OBI_TOPOLOGY_BUS;
+        else if (strcmp(argv[2], "ring") == 0) type = OBI_TOPOLOGY_RING;
         else if (strcmp(argv[2], "star") == 0) type = OBI_TOPOLOGY_STAR;
+        else if (strcmp(argv[2], "mesh") == 0) type = OBI_TOPOLOGY_MESH;
+        else if (strcmp(argv[2], "hybrid") == 0) type = OBI_TOPOLOGY_HYBRID;
         else {
             fprintf(stderr, "Error: Unknown topology type '%s'\n", argv[2]);
             return OBIBUF_ERROR;
@@ -323,6 +326,30 @@ static int handle_topology_commands(obibuf_cli_context_t *ctx, int argc, char *a
         return OBIBUF_SUCCESS;
     }
     
+    if (strcmp(cmd, "failover") == 0) {
+        if (argc < 3) {
+            fprintf(stderr, "Error: failover requires on|off\n");
+            return OBIBUF_ERROR;
+        }
+        
+        bool enabled;
+        if (strcmp(argv[2], "on") == 0 || strcmp(argv[2], "enable") == 0) enabled = true;
+        else if (strcmp(argv[2], "off") == 0 || strcmp(argv[2], "disable") == 0) enabled = false;
+        else {
+            fprintf(stderr, "Error: Unknown failover setting '%s'\n", argv[2]);
+            return OBIBUF_ERROR;
+        }
+        
+        if (obi_topology_set_failover(ctx->topology_ctx, enabled) == OBI_TOPOLOGY_SUCCESS) {
+            printf("✅ Failover %s\n", enabled ? "enabled" : "disabled");
+        } else {
+            log_error("TOPOLOGY", "failover", "Configuration failed");
+            return OBIBUF_ERROR;
+        }
+        
+        return OBIBUF_SUCCESS;
+    }
+    
     if (strcmp(cmd, "metrics") == 0) {
         log_info("TOPOLOGY", "Retrieving network metrics");
         
@@ -332,9 +359,23 @@ static int handle_topology_commands(obibuf_cli_context_t *ctx, int argc, char *a
         if (result == OBI_TOPOLOGY_SUCCESS) {
             printf("📊 Network Metrics:\n");
             printf("   Cost Function: %.3f (threshold: 0.5)\n", metrics.cost_function);
+            printf("   Link Latency: %.1f us (EWMA)\n", metrics.latency_us);
+            printf("   Send Latency: p50 %.1f us, p99 %.1f us, p999 %.1f us, max %.1f us (%llu sends)\n",
+                   metrics.send_latency.p50_us, metrics.send_latency.p99_us,
+                   metrics.send_latency.p999_us, metrics.send_latency.max_us,
+                   (unsigned long long)metrics.send_latency.count);
+            printf("   Queue Depth: %.1f frames\n", metrics.queue_depth);
+            printf("   Drop Rate: %.2f%%\n", metrics.drop_rate * 100.0);
             printf("   Active Nodes: %d\n", metrics.active_nodes);
             printf("   Governance Zone: %s\n", metrics.governance_zone);
+            printf("   Shed Messages: %llu\n", (unsigned long long)metrics.shed_messages);
+            printf("   Busy Sends: %llu\n", (unsigned long long)metrics.busy_sends);
+            printf("   Coalesced: %llu messages in %llu batches\n",
+                   (unsigned long long)metrics.coalesced_messages,
+                   (unsigned long long)metrics.coalesced_batches);
             printf("   Failover Status: %s\n", metrics.failover_enabled ? "ENABLED" : "DISABLED");
+            printf("   Failovers: %llu\n", (unsigned long long)metrics.failovers);
+            printf("   Gossip Frames: %llu\n", (unsigned long long)metrics.gossip_frames);
         } else {
             log_error("TOPOLOGY", "metrics", "Failed to retrieve metrics");
             return OBIBUF_ERROR;
@@ -25,6 +25,24 @@ typedef enum {
     OBI_PROTOCOL_ERROR_ZERO_TRUST_VIOLATION
 } obi_protocol_result_t;
 
+// Message result codes (shared by topology and buffer layers)
+typedef enum {
+    OBI_SUCCESS = 0,
+    OBI_ERROR_INVALID_INPUT,
+    OBI_ERROR_BUFFER_OVERFLOW,
+    OBI_ERROR_OUT_OF_MEMORY,
+    OBI_ERROR_WOULD_BLOCK,
+    OBI_ERROR_NETWORK_FAILURE,
+    OBI_BUSY                    // destination out of flow-control credit; retry later
+} obi_result_t;
+
+// Message buffer (data points at capacity bytes, size are in use)
+typedef struct obi_buffer {
+    uint8_t *data;
+    size_t size;
+    size_t capacity;
+} obi_buffer_t;
+
 // Core API functions
 obi_protocol_result_t obi_protocol_init(void);
 void obi_protocol_cleanup(void);
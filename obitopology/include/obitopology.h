@@ -8,6 +8,8 @@
 #define OBITOPOLOGY_H
 
 #include "obiprotocol.h"
+#include "obitopology_transport.h"
+#include "obitopology_routing.h"
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -15,16 +17,6 @@
 typedef struct obi_topology_context obi_topology_context_t;
 typedef struct obi_topology_metrics obi_topology_metrics_t;
 
-// Topology types
-typedef enum {
-    OBI_TOPOLOGY_P2P,
-    OBI_TOPOLOGY_BUS,
-    OBI_TOPOLOGY_RING,
-    OBI_TOPOLOGY_STAR,
-    OBI_TOPOLOGY_MESH,
-    OBI_TOPOLOGY_HYBRID
-} obi_topology_type_t;
-
 // Result codes
 typedef enum {
     OBI_TOPOLOGY_SUCCESS = 0,
@@ -33,22 +25,414 @@ typedef enum {
     OBI_TOPOLOGY_ERROR_NETWORK_FAILURE
 } obi_topology_result_t;
 
-// Metrics structure
+// Governance zones driven by the cost function C
+typedef enum {
+    OBI_ZONE_AUTONOMOUS = 0,  // C <= 0.5: admit everything
+    OBI_ZONE_WARNING,         // 0.5 < C < 0.6: shed low priority, 2x batching
+    OBI_ZONE_GOVERNANCE       // C >= 0.6: admit high priority only, 4x batching
+} obi_governance_zone_t;
+
+// Zone thresholds; the exit thresholds sit below the entry ones to prevent flapping
+#define OBI_GOVERNANCE_WARNING_ENTER    0.5
+#define OBI_GOVERNANCE_WARNING_EXIT     0.45
+#define OBI_GOVERNANCE_GOVERNANCE_ENTER 0.6
+#define OBI_GOVERNANCE_GOVERNANCE_EXIT  0.55
+
+// Send priority consulted by admission control
+typedef enum {
+    OBI_PRIORITY_LOW = 0,     // shed from the Warning zone up
+    OBI_PRIORITY_NORMAL,      // shed in the Governance zone
+    OBI_PRIORITY_HIGH         // always admitted
+} obi_topology_priority_t;
+
+// Heartbeat failure detection (phi accrual over frame inter-arrival times)
+#define OBI_HEARTBEAT_DEFAULT_INTERVAL_US 100
+#define OBI_HEARTBEAT_DEFAULT_PHI         8.0
+
+typedef struct {
+    uint32_t interval_us;     // heartbeat period to direct neighbours; 0 disables detection
+    double phi_threshold;     // suspicion level at which a neighbour is declared failed
+} obi_heartbeat_config_t;
+
+// Credit-based flow control per destination; every node must use the same window
+#define OBI_FLOW_DEFAULT_WINDOW   256
+#define OBI_FLOW_DEFAULT_PROBE_US 10000
+
+typedef struct {
+    uint32_t window;          // unconsumed frames allowed per destination; 0 disables
+    uint32_t block_us;        // how long a sender waits for credit before OBI_BUSY
+    uint32_t probe_us;        // a sender out of credit this long asks for a grant (0 = default)
+} obi_flow_config_t;
+
+// Small-message coalescing into batch frames per destination
+#define OBI_COALESCE_DEFAULT_MAX_MESSAGE 200
+#define OBI_COALESCE_DEFAULT_DEADLINE_US 50
+
+typedef struct {
+    uint32_t max_message;     // sends up to this many bytes are coalesced; 0 disables
+    uint32_t deadline_us;     // longest a coalesced message waits for its batch to leave
+} obi_coalesce_config_t;
+
+// Duplicate suppression for flooded MESH delivery: delivered payloads are
+// remembered in a fixed-size, time-windowed cuckoo filter and repeats are dropped
+#define OBI_DEDUP_DEFAULT_CAPACITY  65536
+#define OBI_DEDUP_DEFAULT_WINDOW_MS 1000
+#define OBI_DEDUP_MAX_CAPACITY      (1u << 24)
+
+typedef struct {
+    uint32_t capacity;        // messages per window, rounded up to a power of two; 0 disables
+    uint32_t window_ms;       // a message is remembered for one to two windows
+} obi_dedup_config_t;
+
+// Fragmentation of payloads larger than one transport frame. Receivers
+// reassemble into slots preallocated at max_message bytes, so partial-message
+// memory is fixed at slots x max_message. Synchronous and async sends may
+// fragment. A synchronous send that meets a full ring mid-message yields on
+// the caller's thread for up to OBI_FRAGMENT_STALL_MS before it abandons the
+// message with OBI_ERROR_NETWORK_FAILURE; the event loop instead moves on and
+// resumes the message on a later pass, within the same bound. Broadcasts and
+// pipeline submissions stay limited to one frame
+#define OBI_FRAGMENT_MAX_MESSAGE           (64u << 20)
+#define OBI_FRAGMENT_STALL_MS              100
+#define OBI_REASSEMBLY_DEFAULT_MAX_MESSAGE (1u << 20)
+#define OBI_REASSEMBLY_DEFAULT_SLOTS       4
+#define OBI_REASSEMBLY_DEFAULT_TIMEOUT_MS  1000
+#define OBI_REASSEMBLY_MAX_SLOTS           64
+
+typedef struct {
+    uint32_t max_message;     // largest message reassembled; larger ones are dropped
+    uint32_t slots;           // messages reassembled at once; 0 disables reassembly
+    uint32_t timeout_ms;      // a partial message older than this is discarded
+} obi_reassembly_config_t;
+
+// In-order delivery: frames carry per source/destination sequence numbers and
+// the receiver holds early ones in a ring indexed by sequence modulo window
+#define OBI_ORDER_DEFAULT_WINDOW     64
+#define OBI_ORDER_DEFAULT_TIMEOUT_US 1000
+#define OBI_ORDER_MAX_WINDOW         4096
+
+typedef struct {
+    uint32_t window;          // frames held per source, rounded up to a power of two; 0 disables
+    uint32_t timeout_us;      // longest delivery waits for a missing frame before skipping it
+} obi_order_config_t;
+
+// Token-bucket rate limits per destination and per tenant, kept as one
+// theoretical-arrival timestamp each (GCRA) and updated with a single CAS
+#define OBI_RATE_MAX_TENANTS 16
+
+typedef struct {
+    uint32_t rate;            // sends per second; 0 removes the limit
+    uint32_t burst;           // sends allowed back to back after idling; 0 = 1
+} obi_rate_limit_t;
+
+// Send latency distribution from log-bucketed histograms (within ~6% of the true value)
+typedef struct {
+    uint64_t count;
+    double p50_us;
+    double p99_us;
+    double p999_us;
+    double max_us;
+} obi_latency_summary_t;
+
+// SWIM gossip membership for MESH: one direct probe per period, indirect probes
+// through a few members on silence, state changes piggybacked on probes and acks
+#define OBI_GOSSIP_DEFAULT_INTERVAL_US 1000
+#define OBI_GOSSIP_DEFAULT_INDIRECT    3
+#define OBI_GOSSIP_DEFAULT_SUSPICION   4
+#define OBI_GOSSIP_MAX_UPDATES         8
+
+typedef enum {
+    OBI_MEMBER_ALIVE = 0,
+    OBI_MEMBER_SUSPECT,       // missed a probe; refuted or confirmed within the suspicion timeout
+    OBI_MEMBER_DEAD           // inactive in the node graph until it rejoins
+} obi_member_status_t;
+
+typedef struct {
+    uint32_t interval_us;     // protocol period; 0 disables gossip
+    uint32_t indirect_probes; // members asked to probe a silent target
+    uint32_t suspicion_mult;  // suspicion timeout in periods, times log2(members + 1)
+} obi_gossip_config_t;
+
+// Asynchronous sends driven by an epoll event loop owned by the context
+#define OBI_ASYNC_MAX_INFLIGHT 4096   // queued sends across all destinations
+#define OBI_ASYNC_TICK_US      50     // retry tick while sends wait for ring space or credit
+
+// Traffic classes for async queues. Security and audit are served strictly
+// first; the rest share what is left by weight (deficit round robin)
+typedef enum {
+    OBI_CLASS_SECURITY = 0,   // strict; admitted as high priority
+    OBI_CLASS_AUDIT,          // strict, after security; admitted as high priority
+    OBI_CLASS_CONTROL,        // weighted; normal priority
+    OBI_CLASS_DEFAULT,        // weighted; the class of obi_topology_send_async
+    OBI_CLASS_BULK,           // weighted; low priority, shed first
+    OBI_CLASS_COUNT
+} obi_traffic_class_t;
+
+#define OBI_CLASS_STRICT_COUNT      2     // classes served before any weighted one
+#define OBI_CLASS_QUANTUM           1024  // bytes a weighted class earns per unit weight per round
+#define OBI_CLASS_DEFAULT_WEIGHTS   { 0, 0, 4, 2, 1 }
+#define OBI_CLASS_DEFAULT_STRICT_BURST 32
+
+typedef struct {
+    uint16_t weights[OBI_CLASS_COUNT];  // weighted classes only, at least 1; strict entries ignored
+    uint32_t strict_burst;    // strict sends in a row before a waiting weighted class gets one; 0 = unbounded
+} obi_class_config_t;
+
+// Hub aggregation for STAR: transit data frames are batched per destination,
+// validated a batch at a time and forwarded with one vectored send
+#define OBI_HUB_DEFAULT_BATCH    32
+#define OBI_HUB_MAX_BATCH        256
+#define OBI_HUB_DEFAULT_DELAY_US 100
+#define OBI_HUB_DEFAULT_CACHE    4096
+#define OBI_HUB_MAX_CACHE        (1u << 20)
+
+// Sets valid[i] for each of count messages; runs on the hub's receiving thread
+typedef void (*obi_batch_validator_t)(void *user, const obi_buffer_t *messages, size_t count, bool *valid);
+
+typedef struct {
+    uint32_t max_batch;       // frames per destination batch; 0 turns aggregation off
+    uint32_t max_delay_us;    // longest a frame waits while input keeps arriving
+    obi_batch_validator_t validate;  // NULL forwards without validating
+    void *validate_user;
+    uint32_t cache_entries;   // validation results kept by payload hash; rounded up to a power of two, 0 = none
+} obi_hub_config_t;
+
+typedef uint32_t obi_send_handle_t;
+typedef void (*obi_send_callback_t)(void *user, obi_send_handle_t handle, obi_result_t result);
+typedef void (*obi_receive_callback_t)(void *user, const obi_buffer_t *message);
+
+// Staged send pipeline: validation workers -> classifier -> transport thread
+#define OBI_PIPELINE_MAX_WORKERS    16
+#define OBI_PIPELINE_DEFAULT_DEPTH  256   // slots per stage queue
+#define OBI_PIPELINE_IDLE_US        50    // stage threads sleep this long once spinning finds no work
+
+// Runs concurrently on the workers; worker < workers, so per-worker
+// validator state (e.g. one USCN+DFA instance each) needs no locking
+typedef bool (*obi_pipeline_validator_t)(void *user, uint32_t worker, const obi_buffer_t *message);
+
+typedef struct {
+    uint32_t workers;         // validation threads; 0 = online cores minus the two stage threads
+    uint32_t queue_depth;     // rounded up to a power of two; 0 = OBI_PIPELINE_DEFAULT_DEPTH
+    obi_pipeline_validator_t validate;        // NULL accepts every message
+    void *validate_user;
+    obi_send_callback_t completion;           // optional, runs on the transport thread
+    void *completion_user;
+} obi_pipeline_config_t;
+
+typedef struct {
+    uint32_t depth;           // messages waiting now
+    uint32_t peak;            // most ever waiting
+} obi_pipeline_stage_t;
+
+typedef struct {
+    obi_pipeline_stage_t validate;  // submitted, waiting for a worker
+    obi_pipeline_stage_t route;     // validated, waiting for the classifier
+    obi_pipeline_stage_t send;      // routed, waiting for the transport thread
+    uint32_t workers;
+    uint64_t submitted;
+    uint64_t rejected;        // refused by the validator
+    uint64_t sent;
+    uint64_t failed;          // shed, unroutable or refused by the transport
+} obi_pipeline_stats_t;
+
+// Metrics structure - a live snapshot averaged over links that carried traffic
 struct obi_topology_metrics {
     double cost_function;
+    double latency_us;        // EWMA send latency
+    double queue_depth;       // frames queued towards peers
+    double drop_rate;         // fraction of sends refused by the transport
     int active_nodes;
+    obi_governance_zone_t zone;
     char governance_zone[64];
+    uint64_t shed_messages;   // sends refused by admission control
     bool failover_enabled;
+    uint64_t failovers;       // neighbours declared failed
+    uint64_t busy_sends;      // sends refused for lack of credit
+    uint64_t coalesced_messages;  // small sends carried inside batch frames
+    uint64_t coalesced_batches;   // batch frames sent
+    obi_latency_summary_t send_latency;  // every send under the current topology type
+    uint64_t gossip_frames;   // membership probes and acks sent
+    uint64_t duplicates_dropped;  // received copies of a message already delivered
+    uint64_t dedup_overflows;     // filter windows cut short because capacity ran out
+    uint64_t fragmented_messages; // sends split into fragment frames
+    uint64_t reassembled_messages;
+    uint64_t reassembly_timeouts; // partial messages discarded after timeout_ms
+    uint64_t reassembly_drops;    // messages refused: too large, no free slot, reassembly off or a fragment lost
+    uint64_t reordered_frames;    // frames held until their predecessors arrived
+    uint64_t sequence_gaps;       // sequence numbers skipped as lost
+    uint64_t reorder_timeouts;    // waits for a missing frame that ran out
+    uint64_t late_frames;         // frames dropped for arriving after their turn
+    uint64_t rate_limited;        // sends refused by a destination or tenant limit
+    uint64_t relayed_frames;      // transit frames passed on towards their destination
+    uint64_t relay_stalls;        // transit frames held because the next hop was full
+    uint64_t relay_drops;         // transit frames given up: next hop unreachable or stalled too long
+    uint64_t hub_batches;         // vectored sends of aggregated frames
+    uint64_t hub_batched_frames;  // transit frames sent inside them
+    uint64_t hub_validated;       // messages passed to the batch validator
+    uint64_t hub_cache_hits;      // messages whose verdict came from the cache
+    uint64_t hub_rejected;        // transit messages the validator refused
+    uint64_t class_sent[OBI_CLASS_COUNT];  // async sends handed to the transport, per traffic class
+    uint64_t starvation_breaks;   // weighted sends let through ahead of waiting strict traffic
+    uint64_t credit_probes;       // grant requests from senders whose credit stalled
 };
 
 // Core API functions
 obi_topology_result_t obi_topology_init(obi_protocol_context_t *protocol_ctx);
 void obi_topology_cleanup(void);
 obi_topology_context_t* obi_topology_get_context(void);
+
+// Independent contexts beside the process-wide one, e.g. one per simulated
+// node and thread; each has its own transport, routes and counters
+obi_topology_context_t *obi_topology_context_create(obi_protocol_context_t *protocol_ctx);
+void obi_topology_context_destroy(obi_topology_context_t *ctx);
 obi_topology_result_t obi_topology_configure(obi_topology_context_t *ctx, obi_topology_type_t type);
 obi_topology_result_t obi_topology_get_metrics(obi_topology_context_t *ctx, obi_topology_metrics_t *metrics);
 obi_result_t obi_topology_send_message(obi_topology_context_t *ctx, obi_buffer_t *buffer, const char *destination);
 
+// Interned send path - resolve a name to a dense node id once, then send by id
+obi_topology_result_t obi_topology_resolve_node(obi_topology_context_t *ctx, const char *name,
+                                                obi_node_id_t *node_id);
+obi_result_t obi_topology_send_to(obi_topology_context_t *ctx, obi_buffer_t *buffer, obi_node_id_t destination);
+obi_result_t obi_topology_send_priority(obi_topology_context_t *ctx, obi_buffer_t *buffer,
+                                        obi_node_id_t destination, obi_topology_priority_t priority);
+
+// Async API - obi_topology_send_async copies the payload, queues it behind the
+// destination's earlier async sends and returns a handle at once (OBI_BUSY when
+// OBI_ASYNC_MAX_INFLIGHT are queued). obi_topology_run_events hands queued sends
+// to the transport, keeping those refused for ring space or credit queued, runs
+// each callback with the final result, delivers receives to the receive callback
+// and drives obi_topology_poll; it waits up to timeout_ms (-1 = forever) when idle.
+// obi_topology_event_fd is the loop's epoll descriptor for embedding in another loop
+obi_result_t obi_topology_send_async(obi_topology_context_t *ctx, const obi_buffer_t *buffer,
+                                     obi_node_id_t destination, obi_topology_priority_t priority,
+                                     obi_send_callback_t callback, void *user, obi_send_handle_t *handle);
+// Each destination queues per traffic class: FIFO within a class, strict
+// priority for security and audit, weighted fair sharing for the rest.
+// obi_topology_class_for_pattern maps a message's semantic pattern to its class;
+// obi_topology_set_traffic_classes (NULL = defaults) takes effect on the next pass
+obi_result_t obi_topology_send_async_class(obi_topology_context_t *ctx, const obi_buffer_t *buffer,
+                                           obi_node_id_t destination, obi_traffic_class_t traffic_class,
+                                           obi_send_callback_t callback, void *user, obi_send_handle_t *handle);
+obi_traffic_class_t obi_topology_class_for_pattern(obi_semantic_pattern_t pattern);
+obi_topology_result_t obi_topology_set_traffic_classes(obi_topology_context_t *ctx, const obi_class_config_t *config);
+obi_topology_result_t obi_topology_set_receive_callback(obi_topology_context_t *ctx,
+                                                        obi_receive_callback_t callback, void *user);
+obi_result_t obi_topology_run_events(obi_topology_context_t *ctx, int timeout_ms, size_t *completed);
+int obi_topology_event_fd(obi_topology_context_t *ctx);
+
+// Pipeline API - obi_topology_pipeline_submit copies the payload into a pool
+// slot and returns at once (OBI_BUSY when the pool or the validation queue is
+// full). Workers validate, the classifier restores submission order, applies
+// admission control and resolves the route, and the transport thread sends
+// and completes. obi_topology_pipeline_stop drains every stage; call it once
+// submitting threads are done
+obi_topology_result_t obi_topology_pipeline_start(obi_topology_context_t *ctx, const obi_pipeline_config_t *config);
+obi_result_t obi_topology_pipeline_submit(obi_topology_context_t *ctx, const obi_buffer_t *buffer,
+                                          obi_node_id_t destination, obi_topology_priority_t priority,
+                                          obi_send_handle_t *handle);
+obi_topology_result_t obi_topology_pipeline_stats(obi_topology_context_t *ctx, obi_pipeline_stats_t *stats);
+obi_topology_result_t obi_topology_pipeline_stop(obi_topology_context_t *ctx);
+
+// Rate limit API - limits change at runtime without pausing senders. A send
+// over a limit returns OBI_BUSY and counts as a drop on the destination's
+// link, so sustained limiting raises the cost function. obi_topology_send_tenant
+// applies the tenant's limit on top of the destination's
+obi_topology_result_t obi_topology_set_rate_limit(obi_topology_context_t *ctx, obi_node_id_t destination,
+                                                  const obi_rate_limit_t *limit);
+obi_topology_result_t obi_topology_set_tenant_limit(obi_topology_context_t *ctx, uint32_t tenant,
+                                                    const obi_rate_limit_t *limit);
+obi_result_t obi_topology_send_tenant(obi_topology_context_t *ctx, obi_buffer_t *buffer,
+                                      obi_node_id_t destination, obi_topology_priority_t priority,
+                                      uint32_t tenant);
+
+// Hub API - on the STAR hub, obi_topology_set_hub_aggregation (NULL = defaults)
+// batches relayed data frames per destination. Batches leave when full, when
+// the hub's inbound queue runs dry or after max_delay_us. Refused messages are
+// dropped at the hub; the cache spares identical payloads a second validation
+obi_topology_result_t obi_topology_set_hub_aggregation(obi_topology_context_t *ctx, const obi_hub_config_t *config);
+
+// Latency API - send latency tails per final destination and per topology type
+obi_topology_result_t obi_topology_get_latency(obi_topology_context_t *ctx, obi_node_id_t destination,
+                                               obi_latency_summary_t *summary);
+obi_topology_result_t obi_topology_get_type_latency(obi_topology_context_t *ctx, obi_topology_type_t type,
+                                                    obi_latency_summary_t *summary);
+
+// Fan-out API (BUS and MESH) - recipients NULL means every other active node;
+// direct recipients share one payload write, relayed ones get routed copies
+obi_result_t obi_topology_broadcast(obi_topology_context_t *ctx, obi_buffer_t *buffer,
+                                    const obi_node_id_t *recipients, size_t count, size_t *delivered);
+
+// Re-flood the message receive returned last, keeping its origin and id so
+// duplicate suppression treats every copy as one message; call it from the
+// receiving thread
+obi_result_t obi_topology_forward(obi_topology_context_t *ctx, obi_buffer_t *buffer,
+                                  const obi_node_id_t *recipients, size_t count, size_t *delivered);
+
+// Partitioning API (HYBRID) - keys such as a schema id, or obi_topology_partition_key
+// of a SEC token, map onto the active nodes through a consistent-hash ring, so a
+// membership change moves only about 1/N of the keys. obi_topology_send_keyed
+// reports the owner and sends nothing when the key belongs to the local node
+uint64_t obi_topology_partition_key(const void *data, size_t length);
+obi_topology_result_t obi_topology_partition_owner(obi_topology_context_t *ctx, uint64_t key,
+                                                   obi_node_id_t *owner);
+obi_result_t obi_topology_send_keyed(obi_topology_context_t *ctx, obi_buffer_t *buffer, uint64_t key,
+                                     obi_node_id_t *owner);
+
+// Governance API
+obi_governance_zone_t obi_topology_governance_next_zone(obi_governance_zone_t current, double cost);
+
+// Failover API - obi_topology_poll sends due heartbeats, gossip probes and
+// coalesced batches and runs the failure detectors
+obi_topology_result_t obi_topology_set_heartbeat(obi_topology_context_t *ctx, const obi_heartbeat_config_t *config);
+obi_topology_result_t obi_topology_set_failover(obi_topology_context_t *ctx, bool enabled);
+obi_topology_result_t obi_topology_poll(obi_topology_context_t *ctx);
+
+// Membership API (MESH) - a NULL config selects the defaults; obi_topology_poll
+// drives the protocol and obi_topology_receive_message answers probes
+obi_topology_result_t obi_topology_set_gossip(obi_topology_context_t *ctx, const obi_gossip_config_t *config);
+obi_topology_result_t obi_topology_member_status(obi_topology_context_t *ctx, obi_node_id_t node_id,
+                                                 obi_member_status_t *status);
+
+// Flow control API - a NULL config selects the defaults
+obi_topology_result_t obi_topology_set_flow_control(obi_topology_context_t *ctx, const obi_flow_config_t *config);
+
+// Coalescing API - a NULL config selects the defaults; obi_topology_flush sends
+// every queued batch at once for latency-critical traffic
+obi_topology_result_t obi_topology_set_coalescing(obi_topology_context_t *ctx, const obi_coalesce_config_t *config);
+obi_result_t obi_topology_flush(obi_topology_context_t *ctx);
+
+// Dedup API - a NULL config selects the defaults; the filter takes 8 bytes per
+// message of capacity and belongs to the thread that receives
+obi_topology_result_t obi_topology_set_dedup(obi_topology_context_t *ctx, const obi_dedup_config_t *config);
+
+// Fragmentation API - sends up to OBI_FRAGMENT_MAX_MESSAGE bytes are split into
+// fragment frames; a NULL config selects the reassembly defaults.
+// obi_topology_receive_message copies a reassembled message out, returning
+// OBI_ERROR_BUFFER_OVERFLOW and keeping it when the buffer is too small
+obi_topology_result_t obi_topology_set_reassembly(obi_topology_context_t *ctx,
+                                                  const obi_reassembly_config_t *config);
+
+// Ordering API - a NULL config selects the defaults; frames from one source are
+// delivered in send order, across relays, failover and batching
+obi_topology_result_t obi_topology_set_ordering(obi_topology_context_t *ctx, const obi_order_config_t *config);
+
+// Transport API - obi_topology_receive_view returns the next message in place,
+// a reassembled one straight from its slot; the view stays valid until the next
+// receive call on the context
+obi_topology_result_t obi_topology_set_transport(obi_topology_context_t *ctx, obi_topology_transport_t *transport);
+obi_topology_result_t obi_topology_bind(obi_topology_context_t *ctx, const char *local_name);
+obi_result_t obi_topology_receive_message(obi_topology_context_t *ctx, obi_buffer_t *buffer);
+obi_result_t obi_topology_receive_view(obi_topology_context_t *ctx, obi_buffer_t *message);
+
+// Node graph API - every change incrementally updates the next-hop table
+obi_topology_result_t obi_topology_add_node(obi_topology_context_t *ctx, const char *name,
+                                            const char *address, obi_node_id_t *node_id);
+obi_topology_result_t obi_topology_add_link(obi_topology_context_t *ctx, obi_node_id_t a,
+                                            obi_node_id_t b, uint16_t cost);
+obi_topology_result_t obi_topology_set_hub(obi_topology_context_t *ctx, obi_node_id_t hub);
+obi_topology_result_t obi_topology_set_node_active(obi_topology_context_t *ctx, obi_node_id_t node_id,
+                                                   bool active);
+
 #ifdef __cplusplus
 extern "C" {
 #endif
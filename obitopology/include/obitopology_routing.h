@@ -0,0 +1,164 @@
+/*
+ * OBI Topology Routing Header
+ * Node graph and precomputed next-hop tables per topology type
+ * Each send resolves its route with a single array lookup
+ */
+
+#ifndef OBITOPOLOGY_ROUTING_H
+#define OBITOPOLOGY_ROUTING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Routing limits
+#define OBI_TOPOLOGY_MAX_NODES 256
+#define OBI_NODE_INVALID       0xFFFFu
+#define OBI_ROUTE_UNREACHABLE  UINT32_MAX
+
+// Ring positions per active node in the HYBRID partition ring
+#define OBI_PARTITION_VNODES   64
+
+typedef uint16_t obi_node_id_t;
+
+// Topology types
+typedef enum {
+    OBI_TOPOLOGY_P2P,
+    OBI_TOPOLOGY_BUS,
+    OBI_TOPOLOGY_RING,
+    OBI_TOPOLOGY_STAR,
+    OBI_TOPOLOGY_MESH,
+    OBI_TOPOLOGY_HYBRID
+} obi_topology_type_t;
+
+// Node graph - explicit links are only consulted by MESH and HYBRID
+typedef struct {
+    uint32_t node_count;                     // ids [0, node_count) have been allocated
+    uint32_t link_count;
+    obi_node_id_t hub;                       // STAR centre
+    bool active[OBI_TOPOLOGY_MAX_NODES];
+    uint32_t key[OBI_TOPOLOGY_MAX_NODES];    // wire key per id; places the node on the HYBRID ring
+    uint16_t link_cost[OBI_TOPOLOGY_MAX_NODES][OBI_TOPOLOGY_MAX_NODES];  // 0 = no link
+} obi_route_graph_t;
+
+// Consistent-hash ring over the active nodes, sorted by position; a key
+// belongs to the first point at or after its own position
+typedef struct {
+    uint64_t position;
+    uint32_t key;                            // owner's wire key, which orders collisions
+    obi_node_id_t owner;
+} obi_partition_point_t;
+
+typedef struct {
+    uint32_t size;
+    obi_partition_point_t *points;
+} obi_partition_ring_t;
+
+// Dense all-pairs table: row = source, column = destination
+typedef struct {
+    uint32_t node_count;
+    uint64_t version;
+    obi_topology_type_t type;
+    uint32_t touched;                        // destination labels recomputed by the last build/update
+    obi_node_id_t *next_hop;
+    uint32_t *distance;
+    obi_node_id_t *parent;                   // shortest-path tree per source
+    uint32_t *cost;                          // effective link costs the table was derived from
+    obi_node_id_t protected_source;          // row covered by backup_hop
+    obi_node_id_t *backup_hop;               // loop-free alternate per destination, that row only
+    obi_partition_ring_t partition;          // HYBRID only
+} obi_route_table_t;
+
+/**
+ * Compute the all-pairs next-hop table for the graph under a topology type
+ */
+obi_route_table_t *obi_route_table_build(const obi_route_graph_t *graph, obi_topology_type_t type);
+
+/**
+ * Derive a new table from previous after a graph change, recomputing only
+ * destinations whose shortest path is affected; previous is left untouched
+ */
+obi_route_table_t *obi_route_table_update(const obi_route_table_t *previous,
+                                          const obi_route_graph_t *graph, obi_topology_type_t type);
+
+/**
+ * Precompute node-protecting loop-free alternate next hops from source
+ */
+void obi_route_table_protect(obi_route_table_t *table, obi_node_id_t source);
+
+/**
+ * Copy of table whose protected row avoids failed, using the precomputed backups only
+ */
+obi_route_table_t *obi_route_table_failover(const obi_route_table_t *table, obi_node_id_t failed);
+
+/**
+ * Release a table returned by the build, update or failover calls
+ */
+void obi_route_table_destroy(obi_route_table_t *table);
+
+/**
+ * Resolve the next hop from src towards dst (OBI_NODE_INVALID when unreachable)
+ */
+static inline obi_node_id_t obi_route_next_hop(const obi_route_table_t *table,
+                                               obi_node_id_t src, obi_node_id_t dst) {
+    if (!table || src >= table->node_count || dst >= table->node_count) {
+        return OBI_NODE_INVALID;
+    }
+    return table->next_hop[(size_t)src * table->node_count + dst];
+}
+
+/**
+ * Place every active node of the graph on the ring; false when out of memory
+ */
+bool obi_partition_ring_build(obi_partition_ring_t *ring, const obi_route_graph_t *graph);
+
+/**
+ * Copy source into ring without the points of excluded (OBI_NODE_INVALID keeps all)
+ */
+bool obi_partition_ring_copy(obi_partition_ring_t *ring, const obi_partition_ring_t *source,
+                             obi_node_id_t excluded);
+
+/**
+ * Release the points of a ring built or copied above
+ */
+void obi_partition_ring_destroy(obi_partition_ring_t *ring);
+
+/**
+ * Spread a key over the ring (splitmix64 finaliser); sequential ids land far apart
+ */
+static inline uint64_t obi_partition_hash(uint64_t key) {
+    key = (key ^ (key >> 30)) * 0xBF58476D1CE4E5B9ull;
+    key = (key ^ (key >> 27)) * 0x94D049BB133111EBull;
+    return key ^ (key >> 31);
+}
+
+/**
+ * Owner of key on the ring (OBI_NODE_INVALID when empty) - binary search, no allocation
+ */
+static inline obi_node_id_t obi_partition_lookup(const obi_partition_ring_t *ring, uint64_t key) {
+    if (!ring || ring->size == 0) {
+        return OBI_NODE_INVALID;
+    }
+    uint64_t position = obi_partition_hash(key);
+    uint32_t low = 0;
+    uint32_t high = ring->size;
+    while (low < high) {
+        uint32_t mid = low + (high - low) / 2;
+        if (ring->points[mid].position < position) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return ring->points[low == ring->size ? 0 : low].owner;
+}
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OBITOPOLOGY_ROUTING_H */
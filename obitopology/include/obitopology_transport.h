@@ -0,0 +1,299 @@
+/*
+ * OBI Topology Transport Header
+ * Pluggable message transports behind obi_topology_send_message
+ * Shared-memory ring buffer, batched socket and io_uring backends, and an
+ * in-memory network simulator
+ */
+
+#ifndef OBITOPOLOGY_TRANSPORT_H
+#define OBITOPOLOGY_TRANSPORT_H
+
+#include "obiprotocol.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Shared-memory ring defaults
+#define OBI_SHM_RING_MAGIC         0x4F424952u  /* "OBIR" */
+#define OBI_SHM_DEFAULT_SLOT_COUNT 1024
+#define OBI_SHM_DEFAULT_SLOT_SIZE  2048
+#define OBI_SHM_NAME_PREFIX        "/obitopo."
+#define OBI_SHM_POOL_MAGIC         0x4F424950u  /* "OBIP" */
+#define OBI_SHM_DEFAULT_POOL_BLOCKS 256
+#define OBI_SHM_MAX_POOLS          64           // sender pools a receiver keeps mapped
+#define OBI_TRANSPORT_MAX_ADDRESS  64
+#define OBI_TRANSPORT_MAX_BATCH_SCALE 4   // widest batching governance may request
+
+// Socket transport defaults
+#define OBI_SOCKET_DEFAULT_BATCH_SIZE   32
+#define OBI_SOCKET_DEFAULT_DEADLINE_US  200
+#define OBI_SOCKET_DEFAULT_MAX_DATAGRAM 2048
+#define OBI_SOCKET_MAX_BATCH            1024
+#define OBI_SOCKET_MAX_CONNECTIONS      64
+
+// io_uring transport defaults
+#define OBI_URING_DEFAULT_QUEUE_DEPTH  256
+#define OBI_URING_DEFAULT_BUFFER_COUNT 256
+#define OBI_URING_DEFAULT_BUFFER_SIZE  2048
+#define OBI_URING_DEFAULT_SUBMIT_BATCH 32
+#define OBI_URING_MAX_FILES            64
+
+// Simulated network defaults
+#define OBI_SIM_DEFAULT_QUEUE_FRAMES 256
+#define OBI_SIM_DEFAULT_QUEUE_BYTES  (256u * 1024u)
+#define OBI_SIM_DEFAULT_SEED         1
+#define OBI_SIM_MAX_ENDPOINTS        256   // bound addresses per network
+#define OBI_SIM_MAX_INBOUND          1024  // links into one endpoint
+
+// Frame types carried on every transport
+typedef enum {
+    OBI_FRAME_DATA = 0,
+    OBI_FRAME_HEARTBEAT,      // liveness probe between direct neighbours, never delivered
+    OBI_FRAME_CREDIT,         // explicit credit grant when there is no return traffic
+    OBI_FRAME_BATCH,          // coalesced small messages, each prefixed by a 4-byte length
+    OBI_FRAME_GOSSIP,         // membership probe or ack with piggybacked updates, never delivered
+    OBI_FRAME_FRAGMENT        // one piece of a payload larger than the frame, after a fragment header
+} obi_topology_frame_type_t;
+
+// Frame flags
+#define OBI_FRAME_FLAG_CREDIT 0x0001u   // credit and credit_mark are set
+#define OBI_FRAME_FLAG_SHARED 0x0002u   // payload was fanned out from one shared buffer
+#define OBI_FRAME_FLAG_PROBE  0x0004u   // CREDIT frame from a stalled sender asking for a grant
+
+// Wire header written in front of every payload
+typedef struct {
+    uint32_t length;      // payload bytes following the header
+    uint16_t type;        // obi_topology_frame_type_t
+    uint16_t flags;
+    uint32_t source;      // sender node key
+    uint32_t destination; // final destination node key (0 = next hop itself)
+    uint32_t credit;      // highest credit_mark the source has read from the destination
+    uint32_t credit_mark; // credits the source had taken towards the destination when sent
+    uint32_t sequence;    // per source and destination, from 1; 0 = unordered (control frames)
+    uint32_t origin;      // node key of the message's first sender; kept when a relay re-floods it
+    uint32_t message_id;  // per origin, from 1 (a batch's first record); 0 = none
+} obi_topology_frame_t;
+
+// Header at the start of every fragment payload; fragments of one message
+// leave in offset order over one route
+typedef struct {
+    uint32_t message_id;  // per sender, shared by the message's fragments
+    uint32_t total_length;
+    uint32_t offset;      // of this fragment's bytes within the message
+} obi_fragment_header_t;
+
+typedef struct obi_topology_transport obi_topology_transport_t;
+
+// Backend operations - peers are opaque handles resolved once by connect
+typedef struct {
+    const char *name;
+    obi_result_t (*bind)(obi_topology_transport_t *transport, const char *local_address);
+    obi_result_t (*connect)(obi_topology_transport_t *transport, const char *address, void **peer);
+    obi_result_t (*send)(obi_topology_transport_t *transport, void *peer,
+                         const obi_topology_frame_t *frame, const uint8_t *payload);
+    obi_result_t (*receive)(obi_topology_transport_t *transport, obi_topology_frame_t *frame,
+                            uint8_t *payload, size_t capacity);
+    obi_result_t (*flush)(obi_topology_transport_t *transport);
+    size_t (*queue_depth)(obi_topology_transport_t *transport, void *peer);  // frames not yet consumed
+    void (*set_batch_scale)(obi_topology_transport_t *transport, uint32_t scale);  // 1 = as configured
+    // Fan one payload out to count peers, writing it once; optional, NULL
+    // means the caller sends per peer. frames[i] is peer i's header (all of
+    // one length) and results[i] its outcome
+    void (*broadcast)(obi_topology_transport_t *transport, void *const *peers, size_t count,
+                      const obi_topology_frame_t *frames, const uint8_t *payload, obi_result_t *results);
+    // Send count frames to one peer in order with one claim on its queue;
+    // optional, NULL means the caller sends one at a time. Returns how many
+    // leading frames were sent; the rest were refused for space
+    size_t (*send_vector)(obi_topology_transport_t *transport, void *peer, const obi_topology_frame_t *frames,
+                          const uint8_t *const *payloads, size_t count);
+    // Descriptor that turns readable when receive may have frames, for event
+    // loops; optional, NULL or -1 means the caller polls receive on a timer
+    int (*event_fd)(obi_topology_transport_t *transport);
+    void (*disconnect)(obi_topology_transport_t *transport, void *peer);
+    void (*destroy)(obi_topology_transport_t *transport);
+} obi_topology_transport_ops_t;
+
+// Common transport base - backends embed this as their first member
+// Common transport base - backends embed this as their first member. Only a
+// concurrent backend may have its ops called from several threads at once;
+// the context serialises calls into any other
+struct obi_topology_transport {
+    const obi_topology_transport_ops_t *ops;
+    size_t max_frame_payload;
+    bool concurrent;
+};
+
+// Shared-memory ring handle (process-local view of a mapped ring)
+typedef struct obi_shm_ring obi_shm_ring_t;
+
+// In-place reservation returned by obi_shm_ring_reserve
+typedef struct {
+    uint64_t position;
+    void *slot;
+} obi_shm_reservation_t;
+
+typedef struct {
+    uint32_t slot_count;     // rounded up to a power of two
+    uint32_t slot_size;      // bytes per slot including frame header
+    bool single_producer;    // SPSC fast path (no CAS on reserve)
+    uint32_t pool_blocks;    // refcounted broadcast payload blocks (0 = default)
+} obi_shm_config_t;
+
+// Shared-memory ring API
+
+/**
+ * Create and map a ring owned by the receiving process. A ring left by an
+ * owner that has exited is replaced; one whose owner is alive (or still
+ * initialising it) is left alone and OBI_ERROR_NETWORK_FAILURE returned
+ */
+obi_result_t obi_shm_ring_create(const char *name, const obi_shm_config_t *config,
+                                 obi_shm_ring_t **ring);
+
+/**
+ * Attach to an existing ring as a producer; fails unless the ring's
+ * geometry fits the mapped object
+ */
+obi_result_t obi_shm_ring_attach(const char *name, bool single_producer, obi_shm_ring_t **ring);
+
+/**
+ * Unmap the ring; the owner also unlinks the shared-memory object
+ */
+void obi_shm_ring_close(obi_shm_ring_t *ring);
+
+/**
+ * Reserve one slot for length bytes; returns the in-place write area or NULL when full
+ */
+uint8_t *obi_shm_ring_reserve(obi_shm_ring_t *ring, size_t length, obi_shm_reservation_t *reservation);
+
+/**
+ * Producer side: reserve up to count consecutive slots with one CAS;
+ * returns how many were reserved (0 when the ring is full). Each slot is
+ * published on its own, in order
+ */
+size_t obi_shm_ring_reserve_batch(obi_shm_ring_t *ring, size_t count, obi_shm_reservation_t *reservations);
+
+/**
+ * Publish a reserved slot with a single release store
+ */
+void obi_shm_ring_publish(obi_shm_ring_t *ring, const obi_shm_reservation_t *reservation, size_t length);
+
+/**
+ * Consumer side: peek the next published slot without copying
+ */
+const uint8_t *obi_shm_ring_peek(obi_shm_ring_t *ring, size_t *length);
+
+/**
+ * Consumer side: return the peeked slot to producers
+ */
+void obi_shm_ring_release(obi_shm_ring_t *ring);
+
+/**
+ * Usable bytes per slot
+ */
+size_t obi_shm_ring_slot_capacity(const obi_shm_ring_t *ring);
+
+// Socket transport configuration
+// Addresses: "unix:/path", "udp:127.0.0.1:port" (sendmmsg) or "tcp:127.0.0.1:port" (writev)
+typedef struct {
+    uint32_t batch_size;         // messages per sendmmsg/writev flush
+    uint32_t flush_deadline_us;  // max time the oldest queued message waits
+    uint32_t max_datagram;       // frame header + payload bytes per message
+} obi_socket_config_t;
+
+// Socket transport counters - syscalls per message is the batching figure of merit
+typedef struct {
+    uint64_t messages_sent;
+    uint64_t send_syscalls;
+    uint64_t messages_received;
+    uint64_t receive_syscalls;
+} obi_socket_stats_t;
+
+// io_uring transport configuration (datagram addresses: "unix:" and "udp:")
+typedef struct {
+    uint32_t queue_depth;    // submission queue entries
+    uint32_t buffer_count;   // registered send and provided receive buffers (power of two)
+    uint32_t buffer_size;    // frame header + payload bytes per buffer
+    uint32_t submit_batch;   // SQEs queued before io_uring_enter
+} obi_uring_config_t;
+
+// One direction of a simulated link; frames on a link never overtake each other
+typedef struct {
+    uint32_t latency_us;      // propagation delay
+    uint32_t jitter_us;       // extra delay drawn uniformly from [0, jitter_us]
+    uint64_t bandwidth;       // wire bytes per second, frame header included; 0 = unlimited
+    uint32_t loss_ppm;        // frames lost per million; 1000000 cuts the link
+} obi_sim_link_config_t;
+
+// Simulated network: transports created from it reach each other by bound
+// address, in this process, through links with the given impairments
+typedef struct {
+    obi_sim_link_config_t link;   // every link starts with this
+    uint32_t queue_frames;        // frames in flight per link before send reports WOULD_BLOCK
+    uint32_t queue_bytes;         // payload bytes in flight per link, likewise
+    uint64_t seed;                // jitter and loss draws; per link, so runs repeat exactly
+} obi_sim_config_t;
+
+typedef struct {
+    uint64_t frames_sent;         // accepted by a link, lost ones included
+    uint64_t frames_delivered;
+    uint64_t frames_lost;         // by loss_ppm, or sent to an address nobody holds
+    uint64_t frames_refused;      // sends refused for a full link
+    uint64_t bytes_delivered;
+} obi_sim_stats_t;
+
+typedef struct obi_sim_network obi_sim_network_t;
+
+/**
+ * Create an in-memory network (NULL = unimpaired links and default queues)
+ */
+obi_sim_network_t *obi_sim_network_create(const obi_sim_config_t *config);
+
+/**
+ * Free the network; every transport created from it must be destroyed first
+ */
+void obi_sim_network_destroy(obi_sim_network_t *network);
+
+/**
+ * Change the link from one bound address to another (NULL = network
+ * default); takes effect for frames sent afterwards, including on links in use
+ */
+obi_result_t obi_sim_network_set_link(obi_sim_network_t *network, const char *from, const char *to,
+                                      const obi_sim_link_config_t *config);
+
+obi_result_t obi_sim_network_get_stats(obi_sim_network_t *network, obi_sim_stats_t *stats);
+
+// Transport constructors
+obi_topology_transport_t *obi_topology_transport_shm_create(const obi_shm_config_t *config);
+obi_topology_transport_t *obi_topology_transport_socket_create(const obi_socket_config_t *config);
+
+/**
+ * Create the io_uring backend; NULL when the kernel or build lacks io_uring,
+ * in which case callers fall back to obi_topology_transport_socket_create
+ */
+obi_topology_transport_t *obi_topology_transport_uring_create(const obi_uring_config_t *config);
+
+/**
+ * Create a transport on a simulated network; it may be used from any thread.
+ * A node that binds an address it held before keeps its links
+ */
+obi_topology_transport_t *obi_topology_transport_sim_create(obi_sim_network_t *network);
+
+/**
+ * Read socket transport counters (transport must come from the socket constructor)
+ */
+obi_result_t obi_socket_transport_get_stats(obi_topology_transport_t *transport, obi_socket_stats_t *stats);
+
+/**
+ * Read io_uring transport counters (send_syscalls counts io_uring_enter calls)
+ */
+obi_result_t obi_uring_transport_get_stats(obi_topology_transport_t *transport, obi_socket_stats_t *stats);
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OBITOPOLOGY_TRANSPORT_H */
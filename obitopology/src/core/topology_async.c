@@ -0,0 +1,532 @@
+/*
+ * OBI Topology Asynchronous Sends
+ * Sends queue per destination and traffic class and return a handle at
+ * once; an epoll loop owned by the context hands them to the transport,
+ * security and audit first and the other classes by deficit round robin,
+ * retries those refused for ring space or credit on a short tick, and
+ * reports each final result through its completion callback
+ */
+
+#define _GNU_SOURCE
+
+#include "topology_internal.h"
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sched.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+
+#define ASYNC_NONE        UINT32_MAX
+#define HANDLE_INDEX_BITS 12          // request slot in the low bits, generation above
+#define HANDLE_GENERATIONS (1u << (32 - HANDLE_INDEX_BITS))
+#define RECEIVE_BUDGET    256         // messages delivered per pass, so sends are not starved
+
+_Static_assert(OBI_ASYNC_MAX_INFLIGHT <= (1u << HANDLE_INDEX_BITS), "handle index bits too narrow");
+
+static void lock_queues(obi_topology_context_t *ctx) {
+    while (atomic_flag_test_and_set_explicit(&ctx->async_lock, memory_order_acquire)) {
+        sched_yield();
+    }
+}
+
+static void unlock_queues(obi_topology_context_t *ctx) {
+    atomic_flag_clear_explicit(&ctx->async_lock, memory_order_release);
+}
+
+// Caller holds async_lock
+static bool allocate_requests(obi_topology_context_t *ctx) {
+    ctx->async_requests = calloc(OBI_ASYNC_MAX_INFLIGHT, sizeof(obi_async_request_t));
+    if (!ctx->async_requests) {
+        return false;
+    }
+    for (uint32_t i = 0; i < OBI_ASYNC_MAX_INFLIGHT; i++) {
+        ctx->async_requests[i].next = i + 1 < OBI_ASYNC_MAX_INFLIGHT ? i + 1 : ASYNC_NONE;
+        ctx->async_requests[i].generation = 1;
+    }
+    ctx->async_free = 0;
+    for (uint32_t i = 0; i < OBI_TOPOLOGY_MAX_NODES; i++) {
+        obi_async_queue_t *queue = &ctx->async_queues[i];
+        memset(queue, 0, sizeof(*queue));
+        for (int c = 0; c < OBI_CLASS_COUNT; c++) {
+            queue->head[c] = ASYNC_NONE;
+            queue->tail[c] = ASYNC_NONE;
+        }
+        queue->turn = OBI_CLASS_STRICT_COUNT;
+    }
+    return true;
+}
+
+static obi_send_handle_t make_handle(uint32_t index, uint32_t generation) {
+    return (generation << HANDLE_INDEX_BITS) | index;
+}
+
+static void wake_loop(obi_topology_context_t *ctx) {
+    uint64_t one = 1;
+    if (write(ctx->wake_fd, &one, sizeof(one)) < 0) {
+        // EAGAIN means the counter is already non-zero, which wakes the loop just the same
+    }
+}
+
+static obi_result_t enqueue(obi_topology_context_t *ctx, const obi_buffer_t *buffer, obi_node_id_t destination,
+                            obi_topology_priority_t priority, obi_traffic_class_t traffic_class,
+                            obi_send_callback_t callback, void *user, obi_send_handle_t *handle) {
+    if (!ctx || !ctx->active || !buffer || (!buffer->data && buffer->size) || !handle ||
+        destination >= ctx->graph.node_count) {
+        return OBI_ERROR_INVALID_INPUT;
+    }
+    if (buffer->size > OBI_FRAGMENT_MAX_MESSAGE) {
+        return OBI_ERROR_BUFFER_OVERFLOW;
+    }
+
+    lock_queues(ctx);
+    if (!ctx->async_requests && !allocate_requests(ctx)) {
+        unlock_queues(ctx);
+        return OBI_ERROR_OUT_OF_MEMORY;
+    }
+    uint32_t index = ctx->async_free;
+    if (index == ASYNC_NONE) {
+        unlock_queues(ctx);
+        return OBI_BUSY;
+    }
+
+    // Slots keep their payload storage, so steady traffic stops allocating
+    obi_async_request_t *request = &ctx->async_requests[index];
+    if (request->capacity < buffer->size) {
+        uint8_t *data = realloc(request->data, buffer->size);
+        if (!data) {
+            unlock_queues(ctx);
+            return OBI_ERROR_OUT_OF_MEMORY;
+        }
+        request->data = data;
+        request->capacity = buffer->size;
+    }
+    if (buffer->size) {
+        memcpy(request->data, buffer->data, buffer->size);
+    }
+    ctx->async_free = request->next;
+    request->size = buffer->size;
+    request->callback = callback;
+    request->user = user;
+    request->priority = (uint8_t)priority;
+    request->traffic_class = (uint8_t)traffic_class;
+    request->admitted = false;
+    request->train = (obi_fragment_train_t){0};
+    request->next = ASYNC_NONE;
+
+    obi_async_queue_t *queue = &ctx->async_queues[destination];
+    if (queue->tail[traffic_class] == ASYNC_NONE) {
+        queue->head[traffic_class] = index;
+    } else {
+        ctx->async_requests[queue->tail[traffic_class]].next = index;
+    }
+    queue->tail[traffic_class] = index;
+    *handle = make_handle(index, request->generation);
+    unlock_queues(ctx);
+
+    // Pairs with the loop raising events_sleeping before it checks for work
+    atomic_fetch_add(&ctx->async_pending, 1);
+    if (atomic_load(&ctx->events_sleeping)) {
+        wake_loop(ctx);
+    }
+    return OBI_SUCCESS;
+}
+
+obi_result_t obi_topology_send_async(obi_topology_context_t *ctx, const obi_buffer_t *buffer,
+                                     obi_node_id_t destination, obi_topology_priority_t priority,
+                                     obi_send_callback_t callback, void *user, obi_send_handle_t *handle) {
+    return enqueue(ctx, buffer, destination, priority, OBI_CLASS_DEFAULT, callback, user, handle);
+}
+
+obi_result_t obi_topology_send_async_class(obi_topology_context_t *ctx, const obi_buffer_t *buffer,
+                                           obi_node_id_t destination, obi_traffic_class_t traffic_class,
+                                           obi_send_callback_t callback, void *user, obi_send_handle_t *handle) {
+    // Compliance traffic must survive shedding; bulk is the first to go
+    static const obi_topology_priority_t admission[OBI_CLASS_COUNT] = {
+        OBI_PRIORITY_HIGH, OBI_PRIORITY_HIGH, OBI_PRIORITY_NORMAL, OBI_PRIORITY_NORMAL, OBI_PRIORITY_LOW
+    };
+    if ((unsigned)traffic_class >= OBI_CLASS_COUNT) {
+        return OBI_ERROR_INVALID_INPUT;
+    }
+    return enqueue(ctx, buffer, destination, admission[traffic_class], traffic_class, callback, user, handle);
+}
+
+obi_traffic_class_t obi_topology_class_for_pattern(obi_semantic_pattern_t pattern) {
+    switch (pattern) {
+        case PATTERN_SECURITY_TOKEN:
+            return OBI_CLASS_SECURITY;
+        case PATTERN_AUDIT_MARKER:
+            return OBI_CLASS_AUDIT;
+        case PATTERN_DATA_PAYLOAD:
+            return OBI_CLASS_BULK;
+        case PATTERN_PROTOCOL_HEADER:
+        case PATTERN_SCHEMA_REFERENCE:
+        case PATTERN_TRANSITION_BOUNDARY:
+        case PATTERN_ERROR_RECOVERY:
+            return OBI_CLASS_CONTROL;
+        default:
+            return OBI_CLASS_DEFAULT;
+    }
+}
+
+obi_topology_result_t obi_topology_set_traffic_classes(obi_topology_context_t *ctx, const obi_class_config_t *config) {
+    obi_class_config_t defaults = { OBI_CLASS_DEFAULT_WEIGHTS, OBI_CLASS_DEFAULT_STRICT_BURST };
+    if (!config) {
+        config = &defaults;
+    }
+    if (!ctx || !ctx->active) {
+        return OBI_TOPOLOGY_ERROR_INVALID_CONFIG;
+    }
+    for (int c = OBI_CLASS_STRICT_COUNT; c < OBI_CLASS_COUNT; c++) {
+        if (config->weights[c] == 0) {
+            return OBI_TOPOLOGY_ERROR_INVALID_CONFIG;
+        }
+    }
+    memcpy(ctx->class_weights, config->weights, sizeof(ctx->class_weights));
+    ctx->class_strict_burst = config->strict_burst;
+    return OBI_TOPOLOGY_SUCCESS;
+}
+
+obi_topology_result_t obi_topology_set_receive_callback(obi_topology_context_t *ctx,
+                                                        obi_receive_callback_t callback, void *user) {
+    if (!ctx || !ctx->active) {
+        return OBI_TOPOLOGY_ERROR_INVALID_CONFIG;
+    }
+    ctx->receive_callback = callback;
+    ctx->receive_user = user;
+    return OBI_TOPOLOGY_SUCCESS;
+}
+
+// Retire the head of a destination's class queue; the slot is free again
+// before the callback runs, so callbacks may submit follow-up sends
+static void complete_head(obi_topology_context_t *ctx, obi_node_id_t id, int traffic_class, obi_result_t result) {
+    lock_queues(ctx);
+    obi_async_queue_t *queue = &ctx->async_queues[id];
+    uint32_t index = queue->head[traffic_class];
+    obi_async_request_t *request = &ctx->async_requests[index];
+    obi_send_callback_t callback = request->callback;
+    void *user = request->user;
+    obi_send_handle_t handle = make_handle(index, request->generation);
+
+    queue->head[traffic_class] = request->next;
+    if (request->next == ASYNC_NONE) {
+        queue->tail[traffic_class] = ASYNC_NONE;
+    }
+    request->generation = (request->generation + 1) % HANDLE_GENERATIONS;
+    if (request->generation == 0) {
+        request->generation = 1;  // handle 0 is never issued
+    }
+    request->next = ctx->async_free;
+    ctx->async_free = index;
+    unlock_queues(ctx);
+
+    atomic_fetch_sub(&ctx->async_pending, 1);
+    if (callback) {
+        callback(user, handle, result);
+    }
+}
+
+static void next_turn(obi_async_queue_t *queue) {
+    queue->turn = queue->turn + 1 < OBI_CLASS_COUNT ? queue->turn + 1 : OBI_CLASS_STRICT_COUNT;
+    queue->granted = false;
+}
+
+// Caller holds async_lock. Strict classes go first, except that after
+// strict_burst of them in a row a waiting weighted class gets one send.
+// Weighted classes take turns, each sending while its head fits the bytes
+// earned by its weight. Returns OBI_CLASS_COUNT when every queue is empty
+static int pick_class(obi_topology_context_t *ctx, obi_async_queue_t *queue, bool *starving) {
+    int strict = OBI_CLASS_COUNT;
+    for (int c = OBI_CLASS_STRICT_COUNT - 1; c >= 0; c--) {
+        if (queue->head[c] != ASYNC_NONE) {
+            strict = c;
+        }
+    }
+    bool weighted = false;
+    for (int c = OBI_CLASS_STRICT_COUNT; c < OBI_CLASS_COUNT; c++) {
+        weighted |= queue->head[c] != ASYNC_NONE;
+    }
+    if (!weighted) {
+        queue->strict_run = 0;
+        return strict;
+    }
+    if (strict < OBI_CLASS_COUNT && (!ctx->class_strict_burst || queue->strict_run < ctx->class_strict_burst)) {
+        return strict;
+    }
+
+    *starving = strict < OBI_CLASS_COUNT;
+    for (;;) {
+        int c = queue->turn;
+        if (queue->head[c] == ASYNC_NONE) {
+            queue->deficit[c] = 0;  // an idle class banks nothing
+            next_turn(queue);
+            continue;
+        }
+        if (!queue->granted) {
+            queue->deficit[c] += (uint64_t)ctx->class_weights[c] * OBI_CLASS_QUANTUM;
+            queue->granted = true;
+        }
+        if (ctx->async_requests[queue->head[c]].size <= queue->deficit[c]) {
+            return c;
+        }
+        next_turn(queue);
+    }
+}
+
+// Only the loop retires requests, so the head stays put while it is sent
+static size_t dispatch(obi_topology_context_t *ctx) {
+    size_t completed = 0;
+    uint64_t now = obi_topology_now_ns();
+    obi_topology_governance_tick(ctx, now);
+    if (atomic_load(&ctx->async_pending) == 0) {
+        return 0;  // also covers queues not yet allocated
+    }
+
+    for (uint32_t id = 0; id < ctx->graph.node_count; id++) {
+        obi_async_queue_t *queue = &ctx->async_queues[id];
+        for (;;) {
+            bool starving = false;
+            lock_queues(ctx);
+            int traffic_class = pick_class(ctx, queue, &starving);
+            uint32_t index = traffic_class < OBI_CLASS_COUNT ? queue->head[traffic_class] : ASYNC_NONE;
+            unlock_queues(ctx);
+            if (index == ASYNC_NONE) {
+                break;
+            }
+
+            // Admission is decided once; shed sends complete with OBI_ERROR_WOULD_BLOCK
+            obi_async_request_t *request = &ctx->async_requests[index];
+            obi_result_t result = OBI_ERROR_WOULD_BLOCK;
+            if (request->admitted || obi_topology_admit(ctx, (obi_topology_priority_t)request->priority)) {
+                request->admitted = true;
+                obi_buffer_t buffer = { request->data, request->size, request->capacity };
+                result = obi_topology_send_admitted(ctx, &buffer, (obi_node_id_t)id, now, false, &request->train);
+
+                // A full ring or an empty window holds every class until the next
+                // pass; the picked class keeps its turn and its deficit
+                if (result == OBI_BUSY || result == OBI_ERROR_WOULD_BLOCK) {
+                    break;
+                }
+            }
+
+            // Only sends that went out spend a class's share; shed and failed
+            // requests complete without using the link
+            if (result == OBI_SUCCESS) {
+                if (traffic_class < OBI_CLASS_STRICT_COUNT) {
+                    queue->strict_run++;
+                } else {
+                    queue->deficit[traffic_class] -= request->size;
+                    queue->strict_run = 0;
+                    if (starving) {
+                        atomic_fetch_add_explicit(&ctx->starvation_breaks, 1, memory_order_relaxed);
+                    }
+                }
+                atomic_fetch_add_explicit(&ctx->class_sent[traffic_class], 1, memory_order_relaxed);
+            }
+            complete_head(ctx, (obi_node_id_t)id, traffic_class, result);
+            completed++;
+        }
+    }
+
+    if (completed > 0) {
+        obi_topology_transport_flush(ctx);
+    }
+    return completed;
+}
+
+static obi_result_t deliver(obi_topology_context_t *ctx, size_t *received) {
+    // Receiving also absorbs credit grants, which releases held sends; views
+    // hand reassembled messages to the callback without a copy
+    for (size_t i = 0; i < RECEIVE_BUDGET; i++) {
+        obi_buffer_t buffer;
+        obi_result_t result = obi_topology_receive_view(ctx, &buffer);
+        if (result == OBI_ERROR_WOULD_BLOCK) {
+            break;
+        }
+        if (result != OBI_SUCCESS) {
+            return result;
+        }
+        ctx->receive_callback(ctx->receive_user, &buffer);
+        (*received)++;
+    }
+    return OBI_SUCCESS;
+}
+
+static obi_result_t run_pass(obi_topology_context_t *ctx, size_t *completed, size_t *received) {
+    obi_result_t result = OBI_SUCCESS;
+    if (ctx->receive_callback) {
+        result = deliver(ctx, received);
+    }
+    *completed += dispatch(ctx);
+    obi_topology_poll(ctx);
+    return result;
+}
+
+static void close_events(obi_topology_context_t *ctx) {
+    if (ctx->epoll_fd >= 0) {
+        close(ctx->epoll_fd);
+    }
+    if (ctx->timer_fd >= 0) {
+        close(ctx->timer_fd);
+    }
+    if (ctx->wake_fd >= 0) {
+        close(ctx->wake_fd);
+    }
+}
+
+static bool watch(obi_topology_context_t *ctx, int fd) {
+    struct epoll_event event = {0};
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    return epoll_ctl(ctx->epoll_fd, EPOLL_CTL_ADD, fd, &event) == 0;
+}
+
+static obi_result_t setup_events(obi_topology_context_t *ctx) {
+    if (ctx->events_ready) {
+        return OBI_SUCCESS;
+    }
+
+    ctx->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    ctx->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    ctx->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (ctx->epoll_fd < 0 || ctx->timer_fd < 0 || ctx->wake_fd < 0 ||
+        !watch(ctx, ctx->timer_fd) || !watch(ctx, ctx->wake_fd)) {
+        close_events(ctx);
+        return OBI_ERROR_NETWORK_FAILURE;
+    }
+    ctx->events_transport_fd = -1;
+    ctx->tick_armed = false;
+    ctx->events_ready = true;
+    return OBI_SUCCESS;
+}
+
+// Backends expose their descriptor only once bound, so this is retried every
+// run. Without a receive callback nobody would drain it, so it stays unwatched
+static void attach_transport(obi_topology_context_t *ctx) {
+    if (!ctx->receive_callback) {
+        obi_topology_async_detach(ctx);
+        return;
+    }
+    if (ctx->events_transport_fd >= 0 || !ctx->transport->ops->event_fd) {
+        return;
+    }
+    obi_topology_lock_transport(ctx);
+    int fd = ctx->transport->ops->event_fd(ctx->transport);
+    obi_topology_unlock_transport(ctx);
+    if (fd >= 0 && watch(ctx, fd)) {
+        ctx->events_transport_fd = fd;
+    }
+}
+
+// Work that no descriptor signals: held sends, batch deadlines, heartbeats,
+// gossip, and receives on a transport without an event descriptor
+static bool needs_tick(obi_topology_context_t *ctx) {
+    return atomic_load(&ctx->async_pending) > 0 ||
+           atomic_load_explicit(&ctx->coalesce_due_ns, memory_order_relaxed) != 0 ||
+           ctx->heartbeat_interval_ns || ctx->gossip_interval_ns ||
+           (ctx->receive_callback && ctx->events_transport_fd < 0);
+}
+
+static void arm_tick(obi_topology_context_t *ctx, bool armed) {
+    if (armed == ctx->tick_armed) {
+        return;
+    }
+    struct itimerspec spec = {0};
+    if (armed) {
+        spec.it_value.tv_nsec = OBI_ASYNC_TICK_US * 1000L;
+        spec.it_interval.tv_nsec = OBI_ASYNC_TICK_US * 1000L;
+    }
+    if (timerfd_settime(ctx->timer_fd, 0, &spec, NULL) == 0) {
+        ctx->tick_armed = armed;
+    }
+}
+
+static void drain(int fd) {
+    uint64_t count;
+    while (read(fd, &count, sizeof(count)) > 0) {
+    }
+}
+
+obi_result_t obi_topology_run_events(obi_topology_context_t *ctx, int timeout_ms, size_t *completed) {
+    if (completed) {
+        *completed = 0;
+    }
+    if (!ctx || !ctx->active) {
+        return OBI_ERROR_INVALID_INPUT;
+    }
+    if (setup_events(ctx) != OBI_SUCCESS) {
+        return OBI_ERROR_NETWORK_FAILURE;
+    }
+    attach_transport(ctx);
+
+    size_t done = 0;
+    size_t received = 0;
+    obi_result_t result = run_pass(ctx, &done, &received);
+
+    // Idle: sleep until a descriptor fires. A submitter either sees the flag
+    // and writes the wake descriptor, or its pending count arms the tick
+    if (result == OBI_SUCCESS && done == 0 && received == 0 && timeout_ms != 0) {
+        atomic_store(&ctx->events_sleeping, true);
+        arm_tick(ctx, needs_tick(ctx));
+
+        struct epoll_event events[4];
+        int ready = epoll_wait(ctx->epoll_fd, events, 4, timeout_ms);
+        atomic_store(&ctx->events_sleeping, false);
+        for (int i = 0; i < ready; i++) {
+            if (events[i].data.fd == ctx->timer_fd || events[i].data.fd == ctx->wake_fd) {
+                drain(events[i].data.fd);
+            }
+        }
+        if (ready > 0) {
+            result = run_pass(ctx, &done, &received);
+        }
+    }
+
+    // An embedding loop watching the epoll descriptor relies on the tick too
+    arm_tick(ctx, needs_tick(ctx));
+
+    if (completed) {
+        *completed = done;
+    }
+    return result;
+}
+
+int obi_topology_event_fd(obi_topology_context_t *ctx) {
+    if (!ctx || !ctx->active || setup_events(ctx) != OBI_SUCCESS) {
+        return -1;
+    }
+    attach_transport(ctx);
+    arm_tick(ctx, needs_tick(ctx));
+    return ctx->epoll_fd;
+}
+
+void obi_topology_async_detach(obi_topology_context_t *ctx) {
+    if (ctx->events_ready && ctx->events_transport_fd >= 0) {
+        epoll_ctl(ctx->epoll_fd, EPOLL_CTL_DEL, ctx->events_transport_fd, NULL);
+        ctx->events_transport_fd = -1;
+    }
+}
+
+void obi_topology_async_release(obi_topology_context_t *ctx) {
+    if (ctx->async_requests) {
+        for (uint32_t id = 0; id < ctx->graph.node_count; id++) {
+            for (int c = 0; c < OBI_CLASS_COUNT; c++) {
+                while (ctx->async_queues[id].head[c] != ASYNC_NONE) {
+                    complete_head(ctx, (obi_node_id_t)id, c, OBI_ERROR_NETWORK_FAILURE);
+                }
+            }
+        }
+        for (uint32_t i = 0; i < OBI_ASYNC_MAX_INFLIGHT; i++) {
+            free(ctx->async_requests[i].data);
+        }
+        free(ctx->async_requests);
+        ctx->async_requests = NULL;
+    }
+    if (ctx->events_ready) {
+        close_events(ctx);
+        ctx->events_ready = false;
+    }
+}
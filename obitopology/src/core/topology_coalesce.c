@@ -0,0 +1,292 @@
+/*
+ * OBI Topology Coalescing
+ * Small sends to one destination are packed into a single batch frame,
+ * which leaves when it fills, when its deadline passes or on an explicit
+ * flush; the receive path unpacks it back into individual messages
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "topology_internal.h"
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+
+// Each message in a batch payload is a 4-byte length followed by its bytes
+#define BATCH_RECORD_HEADER sizeof(uint32_t)
+
+static void lock_node(obi_topology_node_t *node) {
+    while (atomic_flag_test_and_set_explicit(&node->coalesce_lock, memory_order_acquire)) {
+        sched_yield();
+    }
+}
+
+static void unlock_node(obi_topology_node_t *node) {
+    atomic_flag_clear_explicit(&node->coalesce_lock, memory_order_release);
+}
+
+// Lower the earliest pending deadline to due
+static void note_due(obi_topology_context_t *ctx, uint64_t due) {
+    uint64_t current = atomic_load_explicit(&ctx->coalesce_due_ns, memory_order_relaxed);
+    while ((current == 0 || due < current) &&
+           !atomic_compare_exchange_weak_explicit(&ctx->coalesce_due_ns, &current, due,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+// Caller holds the node lock; a failed send leaves the batch queued for a retry
+static obi_result_t send_batch(obi_topology_context_t *ctx, obi_node_id_t id, obi_topology_node_t *node) {
+    if (node->coalesce_count == 0) {
+        return OBI_SUCCESS;
+    }
+
+    obi_topology_frame_t frame = {0};
+    frame.length = node->coalesce_used;
+    frame.type = OBI_FRAME_BATCH;
+    frame.source = ctx->local_key;
+    frame.destination = node->key;
+    frame.origin = ctx->local_key;
+    frame.message_id = obi_topology_claim_message_ids(ctx, node->coalesce_count);  // records count on from it
+    obi_topology_flow_stamp(ctx, node, &frame, node->coalesce_mark);
+    obi_topology_order_stamp(node, &frame);
+
+    unsigned slot;
+    const obi_route_table_t *routes = obi_route_acquire(&ctx->routes, &slot);
+    obi_result_t result = obi_topology_forward_frame(ctx, routes, id, &frame, node->coalesce);
+    obi_route_release(&ctx->routes, slot);
+    if (result != OBI_SUCCESS) {
+        obi_topology_order_cancel(node, &frame);
+    }
+
+    if (result == OBI_SUCCESS) {
+        atomic_fetch_add_explicit(&ctx->coalesced_messages, node->coalesce_count, memory_order_relaxed);
+        atomic_fetch_add_explicit(&ctx->coalesced_batches, 1, memory_order_relaxed);
+        node->coalesce_used = 0;
+        node->coalesce_count = 0;
+        node->coalesce_deadline_ns = 0;
+    }
+    return result;
+}
+
+static obi_result_t flush_pending(obi_topology_context_t *ctx, uint64_t now, bool all) {
+    obi_result_t result = OBI_SUCCESS;
+    uint64_t next_due = 0;
+
+    // Cleared first: a batch started during the scan registers its own deadline
+    atomic_store_explicit(&ctx->coalesce_due_ns, 0, memory_order_relaxed);
+    for (uint32_t i = 0; i < ctx->graph.node_count; i++) {
+        obi_topology_node_t *node = &ctx->nodes[i];
+        lock_node(node);
+        if (node->coalesce_count && (all || now >= node->coalesce_deadline_ns)) {
+            obi_result_t sent = send_batch(ctx, (obi_node_id_t)i, node);
+            if (sent != OBI_SUCCESS) {
+                result = sent;
+            }
+        }
+        if (node->coalesce_count && (next_due == 0 || node->coalesce_deadline_ns < next_due)) {
+            next_due = node->coalesce_deadline_ns;
+        }
+        unlock_node(node);
+    }
+
+    if (next_due) {
+        note_due(ctx, next_due);
+    }
+    return result;
+}
+
+obi_topology_result_t obi_topology_set_coalescing(obi_topology_context_t *ctx, const obi_coalesce_config_t *config) {
+    obi_coalesce_config_t defaults = { OBI_COALESCE_DEFAULT_MAX_MESSAGE, OBI_COALESCE_DEFAULT_DEADLINE_US };
+    if (!config) {
+        config = &defaults;
+    }
+    if (!ctx || !ctx->active || config->max_message + BATCH_RECORD_HEADER > ctx->transport->max_frame_payload) {
+        return OBI_TOPOLOGY_ERROR_INVALID_CONFIG;
+    }
+
+    // Batches already queued leave under the old settings
+    obi_topology_flush(ctx);
+    ctx->coalesce_max_message = config->max_message;
+    ctx->coalesce_deadline_ns = (uint64_t)config->deadline_us * 1000ull;
+    return OBI_TOPOLOGY_SUCCESS;
+}
+
+obi_result_t obi_topology_flush(obi_topology_context_t *ctx) {
+    if (!ctx || !ctx->active) {
+        return OBI_ERROR_INVALID_INPUT;
+    }
+
+    while (atomic_flag_test_and_set_explicit(&ctx->coalesce_flush_lock, memory_order_acquire)) {
+        sched_yield();
+    }
+    obi_result_t result = flush_pending(ctx, obi_topology_now_ns(), true);
+    atomic_flag_clear_explicit(&ctx->coalesce_flush_lock, memory_order_release);
+
+    // Push the batches past any batching inside the transport too
+    obi_result_t flushed = obi_topology_transport_flush(ctx);
+    return result != OBI_SUCCESS ? result : flushed;
+}
+
+void obi_topology_coalesce_tick(obi_topology_context_t *ctx, uint64_t now) {
+    uint64_t due = atomic_load_explicit(&ctx->coalesce_due_ns, memory_order_relaxed);
+    if (due == 0 || now < due) {
+        return;
+    }
+
+    // One caller flushes expired batches; the rest carry on
+    if (atomic_flag_test_and_set_explicit(&ctx->coalesce_flush_lock, memory_order_acquire)) {
+        return;
+    }
+    flush_pending(ctx, now, false);
+    atomic_flag_clear_explicit(&ctx->coalesce_flush_lock, memory_order_release);
+}
+
+bool obi_topology_coalesce_accepts(const obi_topology_context_t *ctx, size_t size) {
+    return ctx->coalesce_max_message != 0 && size <= ctx->coalesce_max_message;
+}
+
+obi_result_t obi_topology_coalesce_send(obi_topology_context_t *ctx, obi_node_id_t id,
+                                        const obi_buffer_t *buffer, uint64_t now, uint32_t mark) {
+    obi_topology_node_t *node = &ctx->nodes[id];
+    size_t record = BATCH_RECORD_HEADER + buffer->size;
+    obi_result_t result = OBI_SUCCESS;
+
+    lock_node(node);
+    if (!node->coalesce) {
+        node->coalesce_capacity = (uint32_t)ctx->transport->max_frame_payload;
+        node->coalesce = malloc(node->coalesce_capacity);
+        if (!node->coalesce) {
+            unlock_node(node);
+            return OBI_ERROR_OUT_OF_MEMORY;
+        }
+    }
+
+    // Make room by sending what is queued; if that fails the caller is pushed back
+    if (node->coalesce_used + record > node->coalesce_capacity) {
+        result = send_batch(ctx, id, node);
+        if (result != OBI_SUCCESS || record > node->coalesce_capacity) {
+            unlock_node(node);
+            return result != OBI_SUCCESS ? result : OBI_ERROR_BUFFER_OVERFLOW;
+        }
+    }
+
+    uint32_t length = (uint32_t)buffer->size;
+    memcpy(node->coalesce + node->coalesce_used, &length, BATCH_RECORD_HEADER);
+    memcpy(node->coalesce + node->coalesce_used + BATCH_RECORD_HEADER, buffer->data, buffer->size);
+    node->coalesce_used += (uint32_t)record;
+    if (node->coalesce_count == 0 || (int32_t)(mark - node->coalesce_mark) > 0) {
+        node->coalesce_mark = mark;  // the batch's mark covers every record in it
+    }
+    if (node->coalesce_count++ == 0) {
+        node->coalesce_deadline_ns = now + ctx->coalesce_deadline_ns;
+        note_due(ctx, node->coalesce_deadline_ns);
+    }
+
+    // A full batch leaves at once; if the transport is busy the deadline retries it
+    if (node->coalesce_capacity - node->coalesce_used < BATCH_RECORD_HEADER + ctx->coalesce_max_message) {
+        send_batch(ctx, id, node);
+    }
+    unlock_node(node);
+    return OBI_SUCCESS;
+}
+
+obi_result_t obi_topology_coalesce_drain(obi_topology_context_t *ctx, obi_node_id_t id) {
+    if (ctx->coalesce_max_message == 0) {
+        return OBI_SUCCESS;
+    }
+
+    obi_topology_node_t *node = &ctx->nodes[id];
+    lock_node(node);
+    obi_result_t result = send_batch(ctx, id, node);
+    unlock_node(node);
+    return result;
+}
+
+// The staging area leaves room for one record header in front of the payload,
+// so a plain data frame received there is held as a batch of one
+uint8_t *obi_topology_coalesce_staging(obi_topology_context_t *ctx, size_t payload) {
+    size_t needed = BATCH_RECORD_HEADER + payload;
+    if (ctx->rx_batch_capacity < needed) {
+        uint8_t *grown = realloc(ctx->rx_batch, needed);
+        if (!grown) {
+            return NULL;
+        }
+        ctx->rx_batch = grown;
+        ctx->rx_batch_capacity = (uint32_t)needed;
+    }
+    return ctx->rx_batch + BATCH_RECORD_HEADER;
+}
+
+void obi_topology_coalesce_hold(obi_topology_context_t *ctx, const obi_topology_frame_t *frame) {
+    if (frame->type == OBI_FRAME_BATCH) {
+        ctx->rx_batch_offset = BATCH_RECORD_HEADER;
+    } else {
+        memcpy(ctx->rx_batch, &frame->length, BATCH_RECORD_HEADER);
+        ctx->rx_batch_offset = 0;
+    }
+    ctx->rx_batch_length = BATCH_RECORD_HEADER + frame->length;
+    ctx->rx_batch_source = frame->source;
+    ctx->rx_batch_origin = frame->origin ? frame->origin : frame->source;
+    ctx->rx_batch_message_id = frame->message_id;
+}
+
+obi_result_t obi_topology_coalesce_stage(obi_topology_context_t *ctx, const obi_topology_frame_t *frame,
+                                         const uint8_t *payload) {
+    uint8_t *area = obi_topology_coalesce_staging(ctx, frame->length);
+    if (!area) {
+        return OBI_ERROR_OUT_OF_MEMORY;
+    }
+    memcpy(area, payload, frame->length);
+    obi_topology_coalesce_hold(ctx, frame);
+    return OBI_SUCCESS;
+}
+
+bool obi_topology_coalesce_pending(const obi_topology_context_t *ctx) {
+    return ctx->rx_batch_offset < ctx->rx_batch_length;
+}
+
+obi_result_t obi_topology_coalesce_next(obi_topology_context_t *ctx, obi_buffer_t *buffer, uint32_t *source) {
+    uint32_t remaining = ctx->rx_batch_length - ctx->rx_batch_offset;
+    uint32_t length;
+
+    if (remaining < BATCH_RECORD_HEADER) {
+        ctx->rx_batch_offset = ctx->rx_batch_length;
+        return OBI_ERROR_WOULD_BLOCK;
+    }
+    memcpy(&length, ctx->rx_batch + ctx->rx_batch_offset, BATCH_RECORD_HEADER);
+    if (length > remaining - BATCH_RECORD_HEADER) {
+        ctx->rx_batch_offset = ctx->rx_batch_length;  // malformed tail is dropped
+        return OBI_ERROR_WOULD_BLOCK;
+    }
+    if (length > buffer->capacity) {
+        return OBI_ERROR_BUFFER_OVERFLOW;  // kept for a larger buffer
+    }
+
+    memcpy(buffer->data, ctx->rx_batch + ctx->rx_batch_offset + BATCH_RECORD_HEADER, length);
+    buffer->size = length;
+    ctx->rx_batch_offset += BATCH_RECORD_HEADER + length;
+    *source = ctx->rx_batch_source;
+    ctx->rx_origin = ctx->rx_batch_origin;
+    ctx->rx_message_id = ctx->rx_batch_message_id;
+    if (ctx->rx_batch_message_id) {
+        ctx->rx_batch_message_id++;
+        ctx->rx_batch_message_id += ctx->rx_batch_message_id == 0;
+    }
+    return OBI_SUCCESS;
+}
+
+void obi_topology_coalesce_release(obi_topology_context_t *ctx) {
+    for (uint32_t i = 0; i < ctx->graph.node_count; i++) {
+        obi_topology_node_t *node = &ctx->nodes[i];
+        free(node->coalesce);
+        node->coalesce = NULL;
+        node->coalesce_capacity = 0;
+        node->coalesce_used = 0;
+        node->coalesce_count = 0;
+    }
+    free(ctx->rx_batch);
+    ctx->rx_batch = NULL;
+    ctx->rx_batch_capacity = 0;
+    ctx->rx_batch_length = 0;
+    ctx->rx_batch_offset = 0;
+}
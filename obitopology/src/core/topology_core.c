@@ -3,21 +3,281 @@
  * Network coordination and governance functionality
  */
 
+#define _POSIX_C_SOURCE 200809L
+
 #include "obitopology.h"
+#include "topology_internal.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <sched.h>
 
 // Global topology state
 static bool topology_initialized = false;
 static obi_protocol_context_t *protocol_context = NULL;
 static obi_topology_context_t topology_ctx = {0};
 
-struct obi_topology_context {
-    obi_topology_type_t network_type;
-    obi_topology_metrics_t current_metrics;
-    bool active;
-};
+uint32_t obi_topology_name_key(const char *name) {
+    uint32_t hash = 2166136261u;
+    while (*name) {
+        hash ^= (uint8_t)*name++;
+        hash *= 16777619u;
+    }
+    return hash ? hash : 1;  // 0 is reserved for "no destination"
+}
+
+static obi_node_id_t find_node_by_name(obi_topology_context_t *ctx, const char *name) {
+    obi_node_id_t id = obi_node_registry_find(&ctx->registry, obi_topology_name_key(name));
+    if (id != OBI_NODE_INVALID && strcmp(ctx->nodes[id].name, name) != 0) {
+        return OBI_NODE_INVALID;
+    }
+    return id;
+}
+
+static void disconnect_nodes(obi_topology_context_t *ctx) {
+    for (uint32_t i = 0; i < ctx->graph.node_count; i++) {
+        obi_topology_disconnect_node(ctx, &ctx->nodes[i]);
+    }
+}
+
+void obi_topology_lock_graph(obi_topology_context_t *ctx) {
+    while (atomic_flag_test_and_set_explicit(&ctx->graph_lock, memory_order_acquire)) {
+        sched_yield();
+    }
+}
+
+void obi_topology_unlock_graph(obi_topology_context_t *ctx) {
+    atomic_flag_clear_explicit(&ctx->graph_lock, memory_order_release);
+}
+
+// Socket and io_uring backends keep unlocked per-peer queues and SQ state,
+// so their ops never overlap; concurrent backends skip the lock
+void obi_topology_lock_transport(obi_topology_context_t *ctx) {
+    if (ctx->transport->concurrent) {
+        return;
+    }
+    while (atomic_flag_test_and_set_explicit(&ctx->transport_lock, memory_order_acquire)) {
+        sched_yield();
+    }
+}
+
+void obi_topology_unlock_transport(obi_topology_context_t *ctx) {
+    if (!ctx->transport->concurrent) {
+        atomic_flag_clear_explicit(&ctx->transport_lock, memory_order_release);
+    }
+}
+
+// Swap in a new table; in-flight senders finish on the old one before it is freed
+void obi_topology_publish_routes(obi_route_handle_t *handle, obi_route_table_t *table) {
+    obi_route_table_t *previous = atomic_exchange(&handle->current, table);
+    
+    // Flip through both epoch slots so every reader that saw previous has left
+    for (int round = 0; round < 2; round++) {
+        unsigned slot = atomic_fetch_add(&handle->epoch, 1) & 1u;
+        while (atomic_load(&handle->readers[slot]) != 0) {
+            sched_yield();
+        }
+    }
+    obi_route_table_destroy(previous);
+}
+
+// Caller holds graph_lock; only the affected routes are recomputed
+obi_topology_result_t obi_topology_rebuild_routes(obi_topology_context_t *ctx) {
+    obi_route_table_t *previous = atomic_load(&ctx->routes.current);
+    obi_route_table_t *table = obi_route_table_update(previous, &ctx->graph, ctx->network_type);
+    if (!table) {
+        return OBI_TOPOLOGY_ERROR_INVALID_CONFIG;
+    }
+    
+    table->version = previous ? previous->version + 1 : 1;
+    if (ctx->local_id != OBI_NODE_INVALID) {
+        obi_route_table_protect(table, ctx->local_id);
+    }
+    obi_topology_publish_routes(&ctx->routes, table);
+    return OBI_TOPOLOGY_SUCCESS;
+}
+
+// Caller holds graph_lock. A name already registered returns its id
+static obi_topology_result_t register_node(obi_topology_context_t *ctx, const char *name,
+                                           const char *address, obi_node_id_t *node_id) {
+    obi_node_id_t existing = find_node_by_name(ctx, name);
+    if (existing != OBI_NODE_INVALID) {
+        *node_id = existing;
+        return OBI_TOPOLOGY_SUCCESS;
+    }
+    if (ctx->graph.node_count == OBI_TOPOLOGY_MAX_NODES ||
+        strlen(name) >= sizeof(ctx->nodes[0].name) ||
+        strlen(address) >= sizeof(ctx->nodes[0].address)) {
+        return OBI_TOPOLOGY_ERROR_INVALID_CONFIG;
+    }
+    
+    // The entry is complete before the registry publishes its key to lock-free lookups
+    uint32_t key = obi_topology_name_key(name);
+    obi_node_id_t id = (obi_node_id_t)ctx->graph.node_count;
+    obi_topology_node_t *node = &ctx->nodes[id];
+    strcpy(node->name, name);
+    strcpy(node->address, address);
+    node->key = key;
+    node->handle = NULL;
+    memset(&node->link, 0, sizeof(node->link));
+    memset(&node->rate, 0, sizeof(node->rate));
+    obi_topology_flow_reset(node);
+    atomic_flag_clear(&node->coalesce_lock);
+    
+    // A key collision with a different name would make frames ambiguous
+    if (!obi_node_registry_insert(&ctx->registry, key, id)) {
+        return OBI_TOPOLOGY_ERROR_INVALID_CONFIG;
+    }
+    ctx->graph.key[id] = key;
+    ctx->graph.node_count++;
+    ctx->graph.active[id] = true;
+    
+    obi_topology_result_t result = obi_topology_rebuild_routes(ctx);
+    if (result != OBI_TOPOLOGY_SUCCESS) {
+        // Ids are never reused, so rebuild the index without the new entry
+        ctx->graph.active[id] = false;
+        ctx->graph.node_count--;
+        obi_node_registry_reset(&ctx->registry);
+        for (uint32_t i = 0; i < ctx->graph.node_count; i++) {
+            obi_node_registry_insert(&ctx->registry, ctx->nodes[i].key, (obi_node_id_t)i);
+        }
+        return result;
+    }
+    
+    *node_id = id;
+    return OBI_TOPOLOGY_SUCCESS;
+}
+
+obi_result_t obi_topology_transport_flush(obi_topology_context_t *ctx) {
+    obi_topology_lock_transport(ctx);
+    obi_result_t result = ctx->transport->ops->flush(ctx->transport);
+    obi_topology_unlock_transport(ctx);
+    return result;
+}
+
+// Threads racing to a new peer connect it once; the loser uses the winner's handle
+obi_result_t obi_topology_connect_node(obi_topology_context_t *ctx, obi_topology_node_t *node) {
+    if (atomic_load_explicit(&node->handle, memory_order_acquire)) {
+        return OBI_SUCCESS;
+    }
+    while (atomic_flag_test_and_set_explicit(&ctx->connect_lock, memory_order_acquire)) {
+        sched_yield();
+    }
+    obi_result_t result = OBI_SUCCESS;
+    if (!atomic_load_explicit(&node->handle, memory_order_relaxed)) {
+        void *handle = NULL;
+        obi_topology_lock_transport(ctx);
+        result = ctx->transport->ops->connect(ctx->transport, node->address, &handle);
+        obi_topology_unlock_transport(ctx);
+        if (result == OBI_SUCCESS) {
+            atomic_store_explicit(&node->handle, handle, memory_order_release);
+        }
+    }
+    atomic_flag_clear_explicit(&ctx->connect_lock, memory_order_release);
+    return result;
+}
+
+// Callers make sure no sender still holds the handle: at cleanup, or once a
+// route rebuild without the node has drained the senders pinned before it
+void obi_topology_disconnect_node(obi_topology_context_t *ctx, obi_topology_node_t *node) {
+    while (atomic_flag_test_and_set_explicit(&ctx->connect_lock, memory_order_acquire)) {
+        sched_yield();
+    }
+    void *handle = atomic_exchange_explicit(&node->handle, NULL, memory_order_acq_rel);
+    atomic_flag_clear_explicit(&ctx->connect_lock, memory_order_release);
+    if (handle) {
+        obi_topology_lock_transport(ctx);
+        ctx->transport->ops->disconnect(ctx->transport, handle);
+        obi_topology_unlock_transport(ctx);
+    }
+}
+
+// Route a frame one hop towards its destination node
+obi_result_t obi_topology_forward_frame(obi_topology_context_t *ctx, const obi_route_table_t *routes,
+                                        obi_node_id_t destination, const obi_topology_frame_t *frame,
+                                        const uint8_t *payload) {
+    obi_node_id_t hop = destination;
+    if (ctx->local_id != OBI_NODE_INVALID) {
+        hop = obi_route_next_hop(routes, ctx->local_id, destination);
+        if (hop == OBI_NODE_INVALID || hop == ctx->local_id) {
+            return OBI_ERROR_NETWORK_FAILURE;
+        }
+    }
+    
+    obi_topology_node_t *node = &ctx->nodes[hop];
+    obi_result_t connected = obi_topology_connect_node(ctx, node);
+    if (connected != OBI_SUCCESS) {
+        return connected;
+    }
+    
+    uint64_t started = obi_topology_now_ns();
+    obi_topology_lock_transport(ctx);
+    obi_result_t result = ctx->transport->ops->send(ctx->transport, node->handle, frame, payload);
+    obi_topology_unlock_transport(ctx);
+    uint64_t latency = obi_topology_now_ns() - started;
+    obi_link_stats_record(&node->link, latency, result == OBI_SUCCESS);
+    if (result == OBI_SUCCESS && (frame->type == OBI_FRAME_DATA || frame->type == OBI_FRAME_BATCH)) {
+        obi_latency_histogram_record(&ctx->nodes[destination].latency, latency);
+        obi_latency_histogram_record(&ctx->type_latency[routes->type], latency);
+    }
+    return result;
+}
+
+// A context is usable once routes exist and the default transport is up
+static obi_topology_result_t context_setup(obi_topology_context_t *ctx) {
+    ctx->network_type = OBI_TOPOLOGY_P2P;
+    // Ids start anywhere, so a restarted node does not repeat ids its previous
+    // instance left in its peers' duplicate filters
+    atomic_store(&ctx->message_ids, (uint32_t)obi_partition_hash(obi_topology_now_ns() ^ (uintptr_t)ctx));
+    ctx->current_metrics.cost_function = 0.0;
+    ctx->current_metrics.active_nodes = 1;
+    ctx->current_metrics.failover_enabled = true;
+    ctx->transport = obi_topology_transport_shm_create(NULL);
+    if (!ctx->transport) {
+        return OBI_TOPOLOGY_ERROR_NETWORK_FAILURE;
+    }
+    obi_topology_governance_reset(ctx);
+    atomic_flag_clear(&ctx->coalesce_flush_lock);
+    atomic_flag_clear(&ctx->async_lock);
+    ctx->reassembly_ready = -1;
+    ctx->local_id = OBI_NODE_INVALID;
+    ctx->local_key = 0;
+    obi_node_registry_reset(&ctx->registry);
+    atomic_flag_clear(&ctx->graph_lock);
+    atomic_flag_clear(&ctx->transport_lock);
+    atomic_flag_clear(&ctx->connect_lock);
+    ctx->graph.hub = 0;
+    if (obi_topology_rebuild_routes(ctx) != OBI_TOPOLOGY_SUCCESS) {
+        ctx->transport->ops->destroy(ctx->transport);
+        ctx->transport = NULL;
+        return OBI_TOPOLOGY_ERROR_INVALID_CONFIG;
+    }
+    ctx->active = true;
+    obi_topology_set_traffic_classes(ctx, NULL);
+    return OBI_TOPOLOGY_SUCCESS;
+}
+
+// Cleanup topology resources: the pipeline drains, async sends still
+// queued complete with OBI_ERROR_NETWORK_FAILURE, and queued batches are sent
+static void context_teardown(obi_topology_context_t *ctx) {
+    obi_topology_pipeline_release(ctx);
+    obi_topology_async_release(ctx);
+    if (ctx->transport) {
+        obi_topology_flush(ctx);
+        obi_topology_hub_flush(ctx);
+        disconnect_nodes(ctx);
+        ctx->transport->ops->destroy(ctx->transport);
+    }
+    obi_route_table_destroy(atomic_load(&ctx->routes.current));
+    obi_topology_coalesce_release(ctx);
+    obi_topology_dedup_release(ctx);
+    obi_topology_fragment_release(ctx);
+    obi_topology_order_release(ctx);
+    obi_topology_relay_release(ctx);
+    obi_topology_hub_release(ctx);
+    free(ctx->receive_area);
+    memset(ctx, 0, sizeof(*ctx));
+}
 
 obi_topology_result_t obi_topology_init(obi_protocol_context_t *protocol_ctx) {
     if (topology_initialized) {
@@ -29,14 +289,11 @@ obi_topology_result_t obi_topology_init(obi_protocol_context_t *protocol_ctx) {
     }
     
     // Initialize topology management
+    obi_topology_result_t result = context_setup(&topology_ctx);
+    if (result != OBI_TOPOLOGY_SUCCESS) {
+        return result;
+    }
     protocol_context = protocol_ctx;
-    topology_ctx.network_type = OBI_TOPOLOGY_P2P;
-    topology_ctx.current_metrics.cost_function = 0.3;
-    topology_ctx.current_metrics.active_nodes = 1;
-    strcpy(topology_ctx.current_metrics.governance_zone, "AUTONOMOUS");
-    topology_ctx.current_metrics.failover_enabled = true;
-    topology_ctx.active = true;
-    
     topology_initialized = true;
     return OBI_TOPOLOGY_SUCCESS;
 }
@@ -46,41 +303,694 @@ void obi_topology_cleanup(void) {
         return;
     }
     
-    // Cleanup topology resources
+    context_teardown(&topology_ctx);
     protocol_context = NULL;
-    memset(&topology_ctx, 0, sizeof(topology_ctx));
     topology_initialized = false;
 }
 
+obi_topology_context_t *obi_topology_context_create(obi_protocol_context_t *protocol_ctx) {
+    if (!protocol_ctx) {
+        return NULL;
+    }
+    
+    // Contexts are large (every node's state is inline), so they live on the heap
+    obi_topology_context_t *ctx = calloc(1, sizeof(*ctx));
+    if (ctx && context_setup(ctx) != OBI_TOPOLOGY_SUCCESS) {
+        free(ctx);
+        return NULL;
+    }
+    return ctx;
+}
+
+void obi_topology_context_destroy(obi_topology_context_t *ctx) {
+    if (!ctx || ctx == &topology_ctx) {
+        return;
+    }
+    
+    context_teardown(ctx);
+    free(ctx);
+}
+
 obi_topology_context_t* obi_topology_get_context(void) {
     return topology_initialized ? &topology_ctx : NULL;
 }
 
 obi_topology_result_t obi_topology_configure(obi_topology_context_t *ctx, obi_topology_type_t type) {
-    if (!ctx || !topology_initialized) {
+    if (!ctx || !ctx->active) {
         return OBI_TOPOLOGY_ERROR_INVALID_CONFIG;
     }
     
+    obi_topology_lock_graph(ctx);
+    obi_topology_type_t previous = ctx->network_type;
     ctx->network_type = type;
+    if (obi_topology_rebuild_routes(ctx) != OBI_TOPOLOGY_SUCCESS) {
+        ctx->network_type = previous;
+        obi_topology_unlock_graph(ctx);
+        return OBI_TOPOLOGY_ERROR_INVALID_CONFIG;
+    }
+    obi_topology_unlock_graph(ctx);
     printf("Topology configured: %d\n", (int)type);
     
     return OBI_TOPOLOGY_SUCCESS;
 }
 
 obi_topology_result_t obi_topology_get_metrics(obi_topology_context_t *ctx, obi_topology_metrics_t *metrics) {
-    if (!ctx || !metrics || !topology_initialized) {
+    if (!ctx || !metrics || !ctx->active) {
         return OBI_TOPOLOGY_ERROR_INVALID_CONFIG;
     }
     
-    *metrics = ctx->current_metrics;
+    obi_topology_governance_evaluate(ctx, metrics);
     return OBI_TOPOLOGY_SUCCESS;
 }
 
 obi_result_t obi_topology_send_message(obi_topology_context_t *ctx, obi_buffer_t *buffer, const char *destination) {
-    if (!ctx || !buffer || !destination || !topology_initialized) {
+    if (!ctx || !buffer || !destination || !ctx->active) {
+        return OBI_ERROR_INVALID_INPUT;
+    }
+    
+    obi_node_id_t target;
+    if (obi_topology_resolve_node(ctx, destination, &target) != OBI_TOPOLOGY_SUCCESS) {
+        return OBI_ERROR_INVALID_INPUT;
+    }
+    
+    return obi_topology_send_to(ctx, buffer, target);
+}
+
+obi_topology_result_t obi_topology_resolve_node(obi_topology_context_t *ctx, const char *name,
+                                                obi_node_id_t *node_id) {
+    if (!ctx || !name || !node_id || !ctx->active) {
+        return OBI_TOPOLOGY_ERROR_INVALID_CONFIG;
+    }
+    
+    // Known names resolve lock-free; unknown destinations are learned as
+    // directly addressable nodes, one registration at a time
+    obi_node_id_t id = find_node_by_name(ctx, name);
+    if (id != OBI_NODE_INVALID) {
+        *node_id = id;
+        return OBI_TOPOLOGY_SUCCESS;
+    }
+    
+    obi_topology_lock_graph(ctx);
+    obi_topology_result_t result = register_node(ctx, name, name, node_id);
+    obi_topology_unlock_graph(ctx);
+    return result;
+}
+
+obi_result_t obi_topology_send_to(obi_topology_context_t *ctx, obi_buffer_t *buffer, obi_node_id_t destination) {
+    return obi_topology_send_priority(ctx, buffer, destination, OBI_PRIORITY_NORMAL);
+}
+
+uint64_t obi_topology_partition_key(const void *data, size_t length) {
+    const uint8_t *bytes = data;
+    uint64_t hash = 14695981039346656037ull;  // 64-bit FNV-1a
+    for (size_t i = 0; i < length; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+obi_topology_result_t obi_topology_partition_owner(obi_topology_context_t *ctx, uint64_t key,
+                                                   obi_node_id_t *owner) {
+    if (!ctx || !owner || !ctx->active || ctx->network_type != OBI_TOPOLOGY_HYBRID) {
+        return OBI_TOPOLOGY_ERROR_INVALID_CONFIG;
+    }
+    
+    // The ring travels with the route table, so a lookup sees one consistent membership
+    unsigned slot;
+    const obi_route_table_t *routes = obi_route_acquire(&ctx->routes, &slot);
+    *owner = obi_partition_lookup(&routes->partition, key);
+    obi_route_release(&ctx->routes, slot);
+    return *owner == OBI_NODE_INVALID ? OBI_TOPOLOGY_ERROR_NETWORK_FAILURE : OBI_TOPOLOGY_SUCCESS;
+}
+
+obi_result_t obi_topology_send_keyed(obi_topology_context_t *ctx, obi_buffer_t *buffer, uint64_t key,
+                                     obi_node_id_t *owner) {
+    obi_node_id_t id;
+    obi_topology_result_t found = obi_topology_partition_owner(ctx, key, &id);
+    if (owner) {
+        *owner = found == OBI_TOPOLOGY_SUCCESS ? id : OBI_NODE_INVALID;
+    }
+    if (found != OBI_TOPOLOGY_SUCCESS) {
+        return found == OBI_TOPOLOGY_ERROR_NETWORK_FAILURE ? OBI_ERROR_NETWORK_FAILURE : OBI_ERROR_INVALID_INPUT;
+    }
+    if (id == ctx->local_id) {
+        return OBI_SUCCESS;  // the caller handles its own partition
+    }
+    return obi_topology_send_priority(ctx, buffer, id, OBI_PRIORITY_NORMAL);
+}
+
+obi_result_t obi_topology_send_priority(obi_topology_context_t *ctx, obi_buffer_t *buffer,
+                                        obi_node_id_t destination, obi_topology_priority_t priority) {
+    if (!ctx || !buffer || !ctx->active) {
+        return OBI_ERROR_INVALID_INPUT;
+    }
+    
+    // Load shedding: the zone decides which priorities are admitted
+    uint64_t now = obi_topology_now_ns();
+    obi_topology_governance_tick(ctx, now);
+    obi_topology_coalesce_tick(ctx, now);
+    if (!obi_topology_admit(ctx, priority)) {
+        return OBI_ERROR_WOULD_BLOCK;
+    }
+    
+    return obi_topology_send_admitted(ctx, buffer, destination, now, true, NULL);
+}
+
+obi_result_t obi_topology_send_admitted(obi_topology_context_t *ctx, const obi_buffer_t *buffer,
+                                        obi_node_id_t destination, uint64_t now, bool block,
+                                        obi_fragment_train_t *train) {
+    if (buffer->size > OBI_FRAGMENT_MAX_MESSAGE) {
+        return OBI_ERROR_BUFFER_OVERFLOW;
+    }
+    if (destination >= ctx->graph.node_count) {
+        return OBI_ERROR_INVALID_INPUT;
+    }
+    
+    // A train already under way holds its rate token and credit
+    if (train && train->offset) {
+        return obi_topology_fragment_send(ctx, destination, buffer, train, false);
+    }
+    
+    // Rate limit before backpressure, so a refused send holds no credit
+    obi_topology_node_t *target = &ctx->nodes[destination];
+    if (!obi_topology_rate_admit(ctx, &target->rate, target, now)) {
+        return OBI_BUSY;
+    }
+    
+    // Backpressure: credit is taken before the route is pinned, since it may block
+    uint32_t mark;
+    if (!obi_topology_flow_reserve(ctx, target, block, &mark)) {
+        obi_topology_rate_refund(&target->rate);
+        return OBI_BUSY;
+    }
+    
+    // Small sends join the destination's batch; larger ones must not overtake it
+    bool coalesce = obi_topology_coalesce_accepts(ctx, buffer->size) && destination != ctx->local_id;
+    obi_result_t result = coalesce ? obi_topology_coalesce_send(ctx, destination, buffer, now, mark) :
+                                     obi_topology_coalesce_drain(ctx, destination);
+    if (coalesce || result != OBI_SUCCESS) {
+        if (result != OBI_SUCCESS) {
+            obi_topology_flow_cancel(ctx, target, mark);
+        }
+        return result;
+    }
+    
+    // Payloads beyond one frame go out as fragments, under a single credit.
+    // Without a train to keep, the caller waits out a full ring mid-message.
+    // Once a fragment is out the receiver returns the credit, even for a
+    // message it gives up on
+    if (buffer->size > ctx->transport->max_frame_payload) {
+        obi_fragment_train_t local = {0};
+        obi_fragment_train_t *progress = train ? train : &local;
+        progress->credit_mark = mark;
+        result = obi_topology_fragment_send(ctx, destination, buffer, progress, !train);
+        if (result != OBI_SUCCESS && progress->offset == 0) {
+            obi_topology_flow_cancel(ctx, target, mark);
+        }
+        return result;
+    }
+    
+    // Nodes are fully registered before the table that covers them is published
+    unsigned slot;
+    const obi_route_table_t *routes = obi_route_acquire(&ctx->routes, &slot);
+    result = OBI_ERROR_INVALID_INPUT;
+    if (destination < routes->node_count) {
+        obi_topology_frame_t frame = {0};
+        frame.length = (uint32_t)buffer->size;
+        frame.type = OBI_FRAME_DATA;
+        frame.source = ctx->local_key;
+        frame.destination = target->key;
+        frame.origin = ctx->local_key;
+        frame.message_id = obi_topology_claim_message_ids(ctx, 1);
+        obi_topology_flow_stamp(ctx, target, &frame, mark);
+        obi_topology_order_stamp(target, &frame);
+        result = obi_topology_forward_frame(ctx, routes, destination, &frame, buffer->data);
+        if (result != OBI_SUCCESS) {
+            obi_topology_order_cancel(target, &frame);
+        }
+    }
+    obi_route_release(&ctx->routes, slot);
+    
+    if (result != OBI_SUCCESS) {
+        obi_topology_flow_cancel(ctx, target, mark);
+    }
+    return result;
+}
+
+// Every recipient's copy carries one identity: the local node's for a new
+// message, the received one's when a relay re-floods it
+static obi_result_t broadcast(obi_topology_context_t *ctx, obi_buffer_t *buffer, const obi_node_id_t *recipients,
+                              size_t count, size_t *delivered, bool forwarded) {
+    if (delivered) {
+        *delivered = 0;
+    }
+    if (!ctx || !buffer || !ctx->active || (recipients && count > OBI_TOPOLOGY_MAX_NODES) ||
+        (ctx->network_type != OBI_TOPOLOGY_BUS && ctx->network_type != OBI_TOPOLOGY_MESH)) {
+        return OBI_ERROR_INVALID_INPUT;
+    }
+    
+    uint64_t now = obi_topology_now_ns();
+    obi_topology_governance_tick(ctx, now);
+    if (!obi_topology_admit(ctx, OBI_PRIORITY_NORMAL)) {
+        return OBI_ERROR_WOULD_BLOCK;
+    }
+    if (buffer->size > ctx->transport->max_frame_payload) {
+        return OBI_ERROR_BUFFER_OVERFLOW;
+    }
+    
+    // Credit is taken per recipient before the route is pinned, since it may block
+    obi_node_id_t targets[OBI_TOPOLOGY_MAX_NODES];
+    uint32_t marks[OBI_TOPOLOGY_MAX_NODES];   // by node id
+    size_t target_count = 0;
+    obi_result_t result = OBI_SUCCESS;
+    uint32_t node_count = ctx->graph.node_count;
+    size_t candidates = recipients ? count : node_count;
+    for (size_t i = 0; i < candidates; i++) {
+        obi_node_id_t id = recipients ? recipients[i] : (obi_node_id_t)i;
+        if (id >= node_count) {
+            return OBI_ERROR_INVALID_INPUT;
+        }
+        if (id == ctx->local_id || (!recipients && !ctx->graph.active[id])) {
+            continue;
+        }
+        if (!obi_topology_rate_admit(ctx, &ctx->nodes[id].rate, &ctx->nodes[id], now)) {
+            result = OBI_BUSY;
+            continue;
+        }
+        if (!obi_topology_flow_reserve(ctx, &ctx->nodes[id], true, &marks[id])) {
+            obi_topology_rate_refund(&ctx->nodes[id].rate);
+            result = OBI_BUSY;
+            continue;
+        }
+        // Coalesced sends queued for the recipient go out first
+        obi_result_t drained = obi_topology_coalesce_drain(ctx, id);
+        if (drained != OBI_SUCCESS) {
+            obi_topology_flow_cancel(ctx, &ctx->nodes[id], marks[id]);
+            obi_topology_rate_refund(&ctx->nodes[id].rate);
+            result = drained;
+            continue;
+        }
+        targets[target_count++] = id;
+    }
+    
+    obi_topology_frame_t frame = {0};
+    frame.length = (uint32_t)buffer->size;
+    frame.type = OBI_FRAME_DATA;
+    frame.source = ctx->local_key;
+    frame.origin = forwarded ? ctx->rx_origin : ctx->local_key;
+    frame.message_id = forwarded ? ctx->rx_message_id : obi_topology_claim_message_ids(ctx, 1);
+    
+    void *peers[OBI_TOPOLOGY_MAX_NODES];
+    obi_topology_frame_t headers[OBI_TOPOLOGY_MAX_NODES];
+    obi_node_id_t direct[OBI_TOPOLOGY_MAX_NODES];
+    obi_result_t results[OBI_TOPOLOGY_MAX_NODES];
+    size_t direct_count = 0;
+    size_t sent = 0;
+    
+    unsigned slot;
+    const obi_route_table_t *routes = obi_route_acquire(&ctx->routes, &slot);
+    for (size_t i = 0; i < target_count; i++) {
+        obi_node_id_t id = targets[i];
+        obi_topology_node_t *node = &ctx->nodes[id];
+        obi_node_id_t hop = ctx->local_id == OBI_NODE_INVALID ? id : obi_route_next_hop(routes, ctx->local_id, id);
+        obi_result_t outcome;
+        
+        if (hop == id) {
+            // Neighbours share the payload but each gets its own header, since
+            // credit marks and sequences count per destination (0 = the hop itself)
+            outcome = obi_topology_connect_node(ctx, node);
+            if (outcome == OBI_SUCCESS) {
+                headers[direct_count] = frame;
+                obi_topology_flow_stamp(ctx, node, &headers[direct_count], marks[id]);
+                obi_topology_order_stamp(node, &headers[direct_count]);
+                peers[direct_count] = node->handle;
+                direct[direct_count++] = id;
+                continue;
+            }
+        } else {
+            obi_topology_frame_t routed = frame;
+            routed.destination = node->key;
+            obi_topology_flow_stamp(ctx, node, &routed, marks[id]);
+            obi_topology_order_stamp(node, &routed);
+            outcome = obi_topology_forward_frame(ctx, routes, id, &routed, buffer->data);
+            if (outcome != OBI_SUCCESS) {
+                obi_topology_order_cancel(node, &routed);
+            }
+        }
+        
+        if (outcome == OBI_SUCCESS) {
+            sent++;
+        } else {
+            obi_topology_flow_cancel(ctx, node, marks[id]);
+            result = outcome;
+        }
+    }
+    
+    if (direct_count > 0) {
+        uint64_t started = obi_topology_now_ns();
+        obi_topology_lock_transport(ctx);
+        if (ctx->transport->ops->broadcast) {
+            ctx->transport->ops->broadcast(ctx->transport, peers, direct_count, headers, buffer->data, results);
+        } else {
+            for (size_t i = 0; i < direct_count; i++) {
+                results[i] = ctx->transport->ops->send(ctx->transport, peers[i], &headers[i], buffer->data);
+            }
+        }
+        obi_topology_unlock_transport(ctx);
+        uint64_t elapsed = obi_topology_now_ns() - started;
+        
+        for (size_t i = 0; i < direct_count; i++) {
+            obi_topology_node_t *node = &ctx->nodes[direct[i]];
+            obi_link_stats_record(&node->link, elapsed, results[i] == OBI_SUCCESS);
+            if (results[i] == OBI_SUCCESS) {
+                obi_latency_histogram_record(&node->latency, elapsed);
+                obi_latency_histogram_record(&ctx->type_latency[routes->type], elapsed);
+                sent++;
+            } else {
+                obi_topology_order_cancel(node, &headers[i]);
+                obi_topology_flow_cancel(ctx, node, marks[direct[i]]);
+                result = results[i];
+            }
+        }
+    }
+    obi_route_release(&ctx->routes, slot);
+    
+    if (delivered) {
+        *delivered = sent;
+    }
+    return result;
+}
+
+obi_result_t obi_topology_broadcast(obi_topology_context_t *ctx, obi_buffer_t *buffer,
+                                    const obi_node_id_t *recipients, size_t count, size_t *delivered) {
+    return broadcast(ctx, buffer, recipients, count, delivered, false);
+}
+
+obi_result_t obi_topology_forward(obi_topology_context_t *ctx, obi_buffer_t *buffer,
+                                  const obi_node_id_t *recipients, size_t count, size_t *delivered) {
+    return broadcast(ctx, buffer, recipients, count, delivered, true);
+}
+
+// Explicit CREDIT frame: a grant, or with OBI_FRAME_FLAG_PROBE a request for one
+obi_result_t obi_topology_send_credit(obi_topology_context_t *ctx, obi_node_id_t id, uint16_t flags) {
+    obi_topology_node_t *node = &ctx->nodes[id];
+    obi_topology_frame_t frame = {0};
+    frame.type = OBI_FRAME_CREDIT;
+    frame.flags = flags;
+    frame.source = ctx->local_key;
+    frame.destination = node->key;
+    // Control frames reserve nothing; the mark covers what has already left
+    obi_topology_flow_stamp(ctx, node, &frame, atomic_load_explicit(&node->credit_marked, memory_order_relaxed));
+    
+    unsigned slot;
+    const obi_route_table_t *routes = obi_route_acquire(&ctx->routes, &slot);
+    obi_result_t result = obi_topology_forward_frame(ctx, routes, id, &frame, NULL);
+    obi_route_release(&ctx->routes, slot);
+    return result;
+}
+
+// Return credit to a sender that has no traffic of ours to piggyback on, or
+// that asked for it
+void obi_topology_grant_credit(obi_topology_context_t *ctx, uint32_t source_key, bool requested) {
+    obi_node_id_t id = obi_node_registry_find(&ctx->registry, source_key);
+    if (id == OBI_NODE_INVALID || ctx->credit_window == 0 ||
+        (!requested && !obi_topology_flow_grant_due(ctx, &ctx->nodes[id]))) {
+        return;
+    }
+    
+    obi_topology_node_t *node = &ctx->nodes[id];
+    uint32_t granted = atomic_load(&node->granted);
+    if (obi_topology_send_credit(ctx, id, 0) != OBI_SUCCESS) {
+        atomic_store(&node->granted, granted);  // retried on the next delivery
+    }
+}
+
+obi_topology_result_t obi_topology_set_transport(obi_topology_context_t *ctx, obi_topology_transport_t *transport) {
+    // The pipeline's transport thread holds the current transport until stopped
+    if (!ctx || !transport || !ctx->active || ctx->pipeline) {
+        return OBI_TOPOLOGY_ERROR_INVALID_CONFIG;
+    }
+    
+    // The context owns the transport from here on; node handles are re-resolved lazily
+    if (ctx->transport) {
+        obi_topology_flush(ctx);
+        obi_topology_hub_flush(ctx);
+        obi_topology_async_detach(ctx);
+        disconnect_nodes(ctx);
+        ctx->transport->ops->destroy(ctx->transport);
+    }
+    ctx->transport = transport;
+    ctx->local_id = OBI_NODE_INVALID;
+    ctx->local_key = 0;
+    
+    // Batch buffers, reorder rings and the relay hold are sized to the frame
+    // payload of the transport they were made for
+    obi_topology_coalesce_release(ctx);
+    obi_topology_order_release(ctx);
+    obi_topology_relay_release(ctx);
+    if ((size_t)ctx->coalesce_max_message + sizeof(uint32_t) > transport->max_frame_payload) {
+        ctx->coalesce_max_message = 0;
+    }
+    
+    // The new transport starts with the batching of the current zone
+    obi_topology_governance_attach(ctx);
+    
+    return OBI_TOPOLOGY_SUCCESS;
+}
+
+obi_topology_result_t obi_topology_bind(obi_topology_context_t *ctx, const char *local_name) {
+    if (!ctx || !local_name || !ctx->active || ctx->local_id != OBI_NODE_INVALID) {
+        return OBI_TOPOLOGY_ERROR_INVALID_CONFIG;
+    }
+    
+    // A node declared earlier keeps its transport address
+    obi_node_id_t id;
+    obi_topology_lock_graph(ctx);
+    obi_topology_result_t result = register_node(ctx, local_name, local_name, &id);
+    if (result == OBI_TOPOLOGY_SUCCESS) {
+        obi_topology_lock_transport(ctx);
+        if (ctx->transport->ops->bind(ctx->transport, ctx->nodes[id].address) != OBI_SUCCESS) {
+            result = OBI_TOPOLOGY_ERROR_NETWORK_FAILURE;
+        }
+        obi_topology_unlock_transport(ctx);
+    }
+    if (result == OBI_TOPOLOGY_SUCCESS) {
+        ctx->local_id = id;
+        ctx->local_key = ctx->nodes[id].key;
+        
+        // Backup next hops are precomputed for the local row only
+        result = obi_topology_rebuild_routes(ctx);
+    }
+    obi_topology_unlock_graph(ctx);
+    return result;
+}
+
+// Views fill an internal buffer and take reassembled messages in place
+static obi_result_t receive(obi_topology_context_t *ctx, obi_buffer_t *buffer, bool view) {
+    obi_topology_fragment_reclaim(ctx);
+    obi_topology_coalesce_tick(ctx, obi_topology_now_ns());
+    for (;;) {
+        // A reassembled message refused for a small buffer is offered again first
+        if (ctx->reassembly_ready >= 0) {
+            return obi_topology_fragment_deliver(ctx, buffer, view);
+        }
+        
+        // Messages left in the last batch frame come before new frames
+        if (obi_topology_coalesce_pending(ctx)) {
+            uint32_t source;
+            obi_result_t next = obi_topology_coalesce_next(ctx, buffer, &source);
+            if (next == OBI_SUCCESS) {
+                obi_topology_grant_credit(ctx, source, false);
+                if (obi_topology_dedup_seen(ctx, buffer)) {
+                    continue;
+                }
+            }
+            if (next != OBI_ERROR_WOULD_BLOCK) {
+                return next;
+            }
+        }
+        
+        // Buffers smaller than a frame receive through the staging area, so
+        // batch frames fit whatever the caller's buffer size
+        size_t max_payload = ctx->transport->max_frame_payload;
+        bool staged = buffer->capacity < max_payload;
+        uint8_t *area = staged ? obi_topology_coalesce_staging(ctx, max_payload) : buffer->data;
+        if (!area) {
+            return OBI_ERROR_OUT_OF_MEMORY;
+        }
+        
+        // Held frames whose turn has come are read before new ones
+        obi_topology_frame_t frame;
+        obi_result_t result = OBI_SUCCESS;
+        bool released = obi_topology_order_next(ctx, &frame, area);
+        if (!released) {
+            // A transit frame still waiting for its next hop keeps its place in line
+            if (obi_topology_relay_blocked(ctx)) {
+                return OBI_ERROR_WOULD_BLOCK;
+            }
+            obi_topology_lock_transport(ctx);
+            result = ctx->transport->ops->receive(ctx->transport, &frame, area,
+                                                  staged ? max_payload : buffer->capacity);
+            obi_topology_unlock_transport(ctx);
+            if (result != OBI_SUCCESS) {
+                if (result == OBI_ERROR_WOULD_BLOCK) {
+                    obi_topology_relay_idle(ctx);
+                }
+                return result;
+            }
+        }
+        
+        if (ctx->heartbeat_interval_ns && !released) {
+            obi_topology_note_heard(ctx, frame.source);
+        }
+        if (frame.type == OBI_FRAME_HEARTBEAT) {
+            continue;
+        }
+        if (frame.type == OBI_FRAME_GOSSIP) {
+            obi_topology_gossip_receive(ctx, &frame, area);
+            continue;
+        }
+        
+        if (frame.destination == 0 || frame.destination == ctx->local_key) {
+            obi_topology_flow_absorb(ctx, &frame);
+            if (frame.type == OBI_FRAME_CREDIT) {
+                if (frame.flags & OBI_FRAME_FLAG_PROBE) {
+                    obi_topology_grant_credit(ctx, frame.source, true);
+                }
+                continue;
+            }
+            // Sequenced frames wait for the ones their source sent before them
+            if (!released && !obi_topology_order_accept(ctx, &frame, area)) {
+                continue;
+            }
+            if (frame.type == OBI_FRAME_FRAGMENT) {
+                obi_topology_fragment_absorb(ctx, &frame, area);
+                continue;
+            }
+            if (staged) {
+                obi_topology_coalesce_hold(ctx, &frame);
+                continue;
+            }
+            if (frame.type == OBI_FRAME_BATCH) {
+                result = obi_topology_coalesce_stage(ctx, &frame, buffer->data);
+                if (result != OBI_SUCCESS) {
+                    return result;
+                }
+                continue;
+            }
+            buffer->size = frame.length;
+            obi_topology_grant_credit(ctx, frame.source, false);
+            // Copies flooded over other paths never reach validation or audit
+            ctx->rx_origin = frame.origin ? frame.origin : frame.source;
+            ctx->rx_message_id = frame.message_id;
+            if (obi_topology_dedup_seen(ctx, buffer)) {
+                continue;
+            }
+            return OBI_SUCCESS;
+        }
+        
+        // Transit frame (ring/star/mesh relay): pass it one hop on and keep reading
+        obi_node_id_t destination = obi_node_registry_find(&ctx->registry, frame.destination);
+        if (destination != OBI_NODE_INVALID) {
+            obi_topology_relay_frame(ctx, destination, &frame, area);
+        }
+    }
+}
+
+obi_result_t obi_topology_receive_message(obi_topology_context_t *ctx, obi_buffer_t *buffer) {
+    if (!ctx || !buffer || !buffer->data || !ctx->active) {
         return OBI_ERROR_INVALID_INPUT;
     }
+    return receive(ctx, buffer, false);
+}
+
+obi_result_t obi_topology_receive_view(obi_topology_context_t *ctx, obi_buffer_t *message) {
+    if (!ctx || !message || !ctx->active) {
+        return OBI_ERROR_INVALID_INPUT;
+    }
+    
+    size_t capacity = ctx->transport->max_frame_payload;
+    if (ctx->receive_capacity < capacity) {
+        uint8_t *area = realloc(ctx->receive_area, capacity);
+        if (!area) {
+            return OBI_ERROR_OUT_OF_MEMORY;
+        }
+        ctx->receive_area = area;
+        ctx->receive_capacity = capacity;
+    }
+    
+    obi_buffer_t buffer = { ctx->receive_area, 0, ctx->receive_capacity };
+    obi_result_t result = receive(ctx, &buffer, true);
+    if (result == OBI_SUCCESS) {
+        *message = buffer;
+    }
+    return result;
+}
+
+obi_topology_result_t obi_topology_add_node(obi_topology_context_t *ctx, const char *name,
+                                            const char *address, obi_node_id_t *node_id) {
+    if (!ctx || !name || !node_id || !ctx->active) {
+        return OBI_TOPOLOGY_ERROR_INVALID_CONFIG;
+    }
+    
+    obi_topology_lock_graph(ctx);
+    obi_topology_result_t result = register_node(ctx, name, address ? address : name, node_id);
+    obi_topology_unlock_graph(ctx);
+    return result;
+}
+
+obi_topology_result_t obi_topology_add_link(obi_topology_context_t *ctx, obi_node_id_t a,
+                                            obi_node_id_t b, uint16_t cost) {
+    if (!ctx || !ctx->active || a == b ||
+        a >= ctx->graph.node_count || b >= ctx->graph.node_count) {
+        return OBI_TOPOLOGY_ERROR_INVALID_CONFIG;
+    }
+    
+    // Links are symmetric; cost 0 removes the link
+    obi_topology_lock_graph(ctx);
+    bool existed = ctx->graph.link_cost[a][b] != 0;
+    if (existed && cost == 0) {
+        ctx->graph.link_count--;
+    } else if (!existed && cost != 0) {
+        ctx->graph.link_count++;
+    }
+    ctx->graph.link_cost[a][b] = cost;
+    ctx->graph.link_cost[b][a] = cost;
+    
+    obi_topology_result_t result = obi_topology_rebuild_routes(ctx);
+    obi_topology_unlock_graph(ctx);
+    return result;
+}
+
+obi_topology_result_t obi_topology_set_hub(obi_topology_context_t *ctx, obi_node_id_t hub) {
+    if (!ctx || !ctx->active || hub >= ctx->graph.node_count) {
+        return OBI_TOPOLOGY_ERROR_INVALID_CONFIG;
+    }
     
-    printf("Message sent via topology to: %s\n", destination);
-    return OBI_SUCCESS;
+    obi_topology_lock_graph(ctx);
+    ctx->graph.hub = hub;
+    obi_topology_result_t result = obi_topology_rebuild_routes(ctx);
+    obi_topology_unlock_graph(ctx);
+    return result;
+}
+
+obi_topology_result_t obi_topology_set_node_active(obi_topology_context_t *ctx, obi_node_id_t node_id,
+                                                   bool active) {
+    if (!ctx || !ctx->active || node_id >= ctx->graph.node_count) {
+        return OBI_TOPOLOGY_ERROR_INVALID_CONFIG;
+    }
+    
+    // Ids stay interned while a node is away, so it rejoins under the same id
+    obi_topology_result_t result = OBI_TOPOLOGY_SUCCESS;
+    obi_topology_lock_graph(ctx);
+    if (ctx->graph.active[node_id] != active) {
+        ctx->graph.active[node_id] = active;
+        result = obi_topology_rebuild_routes(ctx);
+        if (result != OBI_TOPOLOGY_SUCCESS) {
+            ctx->graph.active[node_id] = !active;
+        }
+    }
+    obi_topology_unlock_graph(ctx);
+    return result;
 }
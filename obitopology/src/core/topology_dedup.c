@@ -0,0 +1,167 @@
+/*
+ * OBI Topology Duplicate Suppression
+ * Flooded MESH traffic reaches a node over several paths. Each delivered
+ * message's identity (origin node and per-origin id, or the payload when a
+ * frame carries no id) is fingerprinted into a cuckoo filter of fixed size;
+ * two filter generations rotate every window, so a message is remembered
+ * for one to two windows and the memory never grows with traffic
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "topology_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Fingerprints per bucket and relocations tried before an insert gives up
+#define DEDUP_BUCKET_SLOTS 4
+#define DEDUP_MAX_KICKS    128
+
+static uint64_t mix64(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdull;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ull;
+    x ^= x >> 33;
+    return x;
+}
+
+static uint32_t *generation(obi_topology_context_t *ctx, uint32_t which) {
+    return ctx->dedup_slots + (size_t)which * ctx->dedup_buckets * DEDUP_BUCKET_SLOTS;
+}
+
+// Partial-key cuckoo hashing: either bucket derives from the other and the fingerprint
+static uint32_t alternate(const obi_topology_context_t *ctx, uint32_t bucket, uint32_t fingerprint) {
+    return (bucket ^ (uint32_t)mix64(fingerprint)) & (ctx->dedup_buckets - 1);
+}
+
+static bool bucket_holds(const uint32_t *table, uint32_t bucket, uint32_t fingerprint) {
+    const uint32_t *slots = table + (size_t)bucket * DEDUP_BUCKET_SLOTS;
+    for (int i = 0; i < DEDUP_BUCKET_SLOTS; i++) {
+        if (slots[i] == fingerprint) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool bucket_put(uint32_t *table, uint32_t bucket, uint32_t fingerprint) {
+    uint32_t *slots = table + (size_t)bucket * DEDUP_BUCKET_SLOTS;
+    for (int i = 0; i < DEDUP_BUCKET_SLOTS; i++) {
+        if (slots[i] == 0) {
+            slots[i] = fingerprint;
+            return true;
+        }
+    }
+    return false;
+}
+
+static void rotate(obi_topology_context_t *ctx, uint64_t now) {
+    ctx->dedup_current ^= 1u;
+    memset(generation(ctx, ctx->dedup_current), 0,
+           (size_t)ctx->dedup_buckets * DEDUP_BUCKET_SLOTS * sizeof(uint32_t));
+    ctx->dedup_rotated_ns = now;
+}
+
+// A full generation rotates early, which shortens the window instead of growing the filter
+static void insert(obi_topology_context_t *ctx, uint32_t bucket, uint32_t fingerprint, uint64_t now) {
+    uint32_t *table = generation(ctx, ctx->dedup_current);
+    if (bucket_put(table, bucket, fingerprint) ||
+        bucket_put(table, alternate(ctx, bucket, fingerprint), fingerprint)) {
+        return;
+    }
+
+    uint32_t carried = fingerprint;
+    for (int kick = 0; kick < DEDUP_MAX_KICKS; kick++) {
+        uint32_t *victim = table + (size_t)bucket * DEDUP_BUCKET_SLOTS + (kick + carried) % DEDUP_BUCKET_SLOTS;
+        uint32_t evicted = *victim;
+        *victim = carried;
+        carried = evicted;
+        bucket = alternate(ctx, bucket, carried);
+        if (bucket_put(table, bucket, carried)) {
+            return;
+        }
+    }
+
+    rotate(ctx, now);
+    bucket_put(generation(ctx, ctx->dedup_current), bucket, carried);
+    atomic_fetch_add_explicit(&ctx->dedup_overflows, 1, memory_order_relaxed);
+}
+
+obi_topology_result_t obi_topology_set_dedup(obi_topology_context_t *ctx, const obi_dedup_config_t *config) {
+    obi_dedup_config_t defaults = { OBI_DEDUP_DEFAULT_CAPACITY, OBI_DEDUP_DEFAULT_WINDOW_MS };
+    if (!config) {
+        config = &defaults;
+    }
+    if (!ctx || !ctx->active || config->capacity > OBI_DEDUP_MAX_CAPACITY ||
+        (config->capacity && config->window_ms == 0)) {
+        return OBI_TOPOLOGY_ERROR_INVALID_CONFIG;
+    }
+
+    obi_topology_dedup_release(ctx);
+    if (config->capacity == 0) {
+        return OBI_TOPOLOGY_SUCCESS;
+    }
+
+    uint32_t buckets = 1;
+    while (buckets * DEDUP_BUCKET_SLOTS < config->capacity) {
+        buckets <<= 1;
+    }
+    ctx->dedup_slots = calloc((size_t)2 * buckets * DEDUP_BUCKET_SLOTS, sizeof(uint32_t));
+    if (!ctx->dedup_slots) {
+        return OBI_TOPOLOGY_ERROR_INVALID_CONFIG;
+    }
+    ctx->dedup_buckets = buckets;
+    ctx->dedup_current = 0;
+    ctx->dedup_window_ns = (uint64_t)config->window_ms * 1000000ull;
+    ctx->dedup_rotated_ns = obi_topology_now_ns();
+    return OBI_TOPOLOGY_SUCCESS;
+}
+
+bool obi_topology_dedup_seen(obi_topology_context_t *ctx, const obi_buffer_t *message) {
+    if (!ctx->dedup_slots) {
+        return false;
+    }
+
+    // Expired generations are cleared before the lookup, so stale entries never match
+    uint64_t now = obi_topology_now_ns();
+    if (now - ctx->dedup_rotated_ns >= ctx->dedup_window_ns) {
+        if (now - ctx->dedup_rotated_ns >= 2 * ctx->dedup_window_ns) {
+            rotate(ctx, now);
+        }
+        rotate(ctx, now);
+    }
+
+    // Relays re-flooding a message keep its origin and id, so copies share the
+    // key while equal payloads from different origins stay distinct. Frames
+    // without an id fall back to the payload
+    uint64_t hash = ctx->rx_message_id
+        ? mix64((uint64_t)ctx->rx_origin << 32 | ctx->rx_message_id)
+        : mix64(obi_topology_partition_key(message->data, message->size) ^ message->size);
+    uint32_t fingerprint = (uint32_t)(hash >> 32);
+    fingerprint += fingerprint == 0;  // 0 marks an empty slot
+    uint32_t bucket = (uint32_t)hash & (ctx->dedup_buckets - 1);
+    uint32_t other = alternate(ctx, bucket, fingerprint);
+
+    for (uint32_t which = 0; which < 2; which++) {
+        const uint32_t *table = generation(ctx, which);
+        if (bucket_holds(table, bucket, fingerprint) || bucket_holds(table, other, fingerprint)) {
+            atomic_fetch_add_explicit(&ctx->duplicates_dropped, 1, memory_order_relaxed);
+            return true;
+        }
+    }
+
+    insert(ctx, bucket, fingerprint, now);
+    return false;
+}
+
+uint32_t obi_topology_claim_message_ids(obi_topology_context_t *ctx, uint32_t count) {
+    uint32_t first = atomic_fetch_add_explicit(&ctx->message_ids, count, memory_order_relaxed) + 1;
+    return first + (first == 0);  // 0 means "no id"
+}
+
+void obi_topology_dedup_release(obi_topology_context_t *ctx) {
+    free(ctx->dedup_slots);
+    ctx->dedup_slots = NULL;
+    ctx->dedup_buckets = 0;
+}
@@ -0,0 +1,174 @@
+/*
+ * OBI Topology Failover
+ * Heartbeats to direct neighbours, a phi-accrual failure detector, and
+ * redirection onto precomputed backup next hops with one table swap
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "topology_internal.h"
+#include <string.h>
+
+#define PHI_LOG10_E 0.4342944819032518
+
+obi_topology_result_t obi_topology_set_heartbeat(obi_topology_context_t *ctx, const obi_heartbeat_config_t *config) {
+    obi_heartbeat_config_t defaults = { OBI_HEARTBEAT_DEFAULT_INTERVAL_US, OBI_HEARTBEAT_DEFAULT_PHI };
+    if (!config) {
+        config = &defaults;
+    }
+    if (!ctx || !ctx->active || config->phi_threshold <= 0.0) {
+        return OBI_TOPOLOGY_ERROR_INVALID_CONFIG;
+    }
+
+    ctx->heartbeat_interval_ns = (uint64_t)config->interval_us * 1000ull;
+    ctx->phi_threshold = config->phi_threshold;
+    ctx->next_heartbeat_ns = 0;
+
+    // Detection restarts from each neighbour's next frame
+    for (uint32_t i = 0; i < ctx->graph.node_count; i++) {
+        atomic_store(&ctx->nodes[i].last_heard_ns, 0);
+        atomic_store(&ctx->nodes[i].mean_interval_ns, ctx->heartbeat_interval_ns);
+    }
+    return OBI_TOPOLOGY_SUCCESS;
+}
+
+obi_topology_result_t obi_topology_set_failover(obi_topology_context_t *ctx, bool enabled) {
+    if (!ctx || !ctx->active) {
+        return OBI_TOPOLOGY_ERROR_INVALID_CONFIG;
+    }
+    ctx->current_metrics.failover_enabled = enabled;
+    return OBI_TOPOLOGY_SUCCESS;
+}
+
+void obi_topology_note_heard(obi_topology_context_t *ctx, uint32_t source_key) {
+    obi_node_id_t id = obi_node_registry_find(&ctx->registry, source_key);
+    if (id == OBI_NODE_INVALID || id == ctx->local_id) {
+        return;
+    }
+
+    obi_topology_node_t *node = &ctx->nodes[id];
+    uint64_t now = obi_topology_now_ns();
+    uint64_t last = atomic_load_explicit(&node->last_heard_ns, memory_order_relaxed);
+    if (last != 0 && now > last) {
+        uint64_t mean = atomic_load_explicit(&node->mean_interval_ns, memory_order_relaxed);
+        uint64_t interval = now - last;
+        mean = interval >= mean ? mean + ((interval - mean) >> 3) : mean - ((mean - interval) >> 3);
+        atomic_store_explicit(&node->mean_interval_ns, mean, memory_order_relaxed);
+    }
+    atomic_store_explicit(&node->last_heard_ns, now, memory_order_release);
+}
+
+// Suspicion that the node is down, assuming exponentially distributed arrivals
+static double phi(const obi_topology_context_t *ctx, obi_topology_node_t *node, uint64_t now) {
+    uint64_t last = atomic_load_explicit(&node->last_heard_ns, memory_order_acquire);
+    uint64_t mean = atomic_load_explicit(&node->mean_interval_ns, memory_order_relaxed);
+
+    // Bursts of data frames must not make the heartbeat period look shorter
+    if (mean < ctx->heartbeat_interval_ns) {
+        mean = ctx->heartbeat_interval_ns;
+    }
+    return now > last ? PHI_LOG10_E * (double)(now - last) / (double)mean : 0.0;
+}
+
+static void send_heartbeats(obi_topology_context_t *ctx, const obi_route_table_t *routes) {
+    uint32_t n = routes->node_count;
+    const uint32_t *links = &routes->cost[(size_t)ctx->local_id * n];
+    obi_topology_frame_t frame = {0};
+    frame.type = OBI_FRAME_HEARTBEAT;
+    frame.source = ctx->local_key;
+
+    // Failed nodes keep receiving heartbeats so a recovered node hears us at once
+    for (uint32_t i = 0; i < n; i++) {
+        obi_topology_node_t *node = &ctx->nodes[i];
+        if (i == ctx->local_id || (links[i] == 0 && !node->failed)) {
+            continue;
+        }
+        if (obi_topology_connect_node(ctx, node) == OBI_SUCCESS) {
+            frame.destination = node->key;
+            obi_topology_lock_transport(ctx);
+            ctx->transport->ops->send(ctx->transport, node->handle, &frame, NULL);
+            obi_topology_unlock_transport(ctx);
+        }
+    }
+    obi_topology_transport_flush(ctx);
+}
+
+static void declare_failed(obi_topology_context_t *ctx, obi_node_id_t id, uint64_t now) {
+    obi_topology_node_t *node = &ctx->nodes[id];
+    node->failed = true;
+    node->failed_at_ns = now;
+    atomic_fetch_add(&ctx->failovers, 1);
+
+    // Fast path: patch the local row from the precomputed backups and swap it in
+    obi_topology_lock_graph(ctx);
+    obi_route_table_t *current = atomic_load(&ctx->routes.current);
+    if (ctx->current_metrics.failover_enabled) {
+        obi_route_table_t *failover = obi_route_table_failover(current, id);
+        if (failover) {
+            failover->version = current->version + 1;
+            obi_topology_publish_routes(&ctx->routes, failover);
+        }
+    }
+
+    // Exact routes without the failed node follow on the next poll
+    ctx->graph.active[id] = false;
+    ctx->reconverge_pending = true;
+    obi_topology_unlock_graph(ctx);
+}
+
+obi_topology_result_t obi_topology_poll(obi_topology_context_t *ctx) {
+    if (!ctx || !ctx->active) {
+        return OBI_TOPOLOGY_ERROR_INVALID_CONFIG;
+    }
+
+    // Idle senders rely on poll to meet their coalescing deadlines
+    uint64_t now = obi_topology_now_ns();
+    obi_topology_coalesce_tick(ctx, now);
+    if (ctx->gossip_interval_ns && ctx->local_id != OBI_NODE_INVALID &&
+        ctx->network_type == OBI_TOPOLOGY_MESH) {
+        obi_topology_gossip_tick(ctx, now);
+    }
+    if (ctx->heartbeat_interval_ns == 0 || ctx->local_id == OBI_NODE_INVALID) {
+        return OBI_TOPOLOGY_SUCCESS;
+    }
+
+    obi_topology_result_t result = OBI_TOPOLOGY_SUCCESS;
+
+    // A failed node that is heard from again rejoins
+    obi_topology_lock_graph(ctx);
+    for (uint32_t i = 0; i < ctx->graph.node_count; i++) {
+        obi_topology_node_t *node = &ctx->nodes[i];
+        if (node->failed && atomic_load(&node->last_heard_ns) > node->failed_at_ns) {
+            node->failed = false;
+            ctx->graph.active[i] = true;
+            obi_topology_flow_reset(node);  // frames in flight to it were lost
+            obi_topology_order_reset(ctx, node);
+            ctx->reconverge_pending = true;
+        }
+    }
+    if (ctx->reconverge_pending) {
+        ctx->reconverge_pending = false;
+        result = obi_topology_rebuild_routes(ctx);
+    }
+    obi_topology_unlock_graph(ctx);
+
+    const obi_route_table_t *routes = atomic_load(&ctx->routes.current);
+    if (now >= ctx->next_heartbeat_ns) {
+        send_heartbeats(ctx, routes);
+        ctx->next_heartbeat_ns = now + ctx->heartbeat_interval_ns;
+    }
+
+    // Only direct neighbours heartbeat us; their silence is what we judge
+    uint32_t n = routes->node_count;
+    for (uint32_t i = 0; i < n; i++) {
+        obi_topology_node_t *node = &ctx->nodes[i];
+        const uint32_t *links = &atomic_load(&ctx->routes.current)->cost[(size_t)ctx->local_id * n];
+        if (links[i] == 0 || node->failed || atomic_load(&node->last_heard_ns) == 0) {
+            continue;
+        }
+        if (phi(ctx, node, now) >= ctx->phi_threshold) {
+            declare_failed(ctx, (obi_node_id_t)i, now);
+        }
+    }
+    return result;
+}
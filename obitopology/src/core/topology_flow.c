@@ -0,0 +1,213 @@
+/*
+ * OBI Topology Flow Control
+ * Credit-based backpressure per destination: every frame carries the
+ * count its send reserved as a mark, the receiver reports the highest
+ * mark it has read, piggybacked on return traffic or in explicit grants,
+ * and a sender stops once window frames are outstanding. A lost frame is
+ * covered by the next mark read; a sender left without credit probes the
+ * receiver for its report. A cancelled send keeps its mark and hands the
+ * credit back locally until a report covers it, so marks never go back
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "topology_internal.h"
+#include <sched.h>
+
+obi_topology_result_t obi_topology_set_flow_control(obi_topology_context_t *ctx, const obi_flow_config_t *config) {
+    obi_flow_config_t defaults = { OBI_FLOW_DEFAULT_WINDOW, 0, 0 };
+    if (!config) {
+        config = &defaults;
+    }
+    if (!ctx || !ctx->active || config->window > INT32_MAX) {
+        return OBI_TOPOLOGY_ERROR_INVALID_CONFIG;
+    }
+
+    ctx->credit_window = config->window;
+    ctx->credit_block_ns = (uint64_t)config->block_us * 1000ull;
+    ctx->credit_probe_ns = (uint64_t)(config->probe_us ? config->probe_us : OBI_FLOW_DEFAULT_PROBE_US) * 1000ull;
+    for (uint32_t i = 0; i < ctx->graph.node_count; i++) {
+        obi_topology_flow_reset(&ctx->nodes[i]);
+    }
+    return OBI_TOPOLOGY_SUCCESS;
+}
+
+void obi_topology_flow_reset(obi_topology_node_t *node) {
+    atomic_store(&node->credit_sent, 0);
+    atomic_store(&node->credit_marked, 0);
+    atomic_store(&node->credit_returned, 0);
+    atomic_store(&node->credit_acked, 0);
+    atomic_store(&node->credit_seen, 0);
+    atomic_store(&node->granted, 0);
+    atomic_store(&node->credit_stalled_ns, 0);
+}
+
+static bool try_reserve(obi_topology_node_t *node, uint32_t window, uint32_t *mark) {
+    uint32_t sent = atomic_load_explicit(&node->credit_sent, memory_order_relaxed);
+    do {
+        uint32_t acked = atomic_load_explicit(&node->credit_acked, memory_order_acquire);
+        uint32_t returned = (uint32_t)atomic_load_explicit(&node->credit_returned, memory_order_relaxed);
+        if ((int32_t)(sent - acked - returned) >= (int32_t)window) {
+            return false;
+        }
+    } while (!atomic_compare_exchange_weak_explicit(&node->credit_sent, &sent, sent + 1,
+                                                    memory_order_relaxed, memory_order_relaxed));
+    *mark = sent + 1;
+    return true;
+}
+
+// Marks leave in reservation order only per thread, so the highest one is
+// kept with a max rather than a store
+static void note_marked(obi_topology_node_t *node, uint32_t mark) {
+    uint32_t marked = atomic_load_explicit(&node->credit_marked, memory_order_relaxed);
+    while ((int32_t)(mark - marked) > 0 &&
+           !atomic_compare_exchange_weak_explicit(&node->credit_marked, &marked, mark,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+// The tail of a burst lost on the way leaves no later mark to cover it. A
+// sender out of credit for a probe interval asks the destination for its
+// report, and asks again each interval while no credit comes back
+static void probe_if_stalled(obi_topology_context_t *ctx, obi_topology_node_t *node) {
+    uint64_t now = obi_topology_now_ns();
+    uint64_t since = atomic_load_explicit(&node->credit_stalled_ns, memory_order_relaxed);
+    if (since == 0) {
+        atomic_compare_exchange_strong_explicit(&node->credit_stalled_ns, &since, now,
+                                                memory_order_relaxed, memory_order_relaxed);
+        return;
+    }
+    if (now - since < ctx->credit_probe_ns ||
+        !atomic_compare_exchange_strong_explicit(&node->credit_stalled_ns, &since, now,
+                                                 memory_order_relaxed, memory_order_relaxed)) {
+        return;
+    }
+    if (obi_topology_send_credit(ctx, (obi_node_id_t)(node - ctx->nodes), OBI_FRAME_FLAG_PROBE) == OBI_SUCCESS) {
+        atomic_fetch_add_explicit(&ctx->credit_probes, 1, memory_order_relaxed);
+    }
+}
+
+bool obi_topology_flow_reserve(obi_topology_context_t *ctx, obi_topology_node_t *node, bool block,
+                               uint32_t *mark) {
+    *mark = 0;
+    if (ctx->credit_window == 0 || try_reserve(node, ctx->credit_window, mark)) {
+        return true;
+    }
+    probe_if_stalled(ctx, node);
+
+    // Blocking only helps when another thread drains receive and absorbs grants
+    if (block && ctx->credit_block_ns) {
+        uint64_t deadline = obi_topology_now_ns() + ctx->credit_block_ns;
+        do {
+            sched_yield();
+            if (try_reserve(node, ctx->credit_window, mark)) {
+                return true;
+            }
+            probe_if_stalled(ctx, node);
+        } while (obi_topology_now_ns() < deadline);
+    }
+
+    atomic_fetch_add_explicit(&ctx->busy_sends, 1, memory_order_relaxed);
+    return false;
+}
+
+// The mark stays taken, since a later or concurrent frame may already carry
+// a higher one; its credit counts as returned until a report reaches it
+void obi_topology_flow_cancel(obi_topology_context_t *ctx, obi_topology_node_t *node, uint32_t mark) {
+    if (ctx->credit_window == 0) {
+        return;
+    }
+    uint64_t returned = atomic_load_explicit(&node->credit_returned, memory_order_relaxed);
+    uint64_t next;
+    do {
+        uint32_t highest = (uint32_t)(returned >> 32);
+        uint32_t count = (uint32_t)returned;
+        if (count == 0 || (int32_t)(mark - highest) > 0) {
+            highest = mark;
+        }
+        next = (uint64_t)highest << 32 | (count + 1);
+    } while (!atomic_compare_exchange_weak_explicit(&node->credit_returned, &returned, next,
+                                                    memory_order_release, memory_order_relaxed));
+    note_marked(node, mark);
+}
+
+// A report at or past the highest cancelled mark covers every cancellation,
+// whose credit then comes back through acked instead. One short of it may
+// cover some already; those count twice until a later report, which at
+// worst lets a few frames beyond the window out meanwhile
+static void settle_returned(obi_topology_node_t *node, uint32_t report) {
+    uint64_t returned = atomic_load_explicit(&node->credit_returned, memory_order_acquire);
+    while ((uint32_t)returned && (int32_t)(report - (uint32_t)(returned >> 32)) >= 0 &&
+           !atomic_compare_exchange_weak_explicit(&node->credit_returned, &returned, returned & ~0xffffffffull,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+void obi_topology_flow_stamp(obi_topology_context_t *ctx, obi_topology_node_t *node,
+                             obi_topology_frame_t *frame, uint32_t mark) {
+    if (ctx->credit_window == 0) {
+        return;
+    }
+
+    // Cumulative marks make lost or duplicated grants harmless
+    uint32_t seen = atomic_load_explicit(&node->credit_seen, memory_order_relaxed);
+    frame->flags |= OBI_FRAME_FLAG_CREDIT;
+    frame->credit = seen;
+    frame->credit_mark = mark;
+    note_marked(node, mark);
+    atomic_store_explicit(&node->granted, seen, memory_order_relaxed);
+}
+
+// Receive side: the mark covers every earlier frame from the node, lost or not.
+// A mark far behind ours means the node restarted its count
+static void note_mark(obi_topology_context_t *ctx, obi_topology_node_t *node, uint32_t mark) {
+    uint32_t seen = atomic_load_explicit(&node->credit_seen, memory_order_relaxed);
+    int32_t ahead = (int32_t)(mark - seen);
+    if (ahead > 0) {
+        atomic_store_explicit(&node->credit_seen, mark, memory_order_relaxed);
+    } else if (ahead < -(int32_t)ctx->credit_window) {
+        atomic_store_explicit(&node->credit_seen, mark, memory_order_relaxed);
+        atomic_store_explicit(&node->granted, mark, memory_order_relaxed);
+    }
+}
+
+void obi_topology_flow_absorb(obi_topology_context_t *ctx, const obi_topology_frame_t *frame) {
+    if (ctx->credit_window == 0 || !(frame->flags & OBI_FRAME_FLAG_CREDIT)) {
+        return;
+    }
+    obi_node_id_t id = obi_node_registry_find(&ctx->registry, frame->source);
+    if (id == OBI_NODE_INVALID) {
+        return;
+    }
+
+    obi_topology_node_t *node = &ctx->nodes[id];
+    note_mark(ctx, node, frame->credit_mark);
+
+    uint32_t report = frame->credit;
+    uint32_t acked = atomic_load_explicit(&node->credit_acked, memory_order_relaxed);
+    do {
+        if ((int32_t)(report - acked) <= 0) {
+            return;  // stale report overtaken by a newer one
+        }
+        // A peer that kept counting while we restarted ours cannot be ahead of us
+        uint32_t sent = atomic_load_explicit(&node->credit_sent, memory_order_relaxed);
+        if ((int32_t)(sent - report) < 0) {
+            report = sent;
+        }
+    } while (!atomic_compare_exchange_weak_explicit(&node->credit_acked, &acked, report,
+                                                    memory_order_release, memory_order_relaxed));
+    settle_returned(node, report);
+    atomic_store_explicit(&node->credit_stalled_ns, 0, memory_order_relaxed);
+}
+
+bool obi_topology_flow_grant_due(obi_topology_context_t *ctx, obi_topology_node_t *node) {
+    if (ctx->credit_window == 0) {
+        return false;
+    }
+
+    // Grant explicitly once half the window is unreported, so a one-way
+    // stream never stalls waiting for return traffic
+    uint32_t seen = atomic_load_explicit(&node->credit_seen, memory_order_relaxed);
+    uint32_t granted = atomic_load_explicit(&node->granted, memory_order_relaxed);
+    return seen - granted >= (ctx->credit_window + 1) / 2;
+}
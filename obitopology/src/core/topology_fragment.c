@@ -0,0 +1,310 @@
+/*
+ * OBI Topology Fragmentation
+ * Payloads larger than one transport frame travel as a train of fragment
+ * frames. The receiver copies each fragment straight to its offset in a
+ * slot preallocated at the largest message size and hands the slot out
+ * in place once complete; partial messages are discarded after a timeout
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "topology_internal.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+
+#define FRAGMENT_STALL_NS ((uint64_t)OBI_FRAGMENT_STALL_MS * 1000000ull)
+
+// Each sending thread keeps one frame of scratch for the trains it sends
+typedef struct {
+    size_t capacity;
+    uint8_t data[];
+} fragment_scratch_t;
+
+static pthread_key_t scratch_key;
+static pthread_once_t scratch_once = PTHREAD_ONCE_INIT;
+
+static void scratch_key_create(void) {
+    pthread_key_create(&scratch_key, free);
+}
+
+static uint8_t *thread_scratch(size_t size) {
+    pthread_once(&scratch_once, scratch_key_create);
+    fragment_scratch_t *scratch = pthread_getspecific(scratch_key);
+    if (!scratch || scratch->capacity < size) {
+        fragment_scratch_t *grown = realloc(scratch, sizeof(*scratch) + size);
+        if (!grown) {
+            return NULL;
+        }
+        grown->capacity = size;
+        pthread_setspecific(scratch_key, grown);
+        scratch = grown;
+    }
+    return scratch->data;
+}
+
+// The first fragment fails like any send. Later ones find the receiver
+// already holding part of the message: a waiting sender yields until the
+// ring has room, others return OBI_ERROR_WOULD_BLOCK with the train kept.
+// Either way a train stalled for OBI_FRAGMENT_STALL_MS is abandoned
+obi_result_t obi_topology_fragment_send(obi_topology_context_t *ctx, obi_node_id_t destination,
+                                        const obi_buffer_t *buffer, obi_fragment_train_t *train, bool wait) {
+    obi_topology_node_t *target = &ctx->nodes[destination];
+    size_t chunk = ctx->transport->max_frame_payload - sizeof(obi_fragment_header_t);
+    uint8_t *scratch = thread_scratch(ctx->transport->max_frame_payload);
+    if (!scratch) {
+        return train->offset ? OBI_ERROR_WOULD_BLOCK : OBI_ERROR_OUT_OF_MEMORY;
+    }
+    if (train->offset == 0) {
+        train->train_id = atomic_fetch_add_explicit(&ctx->fragment_next_id, 1, memory_order_relaxed);
+        train->message_id = obi_topology_claim_message_ids(ctx, 1);
+        train->stalled_ns = 0;
+    }
+
+    obi_fragment_header_t header;
+    header.message_id = train->train_id;
+    header.total_length = (uint32_t)buffer->size;
+
+    obi_result_t result = OBI_SUCCESS;
+    while (train->offset < buffer->size && result == OBI_SUCCESS) {
+        size_t offset = train->offset;
+        size_t length = buffer->size - offset < chunk ? buffer->size - offset : chunk;
+        header.offset = (uint32_t)offset;
+        memcpy(scratch, &header, sizeof(header));
+        memcpy(scratch + sizeof(header), buffer->data + offset, length);
+
+        obi_topology_frame_t frame = {0};
+        frame.length = (uint32_t)(sizeof(header) + length);
+        frame.type = OBI_FRAME_FRAGMENT;
+        frame.source = ctx->local_key;
+        frame.destination = target->key;
+        frame.origin = ctx->local_key;
+        frame.message_id = train->message_id;
+        obi_topology_flow_stamp(ctx, target, &frame, train->credit_mark);
+        obi_topology_order_stamp(target, &frame);
+
+        uint64_t started = obi_topology_now_ns();
+        for (;;) {
+            unsigned slot;
+            const obi_route_table_t *routes = obi_route_acquire(&ctx->routes, &slot);
+            result = obi_topology_forward_frame(ctx, routes, destination, &frame, scratch);
+            obi_route_release(&ctx->routes, slot);
+            if (result != OBI_ERROR_WOULD_BLOCK || offset == 0 || !wait ||
+                obi_topology_now_ns() - started >= FRAGMENT_STALL_NS) {
+                break;
+            }
+            obi_topology_transport_flush(ctx);
+            sched_yield();
+        }
+        if (result != OBI_SUCCESS) {
+            obi_topology_order_cancel(target, &frame);
+        } else {
+            train->offset = (uint32_t)(offset + length);
+            train->stalled_ns = 0;
+        }
+    }
+
+    // The receiver's slot for an abandoned train times out on its own
+    if (result == OBI_ERROR_WOULD_BLOCK && train->offset) {
+        uint64_t now = obi_topology_now_ns();
+        if (!train->stalled_ns) {
+            train->stalled_ns = now;
+        }
+        if (!wait && now - train->stalled_ns < FRAGMENT_STALL_NS) {
+            obi_topology_transport_flush(ctx);
+            return OBI_ERROR_WOULD_BLOCK;
+        }
+        result = OBI_ERROR_NETWORK_FAILURE;
+    }
+    if (result == OBI_SUCCESS) {
+        atomic_fetch_add_explicit(&ctx->fragmented_messages, 1, memory_order_relaxed);
+    }
+    return result;
+}
+
+obi_topology_result_t obi_topology_set_reassembly(obi_topology_context_t *ctx,
+                                                  const obi_reassembly_config_t *config) {
+    obi_reassembly_config_t defaults = { OBI_REASSEMBLY_DEFAULT_MAX_MESSAGE, OBI_REASSEMBLY_DEFAULT_SLOTS,
+                                         OBI_REASSEMBLY_DEFAULT_TIMEOUT_MS };
+    if (!config) {
+        config = &defaults;
+    }
+    if (!ctx || !ctx->active || config->slots > OBI_REASSEMBLY_MAX_SLOTS ||
+        config->max_message > OBI_FRAGMENT_MAX_MESSAGE ||
+        (config->slots && (config->max_message == 0 || config->timeout_ms == 0))) {
+        return OBI_TOPOLOGY_ERROR_INVALID_CONFIG;
+    }
+
+    // Partial messages and an outstanding view go with the old slots
+    obi_topology_fragment_release(ctx);
+    if (config->slots == 0) {
+        return OBI_TOPOLOGY_SUCCESS;
+    }
+
+    ctx->reassembly = calloc(config->slots, sizeof(obi_reassembly_slot_t));
+    if (!ctx->reassembly) {
+        return OBI_TOPOLOGY_ERROR_INVALID_CONFIG;
+    }
+    ctx->reassembly_slots = config->slots;
+    for (uint32_t i = 0; i < config->slots; i++) {
+        ctx->reassembly[i].data = malloc(config->max_message);
+        if (!ctx->reassembly[i].data) {
+            obi_topology_fragment_release(ctx);
+            return OBI_TOPOLOGY_ERROR_INVALID_CONFIG;
+        }
+    }
+    ctx->reassembly_max_message = config->max_message;
+    ctx->reassembly_timeout_ns = (uint64_t)config->timeout_ms * 1000000ull;
+    return OBI_TOPOLOGY_SUCCESS;
+}
+
+// Every message returns one credit to its sender, whether delivered or given up
+static void finish(obi_topology_context_t *ctx, obi_reassembly_slot_t *slot) {
+    slot->state = OBI_REASSEMBLY_FREE;
+    obi_topology_grant_credit(ctx, slot->source, false);
+}
+
+static void expire(obi_topology_context_t *ctx, uint64_t now) {
+    for (uint32_t i = 0; i < ctx->reassembly_slots; i++) {
+        obi_reassembly_slot_t *slot = &ctx->reassembly[i];
+        if (slot->state == OBI_REASSEMBLY_FILLING && now - slot->started_ns >= ctx->reassembly_timeout_ns) {
+            atomic_fetch_add_explicit(&ctx->reassembly_timeouts, 1, memory_order_relaxed);
+            finish(ctx, slot);
+        }
+    }
+}
+
+static obi_reassembly_slot_t *claim(obi_topology_context_t *ctx, const obi_topology_frame_t *frame,
+                                    const obi_fragment_header_t *header, uint64_t now) {
+    uint32_t source = frame->source;
+    obi_reassembly_slot_t *free_slot = NULL;
+    for (uint32_t i = 0; i < ctx->reassembly_slots; i++) {
+        obi_reassembly_slot_t *slot = &ctx->reassembly[i];
+        if (slot->state == OBI_REASSEMBLY_FILLING && slot->source == source &&
+            slot->message_id == header->message_id) {
+            return slot;
+        }
+        if (slot->state == OBI_REASSEMBLY_FREE && !free_slot) {
+            free_slot = slot;
+        }
+    }
+
+    // Only a first fragment opens a slot; the rest of a refused message is ignored
+    if (header->offset != 0) {
+        return NULL;
+    }
+    if (!free_slot || header->total_length > ctx->reassembly_max_message) {
+        atomic_fetch_add_explicit(&ctx->reassembly_drops, 1, memory_order_relaxed);
+        obi_topology_grant_credit(ctx, source, false);
+        return NULL;
+    }
+    free_slot->state = OBI_REASSEMBLY_FILLING;
+    free_slot->source = source;
+    free_slot->message_id = header->message_id;
+    free_slot->origin = frame->origin ? frame->origin : source;
+    free_slot->origin_message_id = frame->message_id;
+    free_slot->total = header->total_length;
+    free_slot->received = 0;
+    free_slot->started_ns = now;
+    return free_slot;
+}
+
+void obi_topology_fragment_absorb(obi_topology_context_t *ctx, const obi_topology_frame_t *frame,
+                                  const uint8_t *payload) {
+    obi_fragment_header_t header;
+    if (frame->length < sizeof(header)) {
+        return;
+    }
+    memcpy(&header, payload, sizeof(header));
+    if (!ctx->reassembly) {
+        if (header.offset == 0) {
+            atomic_fetch_add_explicit(&ctx->reassembly_drops, 1, memory_order_relaxed);
+            obi_topology_grant_credit(ctx, frame->source, false);
+        }
+        return;
+    }
+
+    uint64_t now = obi_topology_now_ns();
+    expire(ctx, now);
+    obi_reassembly_slot_t *slot = claim(ctx, frame, &header, now);
+    if (!slot) {
+        return;
+    }
+
+    // Fragments leave in offset order over one route, so each must start
+    // where the bytes so far end. An earlier offset is a repeated copy and
+    // is ignored; a later one means a fragment was lost and the message
+    // can no longer complete without holes
+    uint32_t length = frame->length - (uint32_t)sizeof(header);
+    if (header.total_length == slot->total && header.offset < slot->received) {
+        return;
+    }
+    if (header.total_length != slot->total || header.offset != slot->received ||
+        length > slot->total - header.offset) {
+        atomic_fetch_add_explicit(&ctx->reassembly_drops, 1, memory_order_relaxed);
+        finish(ctx, slot);
+        return;
+    }
+    memcpy(slot->data + header.offset, payload + sizeof(header), length);
+    slot->received += length;
+    if (slot->received < slot->total) {
+        return;
+    }
+
+    // Flooded copies of a large message are dropped like small ones, under
+    // the identity its first fragment carried
+    obi_buffer_t message = { slot->data, slot->total, slot->total };
+    ctx->rx_origin = slot->origin;
+    ctx->rx_message_id = slot->origin_message_id;
+    if (obi_topology_dedup_seen(ctx, &message)) {
+        finish(ctx, slot);
+        return;
+    }
+    atomic_fetch_add_explicit(&ctx->reassembled_messages, 1, memory_order_relaxed);
+    slot->state = OBI_REASSEMBLY_READY;
+    ctx->reassembly_ready = (int32_t)(slot - ctx->reassembly);
+}
+
+void obi_topology_fragment_reclaim(obi_topology_context_t *ctx) {
+    for (uint32_t i = 0; i < ctx->reassembly_slots; i++) {
+        if (ctx->reassembly[i].state == OBI_REASSEMBLY_LENT) {
+            ctx->reassembly[i].state = OBI_REASSEMBLY_FREE;
+        }
+    }
+}
+
+obi_result_t obi_topology_fragment_deliver(obi_topology_context_t *ctx, obi_buffer_t *buffer, bool view) {
+    if (ctx->reassembly_ready < 0) {
+        return OBI_ERROR_WOULD_BLOCK;
+    }
+
+    obi_reassembly_slot_t *slot = &ctx->reassembly[ctx->reassembly_ready];
+    if (view) {
+        buffer->data = slot->data;
+        buffer->capacity = slot->total;
+        slot->state = OBI_REASSEMBLY_LENT;
+    } else {
+        if (slot->total > buffer->capacity) {
+            return OBI_ERROR_BUFFER_OVERFLOW;  // kept for a larger buffer or a view
+        }
+        memcpy(buffer->data, slot->data, slot->total);
+        slot->state = OBI_REASSEMBLY_FREE;
+    }
+    buffer->size = slot->total;
+    ctx->reassembly_ready = -1;
+    ctx->rx_origin = slot->origin;
+    ctx->rx_message_id = slot->origin_message_id;
+    obi_topology_grant_credit(ctx, slot->source, false);
+    return OBI_SUCCESS;
+}
+
+void obi_topology_fragment_release(obi_topology_context_t *ctx) {
+    for (uint32_t i = 0; i < ctx->reassembly_slots; i++) {
+        free(ctx->reassembly[i].data);
+    }
+    free(ctx->reassembly);
+    ctx->reassembly = NULL;
+    ctx->reassembly_slots = 0;
+    ctx->reassembly_ready = -1;
+}
@@ -0,0 +1,370 @@
+/*
+ * OBI Topology Gossip Membership
+ * SWIM over the local transport: every period probes one member directly,
+ * asks a few others to probe it on silence, then suspects and finally
+ * declares it dead. Membership changes ride on probes and acks, each one
+ * retransmitted O(log N) times, so a change reaches every member in
+ * O(log N) periods while each node sends O(1) frames per period
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "topology_internal.h"
+#include <string.h>
+
+// Piggyback retransmissions per update are this multiple of log2(members + 1)
+#define GOSSIP_RETRANSMIT_MULT 3
+
+enum {
+    GOSSIP_PING = 1,          // probe of subject; ack goes straight to origin
+    GOSSIP_ACK,
+    GOSSIP_PING_REQ           // ask the recipient to probe subject for origin
+};
+
+typedef struct {
+    uint8_t kind;
+    uint8_t update_count;
+    uint16_t reserved;
+    uint32_t sequence;        // origin's probe number, echoed by the ack
+    uint32_t origin;          // node key of the prober
+    uint32_t subject;         // node key being probed
+} gossip_header_t;
+
+typedef struct {
+    uint32_t key;
+    uint32_t incarnation;
+    uint8_t status;           // obi_member_status_t
+    uint8_t reserved[3];
+} gossip_update_t;
+
+static uint32_t ceil_log2(uint32_t n) {
+    uint32_t bits = 0;
+    while ((1u << bits) < n + 1) {
+        bits++;
+    }
+    return bits;
+}
+
+static uint32_t live_members(const obi_topology_context_t *ctx) {
+    uint32_t members = 0;
+    for (uint32_t i = 0; i < ctx->graph.node_count; i++) {
+        members += ctx->nodes[i].member_status != OBI_MEMBER_DEAD ? 1 : 0;
+    }
+    return members;
+}
+
+static uint32_t retransmits(const obi_topology_context_t *ctx) {
+    return GOSSIP_RETRANSMIT_MULT * ceil_log2(live_members(ctx));
+}
+
+// xorshift64*; only has to spread probe order and indirect helpers
+static uint64_t next_random(obi_topology_context_t *ctx) {
+    uint64_t x = ctx->gossip_random;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    ctx->gossip_random = x;
+    return x * 0x2545F4914F6CDD1Dull;
+}
+
+static void set_status(obi_topology_context_t *ctx, obi_node_id_t id, obi_member_status_t status,
+                       uint32_t incarnation, uint64_t now) {
+    obi_topology_node_t *node = &ctx->nodes[id];
+    bool was_dead = node->member_status == OBI_MEMBER_DEAD;
+
+    node->member_status = (uint8_t)status;
+    node->incarnation = incarnation;
+    node->suspect_since_ns = now;
+    node->gossip_transmits = retransmits(ctx);
+
+    // Only death and rejoining change the graph; suspects keep their routes.
+    // A restarted member binds afresh, so its old handle is dropped once the
+    // rebuilt routes have drained the senders still pinned to the old ones
+    if (was_dead != (status == OBI_MEMBER_DEAD)) {
+        obi_topology_lock_graph(ctx);
+        ctx->graph.active[id] = status != OBI_MEMBER_DEAD;
+        if (was_dead) {
+            obi_topology_flow_reset(node);
+            obi_topology_order_reset(ctx, node);
+        }
+        obi_topology_rebuild_routes(ctx);
+        obi_topology_unlock_graph(ctx);
+        if (!was_dead) {
+            obi_topology_disconnect_node(ctx, node);
+        }
+    }
+}
+
+// The local refutation goes first, then a node worth mentioning, then the
+// updates with the most retransmissions left
+static uint8_t pack_updates(obi_topology_context_t *ctx, gossip_update_t *updates, obi_node_id_t mention) {
+    bool chosen[OBI_TOPOLOGY_MAX_NODES] = {false};
+    uint8_t count = 0;
+
+    memset(updates, 0, OBI_GOSSIP_MAX_UPDATES * sizeof(gossip_update_t));
+    if (ctx->self_transmits) {
+        ctx->self_transmits--;
+        updates[count].key = ctx->local_key;
+        updates[count].incarnation = ctx->incarnation;
+        updates[count++].status = OBI_MEMBER_ALIVE;
+    }
+    if (mention != OBI_NODE_INVALID) {
+        chosen[mention] = true;
+        updates[count].key = ctx->nodes[mention].key;
+        updates[count].incarnation = ctx->nodes[mention].incarnation;
+        updates[count++].status = ctx->nodes[mention].member_status;
+    }
+
+    while (count < OBI_GOSSIP_MAX_UPDATES) {
+        obi_node_id_t best = OBI_NODE_INVALID;
+        for (uint32_t i = 0; i < ctx->graph.node_count; i++) {
+            if (!chosen[i] && ctx->nodes[i].gossip_transmits &&
+                (best == OBI_NODE_INVALID || ctx->nodes[i].gossip_transmits > ctx->nodes[best].gossip_transmits)) {
+                best = (obi_node_id_t)i;
+            }
+        }
+        if (best == OBI_NODE_INVALID) {
+            break;
+        }
+        obi_topology_node_t *node = &ctx->nodes[best];
+        chosen[best] = true;
+        node->gossip_transmits--;
+        updates[count].key = node->key;
+        updates[count].incarnation = node->incarnation;
+        updates[count++].status = node->member_status;
+    }
+    return count;
+}
+
+// Gossip goes straight to the member, not along routes: dead members have none
+static void send_gossip(obi_topology_context_t *ctx, obi_node_id_t id, uint8_t kind, uint32_t sequence,
+                        uint32_t origin, uint32_t subject, obi_node_id_t mention) {
+    uint8_t payload[sizeof(gossip_header_t) + OBI_GOSSIP_MAX_UPDATES * sizeof(gossip_update_t)];
+    gossip_update_t updates[OBI_GOSSIP_MAX_UPDATES];
+    gossip_header_t header = { kind, 0, 0, sequence, origin, subject };
+    header.update_count = pack_updates(ctx, updates, mention);
+    memcpy(payload, &header, sizeof(header));
+    memcpy(payload + sizeof(header), updates, header.update_count * sizeof(gossip_update_t));
+
+    obi_topology_node_t *node = &ctx->nodes[id];
+    obi_topology_frame_t frame = {0};
+    frame.length = (uint32_t)(sizeof(header) + header.update_count * sizeof(gossip_update_t));
+    frame.type = OBI_FRAME_GOSSIP;
+    frame.source = ctx->local_key;
+    frame.destination = node->key;
+    if (obi_topology_connect_node(ctx, node) != OBI_SUCCESS) {
+        return;
+    }
+    obi_topology_lock_transport(ctx);
+    obi_result_t result = ctx->transport->ops->send(ctx->transport, node->handle, &frame, payload);
+    obi_topology_unlock_transport(ctx);
+    if (result == OBI_SUCCESS) {
+        atomic_fetch_add_explicit(&ctx->gossip_frames, 1, memory_order_relaxed);
+    }
+}
+
+obi_topology_result_t obi_topology_set_gossip(obi_topology_context_t *ctx, const obi_gossip_config_t *config) {
+    obi_gossip_config_t defaults = { OBI_GOSSIP_DEFAULT_INTERVAL_US, OBI_GOSSIP_DEFAULT_INDIRECT,
+                                     OBI_GOSSIP_DEFAULT_SUSPICION };
+    if (!config) {
+        config = &defaults;
+    }
+    if (!ctx || !ctx->active || ctx->network_type != OBI_TOPOLOGY_MESH || config->suspicion_mult == 0) {
+        return OBI_TOPOLOGY_ERROR_INVALID_CONFIG;
+    }
+
+    ctx->gossip_interval_ns = (uint64_t)config->interval_us * 1000ull;
+    ctx->gossip_indirect = config->indirect_probes;
+    ctx->gossip_suspicion = config->suspicion_mult;
+    ctx->gossip_random = ((uint64_t)ctx->local_key << 32 | 1u) ^ obi_topology_now_ns();
+    ctx->probe_started_ns = 0;
+    ctx->probe_target = OBI_NODE_INVALID;
+    ctx->probe_count = 0;
+    ctx->probe_next = 0;
+
+    // Members start from the graph; announcing ourselves lets a restarted node rejoin
+    for (uint32_t i = 0; i < ctx->graph.node_count; i++) {
+        obi_topology_node_t *node = &ctx->nodes[i];
+        node->member_status = ctx->graph.active[i] ? OBI_MEMBER_ALIVE : OBI_MEMBER_DEAD;
+        node->incarnation = 0;
+        node->gossip_transmits = 0;
+    }
+    ctx->self_transmits = retransmits(ctx);
+    return OBI_TOPOLOGY_SUCCESS;
+}
+
+obi_topology_result_t obi_topology_member_status(obi_topology_context_t *ctx, obi_node_id_t node_id,
+                                                 obi_member_status_t *status) {
+    if (!ctx || !status || !ctx->active || node_id >= ctx->graph.node_count) {
+        return OBI_TOPOLOGY_ERROR_INVALID_CONFIG;
+    }
+    if (ctx->gossip_interval_ns && node_id != ctx->local_id) {
+        *status = (obi_member_status_t)ctx->nodes[node_id].member_status;
+    } else {
+        *status = ctx->graph.active[node_id] ? OBI_MEMBER_ALIVE : OBI_MEMBER_DEAD;
+    }
+    return OBI_TOPOLOGY_SUCCESS;
+}
+
+// Round robin over a shuffled member list bounds the time to the next probe of any member
+static obi_node_id_t next_probe_target(obi_topology_context_t *ctx) {
+    for (int pass = 0; pass < 2; pass++) {
+        while (ctx->probe_next < ctx->probe_count) {
+            obi_node_id_t id = ctx->probe_order[ctx->probe_next++];
+            if (ctx->nodes[id].member_status != OBI_MEMBER_DEAD) {
+                return id;
+            }
+        }
+
+        ctx->probe_count = 0;
+        ctx->probe_next = 0;
+        for (uint32_t i = 0; i < ctx->graph.node_count; i++) {
+            if (i != ctx->local_id && ctx->nodes[i].member_status != OBI_MEMBER_DEAD) {
+                ctx->probe_order[ctx->probe_count++] = (obi_node_id_t)i;
+            }
+        }
+        for (uint32_t i = ctx->probe_count; i > 1; i--) {
+            uint32_t j = (uint32_t)(next_random(ctx) % i);
+            obi_node_id_t swap = ctx->probe_order[i - 1];
+            ctx->probe_order[i - 1] = ctx->probe_order[j];
+            ctx->probe_order[j] = swap;
+        }
+    }
+    return OBI_NODE_INVALID;
+}
+
+static void send_indirect_probes(obi_topology_context_t *ctx) {
+    obi_node_id_t helpers[OBI_TOPOLOGY_MAX_NODES];
+    uint32_t candidates = 0;
+    for (uint32_t i = 0; i < ctx->graph.node_count; i++) {
+        if (i != ctx->local_id && i != ctx->probe_target && ctx->nodes[i].member_status == OBI_MEMBER_ALIVE) {
+            helpers[candidates++] = (obi_node_id_t)i;
+        }
+    }
+
+    // Partial Fisher-Yates picks k distinct helpers
+    uint32_t k = ctx->gossip_indirect < candidates ? ctx->gossip_indirect : candidates;
+    uint32_t subject = ctx->nodes[ctx->probe_target].key;
+    for (uint32_t i = 0; i < k; i++) {
+        uint32_t j = i + (uint32_t)(next_random(ctx) % (candidates - i));
+        obi_node_id_t helper = helpers[j];
+        helpers[j] = helpers[i];
+        send_gossip(ctx, helper, GOSSIP_PING_REQ, ctx->probe_sequence, ctx->local_key, subject, OBI_NODE_INVALID);
+    }
+}
+
+void obi_topology_gossip_tick(obi_topology_context_t *ctx, uint64_t now) {
+    uint64_t suspicion_ns = ctx->gossip_interval_ns * ctx->gossip_suspicion * ceil_log2(live_members(ctx));
+
+    for (uint32_t i = 0; i < ctx->graph.node_count; i++) {
+        obi_topology_node_t *node = &ctx->nodes[i];
+        if (node->member_status == OBI_MEMBER_SUSPECT && now - node->suspect_since_ns >= suspicion_ns) {
+            set_status(ctx, (obi_node_id_t)i, OBI_MEMBER_DEAD, node->incarnation, now);
+        }
+    }
+
+    if (ctx->probe_started_ns && now - ctx->probe_started_ns < ctx->gossip_interval_ns) {
+        // Halfway through a silent period, probe through other members
+        if (!ctx->probe_acked && !ctx->probe_escalated && ctx->probe_target != OBI_NODE_INVALID &&
+            now - ctx->probe_started_ns >= ctx->gossip_interval_ns / 2) {
+            ctx->probe_escalated = true;
+            send_indirect_probes(ctx);
+            obi_topology_transport_flush(ctx);
+        }
+        return;
+    }
+
+    // The period is over: an unanswered target becomes a suspect
+    obi_node_id_t target = ctx->probe_target;
+    if (ctx->probe_started_ns && target != OBI_NODE_INVALID && !ctx->probe_acked &&
+        ctx->nodes[target].member_status == OBI_MEMBER_ALIVE) {
+        set_status(ctx, target, OBI_MEMBER_SUSPECT, ctx->nodes[target].incarnation, now);
+    }
+
+    ctx->probe_started_ns = now;
+    ctx->probe_acked = false;
+    ctx->probe_escalated = false;
+    ctx->probe_target = next_probe_target(ctx);
+    if (ctx->probe_target != OBI_NODE_INVALID) {
+        ctx->probe_sequence++;
+        send_gossip(ctx, ctx->probe_target, GOSSIP_PING, ctx->probe_sequence, ctx->local_key,
+                    ctx->nodes[ctx->probe_target].key, OBI_NODE_INVALID);
+        obi_topology_transport_flush(ctx);
+    }
+}
+
+// SWIM precedence: a higher incarnation wins, and at equal incarnations
+// dead overrides suspect overrides alive
+static void apply_update(obi_topology_context_t *ctx, const gossip_update_t *update, uint64_t now) {
+    obi_node_id_t id = obi_node_registry_find(&ctx->registry, update->key);
+    if (id == OBI_NODE_INVALID || update->status > OBI_MEMBER_DEAD) {
+        return;
+    }
+
+    // Rumours of our own suspicion or death are refuted with a new incarnation
+    if (id == ctx->local_id) {
+        if (update->status != OBI_MEMBER_ALIVE && update->incarnation >= ctx->incarnation) {
+            ctx->incarnation = update->incarnation + 1;
+            ctx->self_transmits = retransmits(ctx);
+        }
+        return;
+    }
+
+    obi_topology_node_t *node = &ctx->nodes[id];
+    if (update->incarnation > node->incarnation ||
+        (update->incarnation == node->incarnation && update->status > node->member_status)) {
+        set_status(ctx, id, (obi_member_status_t)update->status, update->incarnation, now);
+    }
+}
+
+void obi_topology_gossip_receive(obi_topology_context_t *ctx, const obi_topology_frame_t *frame,
+                                 const uint8_t *payload) {
+    gossip_header_t header;
+    if (!ctx->gossip_interval_ns || ctx->local_id == OBI_NODE_INVALID || frame->length < sizeof(header)) {
+        return;
+    }
+    memcpy(&header, payload, sizeof(header));
+    if (header.update_count > OBI_GOSSIP_MAX_UPDATES ||
+        frame->length < sizeof(header) + header.update_count * sizeof(gossip_update_t)) {
+        return;
+    }
+
+    uint64_t now = obi_topology_now_ns();
+    for (uint8_t i = 0; i < header.update_count; i++) {
+        gossip_update_t update;
+        memcpy(&update, payload + sizeof(header) + i * sizeof(update), sizeof(update));
+        apply_update(ctx, &update, now);
+    }
+
+    obi_node_id_t sender = obi_node_registry_find(&ctx->registry, frame->source);
+    obi_node_id_t origin = obi_node_registry_find(&ctx->registry, header.origin);
+    obi_node_id_t subject = obi_node_registry_find(&ctx->registry, header.subject);
+    if (sender == OBI_NODE_INVALID || origin == OBI_NODE_INVALID || subject == OBI_NODE_INVALID) {
+        return;
+    }
+
+    switch (header.kind) {
+        case GOSSIP_PING:
+            // A prober we hold dead is told so, which makes it refute and rejoin
+            if (subject == ctx->local_id) {
+                obi_node_id_t mention = ctx->nodes[origin].member_status == OBI_MEMBER_DEAD ? origin : OBI_NODE_INVALID;
+                send_gossip(ctx, origin, GOSSIP_ACK, header.sequence, header.origin, ctx->local_key, mention);
+                obi_topology_transport_flush(ctx);
+            }
+            break;
+
+        case GOSSIP_PING_REQ:
+            if (subject != ctx->local_id) {
+                send_gossip(ctx, subject, GOSSIP_PING, header.sequence, header.origin, header.subject,
+                            OBI_NODE_INVALID);
+                obi_topology_transport_flush(ctx);
+            }
+            break;
+
+        case GOSSIP_ACK:
+            if (origin == ctx->local_id && subject == ctx->probe_target && header.sequence == ctx->probe_sequence) {
+                ctx->probe_acked = true;
+            }
+            break;
+    }
+}
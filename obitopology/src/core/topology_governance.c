@@ -0,0 +1,117 @@
+/*
+ * OBI Topology Governance
+ * Zone state machine over the live cost function, with hysteresis, and
+ * the admission and batching policies applied in each zone
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "topology_internal.h"
+#include <string.h>
+#include <sched.h>
+
+static const char *const zone_names[] = { "AUTONOMOUS", "WARNING", "GOVERNANCE" };
+
+// Transport batching multiplier per zone
+static const uint32_t zone_batch_scale[] = { 1, 2, OBI_TRANSPORT_MAX_BATCH_SCALE };
+
+obi_governance_zone_t obi_topology_governance_next_zone(obi_governance_zone_t current, double cost) {
+    if (cost >= OBI_GOVERNANCE_GOVERNANCE_ENTER) {
+        return OBI_ZONE_GOVERNANCE;
+    }
+    if (cost <= OBI_GOVERNANCE_WARNING_EXIT) {
+        return OBI_ZONE_AUTONOMOUS;
+    }
+
+    switch (current) {
+        case OBI_ZONE_AUTONOMOUS:
+            return cost > OBI_GOVERNANCE_WARNING_ENTER ? OBI_ZONE_WARNING : OBI_ZONE_AUTONOMOUS;
+        case OBI_ZONE_WARNING:
+            return OBI_ZONE_WARNING;
+        case OBI_ZONE_GOVERNANCE:
+            return cost <= OBI_GOVERNANCE_GOVERNANCE_EXIT ? OBI_ZONE_WARNING : OBI_ZONE_GOVERNANCE;
+    }
+    return current;
+}
+
+static void lock_metrics(obi_topology_context_t *ctx) {
+    while (atomic_flag_test_and_set_explicit(&ctx->metrics_lock, memory_order_acquire)) {
+        sched_yield();
+    }
+}
+
+static void unlock_metrics(obi_topology_context_t *ctx) {
+    atomic_flag_clear_explicit(&ctx->metrics_lock, memory_order_release);
+}
+
+static void apply_zone(obi_topology_context_t *ctx, obi_governance_zone_t zone) {
+    atomic_store_explicit(&ctx->zone, (int)zone, memory_order_release);
+    strcpy(ctx->current_metrics.governance_zone, zone_names[zone]);
+    ctx->current_metrics.zone = zone;
+    if (ctx->transport && ctx->transport->ops->set_batch_scale) {
+        obi_topology_lock_transport(ctx);
+        ctx->transport->ops->set_batch_scale(ctx->transport, zone_batch_scale[zone]);
+        obi_topology_unlock_transport(ctx);
+    }
+}
+
+void obi_topology_governance_reset(obi_topology_context_t *ctx) {
+    atomic_store(&ctx->shed_messages, 0);
+    atomic_store(&ctx->metrics_refreshed_ns, 0);
+    atomic_flag_clear(&ctx->metrics_lock);
+    apply_zone(ctx, OBI_ZONE_AUTONOMOUS);
+}
+
+void obi_topology_governance_attach(obi_topology_context_t *ctx) {
+    lock_metrics(ctx);
+    apply_zone(ctx, (obi_governance_zone_t)atomic_load(&ctx->zone));
+    unlock_metrics(ctx);
+}
+
+static void evaluate_locked(obi_topology_context_t *ctx) {
+    obi_topology_refresh_metrics(ctx);
+
+    obi_governance_zone_t current = (obi_governance_zone_t)atomic_load(&ctx->zone);
+    obi_governance_zone_t next = obi_topology_governance_next_zone(current, ctx->current_metrics.cost_function);
+    if (next != current) {
+        apply_zone(ctx, next);
+    }
+
+    ctx->current_metrics.shed_messages = atomic_load_explicit(&ctx->shed_messages, memory_order_relaxed);
+    atomic_store_explicit(&ctx->metrics_refreshed_ns, obi_topology_now_ns(), memory_order_relaxed);
+}
+
+void obi_topology_governance_tick(obi_topology_context_t *ctx, uint64_t now) {
+    uint64_t refreshed = atomic_load_explicit(&ctx->metrics_refreshed_ns, memory_order_relaxed);
+    if (now - refreshed < OBI_GOVERNANCE_INTERVAL_NS) {
+        return;
+    }
+
+    // One sender pays for the refresh; the others carry on
+    if (atomic_flag_test_and_set_explicit(&ctx->metrics_lock, memory_order_acquire)) {
+        return;
+    }
+    evaluate_locked(ctx);
+    unlock_metrics(ctx);
+}
+
+// The copy is taken under the lock, so a sender's tick cannot rewrite it midway
+void obi_topology_governance_evaluate(obi_topology_context_t *ctx, obi_topology_metrics_t *snapshot) {
+    lock_metrics(ctx);
+    evaluate_locked(ctx);
+    *snapshot = ctx->current_metrics;
+    unlock_metrics(ctx);
+}
+
+bool obi_topology_admit(obi_topology_context_t *ctx, obi_topology_priority_t priority) {
+    obi_governance_zone_t zone = (obi_governance_zone_t)atomic_load_explicit(&ctx->zone, memory_order_acquire);
+    bool admitted = (zone == OBI_ZONE_AUTONOMOUS) ||
+                    (zone == OBI_ZONE_WARNING && priority > OBI_PRIORITY_LOW) ||
+                    (priority >= OBI_PRIORITY_HIGH);
+
+    // Shed sends are not link drops, so shedding itself never raises the cost
+    if (!admitted) {
+        atomic_fetch_add_explicit(&ctx->shed_messages, 1, memory_order_relaxed);
+    }
+    return admitted;
+}
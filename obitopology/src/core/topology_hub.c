@@ -0,0 +1,426 @@
+/*
+ * OBI Topology Hub Aggregation
+ * In a STAR every spoke-to-spoke message crosses the hub, one frame at a
+ * time. The hub instead collects transit data frames per destination,
+ * validates each batch with one validator call, and forwards it with one
+ * vectored send. Verdicts are cached by length and a keyed payload hash,
+ * so a broadcast the hub relays to every spoke is validated once and a
+ * spoke cannot aim a refused payload at an accepted one's entry
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "topology_internal.h"
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static bool hub_active(const obi_topology_context_t *ctx) {
+    return ctx->hub_batches && ctx->network_type == OBI_TOPOLOGY_STAR && ctx->local_id == ctx->graph.hub;
+}
+
+static void note_due(obi_topology_context_t *ctx, uint64_t due) {
+    if (ctx->hub_due_ns == 0 || due < ctx->hub_due_ns) {
+        ctx->hub_due_ns = due;
+    }
+}
+
+static void batch_reset(obi_topology_context_t *ctx, obi_hub_batch_t *batch) {
+    if (batch->oldest_ns) {
+        ctx->hub_pending--;
+    }
+    batch->first = 0;
+    batch->checked = 0;
+    batch->count = 0;
+    batch->used = 0;
+    batch->oldest_ns = 0;
+    batch->stalled_ns = 0;
+}
+
+static void batch_drop(obi_topology_context_t *ctx, obi_hub_batch_t *batch) {
+    atomic_fetch_add_explicit(&ctx->relay_drops, batch->count - batch->first, memory_order_relaxed);
+    batch_reset(ctx, batch);
+}
+
+static void batch_free(obi_hub_batch_t *batch) {
+    free(batch->frames);
+    free(batch->payloads);
+    free(batch->data);
+    memset(batch, 0, sizeof(*batch));
+}
+
+static bool batch_alloc(obi_topology_context_t *ctx, obi_hub_batch_t *batch) {
+    uint32_t slots = ctx->hub_config.max_batch;
+    batch->frames = malloc(slots * sizeof(*batch->frames));
+    batch->payloads = malloc(slots * sizeof(*batch->payloads));
+    batch->data = malloc((size_t)slots * ctx->hub_payload);
+    if (!batch->frames || !batch->payloads || !batch->data) {
+        batch_free(batch);
+        return false;
+    }
+    return true;
+}
+
+#define ROTL(x, b) (((x) << (b)) | ((x) >> (64 - (b))))
+
+static void sip_round(uint64_t v[4]) {
+    v[0] += v[1];
+    v[1] = ROTL(v[1], 13) ^ v[0];
+    v[0] = ROTL(v[0], 32);
+    v[2] += v[3];
+    v[3] = ROTL(v[3], 16) ^ v[2];
+    v[0] += v[3];
+    v[3] = ROTL(v[3], 21) ^ v[0];
+    v[2] += v[1];
+    v[1] = ROTL(v[1], 17) ^ v[2];
+    v[2] = ROTL(v[2], 32);
+}
+
+// SipHash-2-4: without the key a spoke cannot search for a collision offline
+static uint64_t cache_hash(const uint64_t key[2], const uint8_t *payload, uint32_t length) {
+    uint64_t v[4] = { key[0] ^ 0x736f6d6570736575ull, key[1] ^ 0x646f72616e646f6dull,
+                      key[0] ^ 0x6c7967656e657261ull, key[1] ^ 0x7465646279746573ull };
+    const uint8_t *end = payload + (length & ~7u);
+    for (; payload != end; payload += 8) {
+        uint64_t m;
+        memcpy(&m, payload, sizeof(m));
+        v[3] ^= m;
+        sip_round(v);
+        sip_round(v);
+        v[0] ^= m;
+    }
+    uint64_t last = (uint64_t)length << 56;
+    for (uint32_t i = 0; i < (length & 7u); i++) {
+        last |= (uint64_t)payload[i] << (8 * i);
+    }
+    v[3] ^= last;
+    sip_round(v);
+    sip_round(v);
+    v[0] ^= last;
+    v[2] ^= 0xff;
+    for (int i = 0; i < 4; i++) {
+        sip_round(v);
+    }
+    return v[0] ^ v[1] ^ v[2] ^ v[3];
+}
+
+// A fresh key per cache; the clock stands in only if urandom is unreadable
+static void draw_key(obi_topology_context_t *ctx) {
+    int fd = open("/dev/urandom", O_RDONLY);
+    bool drawn = fd >= 0 && read(fd, ctx->hub_key, sizeof(ctx->hub_key)) == (ssize_t)sizeof(ctx->hub_key);
+    if (fd >= 0) {
+        close(fd);
+    }
+    if (!drawn) {
+        uint64_t seed = obi_topology_now_ns() ^ (uintptr_t)ctx;
+        ctx->hub_key[0] = obi_partition_hash(seed);
+        ctx->hub_key[1] = obi_partition_hash(seed + 1);
+    }
+}
+
+// Two ways per bucket, newest first, so two payloads that share a bucket
+// both stay cached
+#define CACHE_WAYS 2
+
+static obi_hub_verdict_t *cache_bucket(obi_topology_context_t *ctx, uint64_t hash) {
+    return &ctx->hub_cache[((uint32_t)(hash ^ (hash >> 32)) & ctx->hub_cache_mask) * CACHE_WAYS];
+}
+
+static const obi_hub_verdict_t *cache_find(obi_topology_context_t *ctx, uint64_t hash, uint32_t length) {
+    const obi_hub_verdict_t *bucket = cache_bucket(ctx, hash);
+    for (int way = 0; way < CACHE_WAYS; way++) {
+        if (bucket[way].verdict && bucket[way].hash == hash && bucket[way].length == length) {
+            return &bucket[way];
+        }
+    }
+    return NULL;
+}
+
+static void cache_insert(obi_topology_context_t *ctx, uint64_t hash, uint32_t length, bool accepted) {
+    obi_hub_verdict_t *bucket = cache_bucket(ctx, hash);
+    memmove(&bucket[1], &bucket[0], (CACHE_WAYS - 1) * sizeof(*bucket));
+    bucket[0] = (obi_hub_verdict_t){ hash, length, accepted ? 2 : 1 };
+}
+
+// Runs the validator over frames not yet checked and removes the rejected ones
+static void batch_validate(obi_topology_context_t *ctx, obi_hub_batch_t *batch) {
+    const obi_hub_config_t *config = &ctx->hub_config;
+    if (!config->validate || batch->checked == batch->count) {
+        batch->checked = batch->count;
+        return;
+    }
+
+    // verdicts[i] covers frame checked + i; misses go to the validator together
+    bool *verdicts = ctx->hub_verdicts;
+    uint32_t misses = 0;
+    uint32_t hits = 0;
+    for (uint32_t i = batch->checked; i < batch->count; i++) {
+        const uint8_t *payload = batch->payloads[i];
+        uint32_t length = batch->frames[i].length;
+        if (ctx->hub_cache) {
+            uint64_t hash = cache_hash(ctx->hub_key, payload, length);
+            const obi_hub_verdict_t *entry = cache_find(ctx, hash, length);
+            if (entry) {
+                verdicts[i - batch->checked] = entry->verdict == 2;
+                hits++;
+                continue;
+            }
+        }
+        ctx->hub_misses[misses] = i;
+        ctx->hub_messages[misses] = (obi_buffer_t){ (uint8_t *)payload, length, length };
+        misses++;
+    }
+
+    if (misses) {
+        bool *results = verdicts + (batch->count - batch->checked);
+        for (uint32_t m = 0; m < misses; m++) {
+            results[m] = false;
+        }
+        config->validate(config->validate_user, ctx->hub_messages, misses, results);
+        for (uint32_t m = 0; m < misses; m++) {
+            uint32_t i = ctx->hub_misses[m];
+            verdicts[i - batch->checked] = results[m];
+            if (ctx->hub_cache) {
+                uint32_t length = batch->frames[i].length;
+                uint64_t hash = cache_hash(ctx->hub_key, batch->payloads[i], length);
+                cache_insert(ctx, hash, length, results[m]);
+            }
+        }
+    }
+    atomic_fetch_add_explicit(&ctx->hub_validated, misses, memory_order_relaxed);
+    atomic_fetch_add_explicit(&ctx->hub_cache_hits, hits, memory_order_relaxed);
+
+    // Survivors close ranks; their payload slots stay where they are
+    uint32_t kept = batch->checked;
+    for (uint32_t i = batch->checked; i < batch->count; i++) {
+        if (!verdicts[i - batch->checked]) {
+            continue;
+        }
+        batch->frames[kept] = batch->frames[i];
+        batch->payloads[kept] = batch->payloads[i];
+        kept++;
+    }
+    atomic_fetch_add_explicit(&ctx->hub_rejected, batch->count - kept, memory_order_relaxed);
+    batch->count = kept;
+    batch->checked = kept;
+}
+
+static size_t batch_send(obi_topology_context_t *ctx, obi_topology_node_t *node, const obi_hub_batch_t *batch,
+                         size_t count) {
+    const obi_topology_transport_ops_t *ops = ctx->transport->ops;
+    const obi_topology_frame_t *frames = &batch->frames[batch->first];
+    const uint8_t *const *payloads = &batch->payloads[batch->first];
+    size_t sent = 0;
+    obi_topology_lock_transport(ctx);
+    if (ops->send_vector) {
+        sent = ops->send_vector(ctx->transport, node->handle, frames, payloads, count);
+    } else {
+        while (sent < count && ops->send(ctx->transport, node->handle, &frames[sent], payloads[sent]) == OBI_SUCCESS) {
+            sent++;
+        }
+    }
+    obi_topology_unlock_transport(ctx);
+    return sent;
+}
+
+// Validates and sends what the batch holds; returns how many frames remain
+static uint32_t batch_flush(obi_topology_context_t *ctx, obi_node_id_t destination, obi_hub_batch_t *batch,
+                            uint64_t now) {
+    batch_validate(ctx, batch);
+    if (batch->first == batch->count) {
+        batch_reset(ctx, batch);
+        return 0;
+    }
+
+    unsigned slot;
+    const obi_route_table_t *routes = obi_route_acquire(&ctx->routes, &slot);
+    obi_node_id_t hop = obi_route_next_hop(routes, ctx->local_id, destination);
+    obi_topology_type_t type = routes->type;
+    obi_route_release(&ctx->routes, slot);
+    obi_topology_node_t *node = hop == OBI_NODE_INVALID || hop == ctx->local_id ? NULL : &ctx->nodes[hop];
+    if (!node || obi_topology_connect_node(ctx, node) != OBI_SUCCESS) {
+        batch_drop(ctx, batch);
+        return 0;
+    }
+
+    size_t pending = batch->count - batch->first;
+    uint64_t started = obi_topology_now_ns();
+    size_t sent = batch_send(ctx, node, batch, pending);
+    uint64_t latency = obi_topology_now_ns() - started;
+
+    // Each frame is charged its share of the vectored send
+    if (sent) {
+        uint64_t share = latency / sent;
+        for (size_t i = 0; i < sent; i++) {
+            obi_link_stats_record(&node->link, share, true);
+            obi_latency_histogram_record(&ctx->nodes[destination].latency, share);
+            obi_latency_histogram_record(&ctx->type_latency[type], share);
+        }
+        atomic_fetch_add_explicit(&ctx->relayed_frames, sent, memory_order_relaxed);
+        atomic_fetch_add_explicit(&ctx->hub_batched_frames, sent, memory_order_relaxed);
+        atomic_fetch_add_explicit(&ctx->hub_batches_sent, 1, memory_order_relaxed);
+        ctx->relay_unflushed = true;
+    }
+    if (sent < pending) {
+        obi_link_stats_record(&node->link, latency, false);
+    }
+
+    batch->first += (uint32_t)sent;
+    if (batch->first == batch->count) {
+        batch_reset(ctx, batch);
+        return 0;
+    }
+
+    // A hop that takes nothing for a whole stall period costs the batch
+    if (sent) {
+        batch->stalled_ns = 0;
+    } else if (batch->stalled_ns == 0) {
+        batch->stalled_ns = now;
+    } else if (now - batch->stalled_ns >= OBI_RELAY_STALL_NS) {
+        batch_drop(ctx, batch);
+        return 0;
+    }
+    return batch->count - batch->first;
+}
+
+static void flush_due(obi_topology_context_t *ctx, uint64_t now, bool all) {
+    ctx->hub_due_ns = 0;
+    for (uint32_t i = 0; i < ctx->graph.node_count && ctx->hub_pending; i++) {
+        obi_hub_batch_t *batch = &ctx->hub_batches[i];
+        if (batch->count == 0) {
+            continue;
+        }
+        if (all || now >= batch->oldest_ns + (uint64_t)ctx->hub_config.max_delay_us * 1000ull) {
+            batch_flush(ctx, (obi_node_id_t)i, batch, now);
+        }
+        if (batch->count) {
+            note_due(ctx, batch->oldest_ns + (uint64_t)ctx->hub_config.max_delay_us * 1000ull);
+        }
+    }
+}
+
+bool obi_topology_hub_accept(obi_topology_context_t *ctx, obi_node_id_t destination,
+                             const obi_topology_frame_t *frame, const uint8_t *payload, obi_result_t *result) {
+    if (!hub_active(ctx)) {
+        return false;
+    }
+    uint64_t now = obi_topology_now_ns();
+    if (ctx->hub_due_ns && now >= ctx->hub_due_ns) {
+        flush_due(ctx, now, false);
+    }
+
+    // Batches were sized for the transport in place when they were filled
+    if (ctx->hub_payload != ctx->transport->max_frame_payload) {
+        obi_topology_hub_flush(ctx);
+        for (uint32_t i = 0; i < OBI_TOPOLOGY_MAX_NODES; i++) {
+            batch_free(&ctx->hub_batches[i]);
+        }
+        ctx->hub_pending = 0;
+        ctx->hub_payload = ctx->transport->max_frame_payload;
+    }
+
+    // Anything else for the destination must not overtake its batched frames
+    obi_hub_batch_t *batch = &ctx->hub_batches[destination];
+    if (frame->type != OBI_FRAME_DATA || frame->length > ctx->hub_payload) {
+        if (batch->count && batch_flush(ctx, destination, batch, now)) {
+            *result = OBI_ERROR_WOULD_BLOCK;
+            return true;
+        }
+        return false;
+    }
+
+    if (batch->used == ctx->hub_config.max_batch && batch_flush(ctx, destination, batch, now)) {
+        *result = OBI_ERROR_WOULD_BLOCK;
+        return true;
+    }
+    if (!batch->data && !batch_alloc(ctx, batch)) {
+        return false;
+    }
+
+    uint8_t *copy = batch->data + (size_t)batch->used++ * ctx->hub_payload;
+    memcpy(copy, payload, frame->length);
+    batch->frames[batch->count] = *frame;
+    batch->payloads[batch->count] = copy;
+    if (batch->count++ == 0) {
+        ctx->hub_pending++;
+        batch->oldest_ns = now;
+        note_due(ctx, now + (uint64_t)ctx->hub_config.max_delay_us * 1000ull);
+    }
+    if (batch->used == ctx->hub_config.max_batch) {
+        batch_flush(ctx, destination, batch, now);
+    }
+    *result = OBI_SUCCESS;
+    return true;
+}
+
+// The inbound queue ran dry: whatever has been collected leaves now
+void obi_topology_hub_flush(obi_topology_context_t *ctx) {
+    if (ctx->hub_batches && ctx->hub_pending) {
+        flush_due(ctx, obi_topology_now_ns(), true);
+    }
+}
+
+void obi_topology_hub_release(obi_topology_context_t *ctx) {
+    if (ctx->hub_batches) {
+        for (uint32_t i = 0; i < OBI_TOPOLOGY_MAX_NODES; i++) {
+            batch_free(&ctx->hub_batches[i]);
+        }
+    }
+    free(ctx->hub_batches);
+    free(ctx->hub_cache);
+    free(ctx->hub_messages);
+    free(ctx->hub_verdicts);
+    free(ctx->hub_misses);
+    ctx->hub_batches = NULL;
+    ctx->hub_cache = NULL;
+    ctx->hub_messages = NULL;
+    ctx->hub_verdicts = NULL;
+    ctx->hub_misses = NULL;
+    ctx->hub_cache_mask = 0;
+    ctx->hub_pending = 0;
+    ctx->hub_due_ns = 0;
+}
+
+obi_topology_result_t obi_topology_set_hub_aggregation(obi_topology_context_t *ctx, const obi_hub_config_t *config) {
+    obi_hub_config_t defaults = { OBI_HUB_DEFAULT_BATCH, OBI_HUB_DEFAULT_DELAY_US, NULL, NULL,
+                                  OBI_HUB_DEFAULT_CACHE };
+    if (!config) {
+        config = &defaults;
+    }
+    if (!ctx || !ctx->active || config->max_batch > OBI_HUB_MAX_BATCH || config->cache_entries > OBI_HUB_MAX_CACHE) {
+        return OBI_TOPOLOGY_ERROR_INVALID_CONFIG;
+    }
+
+    // Frames already collected leave under the old settings and validator
+    obi_topology_hub_flush(ctx);
+    obi_topology_hub_release(ctx);
+    ctx->hub_config = *config;
+    if (config->max_batch == 0) {
+        return OBI_TOPOLOGY_SUCCESS;
+    }
+
+    uint32_t cache = 0;
+    if (config->validate && config->cache_entries) {
+        cache = CACHE_WAYS;
+        while (cache < config->cache_entries) {
+            cache <<= 1;
+        }
+    }
+    ctx->hub_batches = calloc(OBI_TOPOLOGY_MAX_NODES, sizeof(*ctx->hub_batches));
+    ctx->hub_messages = malloc(config->max_batch * sizeof(*ctx->hub_messages));
+    ctx->hub_verdicts = malloc(2 * config->max_batch * sizeof(*ctx->hub_verdicts));
+    ctx->hub_misses = malloc(config->max_batch * sizeof(*ctx->hub_misses));
+    ctx->hub_cache = cache ? calloc(cache, sizeof(*ctx->hub_cache)) : NULL;
+    if (!ctx->hub_batches || !ctx->hub_messages || !ctx->hub_verdicts || !ctx->hub_misses || (cache && !ctx->hub_cache)) {
+        obi_topology_hub_release(ctx);
+        ctx->hub_config.max_batch = 0;
+        return OBI_TOPOLOGY_ERROR_INVALID_CONFIG;
+    }
+    ctx->hub_cache_mask = cache ? cache / CACHE_WAYS - 1 : 0;
+    if (cache) {
+        draw_key(ctx);
+    }
+    ctx->hub_payload = ctx->transport->max_frame_payload;
+    return OBI_TOPOLOGY_SUCCESS;
+}
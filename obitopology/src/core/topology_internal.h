@@ -0,0 +1,541 @@
+/*
+ * OBI Topology Internal Definitions
+ * Context layout shared by the topology core translation units
+ */
+
+#ifndef OBITOPOLOGY_INTERNAL_H
+#define OBITOPOLOGY_INTERNAL_H
+
+#include "obitopology.h"
+#include <stdatomic.h>
+#include <sys/socket.h>
+
+// Cost function inputs and weights (each term is normalised to [0, 1))
+#define OBI_COST_LATENCY_REF_NS 100000   // send latency scoring 0.5
+#define OBI_COST_QUEUE_REF      32       // queued frames scoring 0.5
+#define OBI_COST_WEIGHT_LATENCY 0.4
+#define OBI_COST_WEIGHT_QUEUE   0.3
+#define OBI_COST_WEIGHT_DROPS   0.3
+#define OBI_COST_EWMA_SHIFT     3        // latency EWMA alpha = 1/8
+#define OBI_COST_DROP_ALPHA     0.25     // drop-rate EWMA across snapshots
+
+// Governance re-evaluates the cost function at most this often from the send path
+#define OBI_GOVERNANCE_INTERVAL_NS 10000000ull
+
+// Transit frames a relay cannot pass on for this long are dropped, so a dead
+// hop cannot wedge the relay
+#define OBI_RELAY_STALL_NS 100000000ull
+
+// Per-link measurements - the data path only does atomic adds and one CAS;
+// the snapshot fields are owned by the metrics reader
+typedef struct {
+    _Atomic uint64_t latency_ewma_ns;
+    _Atomic uint64_t sent;
+    _Atomic uint64_t dropped;
+    uint64_t snapshot_sent;
+    uint64_t snapshot_dropped;
+    double drop_rate;
+} obi_link_stats_t;
+
+// Log-bucketed (HDR style) latency histogram: values below OBI_HISTOGRAM_SUB_BUCKETS ns
+// are exact, and every power of two above splits into that many linear buckets
+#define OBI_HISTOGRAM_SUB_BITS    4
+#define OBI_HISTOGRAM_SUB_BUCKETS (1u << OBI_HISTOGRAM_SUB_BITS)
+#define OBI_HISTOGRAM_MAGNITUDES  41      // top bucket starts near 2^44 ns (~4.9 hours)
+#define OBI_HISTOGRAM_BUCKETS     (OBI_HISTOGRAM_SUB_BUCKETS * OBI_HISTOGRAM_MAGNITUDES)
+
+typedef struct {
+    _Atomic uint64_t counts[OBI_HISTOGRAM_BUCKETS];
+    _Atomic uint64_t max_ns;
+} obi_latency_histogram_t;
+
+// Generic cell rate algorithm: a send conforms while tat <= now + tolerance and
+// then pushes tat one interval on. Equivalent to a token bucket of
+// tolerance / interval + 1 tokens refilled every interval, with no refill step
+typedef struct {
+    _Atomic uint64_t tat_ns;                  // theoretical arrival time of the next send
+    _Atomic uint64_t interval_ns;             // 0 = unlimited
+    _Atomic uint64_t tolerance_ns;            // burst allowance
+} obi_rate_limiter_t;
+
+// Frame held by the reorder ring until its predecessors are delivered
+typedef struct {
+    obi_topology_frame_t frame;
+    uint8_t *payload;                         // order_payload bytes inside the ring's block
+    bool present;
+} obi_order_entry_t;
+
+// Known node - transport handle resolved once, on first use
+typedef struct {
+    char name[OBI_TRANSPORT_MAX_ADDRESS];
+    char address[OBI_TRANSPORT_MAX_ADDRESS];
+    uint32_t key;             // FNV-1a of name, carried in frame headers
+    void *_Atomic handle;     // set once under connect_lock, then read lock-free
+    obi_link_stats_t link;    // outbound link to this node
+    obi_latency_histogram_t latency;          // data sends with this node as final destination
+
+    obi_rate_limiter_t rate;                  // sends with this node as final destination
+
+    // Failure detector - written by the receive path, read by poll
+    _Atomic uint64_t last_heard_ns;           // 0 until the first frame arrives
+    _Atomic uint64_t mean_interval_ns;        // EWMA of frame inter-arrival times
+    bool failed;
+    uint64_t failed_at_ns;
+
+    // Gossip membership - owned by the thread that polls and receives
+    uint8_t member_status;                    // obi_member_status_t
+    uint32_t incarnation;                     // highest incarnation heard for the node
+    uint32_t gossip_transmits;                // piggybacks left for its latest update
+    uint64_t suspect_since_ns;
+
+    // Flow control - wrapping frame counts; credit left is
+    // window - (sent - acked - returned). Each reservation takes the next
+    // count as its mark and its frame carries it; the receiver reports the
+    // highest mark it has read, so a lost frame is covered by any later one
+    _Atomic uint32_t credit_sent;             // reservations made towards the node, never taken back
+    _Atomic uint32_t credit_marked;           // highest mark sent or cancelled; CREDIT frames carry it
+    _Atomic uint64_t credit_returned;         // highest cancelled mark << 32 | cancellations not yet reported
+    _Atomic uint32_t credit_acked;            // the node's highest mark read, as last reported
+    _Atomic uint32_t credit_seen;             // highest mark read from the node
+    _Atomic uint32_t granted;                 // credit_seen last reported back
+    _Atomic uint64_t credit_stalled_ns;       // out of credit since (or last probed), 0 = not stalled
+
+    // Ordering - senders stamp send_sequence; the rest belongs to the receiving thread
+    _Atomic uint32_t send_sequence;           // last sequence stamped towards the node
+    uint32_t order_expected;                  // next sequence to deliver from the node, 0 = unsynced
+    uint32_t order_held;                      // early frames waiting in order_ring
+    uint64_t order_stalled_ns;                // when delivery began waiting on the missing head
+    obi_order_entry_t *order_ring;            // order_window entries, allocated on first hold
+
+    // Coalescing - small sends wait here for one batch frame (guarded by coalesce_lock)
+    atomic_flag coalesce_lock;
+    uint8_t *coalesce;                        // allocated on first use
+    uint32_t coalesce_capacity;
+    uint32_t coalesce_used;
+    uint32_t coalesce_count;
+    uint32_t coalesce_mark;                   // highest credit mark among the queued records
+    uint64_t coalesce_deadline_ns;
+} obi_topology_node_t;
+
+// Progress of one fragmented send. A sender that must not block keeps it
+// across attempts, so a train stopped by a full ring resumes where it stopped
+typedef struct {
+    uint32_t train_id;
+    uint32_t message_id;
+    uint32_t offset;                          // payload bytes sent; 0 = not started
+    uint32_t credit_mark;                     // the message's one reservation, carried by every fragment
+    uint64_t stalled_ns;                      // first attempt that made no progress; 0 = moving
+} obi_fragment_train_t;
+
+// Queued asynchronous send; next links the destination queue or the free list
+typedef struct {
+    obi_send_callback_t callback;
+    void *user;
+    uint8_t *data;                            // grown to the largest payload the slot has held
+    size_t capacity;
+    size_t size;
+    uint32_t next;
+    uint32_t generation;                      // upper handle bits, so stale handles never repeat
+    uint8_t priority;
+    uint8_t traffic_class;
+    bool admitted;                            // passed admission; retries skip it
+    obi_fragment_train_t train;               // a payload beyond one frame, part sent
+} obi_async_request_t;
+
+// One destination's async queues and its scheduler state; only the event
+// loop touches the scheduler fields
+typedef struct {
+    uint32_t head[OBI_CLASS_COUNT];
+    uint32_t tail[OBI_CLASS_COUNT];
+    uint64_t deficit[OBI_CLASS_COUNT];        // bytes a weighted class may still send this round
+    uint8_t turn;                             // weighted class holding the round-robin turn
+    bool granted;                             // turn already earned its quantum
+    uint32_t strict_run;                      // strict sends since a weighted one
+} obi_async_queue_t;
+
+// Hub batch for one destination: frames [first, count) wait to be sent, and
+// those below checked have passed validation. Payloads take slots in data in
+// arrival order, so slots are reused only once the batch empties
+typedef struct {
+    obi_topology_frame_t *frames;
+    const uint8_t **payloads;
+    uint8_t *data;                            // max_batch frame payloads, allocated on first use
+    uint32_t first;
+    uint32_t checked;
+    uint32_t count;
+    uint32_t used;                            // payload slots taken
+    uint64_t oldest_ns;
+    uint64_t stalled_ns;                      // first flush that made no progress; 0 = moving
+} obi_hub_batch_t;
+
+// Cached validator verdict; a hit needs the same length and keyed hash
+typedef struct {
+    uint64_t hash;
+    uint32_t length;
+    uint8_t verdict;                          // 0 = empty, 1 = refused, 2 = accepted
+} obi_hub_verdict_t;
+
+// Reassembly slot; fragments are copied straight to their offset in data
+typedef enum {
+    OBI_REASSEMBLY_FREE = 0,
+    OBI_REASSEMBLY_FILLING,
+    OBI_REASSEMBLY_READY,                     // complete, waiting for a receive call
+    OBI_REASSEMBLY_LENT                       // returned as a view until the next receive call
+} obi_reassembly_state_t;
+
+typedef struct {
+    uint8_t *data;                            // max_message bytes, allocated by obi_topology_set_reassembly
+    uint8_t state;                            // obi_reassembly_state_t
+    uint32_t source;
+    uint32_t message_id;                      // the sender's fragment train id
+    uint32_t origin;                          // duplicate suppression identity, from the first fragment
+    uint32_t origin_message_id;
+    uint32_t total;
+    uint32_t received;
+    uint64_t started_ns;
+} obi_reassembly_slot_t;
+
+// Staged send pipeline, private to topology_pipeline.c
+typedef struct obi_topology_pipeline obi_topology_pipeline_t;
+
+// Node key -> id index; twice the node limit keeps probe runs short
+#define OBI_NODE_REGISTRY_SLOTS (OBI_TOPOLOGY_MAX_NODES * 2)
+
+// Inserts happen under the context's graph_lock; lookups are lock-free, since a
+// key is published only after its id and node entry are in place
+typedef struct {
+    _Atomic uint32_t keys[OBI_NODE_REGISTRY_SLOTS];  // 0 = empty slot
+    obi_node_id_t ids[OBI_NODE_REGISTRY_SLOTS];
+} obi_node_registry_t;
+
+void obi_node_registry_reset(obi_node_registry_t *registry);
+obi_node_id_t obi_node_registry_find(const obi_node_registry_t *registry, uint32_t key);
+bool obi_node_registry_insert(obi_node_registry_t *registry, uint32_t key, obi_node_id_t id);
+
+// Parsed "unix:", "udp:" or "tcp:" address shared by the socket backends
+typedef struct {
+    struct sockaddr_storage addr;
+    socklen_t addr_len;
+    int type;                 // SOCK_DGRAM or SOCK_STREAM
+} obi_topology_socket_address_t;
+
+bool obi_topology_parse_socket_address(const char *address, obi_topology_socket_address_t *out);
+
+// Published route table. Readers pin an epoch slot around each lookup; the
+// writer swaps the pointer and waits out both slots before freeing the old table
+typedef struct {
+    obi_route_table_t *_Atomic current;
+    atomic_uint epoch;
+    atomic_uint readers[2];
+} obi_route_handle_t;
+
+static inline const obi_route_table_t *obi_route_acquire(obi_route_handle_t *handle, unsigned *slot) {
+    *slot = atomic_load(&handle->epoch) & 1u;
+    atomic_fetch_add(&handle->readers[*slot], 1);
+    return atomic_load(&handle->current);
+}
+
+static inline void obi_route_release(obi_route_handle_t *handle, unsigned slot) {
+    atomic_fetch_sub_explicit(&handle->readers[slot], 1, memory_order_release);
+}
+
+struct obi_topology_context {
+    obi_topology_type_t network_type;
+    obi_topology_metrics_t current_metrics;
+    bool active;
+
+    // Transport state. Ops on a transport that is not concurrent run under
+    // transport_lock, since the event loop and pipeline threads share it
+    obi_topology_transport_t *transport;
+    atomic_flag transport_lock;
+    atomic_flag connect_lock;
+    obi_node_id_t local_id;
+    uint32_t local_key;       // 0 until bound
+
+    // Node graph and the next-hop table derived from it. Registration, graph
+    // changes and route publication hold graph_lock; senders read routes lock-free
+    obi_topology_node_t nodes[OBI_TOPOLOGY_MAX_NODES];
+    obi_node_registry_t registry;
+    obi_route_graph_t graph;
+    obi_route_handle_t routes;
+    atomic_flag graph_lock;
+
+    // Governance - the send path reads the zone lock-free; whichever caller
+    // wins metrics_lock refreshes the snapshot and runs the zone machine
+    _Atomic int zone;
+    _Atomic uint64_t shed_messages;
+    _Atomic uint64_t metrics_refreshed_ns;
+    atomic_flag metrics_lock;
+
+    // Rate limits (topology_rate.c); per-destination limiters live on the nodes
+    obi_rate_limiter_t tenant_rate[OBI_RATE_MAX_TENANTS];
+    _Atomic uint64_t rate_limited;
+
+    // Send latency per topology type; per-destination histograms live on the nodes
+    obi_latency_histogram_t type_latency[OBI_TOPOLOGY_HYBRID + 1];
+
+    // Heartbeats and failover (topology_failover.c)
+    uint64_t heartbeat_interval_ns;           // 0 = heartbeats disabled
+    double phi_threshold;
+    uint64_t next_heartbeat_ns;
+    bool reconverge_pending;                  // failover table awaits a full route update
+    _Atomic uint64_t failovers;
+
+    // Gossip membership (topology_gossip.c) - one probe in flight per period
+    uint64_t gossip_interval_ns;              // 0 = gossip disabled
+    uint32_t gossip_indirect;
+    uint32_t gossip_suspicion;
+    uint32_t incarnation;                     // local node's own incarnation
+    uint32_t self_transmits;                  // piggybacks left for the local node's refutation
+    uint64_t gossip_random;
+    uint64_t probe_started_ns;                // 0 = no probe in flight
+    uint32_t probe_sequence;
+    obi_node_id_t probe_target;
+    bool probe_acked;
+    bool probe_escalated;                     // indirect probes sent for this period
+    obi_node_id_t probe_order[OBI_TOPOLOGY_MAX_NODES];
+    uint32_t probe_count;
+    uint32_t probe_next;
+    _Atomic uint64_t gossip_frames;
+
+    // Flow control (topology_flow.c)
+    uint32_t credit_window;                   // 0 = flow control disabled
+    uint64_t credit_block_ns;
+    uint64_t credit_probe_ns;
+    _Atomic uint64_t busy_sends;
+    _Atomic uint64_t credit_probes;
+
+    // Coalescing (topology_coalesce.c); the rx_ fields are the receive path's
+    // staging area, holding the unread rest of a batch frame
+    uint32_t coalesce_max_message;            // 0 = coalescing disabled
+    uint64_t coalesce_deadline_ns;
+    _Atomic uint64_t coalesce_due_ns;         // earliest pending batch deadline, 0 = none
+    atomic_flag coalesce_flush_lock;
+    _Atomic uint64_t coalesced_messages;
+    _Atomic uint64_t coalesced_batches;
+    uint8_t *rx_batch;
+    uint32_t rx_batch_capacity;
+    uint32_t rx_batch_length;
+    uint32_t rx_batch_offset;
+    uint32_t rx_batch_source;
+    uint32_t rx_batch_origin;
+    uint32_t rx_batch_message_id;             // next record's id, 0 = the batch carries none
+
+    // Asynchronous sends (topology_async.c) - submitters and the event loop share
+    // the queues under async_lock; callbacks and sends run outside it
+    obi_async_request_t *async_requests;      // OBI_ASYNC_MAX_INFLIGHT slots, allocated on first use
+    uint32_t async_free;                      // free-list head
+    obi_async_queue_t async_queues[OBI_TOPOLOGY_MAX_NODES];
+    uint16_t class_weights[OBI_CLASS_COUNT];
+    uint32_t class_strict_burst;
+    _Atomic uint64_t class_sent[OBI_CLASS_COUNT];
+    _Atomic uint64_t starvation_breaks;
+    _Atomic uint32_t async_pending;
+    atomic_flag async_lock;
+    obi_receive_callback_t receive_callback;
+    void *receive_user;
+
+    // Receive area behind obi_topology_receive_view, one frame payload
+    uint8_t *receive_area;
+    size_t receive_capacity;
+
+    // Event loop descriptors, valid once events_ready
+    bool events_ready;
+    int epoll_fd;
+    int timer_fd;                             // retry tick for work no descriptor signals
+    int wake_fd;                              // eventfd written by submitters while the loop sleeps
+    int events_transport_fd;                  // transport descriptor registered, -1 = none
+    bool tick_armed;
+    _Atomic bool events_sleeping;
+
+    // Duplicate suppression (topology_dedup.c) - owned by the receiving thread;
+    // two filter generations, the older one cleared as each window starts
+    uint32_t *dedup_slots;                    // 2 x dedup_buckets x 4 fingerprints, NULL = disabled
+    uint32_t dedup_buckets;                   // per generation, a power of two
+    uint32_t dedup_current;                   // generation taking inserts
+    uint64_t dedup_window_ns;
+    uint64_t dedup_rotated_ns;
+    uint32_t rx_origin;                       // identity of the message being delivered,
+    uint32_t rx_message_id;                   // which obi_topology_forward keeps (0 = none)
+    _Atomic uint32_t message_ids;             // last id given to a message this node originated
+    _Atomic uint64_t duplicates_dropped;
+    _Atomic uint64_t dedup_overflows;
+
+    // In-order delivery (topology_order.c) - owned by the receiving thread. A frame
+    // a whole window ahead is parked while the window moves up to it
+    uint32_t order_window;                    // power of two; 0 = reordering disabled
+    uint64_t order_timeout_ns;
+    size_t order_payload;                     // frame payload limit when the rings were sized
+    uint32_t order_holding;                   // held frames across every source
+    bool order_parked;
+    obi_node_id_t order_parked_node;
+    obi_topology_frame_t order_parked_frame;
+    uint8_t *order_parked_payload;
+    _Atomic uint64_t reordered_frames;
+    _Atomic uint64_t sequence_gaps;
+    _Atomic uint64_t reorder_timeouts;
+    _Atomic uint64_t late_frames;
+
+    // Relaying (topology_relay.c) - owned by the receiving thread. A transit
+    // frame the next hop refused waits here and holds back every frame behind it
+    bool relay_pending;
+    obi_node_id_t relay_destination;
+    obi_topology_frame_t relay_frame;
+    uint8_t *relay_payload;                   // one frame payload, allocated on first hold
+    uint64_t relay_held_ns;
+    bool relay_unflushed;                     // forwarded since the last transport flush
+    _Atomic uint64_t relayed_frames;
+    _Atomic uint64_t relay_stalls;
+    _Atomic uint64_t relay_drops;
+
+    // Hub aggregation (topology_hub.c) - owned by the receiving thread
+    obi_hub_config_t hub_config;
+    obi_hub_batch_t *hub_batches;             // one per node slot; NULL = aggregation off
+    size_t hub_payload;                       // frame payload limit the batches were sized for
+    uint32_t hub_pending;                     // destinations with frames waiting
+    uint64_t hub_due_ns;                      // earliest batch deadline; 0 = none
+    obi_hub_verdict_t *hub_cache;
+    uint32_t hub_cache_mask;                  // buckets - 1; each bucket holds two verdicts
+    uint64_t hub_key[2];                      // SipHash key, drawn whenever the cache is allocated
+    obi_buffer_t *hub_messages;               // validator arguments, max_batch each
+    bool *hub_verdicts;
+    uint32_t *hub_misses;
+    _Atomic uint64_t hub_batches_sent;
+    _Atomic uint64_t hub_batched_frames;
+    _Atomic uint64_t hub_validated;
+    _Atomic uint64_t hub_cache_hits;
+    _Atomic uint64_t hub_rejected;
+
+    // Fragmentation (topology_fragment.c) - slots are owned by the receiving
+    // thread; at most one is READY, since it is delivered before more frames are read
+    _Atomic uint32_t fragment_next_id;
+    obi_reassembly_slot_t *reassembly;        // NULL = reassembly disabled
+    uint32_t reassembly_slots;
+    uint32_t reassembly_max_message;
+    uint64_t reassembly_timeout_ns;
+    int32_t reassembly_ready;                 // READY slot index, -1 = none
+    _Atomic uint64_t fragmented_messages;
+    _Atomic uint64_t reassembled_messages;
+    _Atomic uint64_t reassembly_timeouts;
+    _Atomic uint64_t reassembly_drops;
+
+    // Staged send pipeline (topology_pipeline.c), NULL unless started
+    obi_topology_pipeline_t *pipeline;
+};
+
+uint32_t obi_topology_name_key(const char *name);
+uint64_t obi_topology_now_ns(void);
+
+// Live metrics (topology_metrics.c)
+void obi_link_stats_record(obi_link_stats_t *link, uint64_t latency_ns, bool delivered);
+void obi_latency_histogram_record(obi_latency_histogram_t *histogram, uint64_t latency_ns);
+void obi_latency_histogram_summarize(const obi_latency_histogram_t *histogram, obi_latency_summary_t *summary);
+void obi_topology_refresh_metrics(obi_topology_context_t *ctx);
+
+// Shared core helpers (topology_core.c)
+void obi_topology_lock_graph(obi_topology_context_t *ctx);
+void obi_topology_unlock_graph(obi_topology_context_t *ctx);
+void obi_topology_lock_transport(obi_topology_context_t *ctx);
+void obi_topology_unlock_transport(obi_topology_context_t *ctx);
+obi_result_t obi_topology_transport_flush(obi_topology_context_t *ctx);
+void obi_topology_publish_routes(obi_route_handle_t *handle, obi_route_table_t *table);
+obi_topology_result_t obi_topology_rebuild_routes(obi_topology_context_t *ctx);
+obi_result_t obi_topology_connect_node(obi_topology_context_t *ctx, obi_topology_node_t *node);
+void obi_topology_disconnect_node(obi_topology_context_t *ctx, obi_topology_node_t *node);
+obi_result_t obi_topology_forward_frame(obi_topology_context_t *ctx, const obi_route_table_t *routes,
+                                        obi_node_id_t destination, const obi_topology_frame_t *frame,
+                                        const uint8_t *payload);
+obi_result_t obi_topology_send_admitted(obi_topology_context_t *ctx, const obi_buffer_t *buffer,
+                                        obi_node_id_t destination, uint64_t now, bool block,
+                                        obi_fragment_train_t *train);
+obi_result_t obi_topology_send_credit(obi_topology_context_t *ctx, obi_node_id_t id, uint16_t flags);
+void obi_topology_grant_credit(obi_topology_context_t *ctx, uint32_t source_key, bool requested);
+
+// Rate limits (topology_rate.c)
+bool obi_topology_rate_admit(obi_topology_context_t *ctx, obi_rate_limiter_t *limiter,
+                             obi_topology_node_t *target, uint64_t now);
+void obi_topology_rate_refund(obi_rate_limiter_t *limiter);
+
+// Failure detection (topology_failover.c)
+void obi_topology_note_heard(obi_topology_context_t *ctx, uint32_t source_key);
+
+// Gossip membership (topology_gossip.c)
+void obi_topology_gossip_tick(obi_topology_context_t *ctx, uint64_t now);
+void obi_topology_gossip_receive(obi_topology_context_t *ctx, const obi_topology_frame_t *frame,
+                                 const uint8_t *payload);
+
+// Flow control (topology_flow.c)
+void obi_topology_flow_reset(obi_topology_node_t *node);
+bool obi_topology_flow_reserve(obi_topology_context_t *ctx, obi_topology_node_t *node, bool block,
+                               uint32_t *mark);
+void obi_topology_flow_cancel(obi_topology_context_t *ctx, obi_topology_node_t *node, uint32_t mark);
+void obi_topology_flow_stamp(obi_topology_context_t *ctx, obi_topology_node_t *node,
+                             obi_topology_frame_t *frame, uint32_t mark);
+void obi_topology_flow_absorb(obi_topology_context_t *ctx, const obi_topology_frame_t *frame);
+bool obi_topology_flow_grant_due(obi_topology_context_t *ctx, obi_topology_node_t *node);
+
+// Coalescing (topology_coalesce.c)
+void obi_topology_coalesce_tick(obi_topology_context_t *ctx, uint64_t now);
+bool obi_topology_coalesce_accepts(const obi_topology_context_t *ctx, size_t size);
+obi_result_t obi_topology_coalesce_send(obi_topology_context_t *ctx, obi_node_id_t id,
+                                        const obi_buffer_t *buffer, uint64_t now, uint32_t mark);
+obi_result_t obi_topology_coalesce_drain(obi_topology_context_t *ctx, obi_node_id_t id);
+uint8_t *obi_topology_coalesce_staging(obi_topology_context_t *ctx, size_t payload);
+void obi_topology_coalesce_hold(obi_topology_context_t *ctx, const obi_topology_frame_t *frame);
+obi_result_t obi_topology_coalesce_stage(obi_topology_context_t *ctx, const obi_topology_frame_t *frame,
+                                         const uint8_t *payload);
+bool obi_topology_coalesce_pending(const obi_topology_context_t *ctx);
+obi_result_t obi_topology_coalesce_next(obi_topology_context_t *ctx, obi_buffer_t *buffer, uint32_t *source);
+void obi_topology_coalesce_release(obi_topology_context_t *ctx);
+
+// Duplicate suppression (topology_dedup.c)
+bool obi_topology_dedup_seen(obi_topology_context_t *ctx, const obi_buffer_t *message);
+uint32_t obi_topology_claim_message_ids(obi_topology_context_t *ctx, uint32_t count);  // first of count
+void obi_topology_dedup_release(obi_topology_context_t *ctx);
+
+// In-order delivery (topology_order.c)
+void obi_topology_order_stamp(obi_topology_node_t *node, obi_topology_frame_t *frame);
+void obi_topology_order_cancel(obi_topology_node_t *node, const obi_topology_frame_t *frame);
+void obi_topology_order_reset(obi_topology_context_t *ctx, obi_topology_node_t *node);
+bool obi_topology_order_accept(obi_topology_context_t *ctx, const obi_topology_frame_t *frame,
+                               const uint8_t *payload);
+bool obi_topology_order_next(obi_topology_context_t *ctx, obi_topology_frame_t *frame, uint8_t *payload);
+void obi_topology_order_release(obi_topology_context_t *ctx);
+
+// Relaying (topology_relay.c)
+void obi_topology_relay_frame(obi_topology_context_t *ctx, obi_node_id_t destination,
+                              const obi_topology_frame_t *frame, const uint8_t *payload);
+bool obi_topology_relay_blocked(obi_topology_context_t *ctx);
+void obi_topology_relay_idle(obi_topology_context_t *ctx);
+void obi_topology_relay_release(obi_topology_context_t *ctx);
+
+// Hub aggregation (topology_hub.c)
+bool obi_topology_hub_accept(obi_topology_context_t *ctx, obi_node_id_t destination,
+                             const obi_topology_frame_t *frame, const uint8_t *payload, obi_result_t *result);
+void obi_topology_hub_flush(obi_topology_context_t *ctx);
+void obi_topology_hub_release(obi_topology_context_t *ctx);
+
+// Fragmentation (topology_fragment.c)
+obi_result_t obi_topology_fragment_send(obi_topology_context_t *ctx, obi_node_id_t destination,
+                                        const obi_buffer_t *buffer, obi_fragment_train_t *train, bool wait);
+void obi_topology_fragment_absorb(obi_topology_context_t *ctx, const obi_topology_frame_t *frame,
+                                  const uint8_t *payload);
+void obi_topology_fragment_reclaim(obi_topology_context_t *ctx);
+obi_result_t obi_topology_fragment_deliver(obi_topology_context_t *ctx, obi_buffer_t *buffer, bool view);
+void obi_topology_fragment_release(obi_topology_context_t *ctx);
+
+// Asynchronous sends (topology_async.c)
+void obi_topology_async_detach(obi_topology_context_t *ctx);
+void obi_topology_async_release(obi_topology_context_t *ctx);
+
+// Send pipeline (topology_pipeline.c)
+void obi_topology_pipeline_release(obi_topology_context_t *ctx);
+
+// Governance (topology_governance.c)
+void obi_topology_governance_reset(obi_topology_context_t *ctx);
+void obi_topology_governance_attach(obi_topology_context_t *ctx);
+void obi_topology_governance_tick(obi_topology_context_t *ctx, uint64_t now);
+void obi_topology_governance_evaluate(obi_topology_context_t *ctx, obi_topology_metrics_t *snapshot);
+bool obi_topology_admit(obi_topology_context_t *ctx, obi_topology_priority_t priority);
+
+#endif /* OBITOPOLOGY_INTERNAL_H */
@@ -0,0 +1,215 @@
+/*
+ * OBI Topology Metrics
+ * Live cost function built from per-link send latency, queue depth and
+ * drop rate, plus send latency histograms for tail percentiles; the data
+ * path records lock-free, readers aggregate on demand
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "topology_internal.h"
+#include <time.h>
+
+uint64_t obi_topology_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+void obi_link_stats_record(obi_link_stats_t *link, uint64_t latency_ns, bool delivered) {
+    if (!delivered) {
+        atomic_fetch_add_explicit(&link->dropped, 1, memory_order_relaxed);
+        return;
+    }
+    atomic_fetch_add_explicit(&link->sent, 1, memory_order_relaxed);
+
+    // EWMA in integer nanoseconds; the first sample seeds the average
+    uint64_t current = atomic_load_explicit(&link->latency_ewma_ns, memory_order_relaxed);
+    uint64_t next;
+    do {
+        if (current == 0) {
+            next = latency_ns ? latency_ns : 1;
+        } else if (latency_ns >= current) {
+            next = current + ((latency_ns - current) >> OBI_COST_EWMA_SHIFT);
+        } else {
+            next = current - ((current - latency_ns) >> OBI_COST_EWMA_SHIFT);
+        }
+    } while (!atomic_compare_exchange_weak_explicit(&link->latency_ewma_ns, &current, next,
+                                                    memory_order_relaxed, memory_order_relaxed));
+}
+
+static uint32_t histogram_bucket(uint64_t value) {
+    if (value < OBI_HISTOGRAM_SUB_BUCKETS) {
+        return (uint32_t)value;
+    }
+    uint32_t magnitude = 63u - (uint32_t)__builtin_clzll(value) - OBI_HISTOGRAM_SUB_BITS + 1;
+    if (magnitude >= OBI_HISTOGRAM_MAGNITUDES) {
+        return OBI_HISTOGRAM_BUCKETS - 1;
+    }
+    uint32_t sub = (uint32_t)(value >> (magnitude - 1)) & (OBI_HISTOGRAM_SUB_BUCKETS - 1);
+    return magnitude * OBI_HISTOGRAM_SUB_BUCKETS + sub;
+}
+
+// Midpoint of a bucket's value range
+static uint64_t histogram_value(uint32_t bucket) {
+    uint32_t magnitude = bucket / OBI_HISTOGRAM_SUB_BUCKETS;
+    uint64_t sub = bucket % OBI_HISTOGRAM_SUB_BUCKETS;
+    if (magnitude == 0) {
+        return sub;
+    }
+    uint64_t width = 1ull << (magnitude - 1);
+    return (OBI_HISTOGRAM_SUB_BUCKETS + sub) * width + width / 2;
+}
+
+void obi_latency_histogram_record(obi_latency_histogram_t *histogram, uint64_t latency_ns) {
+    atomic_fetch_add_explicit(&histogram->counts[histogram_bucket(latency_ns)], 1, memory_order_relaxed);
+
+    uint64_t max = atomic_load_explicit(&histogram->max_ns, memory_order_relaxed);
+    while (latency_ns > max &&
+           !atomic_compare_exchange_weak_explicit(&histogram->max_ns, &max, latency_ns,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+// Counts are read without a pause in recording, so concurrent samples may or may not be included
+void obi_latency_histogram_summarize(const obi_latency_histogram_t *histogram, obi_latency_summary_t *summary) {
+    static const double quantiles[] = { 0.5, 0.99, 0.999 };
+    uint64_t counts[OBI_HISTOGRAM_BUCKETS];
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < OBI_HISTOGRAM_BUCKETS; i++) {
+        counts[i] = atomic_load_explicit(&histogram->counts[i], memory_order_relaxed);
+        total += counts[i];
+    }
+
+    uint64_t max = atomic_load_explicit(&histogram->max_ns, memory_order_relaxed);
+    double values[3] = {0.0, 0.0, 0.0};
+    uint64_t seen = 0;
+    uint32_t bucket = 0;
+    for (int q = 0; q < 3 && total; q++) {
+        // Smallest bucket at which the cumulative count reaches the quantile's rank
+        uint64_t rank = (uint64_t)(quantiles[q] * (double)total + 0.999999);
+        while (bucket < OBI_HISTOGRAM_BUCKETS - 1 && seen + counts[bucket] < rank) {
+            seen += counts[bucket++];
+        }
+        uint64_t value = histogram_value(bucket);
+        values[q] = (double)(value < max ? value : max) / 1000.0;
+    }
+
+    summary->count = total;
+    summary->p50_us = values[0];
+    summary->p99_us = values[1];
+    summary->p999_us = values[2];
+    summary->max_us = (double)max / 1000.0;
+}
+
+obi_topology_result_t obi_topology_get_latency(obi_topology_context_t *ctx, obi_node_id_t destination,
+                                               obi_latency_summary_t *summary) {
+    if (!ctx || !summary || !ctx->active || destination >= ctx->graph.node_count) {
+        return OBI_TOPOLOGY_ERROR_INVALID_CONFIG;
+    }
+    obi_latency_histogram_summarize(&ctx->nodes[destination].latency, summary);
+    return OBI_TOPOLOGY_SUCCESS;
+}
+
+obi_topology_result_t obi_topology_get_type_latency(obi_topology_context_t *ctx, obi_topology_type_t type,
+                                                    obi_latency_summary_t *summary) {
+    if (!ctx || !summary || !ctx->active || (unsigned)type > OBI_TOPOLOGY_HYBRID) {
+        return OBI_TOPOLOGY_ERROR_INVALID_CONFIG;
+    }
+    obi_latency_histogram_summarize(&ctx->type_latency[type], summary);
+    return OBI_TOPOLOGY_SUCCESS;
+}
+
+static double saturate(double value, double reference) {
+    return value / (value + reference);
+}
+
+void obi_topology_refresh_metrics(obi_topology_context_t *ctx) {
+    double latency_ns = 0.0;
+    double queue_depth = 0.0;
+    double drop_rate = 0.0;
+    double cost = 0.0;
+    int links = 0;
+    int active = 0;
+
+    for (uint32_t i = 0; i < ctx->graph.node_count; i++) {
+        obi_topology_node_t *node = &ctx->nodes[i];
+        obi_link_stats_t *link = &node->link;
+
+        if (ctx->graph.active[i]) {
+            active++;
+        }
+
+        // Drop rate over the interval since the last snapshot, smoothed across snapshots
+        uint64_t sent = atomic_load_explicit(&link->sent, memory_order_relaxed);
+        uint64_t dropped = atomic_load_explicit(&link->dropped, memory_order_relaxed);
+        uint64_t interval_sent = sent - link->snapshot_sent;
+        uint64_t interval_dropped = dropped - link->snapshot_dropped;
+        double sample = (interval_sent + interval_dropped) > 0
+            ? (double)interval_dropped / (double)(interval_sent + interval_dropped)
+            : 0.0;
+        link->drop_rate += OBI_COST_DROP_ALPHA * (sample - link->drop_rate);
+        link->snapshot_sent = sent;
+        link->snapshot_dropped = dropped;
+
+        // Links that never carried traffic would dilute the average, and a
+        // failed node's stuck queue says nothing about current load
+        if (sent + dropped == 0 || !ctx->graph.active[i]) {
+            continue;
+        }
+
+        double link_latency = (double)atomic_load_explicit(&link->latency_ewma_ns, memory_order_relaxed);
+        double link_queue = 0.0;
+        void *handle = atomic_load_explicit(&node->handle, memory_order_acquire);
+        if (handle && ctx->transport->ops->queue_depth) {
+            obi_topology_lock_transport(ctx);
+            link_queue = (double)ctx->transport->ops->queue_depth(ctx->transport, handle);
+            obi_topology_unlock_transport(ctx);
+        }
+
+        latency_ns += link_latency;
+        queue_depth += link_queue;
+        drop_rate += link->drop_rate;
+        cost += OBI_COST_WEIGHT_LATENCY * saturate(link_latency, OBI_COST_LATENCY_REF_NS) +
+                OBI_COST_WEIGHT_QUEUE * saturate(link_queue, OBI_COST_QUEUE_REF) +
+                OBI_COST_WEIGHT_DROPS * link->drop_rate;
+        links++;
+    }
+
+    obi_topology_metrics_t *metrics = &ctx->current_metrics;
+    metrics->cost_function = links ? cost / links : 0.0;
+    metrics->latency_us = links ? latency_ns / links / 1000.0 : 0.0;
+    metrics->queue_depth = links ? queue_depth / links : 0.0;
+    metrics->drop_rate = links ? drop_rate / links : 0.0;
+    metrics->active_nodes = active > 0 ? active : 1;  // the local node always counts
+    metrics->failovers = atomic_load_explicit(&ctx->failovers, memory_order_relaxed);
+    metrics->busy_sends = atomic_load_explicit(&ctx->busy_sends, memory_order_relaxed);
+    metrics->coalesced_messages = atomic_load_explicit(&ctx->coalesced_messages, memory_order_relaxed);
+    metrics->coalesced_batches = atomic_load_explicit(&ctx->coalesced_batches, memory_order_relaxed);
+    obi_latency_histogram_summarize(&ctx->type_latency[ctx->network_type], &metrics->send_latency);
+    metrics->gossip_frames = atomic_load_explicit(&ctx->gossip_frames, memory_order_relaxed);
+    metrics->duplicates_dropped = atomic_load_explicit(&ctx->duplicates_dropped, memory_order_relaxed);
+    metrics->dedup_overflows = atomic_load_explicit(&ctx->dedup_overflows, memory_order_relaxed);
+    metrics->fragmented_messages = atomic_load_explicit(&ctx->fragmented_messages, memory_order_relaxed);
+    metrics->reassembled_messages = atomic_load_explicit(&ctx->reassembled_messages, memory_order_relaxed);
+    metrics->reassembly_timeouts = atomic_load_explicit(&ctx->reassembly_timeouts, memory_order_relaxed);
+    metrics->reassembly_drops = atomic_load_explicit(&ctx->reassembly_drops, memory_order_relaxed);
+    metrics->reordered_frames = atomic_load_explicit(&ctx->reordered_frames, memory_order_relaxed);
+    metrics->sequence_gaps = atomic_load_explicit(&ctx->sequence_gaps, memory_order_relaxed);
+    metrics->reorder_timeouts = atomic_load_explicit(&ctx->reorder_timeouts, memory_order_relaxed);
+    metrics->late_frames = atomic_load_explicit(&ctx->late_frames, memory_order_relaxed);
+    metrics->rate_limited = atomic_load_explicit(&ctx->rate_limited, memory_order_relaxed);
+    metrics->relayed_frames = atomic_load_explicit(&ctx->relayed_frames, memory_order_relaxed);
+    metrics->relay_stalls = atomic_load_explicit(&ctx->relay_stalls, memory_order_relaxed);
+    metrics->relay_drops = atomic_load_explicit(&ctx->relay_drops, memory_order_relaxed);
+    metrics->hub_batches = atomic_load_explicit(&ctx->hub_batches_sent, memory_order_relaxed);
+    metrics->hub_batched_frames = atomic_load_explicit(&ctx->hub_batched_frames, memory_order_relaxed);
+    metrics->hub_validated = atomic_load_explicit(&ctx->hub_validated, memory_order_relaxed);
+    metrics->hub_cache_hits = atomic_load_explicit(&ctx->hub_cache_hits, memory_order_relaxed);
+    metrics->hub_rejected = atomic_load_explicit(&ctx->hub_rejected, memory_order_relaxed);
+    for (int c = 0; c < OBI_CLASS_COUNT; c++) {
+        metrics->class_sent[c] = atomic_load_explicit(&ctx->class_sent[c], memory_order_relaxed);
+    }
+    metrics->starvation_breaks = atomic_load_explicit(&ctx->starvation_breaks, memory_order_relaxed);
+    metrics->credit_probes = atomic_load_explicit(&ctx->credit_probes, memory_order_relaxed);
+}
@@ -0,0 +1,273 @@
+/*
+ * OBI Topology In-Order Delivery
+ * Senders number data, batch and fragment frames per destination. The
+ * receiver delivers each source's frames in that order: an early frame
+ * waits in a ring slot indexed by its sequence modulo the window, so
+ * inserting and releasing are O(1) and nothing is ever sorted. A missing
+ * frame is skipped once the timeout passes
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "topology_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+void obi_topology_order_stamp(obi_topology_node_t *node, obi_topology_frame_t *frame) {
+    uint32_t sequence;
+    do {
+        sequence = atomic_fetch_add_explicit(&node->send_sequence, 1, memory_order_relaxed) + 1;
+    } while (sequence == 0);  // 0 marks unordered frames
+    frame->sequence = sequence;
+}
+
+// An unsent frame returns its number unless a later send already took the next
+// one; the receiver then sees a gap and skips it after the timeout
+void obi_topology_order_cancel(obi_topology_node_t *node, const obi_topology_frame_t *frame) {
+    uint32_t expected = frame->sequence;
+    atomic_compare_exchange_strong_explicit(&node->send_sequence, &expected, frame->sequence - 1,
+                                            memory_order_relaxed, memory_order_relaxed);
+}
+
+static void discard_held(obi_topology_context_t *ctx, obi_topology_node_t *node) {
+    if (node->order_ring) {
+        for (uint32_t i = 0; i < ctx->order_window; i++) {
+            node->order_ring[i].present = false;
+        }
+    }
+    ctx->order_holding -= node->order_held;
+    node->order_held = 0;
+}
+
+// A rejoining source may have restarted its numbering; our own towards it
+// keeps counting, since the receiver resynchronises on far-behind frames
+void obi_topology_order_reset(obi_topology_context_t *ctx, obi_topology_node_t *node) {
+    discard_held(ctx, node);
+    node->order_expected = 0;
+    if (ctx->order_parked && &ctx->nodes[ctx->order_parked_node] == node) {
+        ctx->order_parked = false;
+    }
+}
+
+obi_topology_result_t obi_topology_set_ordering(obi_topology_context_t *ctx, const obi_order_config_t *config) {
+    obi_order_config_t defaults = { OBI_ORDER_DEFAULT_WINDOW, OBI_ORDER_DEFAULT_TIMEOUT_US };
+    if (!config) {
+        config = &defaults;
+    }
+    if (!ctx || !ctx->active || config->window > OBI_ORDER_MAX_WINDOW ||
+        (config->window && config->timeout_us == 0)) {
+        return OBI_TOPOLOGY_ERROR_INVALID_CONFIG;
+    }
+
+    // Held frames belong to the old window; every source resynchronises
+    obi_topology_order_release(ctx);
+    uint32_t window = 0;
+    if (config->window) {
+        window = 1;
+        while (window < config->window) {
+            window <<= 1;
+        }
+    }
+    ctx->order_window = window;
+    ctx->order_timeout_ns = (uint64_t)config->timeout_us * 1000ull;
+    return OBI_TOPOLOGY_SUCCESS;
+}
+
+// One block per source: the entries, then a frame payload for each
+static obi_order_entry_t *ring_for(obi_topology_context_t *ctx, obi_topology_node_t *node) {
+    if (node->order_ring) {
+        return node->order_ring;
+    }
+    size_t payload = ctx->transport->max_frame_payload;
+    if (ctx->order_payload == 0) {
+        ctx->order_payload = payload;
+    }
+    size_t entries = ctx->order_window * sizeof(obi_order_entry_t);
+    uint8_t *block = malloc(entries + ctx->order_window * ctx->order_payload);
+    if (!block) {
+        return NULL;
+    }
+    node->order_ring = (obi_order_entry_t *)block;
+    for (uint32_t i = 0; i < ctx->order_window; i++) {
+        node->order_ring[i].payload = block + entries + i * ctx->order_payload;
+        node->order_ring[i].present = false;
+    }
+    return node->order_ring;
+}
+
+static bool hold(obi_topology_context_t *ctx, obi_topology_node_t *node, const obi_topology_frame_t *frame,
+                 const uint8_t *payload) {
+    obi_order_entry_t *ring = ring_for(ctx, node);
+    if (!ring || frame->length > ctx->order_payload) {
+        return false;
+    }
+
+    obi_order_entry_t *entry = &ring[frame->sequence & (ctx->order_window - 1)];
+    if (entry->present) {
+        atomic_fetch_add_explicit(&ctx->late_frames, 1, memory_order_relaxed);  // duplicate
+        return true;
+    }
+    entry->frame = *frame;
+    memcpy(entry->payload, payload, frame->length);
+    entry->present = true;
+    if (node->order_held++ == 0) {
+        node->order_stalled_ns = obi_topology_now_ns();
+    }
+    ctx->order_holding++;
+    atomic_fetch_add_explicit(&ctx->reordered_frames, 1, memory_order_relaxed);
+    return true;
+}
+
+bool obi_topology_order_accept(obi_topology_context_t *ctx, const obi_topology_frame_t *frame,
+                               const uint8_t *payload) {
+    if (ctx->order_window == 0 || frame->sequence == 0) {
+        return true;
+    }
+    obi_node_id_t id = obi_node_registry_find(&ctx->registry, frame->source);
+    if (id == OBI_NODE_INVALID) {
+        return true;
+    }
+
+    obi_topology_node_t *node = &ctx->nodes[id];
+    if (node->order_expected == 0) {
+        node->order_expected = frame->sequence;  // first frame heard from the source
+    }
+
+    int32_t ahead = (int32_t)(frame->sequence - node->order_expected);
+    if (ahead < 0) {
+        if ((uint32_t)-ahead < ctx->order_window) {
+            atomic_fetch_add_explicit(&ctx->late_frames, 1, memory_order_relaxed);
+            return false;
+        }
+        // Far behind: the source restarted its numbering
+        discard_held(ctx, node);
+        node->order_expected = frame->sequence;
+        ahead = 0;
+    }
+    if (ahead == 0) {
+        node->order_expected++;
+        if (node->order_held) {
+            node->order_stalled_ns = obi_topology_now_ns();  // the next missing frame waits afresh
+        }
+        return true;
+    }
+
+    // A frame a whole window ahead waits while the window moves up to it;
+    // one that cannot be copied is delivered at once rather than lost
+    if ((uint32_t)ahead >= ctx->order_window) {
+        if (!ctx->order_parked_payload) {
+            ctx->order_parked_payload = malloc(ctx->transport->max_frame_payload);
+        }
+        if (!ctx->order_parked_payload || frame->length > ctx->transport->max_frame_payload) {
+            return true;
+        }
+        ctx->order_parked = true;
+        ctx->order_parked_node = id;
+        ctx->order_parked_frame = *frame;
+        memcpy(ctx->order_parked_payload, payload, frame->length);
+        return false;
+    }
+    return !hold(ctx, node, frame, payload);
+}
+
+static void pop(obi_topology_context_t *ctx, obi_topology_node_t *node, obi_order_entry_t *entry,
+                obi_topology_frame_t *frame, uint8_t *payload) {
+    *frame = entry->frame;
+    memcpy(payload, entry->payload, entry->frame.length);
+    entry->present = false;
+    node->order_expected++;
+    node->order_held--;
+    ctx->order_holding--;
+    node->order_stalled_ns = obi_topology_now_ns();
+}
+
+// Skip missing frames up to the next held one, or to target when nothing is held
+static void skip_gap(obi_topology_context_t *ctx, obi_topology_node_t *node, uint32_t target) {
+    uint32_t mask = ctx->order_window - 1;
+    uint32_t skipped = 0;
+    if (node->order_held == 0) {
+        skipped = target - node->order_expected;
+        node->order_expected = target;
+    } else {
+        while (!node->order_ring[node->order_expected & mask].present) {
+            node->order_expected++;
+            skipped++;
+        }
+    }
+    atomic_fetch_add_explicit(&ctx->sequence_gaps, skipped, memory_order_relaxed);
+}
+
+// Move the window up to the parked frame; true when a held frame was popped first
+static bool advance_parked(obi_topology_context_t *ctx, obi_topology_frame_t *frame, uint8_t *payload) {
+    obi_topology_node_t *node = &ctx->nodes[ctx->order_parked_node];
+    const obi_topology_frame_t *parked = &ctx->order_parked_frame;
+    uint32_t mask = ctx->order_window - 1;
+
+    while ((uint32_t)(parked->sequence - node->order_expected) >= ctx->order_window) {
+        obi_order_entry_t *head = node->order_ring ? &node->order_ring[node->order_expected & mask] : NULL;
+        if (head && head->present) {
+            pop(ctx, node, head, frame, payload);
+            return true;
+        }
+        skip_gap(ctx, node, parked->sequence - ctx->order_window + 1);
+    }
+
+    ctx->order_parked = false;
+    if (parked->sequence == node->order_expected) {
+        *frame = *parked;
+        memcpy(payload, ctx->order_parked_payload, parked->length);
+        node->order_expected++;
+        return true;
+    }
+    if (!hold(ctx, node, parked, ctx->order_parked_payload)) {
+        *frame = *parked;  // no room to hold it: deliver rather than lose it
+        memcpy(payload, ctx->order_parked_payload, parked->length);
+        return true;
+    }
+    return false;
+}
+
+bool obi_topology_order_next(obi_topology_context_t *ctx, obi_topology_frame_t *frame, uint8_t *payload) {
+    if (ctx->order_parked && advance_parked(ctx, frame, payload)) {
+        return true;
+    }
+    if (ctx->order_holding == 0) {
+        return false;
+    }
+
+    uint64_t now = obi_topology_now_ns();
+    uint32_t mask = ctx->order_window - 1;
+    for (uint32_t i = 0; i < ctx->graph.node_count; i++) {
+        obi_topology_node_t *node = &ctx->nodes[i];
+        if (node->order_held == 0) {
+            continue;
+        }
+        obi_order_entry_t *head = &node->order_ring[node->order_expected & mask];
+        if (!head->present) {
+            if (now - node->order_stalled_ns < ctx->order_timeout_ns) {
+                continue;
+            }
+            atomic_fetch_add_explicit(&ctx->reorder_timeouts, 1, memory_order_relaxed);
+            skip_gap(ctx, node, 0);
+            head = &node->order_ring[node->order_expected & mask];
+        }
+        pop(ctx, node, head, frame, payload);
+        return true;
+    }
+    return false;
+}
+
+void obi_topology_order_release(obi_topology_context_t *ctx) {
+    for (uint32_t i = 0; i < ctx->graph.node_count; i++) {
+        obi_topology_node_t *node = &ctx->nodes[i];
+        free(node->order_ring);
+        node->order_ring = NULL;
+        node->order_held = 0;
+        node->order_expected = 0;
+    }
+    free(ctx->order_parked_payload);
+    ctx->order_parked_payload = NULL;
+    ctx->order_parked = false;
+    ctx->order_holding = 0;
+    ctx->order_payload = 0;
+}
@@ -0,0 +1,72 @@
+/*
+ * OBI Topology Partitioning
+ * Consistent-hash ring behind HYBRID key-partitioned delivery: each active
+ * node owns OBI_PARTITION_VNODES pseudo-random ring positions, so a node
+ * joining or leaving moves only the keys next to its own points
+ */
+
+#include "obitopology_routing.h"
+#include <stdlib.h>
+#include <string.h>
+
+static int compare_points(const void *a, const void *b) {
+    const obi_partition_point_t *x = a;
+    const obi_partition_point_t *y = b;
+    if (x->position != y->position) {
+        return x->position < y->position ? -1 : 1;
+    }
+    // Keys, unlike ids, are the same in every process, even on the rare collision
+    return x->key == y->key ? 0 : (x->key < y->key ? -1 : 1);
+}
+
+bool obi_partition_ring_build(obi_partition_ring_t *ring, const obi_route_graph_t *graph) {
+    uint32_t members = 0;
+    for (uint32_t i = 0; i < graph->node_count; i++) {
+        members += graph->active[i] ? 1 : 0;
+    }
+
+    ring->size = 0;
+    ring->points = malloc(((size_t)members * OBI_PARTITION_VNODES + 1) * sizeof(obi_partition_point_t));
+    if (!ring->points) {
+        return false;
+    }
+
+    // Positions come from the wire key, not the dense id: ids follow the local
+    // registration order, so only the key gives every process the same ring
+    for (uint32_t i = 0; i < graph->node_count; i++) {
+        if (!graph->active[i]) {
+            continue;
+        }
+        for (uint32_t v = 0; v < OBI_PARTITION_VNODES; v++) {
+            obi_partition_point_t *point = &ring->points[ring->size++];
+            point->position = obi_partition_hash((uint64_t)graph->key[i] << 32 | v);
+            point->key = graph->key[i];
+            point->owner = (obi_node_id_t)i;
+        }
+    }
+    qsort(ring->points, ring->size, sizeof(obi_partition_point_t), compare_points);
+    return true;
+}
+
+bool obi_partition_ring_copy(obi_partition_ring_t *ring, const obi_partition_ring_t *source,
+                             obi_node_id_t excluded) {
+    ring->size = 0;
+    ring->points = malloc(((size_t)source->size + 1) * sizeof(obi_partition_point_t));
+    if (!ring->points) {
+        return false;
+    }
+
+    // Dropping one node's points keeps the rest in order
+    for (uint32_t i = 0; i < source->size; i++) {
+        if (source->points[i].owner != excluded) {
+            ring->points[ring->size++] = source->points[i];
+        }
+    }
+    return true;
+}
+
+void obi_partition_ring_destroy(obi_partition_ring_t *ring) {
+    free(ring->points);
+    ring->points = NULL;
+    ring->size = 0;
+}
@@ -0,0 +1,514 @@
+/*
+ * OBI Topology Send Pipeline
+ * Validation on a worker pool, routing on a classifier thread and I/O on a
+ * transport thread, connected by bounded lock-free queues of pool slots
+ */
+
+#define _GNU_SOURCE
+
+#include "topology_internal.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sched.h>
+#include <pthread.h>
+
+#define SLOT_NONE   UINT32_MAX
+#define IDLE_SPINS  64            // sched_yield rounds before a stage thread sleeps
+
+// Bounded MPMC queue of slot indices (Vyukov): each cell's sequence says
+// whether it is free for position pos (== pos) or holds pos's value (== pos + 1)
+typedef struct {
+    _Atomic uint64_t sequence;
+    uint32_t value;
+} pipeline_cell_t;
+
+typedef struct {
+    pipeline_cell_t *cells;
+    uint64_t mask;
+    _Alignas(64) _Atomic uint64_t head;       // next position to fill
+    _Alignas(64) _Atomic uint64_t tail;       // next position to drain
+    _Atomic uint32_t peak;
+} pipeline_queue_t;
+
+typedef struct {
+    uint8_t *data;
+    size_t size;
+    obi_node_id_t destination;
+    uint8_t priority;
+    obi_send_handle_t handle;
+    obi_result_t result;      // set by validation and classification, final after send
+    bool rejected;            // refused by the validator
+} pipeline_message_t;
+
+typedef struct {
+    obi_topology_pipeline_t *pipeline;
+    uint32_t index;
+    pthread_t thread;
+} pipeline_worker_t;
+
+struct obi_topology_pipeline {
+    obi_topology_context_t *ctx;
+    obi_pipeline_config_t config;
+
+    // Slot pool; free holds the indices of unused slots
+    pipeline_message_t *messages;
+    uint8_t *storage;
+    size_t slot_capacity;
+    pipeline_queue_t free;
+
+    // Stage queues. Workers finish out of order, so validated slots land in
+    // a reorder ring at their validation-queue position and the classifier
+    // takes them strictly in submission order
+    pipeline_queue_t validate;
+    _Atomic uint32_t *route;
+    uint64_t route_mask;
+    _Alignas(64) _Atomic uint64_t route_next;
+    _Atomic uint32_t route_depth;
+    _Atomic uint32_t route_peak;
+    pipeline_queue_t send;
+
+    pipeline_worker_t workers[OBI_PIPELINE_MAX_WORKERS];
+    uint32_t worker_count;
+    _Atomic uint32_t workers_running;
+    pthread_t classifier;
+    pthread_t transport;
+    _Atomic bool classifier_running;
+    _Atomic bool closed;      // no more submissions; stages exit once drained
+
+    _Atomic uint32_t next_handle;
+    _Atomic uint64_t submitted;
+    _Atomic uint64_t rejected;
+    _Atomic uint64_t sent;
+    _Atomic uint64_t failed;
+};
+
+static uint64_t round_up_pow2(uint64_t value) {
+    uint64_t size = 1;
+    while (size < value) {
+        size <<= 1;
+    }
+    return size;
+}
+
+static void note_peak(_Atomic uint32_t *peak, uint32_t depth) {
+    uint32_t current = atomic_load_explicit(peak, memory_order_relaxed);
+    while (depth > current &&
+           !atomic_compare_exchange_weak_explicit(peak, &current, depth,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+static bool queue_init(pipeline_queue_t *queue, uint64_t size) {
+    queue->cells = calloc(size, sizeof(pipeline_cell_t));
+    if (!queue->cells) {
+        return false;
+    }
+    for (uint64_t i = 0; i < size; i++) {
+        atomic_store_explicit(&queue->cells[i].sequence, i, memory_order_relaxed);
+    }
+    queue->mask = size - 1;
+    atomic_store(&queue->head, 0);
+    atomic_store(&queue->tail, 0);
+    atomic_store(&queue->peak, 0);
+    return true;
+}
+
+static uint32_t queue_depth(pipeline_queue_t *queue) {
+    uint64_t tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+    uint64_t head = atomic_load_explicit(&queue->head, memory_order_acquire);
+    return head > tail ? (uint32_t)(head - tail) : 0;
+}
+
+static bool queue_push(pipeline_queue_t *queue, uint32_t value) {
+    uint64_t pos = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    pipeline_cell_t *cell;
+    for (;;) {
+        cell = &queue->cells[pos & queue->mask];
+        uint64_t sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        int64_t diff = (int64_t)(sequence - pos);
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&queue->head, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false;  // full
+        } else {
+            pos = atomic_load_explicit(&queue->head, memory_order_relaxed);
+        }
+    }
+    cell->value = value;
+    atomic_store_explicit(&cell->sequence, pos + 1, memory_order_release);
+    note_peak(&queue->peak, queue_depth(queue));
+    return true;
+}
+
+// position receives the value's queue position, a gap-free submission sequence
+static bool queue_pop(pipeline_queue_t *queue, uint32_t *value, uint64_t *position) {
+    uint64_t pos = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+    pipeline_cell_t *cell;
+    for (;;) {
+        cell = &queue->cells[pos & queue->mask];
+        uint64_t sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        int64_t diff = (int64_t)(sequence - (pos + 1));
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&queue->tail, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false;  // empty
+        } else {
+            pos = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+        }
+    }
+    *value = cell->value;
+    if (position) {
+        *position = pos;
+    }
+    atomic_store_explicit(&cell->sequence, pos + queue->mask + 1, memory_order_release);
+    return true;
+}
+
+static void idle(uint32_t *spins) {
+    if (++*spins < IDLE_SPINS) {
+        sched_yield();
+        return;
+    }
+    struct timespec pause = { 0, OBI_PIPELINE_IDLE_US * 1000L };
+    nanosleep(&pause, NULL);
+}
+
+static void *validate_stage(void *arg) {
+    pipeline_worker_t *worker = arg;
+    obi_topology_pipeline_t *pipeline = worker->pipeline;
+    uint32_t spins = 0;
+
+    for (;;) {
+        uint32_t index;
+        uint64_t sequence;
+        if (!queue_pop(&pipeline->validate, &index, &sequence)) {
+            if (atomic_load(&pipeline->closed) && queue_depth(&pipeline->validate) == 0) {
+                break;
+            }
+            idle(&spins);
+            continue;
+        }
+        spins = 0;
+
+        pipeline_message_t *message = &pipeline->messages[index];
+        obi_buffer_t buffer = { message->data, message->size, pipeline->slot_capacity };
+        bool valid = !pipeline->config.validate ||
+                     pipeline->config.validate(pipeline->config.validate_user, worker->index, &buffer);
+        message->result = valid ? OBI_SUCCESS : OBI_ERROR_INVALID_INPUT;
+        message->rejected = !valid;
+        if (!valid) {
+            atomic_fetch_add_explicit(&pipeline->rejected, 1, memory_order_relaxed);
+        }
+
+        // A worker far ahead of the classifier waits for room in the ring
+        while (sequence - atomic_load_explicit(&pipeline->route_next, memory_order_acquire) > pipeline->route_mask) {
+            idle(&spins);
+        }
+        atomic_store_explicit(&pipeline->route[sequence & pipeline->route_mask], index, memory_order_release);
+        note_peak(&pipeline->route_peak, atomic_fetch_add(&pipeline->route_depth, 1) + 1);
+    }
+
+    atomic_fetch_sub(&pipeline->workers_running, 1);
+    return NULL;
+}
+
+// Admission control and route resolution; the transport thread only sends
+static obi_result_t classify(obi_topology_context_t *ctx, const pipeline_message_t *message) {
+    obi_topology_governance_tick(ctx, obi_topology_now_ns());
+    if (!obi_topology_admit(ctx, (obi_topology_priority_t)message->priority)) {
+        return OBI_ERROR_WOULD_BLOCK;
+    }
+    if (message->destination >= ctx->graph.node_count) {
+        return OBI_ERROR_INVALID_INPUT;
+    }
+    if (ctx->local_id == OBI_NODE_INVALID) {
+        return OBI_SUCCESS;
+    }
+
+    unsigned slot;
+    const obi_route_table_t *routes = obi_route_acquire(&ctx->routes, &slot);
+    obi_node_id_t hop = message->destination < routes->node_count ?
+                        obi_route_next_hop(routes, ctx->local_id, message->destination) : OBI_NODE_INVALID;
+    obi_route_release(&ctx->routes, slot);
+    return hop == OBI_NODE_INVALID || hop == ctx->local_id ? OBI_ERROR_NETWORK_FAILURE : OBI_SUCCESS;
+}
+
+static void *route_stage(void *arg) {
+    obi_topology_pipeline_t *pipeline = arg;
+    uint32_t spins = 0;
+
+    for (;;) {
+        uint64_t next = atomic_load_explicit(&pipeline->route_next, memory_order_relaxed);
+        _Atomic uint32_t *cell = &pipeline->route[next & pipeline->route_mask];
+        uint32_t index = atomic_load_explicit(cell, memory_order_acquire);
+        if (index == SLOT_NONE) {
+            // Every validated slot is in the ring before its worker exits
+            if (atomic_load(&pipeline->workers_running) == 0 &&
+                atomic_load_explicit(cell, memory_order_acquire) == SLOT_NONE) {
+                break;
+            }
+            idle(&spins);
+            continue;
+        }
+        spins = 0;
+        atomic_store_explicit(cell, SLOT_NONE, memory_order_relaxed);
+        atomic_store_explicit(&pipeline->route_next, next + 1, memory_order_release);
+        atomic_fetch_sub(&pipeline->route_depth, 1);
+
+        pipeline_message_t *message = &pipeline->messages[index];
+        if (message->result == OBI_SUCCESS) {
+            message->result = classify(pipeline->ctx, message);
+        }
+        while (!queue_push(&pipeline->send, index)) {
+            idle(&spins);
+        }
+    }
+
+    atomic_store(&pipeline->classifier_running, false);
+    return NULL;
+}
+
+static void *transport_stage(void *arg) {
+    obi_topology_pipeline_t *pipeline = arg;
+    obi_topology_context_t *ctx = pipeline->ctx;
+    bool unflushed = false;
+    uint32_t spins = 0;
+
+    for (;;) {
+        uint32_t index;
+        if (!queue_pop(&pipeline->send, &index, NULL)) {
+            // An empty queue is the natural batch boundary
+            if (unflushed) {
+                obi_topology_transport_flush(ctx);
+                unflushed = false;
+            }
+            if (!atomic_load(&pipeline->classifier_running) && queue_depth(&pipeline->send) == 0) {
+                break;
+            }
+            idle(&spins);
+            continue;
+        }
+        spins = 0;
+
+        // A full ring or an empty window holds the stage, keeping order; once
+        // the pipeline is closed the refusal becomes the result
+        pipeline_message_t *message = &pipeline->messages[index];
+        obi_result_t result = message->result;
+        if (result == OBI_SUCCESS) {
+            obi_buffer_t buffer = { message->data, message->size, pipeline->slot_capacity };
+            for (;;) {
+                result = obi_topology_send_admitted(ctx, &buffer, message->destination, obi_topology_now_ns(), false,
+                                                    NULL);
+                if ((result != OBI_BUSY && result != OBI_ERROR_WOULD_BLOCK) || atomic_load(&pipeline->closed)) {
+                    break;
+                }
+                obi_topology_transport_flush(ctx);
+                struct timespec pause = { 0, OBI_PIPELINE_IDLE_US * 1000L };
+                nanosleep(&pause, NULL);
+            }
+            unflushed = true;
+        }
+
+        if (result == OBI_SUCCESS) {
+            atomic_fetch_add_explicit(&pipeline->sent, 1, memory_order_relaxed);
+        } else if (!message->rejected) {
+            atomic_fetch_add_explicit(&pipeline->failed, 1, memory_order_relaxed);
+        }
+        if (pipeline->config.completion) {
+            pipeline->config.completion(pipeline->config.completion_user, message->handle, result);
+        }
+        queue_push(&pipeline->free, index);
+    }
+
+    if (unflushed) {
+        obi_topology_transport_flush(ctx);
+    }
+    return NULL;
+}
+
+static void destroy_pipeline(obi_topology_pipeline_t *pipeline) {
+    free(pipeline->free.cells);
+    free(pipeline->validate.cells);
+    free(pipeline->send.cells);
+    free((void *)pipeline->route);
+    free(pipeline->messages);
+    free(pipeline->storage);
+    free(pipeline);
+}
+
+static uint32_t default_workers(void) {
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cores <= 3) {
+        return 1;
+    }
+    return cores - 2 > OBI_PIPELINE_MAX_WORKERS ? OBI_PIPELINE_MAX_WORKERS : (uint32_t)(cores - 2);
+}
+
+// Stops the stages that have started and waits for each to drain
+static void join_stages(obi_topology_pipeline_t *pipeline, uint32_t workers, bool classifier, bool transport) {
+    atomic_store(&pipeline->closed, true);
+    for (uint32_t i = 0; i < workers; i++) {
+        pthread_join(pipeline->workers[i].thread, NULL);
+    }
+    atomic_store(&pipeline->workers_running, 0);
+    if (classifier) {
+        pthread_join(pipeline->classifier, NULL);
+    }
+    atomic_store(&pipeline->classifier_running, false);
+    if (transport) {
+        pthread_join(pipeline->transport, NULL);
+    }
+}
+
+obi_topology_result_t obi_topology_pipeline_start(obi_topology_context_t *ctx, const obi_pipeline_config_t *config) {
+    obi_pipeline_config_t defaults = {0};
+    if (!config) {
+        config = &defaults;
+    }
+    if (!ctx || !ctx->active || ctx->pipeline || config->workers > OBI_PIPELINE_MAX_WORKERS ||
+        config->queue_depth > (1u << 20)) {
+        return OBI_TOPOLOGY_ERROR_INVALID_CONFIG;
+    }
+
+    // The queue heads and tails sit on their own cache lines
+    size_t size = (sizeof(obi_topology_pipeline_t) + 63) & ~(size_t)63;
+    obi_topology_pipeline_t *pipeline = aligned_alloc(64, size);
+    if (!pipeline) {
+        return OBI_TOPOLOGY_ERROR_INVALID_CONFIG;
+    }
+    memset(pipeline, 0, size);
+    pipeline->ctx = ctx;
+    pipeline->config = *config;
+    pipeline->worker_count = config->workers ? config->workers : default_workers();
+
+    // Enough slots to fill every queue and the ring, plus one in each thread's hands
+    uint64_t depth = round_up_pow2(config->queue_depth ? config->queue_depth : OBI_PIPELINE_DEFAULT_DEPTH);
+    uint64_t slots = depth * 4 + pipeline->worker_count + 2;
+    pipeline->slot_capacity = ctx->transport->max_frame_payload;
+    pipeline->messages = calloc(slots, sizeof(pipeline_message_t));
+    pipeline->storage = malloc(slots * pipeline->slot_capacity);
+    pipeline->route = malloc(depth * 2 * sizeof(*pipeline->route));
+    pipeline->route_mask = depth * 2 - 1;
+    if (!pipeline->messages || !pipeline->storage || !pipeline->route ||
+        !queue_init(&pipeline->free, round_up_pow2(slots)) ||
+        !queue_init(&pipeline->validate, depth) || !queue_init(&pipeline->send, depth)) {
+        destroy_pipeline(pipeline);
+        return OBI_TOPOLOGY_ERROR_INVALID_CONFIG;
+    }
+    for (uint64_t i = 0; i < slots; i++) {
+        pipeline->messages[i].data = pipeline->storage + i * pipeline->slot_capacity;
+        queue_push(&pipeline->free, (uint32_t)i);
+    }
+    for (uint64_t i = 0; i <= pipeline->route_mask; i++) {
+        atomic_init(&pipeline->route[i], SLOT_NONE);
+    }
+    atomic_store(&pipeline->next_handle, 1);
+
+    atomic_store(&pipeline->workers_running, pipeline->worker_count);
+    atomic_store(&pipeline->classifier_running, true);
+    for (uint32_t i = 0; i < pipeline->worker_count; i++) {
+        pipeline->workers[i].pipeline = pipeline;
+        pipeline->workers[i].index = i;
+        if (pthread_create(&pipeline->workers[i].thread, NULL, validate_stage, &pipeline->workers[i]) != 0) {
+            atomic_store(&pipeline->workers_running, i);
+            join_stages(pipeline, i, false, false);
+            destroy_pipeline(pipeline);
+            return OBI_TOPOLOGY_ERROR_INVALID_CONFIG;
+        }
+    }
+    if (pthread_create(&pipeline->classifier, NULL, route_stage, pipeline) != 0) {
+        join_stages(pipeline, pipeline->worker_count, false, false);
+        destroy_pipeline(pipeline);
+        return OBI_TOPOLOGY_ERROR_INVALID_CONFIG;
+    }
+    if (pthread_create(&pipeline->transport, NULL, transport_stage, pipeline) != 0) {
+        join_stages(pipeline, pipeline->worker_count, true, false);
+        destroy_pipeline(pipeline);
+        return OBI_TOPOLOGY_ERROR_INVALID_CONFIG;
+    }
+
+    ctx->pipeline = pipeline;
+    return OBI_TOPOLOGY_SUCCESS;
+}
+
+obi_result_t obi_topology_pipeline_submit(obi_topology_context_t *ctx, const obi_buffer_t *buffer,
+                                          obi_node_id_t destination, obi_topology_priority_t priority,
+                                          obi_send_handle_t *handle) {
+    if (!ctx || !ctx->pipeline || !buffer || (!buffer->data && buffer->size) || !handle) {
+        return OBI_ERROR_INVALID_INPUT;
+    }
+    obi_topology_pipeline_t *pipeline = ctx->pipeline;
+    if (buffer->size > pipeline->slot_capacity) {
+        return OBI_ERROR_BUFFER_OVERFLOW;
+    }
+
+    uint32_t index;
+    if (!queue_pop(&pipeline->free, &index, NULL)) {
+        return OBI_BUSY;
+    }
+    pipeline_message_t *message = &pipeline->messages[index];
+    if (buffer->size) {
+        memcpy(message->data, buffer->data, buffer->size);
+    }
+    message->size = buffer->size;
+    message->destination = destination;
+    message->priority = (uint8_t)priority;
+    message->handle = atomic_fetch_add_explicit(&pipeline->next_handle, 1, memory_order_relaxed);
+    if (message->handle == 0) {
+        message->handle = atomic_fetch_add_explicit(&pipeline->next_handle, 1, memory_order_relaxed);
+    }
+    *handle = message->handle;
+
+    if (!queue_push(&pipeline->validate, index)) {
+        queue_push(&pipeline->free, index);
+        return OBI_BUSY;
+    }
+    atomic_fetch_add_explicit(&pipeline->submitted, 1, memory_order_relaxed);
+    return OBI_SUCCESS;
+}
+
+obi_topology_result_t obi_topology_pipeline_stats(obi_topology_context_t *ctx, obi_pipeline_stats_t *stats) {
+    if (!ctx || !ctx->pipeline || !stats) {
+        return OBI_TOPOLOGY_ERROR_INVALID_CONFIG;
+    }
+
+    obi_topology_pipeline_t *pipeline = ctx->pipeline;
+    stats->validate.depth = queue_depth(&pipeline->validate);
+    stats->validate.peak = atomic_load_explicit(&pipeline->validate.peak, memory_order_relaxed);
+    stats->route.depth = atomic_load_explicit(&pipeline->route_depth, memory_order_relaxed);
+    stats->route.peak = atomic_load_explicit(&pipeline->route_peak, memory_order_relaxed);
+    stats->send.depth = queue_depth(&pipeline->send);
+    stats->send.peak = atomic_load_explicit(&pipeline->send.peak, memory_order_relaxed);
+    stats->workers = pipeline->worker_count;
+    stats->submitted = atomic_load_explicit(&pipeline->submitted, memory_order_relaxed);
+    stats->rejected = atomic_load_explicit(&pipeline->rejected, memory_order_relaxed);
+    stats->sent = atomic_load_explicit(&pipeline->sent, memory_order_relaxed);
+    stats->failed = atomic_load_explicit(&pipeline->failed, memory_order_relaxed);
+    return OBI_TOPOLOGY_SUCCESS;
+}
+
+obi_topology_result_t obi_topology_pipeline_stop(obi_topology_context_t *ctx) {
+    if (!ctx || !ctx->pipeline) {
+        return OBI_TOPOLOGY_ERROR_INVALID_CONFIG;
+    }
+    obi_topology_pipeline_release(ctx);
+    return OBI_TOPOLOGY_SUCCESS;
+}
+
+void obi_topology_pipeline_release(obi_topology_context_t *ctx) {
+    obi_topology_pipeline_t *pipeline = ctx->pipeline;
+    if (!pipeline) {
+        return;
+    }
+    join_stages(pipeline, pipeline->worker_count, true, true);
+    ctx->pipeline = NULL;
+    destroy_pipeline(pipeline);
+}
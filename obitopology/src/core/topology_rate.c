@@ -0,0 +1,89 @@
+/*
+ * OBI Topology Rate Limiting
+ * Token buckets per destination and per tenant in GCRA form: one timestamp
+ * per bucket, refilled implicitly by the monotonic clock and advanced with
+ * a single CAS, so limited sends never take a lock
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "topology_internal.h"
+
+// Interval and tolerance are stored separately; a send racing a limit change
+// may see one old and one new value, which only matters for that one send
+static void configure(obi_rate_limiter_t *limiter, const obi_rate_limit_t *limit) {
+    uint64_t interval = limit->rate ? 1000000000ull / limit->rate : 0;
+    uint32_t burst = limit->burst ? limit->burst : 1;
+    atomic_store_explicit(&limiter->tolerance_ns, interval * (burst - 1), memory_order_relaxed);
+    atomic_store_explicit(&limiter->interval_ns, interval ? interval : (limit->rate ? 1 : 0),
+                          memory_order_relaxed);
+}
+
+obi_topology_result_t obi_topology_set_rate_limit(obi_topology_context_t *ctx, obi_node_id_t destination,
+                                                  const obi_rate_limit_t *limit) {
+    if (!ctx || !ctx->active || !limit || destination >= ctx->graph.node_count) {
+        return OBI_TOPOLOGY_ERROR_INVALID_CONFIG;
+    }
+    configure(&ctx->nodes[destination].rate, limit);
+    return OBI_TOPOLOGY_SUCCESS;
+}
+
+obi_topology_result_t obi_topology_set_tenant_limit(obi_topology_context_t *ctx, uint32_t tenant,
+                                                    const obi_rate_limit_t *limit) {
+    if (!ctx || !ctx->active || !limit || tenant >= OBI_RATE_MAX_TENANTS) {
+        return OBI_TOPOLOGY_ERROR_INVALID_CONFIG;
+    }
+    configure(&ctx->tenant_rate[tenant], limit);
+    return OBI_TOPOLOGY_SUCCESS;
+}
+
+bool obi_topology_rate_admit(obi_topology_context_t *ctx, obi_rate_limiter_t *limiter,
+                             obi_topology_node_t *target, uint64_t now) {
+    uint64_t interval = atomic_load_explicit(&limiter->interval_ns, memory_order_relaxed);
+    if (interval == 0) {
+        return true;
+    }
+    uint64_t tolerance = atomic_load_explicit(&limiter->tolerance_ns, memory_order_relaxed);
+
+    uint64_t tat = atomic_load_explicit(&limiter->tat_ns, memory_order_relaxed);
+    uint64_t next;
+    do {
+        uint64_t start = tat > now ? tat : now;
+        if (start - now > tolerance) {
+            // Limiting is a refused send on the link, so it feeds the drop rate term
+            atomic_fetch_add_explicit(&ctx->rate_limited, 1, memory_order_relaxed);
+            obi_link_stats_record(&target->link, 0, false);
+            return false;
+        }
+        next = start + interval;
+    } while (!atomic_compare_exchange_weak_explicit(&limiter->tat_ns, &tat, next,
+                                                    memory_order_relaxed, memory_order_relaxed));
+    return true;
+}
+
+// A send refused after admission, e.g. for want of credit, returns its slot
+void obi_topology_rate_refund(obi_rate_limiter_t *limiter) {
+    uint64_t interval = atomic_load_explicit(&limiter->interval_ns, memory_order_relaxed);
+    uint64_t tat = atomic_load_explicit(&limiter->tat_ns, memory_order_relaxed);
+    while (interval && tat >= interval &&
+           !atomic_compare_exchange_weak_explicit(&limiter->tat_ns, &tat, tat - interval,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+obi_result_t obi_topology_send_tenant(obi_topology_context_t *ctx, obi_buffer_t *buffer,
+                                      obi_node_id_t destination, obi_topology_priority_t priority,
+                                      uint32_t tenant) {
+    if (!ctx || !ctx->active || tenant >= OBI_RATE_MAX_TENANTS || destination >= ctx->graph.node_count) {
+        return OBI_ERROR_INVALID_INPUT;
+    }
+    if (!obi_topology_rate_admit(ctx, &ctx->tenant_rate[tenant], &ctx->nodes[destination],
+                                 obi_topology_now_ns())) {
+        return OBI_BUSY;
+    }
+    obi_result_t result = obi_topology_send_priority(ctx, buffer, destination, priority);
+    if (result == OBI_BUSY || result == OBI_ERROR_WOULD_BLOCK) {
+        obi_topology_rate_refund(&ctx->tenant_rate[tenant]);  // refused, not sent
+    }
+    return result;
+}
@@ -0,0 +1,47 @@
+/*
+ * OBI Topology Node Registry
+ * Open-addressing index from node key to dense node id, so names are
+ * hashed once when interned and never on the per-message path
+ */
+
+#include "topology_internal.h"
+#include <string.h>
+
+void obi_node_registry_reset(obi_node_registry_t *registry) {
+    memset(registry, 0, sizeof(*registry));
+}
+
+obi_node_id_t obi_node_registry_find(const obi_node_registry_t *registry, uint32_t key) {
+    // Linear probing; the table is never more than half full so runs stay short
+    for (uint32_t i = 0; i < OBI_NODE_REGISTRY_SLOTS; i++) {
+        uint32_t slot = (key + i) & (OBI_NODE_REGISTRY_SLOTS - 1);
+        uint32_t stored = atomic_load_explicit(&registry->keys[slot], memory_order_acquire);
+        if (stored == 0) {
+            return OBI_NODE_INVALID;
+        }
+        if (stored == key) {
+            return registry->ids[slot];
+        }
+    }
+    return OBI_NODE_INVALID;
+}
+
+bool obi_node_registry_insert(obi_node_registry_t *registry, uint32_t key, obi_node_id_t id) {
+    if (key == 0) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < OBI_NODE_REGISTRY_SLOTS; i++) {
+        uint32_t slot = (key + i) & (OBI_NODE_REGISTRY_SLOTS - 1);
+        uint32_t stored = atomic_load_explicit(&registry->keys[slot], memory_order_relaxed);
+        if (stored == key) {
+            return false;  // keys identify nodes on the wire and must stay unique
+        }
+        if (stored == 0) {
+            registry->ids[slot] = id;
+            atomic_store_explicit(&registry->keys[slot], key, memory_order_release);
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,99 @@
+/*
+ * OBI Topology Relaying
+ * Transit frames are forwarded one frame at a time, as soon as they are
+ * read, so a fragmented message streams through a ring with every hop busy
+ * at once and throughput is set by the slowest hop. A frame the next hop
+ * cannot take yet is held and retried instead of dropped, and nothing
+ * behind it is read meanwhile: a full hop pushes back along the path
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "topology_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+static obi_result_t forward(obi_topology_context_t *ctx, obi_node_id_t destination,
+                            const obi_topology_frame_t *frame, const uint8_t *payload) {
+    unsigned slot;
+    const obi_route_table_t *routes = obi_route_acquire(&ctx->routes, &slot);
+    obi_result_t result = obi_topology_forward_frame(ctx, routes, destination, frame, payload);
+    obi_route_release(&ctx->routes, slot);
+    if (result == OBI_SUCCESS) {
+        atomic_fetch_add_explicit(&ctx->relayed_frames, 1, memory_order_relaxed);
+        ctx->relay_unflushed = true;
+    }
+    return result;
+}
+
+// The STAR hub queues data frames for aggregation; everything else goes straight on
+static obi_result_t relay_once(obi_topology_context_t *ctx, obi_node_id_t destination,
+                               const obi_topology_frame_t *frame, const uint8_t *payload) {
+    obi_result_t result;
+    if (obi_topology_hub_accept(ctx, destination, frame, payload, &result)) {
+        return result;
+    }
+    return forward(ctx, destination, frame, payload);
+}
+
+void obi_topology_relay_frame(obi_topology_context_t *ctx, obi_node_id_t destination,
+                              const obi_topology_frame_t *frame, const uint8_t *payload) {
+    obi_result_t result = relay_once(ctx, destination, frame, payload);
+    if (result == OBI_SUCCESS) {
+        return;
+    }
+    if (result != OBI_ERROR_WOULD_BLOCK) {
+        atomic_fetch_add_explicit(&ctx->relay_drops, 1, memory_order_relaxed);
+        return;
+    }
+
+    // The next hop is full: keep the frame and let our own ring fill behind it
+    if (!ctx->relay_payload) {
+        ctx->relay_payload = malloc(ctx->transport->max_frame_payload);
+    }
+    if (!ctx->relay_payload || frame->length > ctx->transport->max_frame_payload) {
+        atomic_fetch_add_explicit(&ctx->relay_drops, 1, memory_order_relaxed);
+        return;
+    }
+    memcpy(ctx->relay_payload, payload, frame->length);
+    ctx->relay_frame = *frame;
+    ctx->relay_destination = destination;
+    ctx->relay_held_ns = obi_topology_now_ns();
+    ctx->relay_pending = true;
+    atomic_fetch_add_explicit(&ctx->relay_stalls, 1, memory_order_relaxed);
+
+    // Batching transports may be holding the hop's earlier frames
+    obi_topology_transport_flush(ctx);
+}
+
+bool obi_topology_relay_blocked(obi_topology_context_t *ctx) {
+    if (!ctx->relay_pending) {
+        return false;
+    }
+    obi_result_t result = relay_once(ctx, ctx->relay_destination, &ctx->relay_frame, ctx->relay_payload);
+    if (result == OBI_ERROR_WOULD_BLOCK && obi_topology_now_ns() - ctx->relay_held_ns < OBI_RELAY_STALL_NS) {
+        return true;
+    }
+    if (result != OBI_SUCCESS) {
+        atomic_fetch_add_explicit(&ctx->relay_drops, 1, memory_order_relaxed);
+    }
+    ctx->relay_pending = false;
+    return false;
+}
+
+// Nothing left to read: frames forwarded meanwhile leave now, not at the
+// transport's batch deadline
+void obi_topology_relay_idle(obi_topology_context_t *ctx) {
+    obi_topology_hub_flush(ctx);
+    if (ctx->relay_unflushed) {
+        ctx->relay_unflushed = false;
+        obi_topology_transport_flush(ctx);
+    }
+}
+
+void obi_topology_relay_release(obi_topology_context_t *ctx) {
+    free(ctx->relay_payload);
+    ctx->relay_payload = NULL;
+    ctx->relay_pending = false;
+    ctx->relay_unflushed = false;
+}
@@ -0,0 +1,474 @@
+/*
+ * OBI Topology Routing
+ * Derives the link set implied by each topology type and precomputes
+ * all-pairs shortest-path next hops whenever the topology changes
+ */
+
+#include "obitopology_routing.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Effective link cost between two active nodes under a topology type
+static uint32_t effective_cost(const obi_route_graph_t *graph, obi_topology_type_t type,
+                               const obi_node_id_t *ring_next, obi_node_id_t a, obi_node_id_t b) {
+    uint16_t explicit_cost = graph->link_cost[a][b];
+
+    switch (type) {
+        case OBI_TOPOLOGY_P2P:
+        case OBI_TOPOLOGY_BUS:
+            // Every node shares the medium / can dial every other node directly
+            return explicit_cost ? explicit_cost : 1;
+
+        case OBI_TOPOLOGY_RING:
+            return (ring_next[a] == b || ring_next[b] == a) ? 1 : 0;
+
+        case OBI_TOPOLOGY_STAR:
+            return (a == graph->hub || b == graph->hub) ? 1 : 0;
+
+        case OBI_TOPOLOGY_MESH:
+        case OBI_TOPOLOGY_HYBRID:
+            // Declared links only; an undeclared mesh is fully connected
+            if (graph->link_count == 0) {
+                return 1;
+            }
+            return explicit_cost;
+    }
+
+    return 0;
+}
+
+// Fill the effective cost matrix (0 = no link) for every pair of active nodes
+static void compute_costs(const obi_route_graph_t *graph, obi_topology_type_t type, uint32_t *cost) {
+    uint32_t n = graph->node_count;
+
+    // Ring order follows node id order over active nodes
+    obi_node_id_t ring_next[OBI_TOPOLOGY_MAX_NODES];
+    obi_node_id_t first = OBI_NODE_INVALID;
+    obi_node_id_t previous = OBI_NODE_INVALID;
+    for (uint32_t i = 0; i < n; i++) {
+        ring_next[i] = OBI_NODE_INVALID;
+        if (!graph->active[i]) {
+            continue;
+        }
+        if (previous != OBI_NODE_INVALID) {
+            ring_next[previous] = (obi_node_id_t)i;
+        } else {
+            first = (obi_node_id_t)i;
+        }
+        previous = (obi_node_id_t)i;
+    }
+    if (previous != OBI_NODE_INVALID && previous != first) {
+        ring_next[previous] = first;
+    }
+
+    for (uint32_t a = 0; a < n; a++) {
+        for (uint32_t b = 0; b < n; b++) {
+            cost[(size_t)a * n + b] = (a != b && graph->active[a] && graph->active[b])
+                ? effective_cost(graph, type, ring_next, (obi_node_id_t)a, (obi_node_id_t)b)
+                : 0;
+        }
+    }
+}
+
+static obi_route_table_t *table_create(uint32_t n, obi_topology_type_t type) {
+    size_t cells = (size_t)n * n + 1;
+    obi_route_table_t *table = calloc(1, sizeof(*table));
+    if (!table) {
+        return NULL;
+    }
+
+    table->node_count = n;
+    table->type = type;
+    table->protected_source = OBI_NODE_INVALID;
+    table->next_hop = malloc(cells * sizeof(obi_node_id_t));
+    table->parent = malloc(cells * sizeof(obi_node_id_t));
+    table->distance = malloc(cells * sizeof(uint32_t));
+    table->cost = malloc(cells * sizeof(uint32_t));
+    if (!table->next_hop || !table->parent || !table->distance || !table->cost) {
+        obi_route_table_destroy(table);
+        return NULL;
+    }
+    return table;
+}
+
+static void reset_row(obi_route_table_t *table, obi_node_id_t source) {
+    uint32_t n = table->node_count;
+    for (uint32_t i = 0; i < n; i++) {
+        table->distance[(size_t)source * n + i] = OBI_ROUTE_UNREACHABLE;
+        table->next_hop[(size_t)source * n + i] = OBI_NODE_INVALID;
+        table->parent[(size_t)source * n + i] = OBI_NODE_INVALID;
+    }
+}
+
+static void set_label(obi_route_table_t *table, obi_node_id_t source, obi_node_id_t via,
+                      obi_node_id_t node, uint32_t distance) {
+    size_t row = (size_t)source * table->node_count;
+    table->distance[row + node] = distance;
+    table->parent[row + node] = via;
+    // First hop is inherited along the path; neighbours of the source are their own hop
+    table->next_hop[row + node] = (via == source) ? node : table->next_hop[row + via];
+    table->touched++;
+}
+
+// Dense label-correcting Dijkstra: settles queued nodes and everything their
+// labels improve. O(n) selection suits the small dense node sets here
+static void settle(obi_route_table_t *table, obi_node_id_t source, bool *queued) {
+    uint32_t n = table->node_count;
+    uint32_t *dist = &table->distance[(size_t)source * n];
+
+    for (;;) {
+        uint32_t best = OBI_ROUTE_UNREACHABLE;
+        uint32_t u = n;
+        for (uint32_t i = 0; i < n; i++) {
+            if (queued[i] && dist[i] < best) {
+                best = dist[i];
+                u = i;
+            }
+        }
+        if (u == n) {
+            break;
+        }
+        queued[u] = false;
+
+        for (uint32_t v = 0; v < n; v++) {
+            uint32_t c = table->cost[(size_t)u * n + v];
+            if (c != 0 && dist[u] + c < dist[v]) {
+                set_label(table, source, (obi_node_id_t)u, (obi_node_id_t)v, dist[u] + c);
+                queued[v] = true;
+            }
+        }
+    }
+}
+
+static void full_row(obi_route_table_t *table, const obi_route_graph_t *graph, obi_node_id_t source) {
+    bool queued[OBI_TOPOLOGY_MAX_NODES] = {false};
+
+    reset_row(table, source);
+    if (!graph->active[source]) {
+        return;
+    }
+    set_label(table, source, source, source, 0);
+    queued[source] = true;
+    settle(table, source, queued);
+}
+
+// A node is routed in a table exactly when its own distance label is set
+static bool was_member(const obi_route_table_t *table, uint32_t node) {
+    return node < table->node_count &&
+           table->distance[(size_t)node * table->node_count + node] != OBI_ROUTE_UNREACHABLE;
+}
+
+// HYBRID tables carry the partition ring; it is reused while the active set is unchanged
+static bool attach_partition(obi_route_table_t *table, const obi_route_graph_t *graph,
+                             const obi_route_table_t *previous) {
+    if (table->type != OBI_TOPOLOGY_HYBRID) {
+        return true;
+    }
+    if (previous && previous->partition.points) {
+        bool unchanged = true;
+        for (uint32_t i = 0; i < graph->node_count && unchanged; i++) {
+            unchanged = was_member(previous, i) == graph->active[i];
+        }
+        if (unchanged) {
+            return obi_partition_ring_copy(&table->partition, &previous->partition, OBI_NODE_INVALID);
+        }
+    }
+    return obi_partition_ring_build(&table->partition, graph);
+}
+
+obi_route_table_t *obi_route_table_build(const obi_route_graph_t *graph, obi_topology_type_t type) {
+    if (!graph || graph->node_count > OBI_TOPOLOGY_MAX_NODES) {
+        return NULL;
+    }
+
+    obi_route_table_t *table = table_create(graph->node_count, type);
+    if (!table) {
+        return NULL;
+    }
+
+    compute_costs(graph, type, table->cost);
+    for (uint32_t source = 0; source < table->node_count; source++) {
+        full_row(table, graph, (obi_node_id_t)source);
+    }
+    if (!attach_partition(table, graph, NULL)) {
+        obi_route_table_destroy(table);
+        return NULL;
+    }
+    return table;
+}
+
+// Link changes between two tables, packed as (from << 16 | to)
+typedef struct {
+    uint32_t *raised;         // removed or more expensive
+    uint32_t raised_count;
+    uint32_t *lowered;        // added or cheaper
+    uint32_t lowered_count;
+} route_delta_t;
+
+static uint32_t old_cost(const obi_route_table_t *previous, uint32_t a, uint32_t b) {
+    uint32_t m = previous->node_count;
+    return (a < m && b < m) ? previous->cost[(size_t)a * m + b] : 0;
+}
+
+static bool collect_delta(const obi_route_table_t *previous, const obi_route_table_t *table,
+                          route_delta_t *delta, uint32_t limit) {
+    uint32_t n = table->node_count;
+
+    for (uint32_t a = 0; a < n; a++) {
+        for (uint32_t b = 0; b < n; b++) {
+            uint32_t before = old_cost(previous, a, b);
+            uint32_t after = table->cost[(size_t)a * n + b];
+            if (before == after) {
+                continue;
+            }
+            if (delta->raised_count + delta->lowered_count == limit) {
+                return false;
+            }
+            if (after == 0 || (before != 0 && after > before)) {
+                delta->raised[delta->raised_count++] = a << 16 | b;
+            } else {
+                delta->lowered[delta->lowered_count++] = a << 16 | b;
+            }
+        }
+    }
+    return true;
+}
+
+// Ramalingam-Reps style repair of one source row: invalidate the subtrees
+// hanging off raised tree links, re-seed them from their unaffected
+// neighbours, relax lowered links, then settle only what changed
+static void repair_row(obi_route_table_t *table, const obi_route_graph_t *graph,
+                       const route_delta_t *delta, obi_node_id_t source) {
+    enum { UNKNOWN, CLEAN, AFFECTED };
+    uint8_t state[OBI_TOPOLOGY_MAX_NODES] = {UNKNOWN};
+    bool queued[OBI_TOPOLOGY_MAX_NODES] = {false};
+    bool raised_tree_link[OBI_TOPOLOGY_MAX_NODES] = {false};
+    uint32_t n = table->node_count;
+    size_t row = (size_t)source * n;
+    uint32_t *dist = &table->distance[row];
+
+    for (uint32_t i = 0; i < delta->raised_count; i++) {
+        uint32_t from = delta->raised[i] >> 16;
+        uint32_t to = delta->raised[i] & 0xFFFF;
+        if (table->parent[row + to] == from && to != source) {
+            raised_tree_link[to] = true;
+        }
+    }
+
+    // Classify every node by walking its tree path towards the source
+    for (uint32_t x = 0; x < n; x++) {
+        obi_node_id_t path[OBI_TOPOLOGY_MAX_NODES];
+        uint32_t depth = 0;
+        uint32_t node = x;
+
+        while (state[node] == UNKNOWN) {
+            if (node == source || dist[node] == OBI_ROUTE_UNREACHABLE) {
+                state[node] = CLEAN;
+                break;
+            }
+            if (!graph->active[node] || raised_tree_link[node]) {
+                state[node] = AFFECTED;
+                break;
+            }
+            path[depth++] = (obi_node_id_t)node;
+            node = table->parent[row + node];
+        }
+        while (depth > 0) {
+            state[path[--depth]] = state[node];
+        }
+    }
+
+    for (uint32_t x = 0; x < n; x++) {
+        if (state[x] == AFFECTED) {
+            dist[x] = OBI_ROUTE_UNREACHABLE;
+            table->next_hop[row + x] = OBI_NODE_INVALID;
+            table->parent[row + x] = OBI_NODE_INVALID;
+        }
+    }
+
+    for (uint32_t x = 0; x < n; x++) {
+        if (state[x] != AFFECTED || !graph->active[x]) {
+            continue;
+        }
+        uint32_t best = OBI_ROUTE_UNREACHABLE;
+        obi_node_id_t via = OBI_NODE_INVALID;
+        for (uint32_t w = 0; w < n; w++) {
+            uint32_t c = table->cost[(size_t)w * n + x];
+            if (c != 0 && state[w] == CLEAN && dist[w] != OBI_ROUTE_UNREACHABLE && dist[w] + c < best) {
+                best = dist[w] + c;
+                via = (obi_node_id_t)w;
+            }
+        }
+        if (via != OBI_NODE_INVALID) {
+            set_label(table, source, via, (obi_node_id_t)x, best);
+            queued[x] = true;
+        }
+    }
+
+    for (uint32_t i = 0; i < delta->lowered_count; i++) {
+        uint32_t from = delta->lowered[i] >> 16;
+        uint32_t to = delta->lowered[i] & 0xFFFF;
+        uint32_t c = table->cost[(size_t)from * n + to];
+        if (dist[from] != OBI_ROUTE_UNREACHABLE && dist[from] + c < dist[to]) {
+            set_label(table, source, (obi_node_id_t)from, (obi_node_id_t)to, dist[from] + c);
+            queued[to] = true;
+        }
+    }
+
+    settle(table, source, queued);
+}
+
+obi_route_table_t *obi_route_table_update(const obi_route_table_t *previous,
+                                          const obi_route_graph_t *graph, obi_topology_type_t type) {
+    if (!previous || !graph || previous->type != type ||
+        graph->node_count < previous->node_count || graph->node_count > OBI_TOPOLOGY_MAX_NODES) {
+        return obi_route_table_build(graph, type);
+    }
+
+    uint32_t n = graph->node_count;
+    uint32_t m = previous->node_count;
+    obi_route_table_t *table = table_create(n, type);
+    if (!table) {
+        return NULL;
+    }
+    compute_costs(graph, type, table->cost);
+
+    // Past a quarter of all links changing, a full rebuild is cheaper
+    uint32_t limit = n * n / 4 + 1;
+    route_delta_t delta = {0};
+    delta.raised = malloc(limit * sizeof(uint32_t));
+    delta.lowered = malloc(limit * sizeof(uint32_t));
+    if (!delta.raised || !delta.lowered || !collect_delta(previous, table, &delta, limit)) {
+        free(delta.raised);
+        free(delta.lowered);
+        obi_route_table_destroy(table);
+        return obi_route_table_build(graph, type);
+    }
+
+    for (uint32_t source = 0; source < n; source++) {
+        size_t row = (size_t)source * n;
+
+        if (!was_member(previous, source) || !graph->active[source]) {
+            full_row(table, graph, (obi_node_id_t)source);
+            continue;
+        }
+
+        // Start from the previous labels; new nodes begin unreachable
+        for (uint32_t d = 0; d < n; d++) {
+            size_t old = (size_t)source * m + d;
+            table->distance[row + d] = d < m ? previous->distance[old] : OBI_ROUTE_UNREACHABLE;
+            table->next_hop[row + d] = d < m ? previous->next_hop[old] : OBI_NODE_INVALID;
+            table->parent[row + d] = d < m ? previous->parent[old] : OBI_NODE_INVALID;
+        }
+        repair_row(table, graph, &delta, (obi_node_id_t)source);
+    }
+
+    free(delta.raised);
+    free(delta.lowered);
+    if (!attach_partition(table, graph, previous)) {
+        obi_route_table_destroy(table);
+        return NULL;
+    }
+    return table;
+}
+
+void obi_route_table_protect(obi_route_table_t *table, obi_node_id_t source) {
+    uint32_t n = table->node_count;
+    if (source >= n) {
+        return;
+    }
+    if (!table->backup_hop) {
+        table->backup_hop = malloc(((size_t)n + 1) * sizeof(obi_node_id_t));
+        if (!table->backup_hop) {
+            return;
+        }
+    }
+    table->protected_source = source;
+
+    obi_node_id_t neighbours[OBI_TOPOLOGY_MAX_NODES];
+    uint32_t degree = 0;
+    for (uint32_t h = 0; h < n; h++) {
+        if (table->cost[(size_t)source * n + h] != 0) {
+            neighbours[degree++] = (obi_node_id_t)h;
+        }
+    }
+
+    const uint32_t *dist = table->distance;
+    for (uint32_t d = 0; d < n; d++) {
+        obi_node_id_t primary = table->next_hop[(size_t)source * n + d];
+        uint32_t best = OBI_ROUTE_UNREACHABLE;
+        table->backup_hop[d] = OBI_NODE_INVALID;
+        if (primary == OBI_NODE_INVALID || primary == source || primary == d) {
+            continue;  // nothing to protect, or the destination is the failed node itself
+        }
+
+        // Node-protecting LFA (RFC 5286): the neighbour's own shortest path
+        // to d must not run through the primary hop
+        for (uint32_t i = 0; i < degree; i++) {
+            obi_node_id_t h = neighbours[i];
+            uint32_t h_to_d = dist[(size_t)h * n + d];
+            uint32_t h_to_p = dist[(size_t)h * n + primary];
+            uint32_t p_to_d = dist[(size_t)primary * n + d];
+            if (h == primary || h_to_d == OBI_ROUTE_UNREACHABLE) {
+                continue;
+            }
+            if (h_to_p != OBI_ROUTE_UNREACHABLE && p_to_d != OBI_ROUTE_UNREACHABLE &&
+                h_to_d >= h_to_p + p_to_d) {
+                continue;
+            }
+            uint32_t via = table->cost[(size_t)source * n + h] + h_to_d;
+            if (via < best) {
+                best = via;
+                table->backup_hop[d] = h;
+            }
+        }
+    }
+}
+
+obi_route_table_t *obi_route_table_failover(const obi_route_table_t *table, obi_node_id_t failed) {
+    uint32_t n = table->node_count;
+    obi_node_id_t source = table->protected_source;
+    if (source >= n || !table->backup_hop) {
+        return NULL;
+    }
+
+    obi_route_table_t *copy = table_create(n, table->type);
+    if (!copy) {
+        return NULL;
+    }
+    size_t cells = (size_t)n * n;
+    memcpy(copy->next_hop, table->next_hop, cells * sizeof(obi_node_id_t));
+    memcpy(copy->distance, table->distance, cells * sizeof(uint32_t));
+    memcpy(copy->parent, table->parent, cells * sizeof(obi_node_id_t));
+    memcpy(copy->cost, table->cost, cells * sizeof(uint32_t));
+    copy->version = table->version;
+
+    // Keys owned by the failed node move to their ring successors
+    if (table->partition.points &&
+        !obi_partition_ring_copy(&copy->partition, &table->partition, failed)) {
+        obi_route_table_destroy(copy);
+        return NULL;
+    }
+
+    // Redirect every destination behind the failed hop; no route search
+    obi_node_id_t *row = &copy->next_hop[(size_t)source * n];
+    for (uint32_t d = 0; d < n; d++) {
+        if (row[d] == failed && d != source) {
+            row[d] = d == failed ? OBI_NODE_INVALID : table->backup_hop[d];
+        }
+    }
+    return copy;
+}
+
+void obi_route_table_destroy(obi_route_table_t *table) {
+    if (!table) {
+        return;
+    }
+    obi_partition_ring_destroy(&table->partition);
+    free(table->backup_hop);
+    free(table->next_hop);
+    free(table->distance);
+    free(table->parent);
+    free(table->cost);
+    free(table);
+}
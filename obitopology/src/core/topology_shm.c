@@ -0,0 +1,830 @@
+/*
+ * OBI Topology Shared-Memory Transport
+ * Lock-free SPSC/MPSC ring buffers in POSIX shared memory
+ * Producers reserve a slot, write the frame in place and publish it
+ * with a single release store - no syscalls on the fast path
+ * Broadcasts write the payload once into a refcounted block of the
+ * sender's pool and push only a reference into each recipient ring
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "obitopology_transport.h"
+#include "topology_internal.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sched.h>
+#include <stddef.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define SHM_CACHE_LINE 64
+
+// Ring header at the start of the shared-memory object
+typedef struct {
+    _Atomic uint32_t magic;        // stored last by the owner once slots are ready
+    uint32_t slot_count;
+    uint32_t slot_stride;
+    int32_t owner_pid;             // creator; a dead one marks the ring stale
+    alignas(SHM_CACHE_LINE) _Atomic uint64_t enqueue_pos;
+    alignas(SHM_CACHE_LINE) _Atomic uint64_t dequeue_pos;
+} shm_ring_header_t;
+
+// Per-slot header; sequence == position + 1 means "published"
+typedef struct {
+    _Atomic uint64_t sequence;
+    uint32_t length;
+    uint32_t reserved;
+} shm_slot_t;
+
+struct obi_shm_ring {
+    shm_ring_header_t *header;
+    uint8_t *slots;
+    size_t map_size;
+    uint64_t mask;
+    uint32_t stride;
+    bool owner;
+    bool single_producer;
+    char name[OBI_TRANSPORT_MAX_ADDRESS];
+};
+
+// Broadcast pool header at the start of "/obitopo.<node>.pool"
+typedef struct {
+    _Atomic uint32_t magic;        // stored last by the owner once blocks are ready
+    uint32_t block_count;
+    uint32_t block_stride;
+    int32_t owner_pid;             // creator; a dead one marks the pool stale
+    uint64_t instance;             // tells a restarted sender's pool from its predecessor
+} shm_pool_header_t;
+
+// Per-block header; refs counts recipients that have not consumed it yet
+typedef struct {
+    _Atomic uint32_t refs;
+    uint32_t length;
+} shm_block_t;
+
+// What a recipient ring carries in place of a broadcast payload
+typedef struct {
+    uint64_t instance;
+    uint32_t block;
+    uint32_t reserved;
+    char pool[OBI_TRANSPORT_MAX_ADDRESS];
+} shm_shared_ref_t;
+
+typedef struct {
+    shm_pool_header_t *header;
+    uint8_t *blocks;
+    size_t map_size;
+    bool owner;
+    char name[OBI_TRANSPORT_MAX_ADDRESS];
+} shm_pool_t;
+
+typedef struct {
+    obi_topology_transport_t base;
+    obi_shm_config_t config;
+    obi_shm_ring_t *inbound;
+
+    // Broadcast: our own pool (created on first use) and senders' pools we consume from
+    char pool_name[OBI_TRANSPORT_MAX_ADDRESS];
+    shm_pool_t *_Atomic outbound_pool;
+    atomic_flag pool_lock;    // concurrent first broadcasts create the pool once
+    _Atomic uint32_t pool_cursor;
+    shm_pool_t *pools[OBI_SHM_MAX_POOLS];
+    uint32_t pool_victim;
+} shm_transport_t;
+
+static size_t ring_header_size(void) {
+    return (sizeof(shm_ring_header_t) + SHM_CACHE_LINE - 1) & ~(size_t)(SHM_CACHE_LINE - 1);
+}
+
+static uint32_t round_up_pow2(uint32_t value) {
+    uint32_t result = 1;
+    while (result < value && result < (1u << 30)) {
+        result <<= 1;
+    }
+    return result;
+}
+
+static shm_slot_t *slot_at(const obi_shm_ring_t *ring, uint64_t position) {
+    return (shm_slot_t *)(ring->slots + (size_t)(position & ring->mask) * ring->stride);
+}
+
+static bool build_shm_name(const char *address, char *name, size_t name_size) {
+    if (!address || !*address || strchr(address, '/')) {
+        return false;
+    }
+    int written = snprintf(name, name_size, "%s%s", OBI_SHM_NAME_PREFIX, address);
+    return written > 0 && (size_t)written < name_size;
+}
+
+// True when name exists but its creator has exited. An object still being
+// initialised, or owned by a live process, is never taken over
+static bool shm_object_stale(const char *name, size_t owner_offset) {
+    int fd = shm_open(name, O_RDONLY, 0600);
+    if (fd < 0) {
+        return errno == ENOENT;  // already gone; creating again is safe
+    }
+
+    bool stale = false;
+    struct stat st;
+    size_t header = owner_offset + sizeof(int32_t);
+    if (fstat(fd, &st) == 0 && (size_t)st.st_size >= header) {
+        void *base = mmap(NULL, header, PROT_READ, MAP_SHARED, fd, 0);
+        if (base != MAP_FAILED) {
+            // Both headers start with the magic, stored after the owner pid
+            uint32_t magic = atomic_load_explicit((_Atomic uint32_t *)base, memory_order_acquire);
+            int32_t owner;
+            memcpy(&owner, (uint8_t *)base + owner_offset, sizeof(owner));
+            stale = (magic == OBI_SHM_RING_MAGIC || magic == OBI_SHM_POOL_MAGIC) && owner > 0 &&
+                    kill((pid_t)owner, 0) != 0 && errno == ESRCH;
+            munmap(base, header);
+        }
+    }
+    close(fd);
+    return stale;
+}
+
+// Exclusive create; an existing object is replaced only when stale
+static int shm_create_exclusive(const char *name, size_t owner_offset) {
+    int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0 && errno == EEXIST && shm_object_stale(name, owner_offset)) {
+        shm_unlink(name);
+        fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+    }
+    return fd;
+}
+
+static obi_result_t map_ring(obi_shm_ring_t *ring, int fd, size_t size) {
+    void *base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        return OBI_ERROR_NETWORK_FAILURE;
+    }
+    ring->header = base;
+    ring->slots = (uint8_t *)base + ring_header_size();
+    ring->map_size = size;
+    return OBI_SUCCESS;
+}
+
+obi_result_t obi_shm_ring_create(const char *name, const obi_shm_config_t *config,
+                                 obi_shm_ring_t **ring) {
+    if (!name || !config || !ring || config->slot_count == 0 ||
+        config->slot_size <= sizeof(shm_slot_t) + sizeof(obi_topology_frame_t)) {
+        return OBI_ERROR_INVALID_INPUT;
+    }
+
+    obi_shm_ring_t *r = calloc(1, sizeof(*r));
+    if (!r) {
+        return OBI_ERROR_OUT_OF_MEMORY;
+    }
+
+    uint32_t slot_count = round_up_pow2(config->slot_count);
+    uint32_t stride = (config->slot_size + SHM_CACHE_LINE - 1) & ~(uint32_t)(SHM_CACHE_LINE - 1);
+    size_t size = ring_header_size() + (size_t)slot_count * stride;
+
+    // A ring left behind by a crashed owner is replaced, never reused; a live
+    // owner's ring is never touched
+    int fd = shm_create_exclusive(name, offsetof(shm_ring_header_t, owner_pid));
+    if (fd < 0) {
+        free(r);
+        return OBI_ERROR_NETWORK_FAILURE;
+    }
+
+    if (ftruncate(fd, (off_t)size) != 0 || map_ring(r, fd, size) != OBI_SUCCESS) {
+        close(fd);
+        shm_unlink(name);
+        free(r);
+        return OBI_ERROR_NETWORK_FAILURE;
+    }
+    close(fd);
+
+    r->header->slot_count = slot_count;
+    r->header->slot_stride = stride;
+    r->header->owner_pid = (int32_t)getpid();
+    atomic_init(&r->header->enqueue_pos, 0);
+    atomic_init(&r->header->dequeue_pos, 0);
+    r->mask = slot_count - 1;
+    r->stride = stride;
+    r->owner = true;
+    r->single_producer = config->single_producer;
+    strncpy(r->name, name, sizeof(r->name) - 1);
+
+    for (uint64_t i = 0; i < slot_count; i++) {
+        atomic_init(&slot_at(r, i)->sequence, i);
+    }
+    atomic_store_explicit(&r->header->magic, OBI_SHM_RING_MAGIC, memory_order_release);
+
+    *ring = r;
+    return OBI_SUCCESS;
+}
+
+obi_result_t obi_shm_ring_attach(const char *name, bool single_producer, obi_shm_ring_t **ring) {
+    if (!name || !ring) {
+        return OBI_ERROR_INVALID_INPUT;
+    }
+
+    int fd = shm_open(name, O_RDWR, 0600);
+    if (fd < 0) {
+        return OBI_ERROR_NETWORK_FAILURE;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size <= ring_header_size()) {
+        close(fd);
+        return OBI_ERROR_NETWORK_FAILURE;
+    }
+
+    obi_shm_ring_t *r = calloc(1, sizeof(*r));
+    if (!r) {
+        close(fd);
+        return OBI_ERROR_OUT_OF_MEMORY;
+    }
+
+    obi_result_t result = map_ring(r, fd, (size_t)st.st_size);
+    close(fd);
+    if (result != OBI_SUCCESS) {
+        free(r);
+        return result;
+    }
+
+    // The geometry comes from another process; it must fit what was mapped
+    bool ready = atomic_load_explicit(&r->header->magic, memory_order_acquire) == OBI_SHM_RING_MAGIC;
+    uint32_t slot_count = r->header->slot_count;
+    uint32_t stride = r->header->slot_stride;
+    if (!ready || slot_count == 0 || (slot_count & (slot_count - 1)) != 0 ||
+        stride <= sizeof(shm_slot_t) + sizeof(obi_topology_frame_t) ||
+        ring_header_size() + (uint64_t)slot_count * stride > (uint64_t)st.st_size) {
+        munmap(r->header, r->map_size);
+        free(r);
+        return OBI_ERROR_NETWORK_FAILURE;
+    }
+
+    r->mask = slot_count - 1;
+    r->stride = stride;
+    r->owner = false;
+    r->single_producer = single_producer;
+    strncpy(r->name, name, sizeof(r->name) - 1);
+
+    *ring = r;
+    return OBI_SUCCESS;
+}
+
+void obi_shm_ring_close(obi_shm_ring_t *ring) {
+    if (!ring) {
+        return;
+    }
+
+    munmap(ring->header, ring->map_size);
+    if (ring->owner) {
+        shm_unlink(ring->name);
+    }
+    free(ring);
+}
+
+size_t obi_shm_ring_slot_capacity(const obi_shm_ring_t *ring) {
+    return ring ? ring->stride - sizeof(shm_slot_t) : 0;
+}
+
+uint8_t *obi_shm_ring_reserve(obi_shm_ring_t *ring, size_t length, obi_shm_reservation_t *reservation) {
+    if (!ring || !reservation || length > obi_shm_ring_slot_capacity(ring)) {
+        return NULL;
+    }
+
+    shm_ring_header_t *header = ring->header;
+    uint64_t pos = atomic_load_explicit(&header->enqueue_pos, memory_order_relaxed);
+    shm_slot_t *slot;
+
+    for (;;) {
+        slot = slot_at(ring, pos);
+        uint64_t seq = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+        int64_t diff = (int64_t)(seq - pos);
+
+        if (diff == 0) {
+            if (ring->single_producer) {
+                atomic_store_explicit(&header->enqueue_pos, pos + 1, memory_order_relaxed);
+                break;
+            }
+            if (atomic_compare_exchange_weak_explicit(&header->enqueue_pos, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return NULL;  // ring full
+        } else {
+            pos = atomic_load_explicit(&header->enqueue_pos, memory_order_relaxed);
+        }
+    }
+
+    reservation->position = pos;
+    reservation->slot = slot;
+    return (uint8_t *)(slot + 1);
+}
+
+size_t obi_shm_ring_reserve_batch(obi_shm_ring_t *ring, size_t count, obi_shm_reservation_t *reservations) {
+    if (!ring || !reservations || count == 0) {
+        return 0;
+    }
+
+    shm_ring_header_t *header = ring->header;
+    uint64_t pos = atomic_load_explicit(&header->enqueue_pos, memory_order_relaxed);
+    size_t claimed;
+
+    for (;;) {
+        // Slots free for this lap carry their own position; consumers only free more
+        claimed = 0;
+        while (claimed < count) {
+            uint64_t seq = atomic_load_explicit(&slot_at(ring, pos + claimed)->sequence, memory_order_acquire);
+            if (seq != pos + claimed) {
+                break;
+            }
+            claimed++;
+        }
+        if (claimed == 0) {
+            uint64_t seq = atomic_load_explicit(&slot_at(ring, pos)->sequence, memory_order_acquire);
+            if ((int64_t)(seq - pos) < 0) {
+                return 0;  // ring full
+            }
+            pos = atomic_load_explicit(&header->enqueue_pos, memory_order_relaxed);
+            continue;
+        }
+        if (ring->single_producer) {
+            atomic_store_explicit(&header->enqueue_pos, pos + claimed, memory_order_relaxed);
+            break;
+        }
+        if (atomic_compare_exchange_weak_explicit(&header->enqueue_pos, &pos, pos + claimed,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+            break;
+        }
+    }
+
+    for (size_t i = 0; i < claimed; i++) {
+        reservations[i].position = pos + i;
+        reservations[i].slot = slot_at(ring, pos + i);
+    }
+    return claimed;
+}
+
+void obi_shm_ring_publish(obi_shm_ring_t *ring, const obi_shm_reservation_t *reservation, size_t length) {
+    (void)ring;
+    shm_slot_t *slot = reservation->slot;
+    slot->length = (uint32_t)length;
+    atomic_store_explicit(&slot->sequence, reservation->position + 1, memory_order_release);
+}
+
+const uint8_t *obi_shm_ring_peek(obi_shm_ring_t *ring, size_t *length) {
+    if (!ring || !length) {
+        return NULL;
+    }
+
+    uint64_t pos = atomic_load_explicit(&ring->header->dequeue_pos, memory_order_relaxed);
+    shm_slot_t *slot = slot_at(ring, pos);
+    if (atomic_load_explicit(&slot->sequence, memory_order_acquire) != pos + 1) {
+        return NULL;
+    }
+
+    *length = slot->length;
+    return (const uint8_t *)(slot + 1);
+}
+
+void obi_shm_ring_release(obi_shm_ring_t *ring) {
+    uint64_t pos = atomic_load_explicit(&ring->header->dequeue_pos, memory_order_relaxed);
+    shm_slot_t *slot = slot_at(ring, pos);
+    atomic_store_explicit(&slot->sequence, pos + ring->mask + 1, memory_order_release);
+    atomic_store_explicit(&ring->header->dequeue_pos, pos + 1, memory_order_relaxed);
+}
+
+/*
+ * Broadcast pools
+ */
+
+static shm_block_t *block_at(const shm_pool_t *pool, uint32_t index) {
+    return (shm_block_t *)(pool->blocks + (size_t)index * pool->header->block_stride);
+}
+
+static size_t pool_header_size(void) {
+    return (sizeof(shm_pool_header_t) + SHM_CACHE_LINE - 1) & ~(size_t)(SHM_CACHE_LINE - 1);
+}
+
+static void pool_close(shm_pool_t *pool) {
+    if (!pool) {
+        return;
+    }
+    munmap(pool->header, pool->map_size);
+    if (pool->owner) {
+        shm_unlink(pool->name);
+    }
+    free(pool);
+}
+
+static shm_pool_t *pool_create(const char *name, uint32_t block_count, uint32_t payload_size) {
+    shm_pool_t *pool = calloc(1, sizeof(*pool));
+    if (!pool) {
+        return NULL;
+    }
+
+    uint32_t stride = (uint32_t)((sizeof(shm_block_t) + payload_size + SHM_CACHE_LINE - 1) &
+                                 ~(size_t)(SHM_CACHE_LINE - 1));
+    size_t size = pool_header_size() + (size_t)block_count * stride;
+
+    int fd = shm_create_exclusive(name, offsetof(shm_pool_header_t, owner_pid));
+    if (fd < 0) {
+        free(pool);
+        return NULL;
+    }
+
+    void *base = MAP_FAILED;
+    if (ftruncate(fd, (off_t)size) == 0) {
+        base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (base == MAP_FAILED) {
+        shm_unlink(name);
+        free(pool);
+        return NULL;
+    }
+
+    pool->header = base;
+    pool->blocks = (uint8_t *)base + pool_header_size();
+    pool->map_size = size;
+    pool->owner = true;
+    snprintf(pool->name, sizeof(pool->name), "%s", name);
+
+    pool->header->block_count = block_count;
+    pool->header->block_stride = stride;
+    pool->header->owner_pid = (int32_t)getpid();
+    pool->header->instance = ((uint64_t)getpid() << 32) ^ obi_topology_now_ns();
+    for (uint32_t i = 0; i < block_count; i++) {
+        atomic_init(&block_at(pool, i)->refs, 0);
+    }
+    atomic_store_explicit(&pool->header->magic, OBI_SHM_POOL_MAGIC, memory_order_release);
+    return pool;
+}
+
+static shm_pool_t *pool_attach(const char *name, uint64_t instance) {
+    int fd = shm_open(name, O_RDWR, 0600);
+    if (fd < 0) {
+        return NULL;
+    }
+
+    struct stat st;
+    void *base = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && (size_t)st.st_size > pool_header_size()) {
+        base = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (base == MAP_FAILED) {
+        return NULL;
+    }
+
+    shm_pool_header_t *header = base;
+    bool ready = atomic_load_explicit(&header->magic, memory_order_acquire) == OBI_SHM_POOL_MAGIC;
+    uint64_t needed = pool_header_size() + (uint64_t)header->block_count * header->block_stride;
+    if (!ready || header->instance != instance || header->block_stride < sizeof(shm_block_t) ||
+        needed > (uint64_t)st.st_size) {
+        munmap(base, (size_t)st.st_size);
+        return NULL;
+    }
+
+    shm_pool_t *pool = calloc(1, sizeof(*pool));
+    if (!pool) {
+        munmap(base, (size_t)st.st_size);
+        return NULL;
+    }
+    pool->header = header;
+    pool->blocks = (uint8_t *)base + pool_header_size();
+    pool->map_size = (size_t)st.st_size;
+    snprintf(pool->name, sizeof(pool->name), "%s", name);
+    return pool;
+}
+
+// Receive side: the referenced sender pool, mapped once and kept
+static shm_pool_t *find_pool(shm_transport_t *shm, shm_shared_ref_t *ref) {
+    for (uint32_t i = 0; i < OBI_SHM_MAX_POOLS; i++) {
+        if (shm->pools[i] && shm->pools[i]->header->instance == ref->instance) {
+            return shm->pools[i];
+        }
+    }
+
+    ref->pool[sizeof(ref->pool) - 1] = '\0';
+    shm_pool_t *pool = pool_attach(ref->pool, ref->instance);
+    if (!pool) {
+        return NULL;
+    }
+
+    // Prefer an empty entry, else evict round robin
+    uint32_t entry = shm->pool_victim;
+    for (uint32_t i = 0; i < OBI_SHM_MAX_POOLS; i++) {
+        if (!shm->pools[i]) {
+            entry = i;
+            break;
+        }
+    }
+    if (entry == shm->pool_victim) {
+        shm->pool_victim = (shm->pool_victim + 1) % OBI_SHM_MAX_POOLS;
+    }
+    pool_close(shm->pools[entry]);
+    shm->pools[entry] = pool;
+    return pool;
+}
+
+// Send side: claim a free block for refs recipients (blocks are free at refs == 0)
+static shm_block_t *pool_claim(shm_transport_t *shm, uint32_t refs, uint32_t *index) {
+    shm_pool_t *pool = shm->outbound_pool;
+    uint32_t count = pool->header->block_count;
+    uint32_t start = atomic_fetch_add_explicit(&shm->pool_cursor, 1, memory_order_relaxed);
+
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t candidate = (start + i) % count;
+        shm_block_t *block = block_at(pool, candidate);
+        uint32_t expected = 0;
+        if (atomic_compare_exchange_strong_explicit(&block->refs, &expected, refs,
+                                                    memory_order_acquire, memory_order_relaxed)) {
+            *index = candidate;
+            return block;
+        }
+    }
+    return NULL;  // every block still referenced; fall back to copies
+}
+
+/*
+ * Transport backend
+ */
+
+static obi_result_t shm_bind(obi_topology_transport_t *transport, const char *local_address) {
+    shm_transport_t *shm = (shm_transport_t *)transport;
+    char name[OBI_TRANSPORT_MAX_ADDRESS];
+
+    if (shm->inbound || !build_shm_name(local_address, name, sizeof(name))) {
+        return OBI_ERROR_INVALID_INPUT;
+    }
+
+    obi_result_t result = obi_shm_ring_create(name, &shm->config, &shm->inbound);
+    if (result == OBI_SUCCESS) {
+        transport->max_frame_payload = obi_shm_ring_slot_capacity(shm->inbound) - sizeof(obi_topology_frame_t);
+        // Without a pool name that fits, broadcasts fall back to per-peer copies
+        if (strlen(name) < sizeof(shm->pool_name) - sizeof(".pool") + 1) {
+            snprintf(shm->pool_name, sizeof(shm->pool_name), "%.58s.pool", name);
+        }
+    }
+    return result;
+}
+
+static obi_result_t shm_connect(obi_topology_transport_t *transport, const char *address, void **peer) {
+    shm_transport_t *shm = (shm_transport_t *)transport;
+    char name[OBI_TRANSPORT_MAX_ADDRESS];
+
+    if (!peer || !build_shm_name(address, name, sizeof(name))) {
+        return OBI_ERROR_INVALID_INPUT;
+    }
+
+    return obi_shm_ring_attach(name, shm->config.single_producer, (obi_shm_ring_t **)peer);
+}
+
+static obi_result_t shm_send(obi_topology_transport_t *transport, void *peer,
+                             const obi_topology_frame_t *frame, const uint8_t *payload) {
+    (void)transport;
+    obi_shm_ring_t *ring = peer;
+    size_t total = sizeof(*frame) + frame->length;
+
+    if (total > obi_shm_ring_slot_capacity(ring)) {
+        return OBI_ERROR_BUFFER_OVERFLOW;
+    }
+
+    obi_shm_reservation_t reservation;
+    uint8_t *slot = obi_shm_ring_reserve(ring, total, &reservation);
+    if (!slot) {
+        return OBI_ERROR_WOULD_BLOCK;
+    }
+
+    memcpy(slot, frame, sizeof(*frame));
+    if (frame->length > 0) {
+        memcpy(slot + sizeof(*frame), payload, frame->length);
+    }
+    obi_shm_ring_publish(ring, &reservation, total);
+    return OBI_SUCCESS;
+}
+
+// Frames per claim on the peer's ring; longer vectors take several
+#define SHM_VECTOR_CHUNK 64
+
+static size_t shm_send_vector(obi_topology_transport_t *transport, void *peer, const obi_topology_frame_t *frames,
+                              const uint8_t *const *payloads, size_t count) {
+    (void)transport;
+    obi_shm_ring_t *ring = peer;
+    size_t capacity = obi_shm_ring_slot_capacity(ring);
+    size_t sent = 0;
+
+    while (sent < count) {
+        // An oversized frame ends the vector; the caller sees it refused
+        size_t chunk = 0;
+        while (chunk < SHM_VECTOR_CHUNK && sent + chunk < count &&
+               sizeof(frames[0]) + frames[sent + chunk].length <= capacity) {
+            chunk++;
+        }
+        obi_shm_reservation_t reservations[SHM_VECTOR_CHUNK];
+        size_t claimed = chunk ? obi_shm_ring_reserve_batch(ring, chunk, reservations) : 0;
+        for (size_t i = 0; i < claimed; i++) {
+            const obi_topology_frame_t *frame = &frames[sent + i];
+            uint8_t *slot = (uint8_t *)((shm_slot_t *)reservations[i].slot + 1);
+            memcpy(slot, frame, sizeof(*frame));
+            if (frame->length > 0) {
+                memcpy(slot + sizeof(*frame), payloads[sent + i], frame->length);
+            }
+            obi_shm_ring_publish(ring, &reservations[i], sizeof(*frame) + frame->length);
+        }
+        sent += claimed;
+        if (claimed < chunk || chunk == 0) {
+            break;
+        }
+    }
+    return sent;
+}
+
+static obi_result_t shm_receive(obi_topology_transport_t *transport, obi_topology_frame_t *frame,
+                                uint8_t *payload, size_t capacity) {
+    shm_transport_t *shm = (shm_transport_t *)transport;
+    size_t length;
+
+    if (!shm->inbound) {
+        return OBI_ERROR_NETWORK_FAILURE;
+    }
+
+    for (;;) {
+        const uint8_t *slot = obi_shm_ring_peek(shm->inbound, &length);
+        if (!slot) {
+            return OBI_ERROR_WOULD_BLOCK;
+        }
+
+        // Producers are other processes: a length that overruns the slot is dropped
+        if (length < sizeof(*frame) || length > obi_shm_ring_slot_capacity(shm->inbound)) {
+            obi_shm_ring_release(shm->inbound);
+            continue;
+        }
+        memcpy(frame, slot, sizeof(*frame));
+        if (frame->length > length - sizeof(*frame) && !(frame->flags & OBI_FRAME_FLAG_SHARED)) {
+            obi_shm_ring_release(shm->inbound);
+            continue;
+        }
+        if (frame->length > capacity) {
+            return OBI_ERROR_BUFFER_OVERFLOW;  // left queued for a larger buffer
+        }
+
+        if (!(frame->flags & OBI_FRAME_FLAG_SHARED)) {
+            memcpy(payload, slot + sizeof(*frame), frame->length);
+            obi_shm_ring_release(shm->inbound);
+            return OBI_SUCCESS;
+        }
+
+        // Broadcast reference: copy out of the sender's block, then drop our claim on it
+        shm_shared_ref_t ref;
+        if (length - sizeof(*frame) < sizeof(ref)) {
+            obi_shm_ring_release(shm->inbound);
+            continue;
+        }
+        memcpy(&ref, slot + sizeof(*frame), sizeof(ref));
+        shm_pool_t *pool = find_pool(shm, &ref);
+        shm_block_t *block = pool && ref.block < pool->header->block_count ? block_at(pool, ref.block) : NULL;
+        if (block && block->length == frame->length &&
+            frame->length <= pool->header->block_stride - sizeof(shm_block_t)) {
+            memcpy(payload, block + 1, frame->length);
+            atomic_fetch_sub_explicit(&block->refs, 1, memory_order_release);
+            obi_shm_ring_release(shm->inbound);
+            return OBI_SUCCESS;
+        }
+        obi_shm_ring_release(shm->inbound);  // sender gone; the reference is unusable
+    }
+}
+
+static void shm_broadcast(obi_topology_transport_t *transport, void *const *peers, size_t count,
+                          const obi_topology_frame_t *frames, const uint8_t *payload, obi_result_t *results) {
+    shm_transport_t *shm = (shm_transport_t *)transport;
+    uint32_t length = frames[0].length;
+    size_t total = sizeof(*frames) + sizeof(shm_shared_ref_t);
+
+    // The pool needs a bound name; a single recipient gains nothing from it
+    if (count > 1 && !atomic_load_explicit(&shm->outbound_pool, memory_order_acquire) && shm->pool_name[0]) {
+        while (atomic_flag_test_and_set_explicit(&shm->pool_lock, memory_order_acquire)) {
+            sched_yield();
+        }
+        if (!atomic_load_explicit(&shm->outbound_pool, memory_order_relaxed)) {
+            uint32_t blocks = shm->config.pool_blocks ? shm->config.pool_blocks : OBI_SHM_DEFAULT_POOL_BLOCKS;
+            atomic_store_explicit(&shm->outbound_pool,
+                                  pool_create(shm->pool_name, blocks, (uint32_t)transport->max_frame_payload),
+                                  memory_order_release);
+        }
+        atomic_flag_clear_explicit(&shm->pool_lock, memory_order_release);
+    }
+
+    uint32_t index = 0;
+    shm_block_t *block = NULL;
+    if (count > 1 && count <= UINT32_MAX && shm->outbound_pool && length <= transport->max_frame_payload) {
+        block = pool_claim(shm, (uint32_t)count, &index);
+    }
+    if (!block) {
+        for (size_t i = 0; i < count; i++) {
+            results[i] = shm_send(transport, peers[i], &frames[i], payload);
+        }
+        return;
+    }
+
+    // One payload write; every recipient gets a fixed-size reference
+    block->length = length;
+    memcpy(block + 1, payload, length);
+    shm_shared_ref_t ref = { shm->outbound_pool->header->instance, index, 0, {0} };
+    memcpy(ref.pool, shm->pool_name, sizeof(ref.pool));
+
+    uint32_t undelivered = 0;
+    for (size_t i = 0; i < count; i++) {
+        obi_shm_ring_t *ring = peers[i];
+        obi_shm_reservation_t reservation;
+        uint8_t *slot = total <= obi_shm_ring_slot_capacity(ring) ?
+                        obi_shm_ring_reserve(ring, total, &reservation) : NULL;
+        if (!slot) {
+            results[i] = OBI_ERROR_WOULD_BLOCK;
+            undelivered++;
+            continue;
+        }
+        obi_topology_frame_t shared = frames[i];
+        shared.flags |= OBI_FRAME_FLAG_SHARED;
+        memcpy(slot, &shared, sizeof(shared));
+        memcpy(slot + sizeof(shared), &ref, sizeof(ref));
+        obi_shm_ring_publish(ring, &reservation, total);
+        results[i] = OBI_SUCCESS;
+    }
+    if (undelivered) {
+        atomic_fetch_sub_explicit(&block->refs, undelivered, memory_order_release);
+    }
+}
+
+static obi_result_t shm_flush(obi_topology_transport_t *transport) {
+    (void)transport;
+    return OBI_SUCCESS;  // publish is already visible to the consumer
+}
+
+static size_t shm_queue_depth(obi_topology_transport_t *transport, void *peer) {
+    (void)transport;
+    obi_shm_ring_t *ring = peer;
+    uint64_t enqueued = atomic_load_explicit(&ring->header->enqueue_pos, memory_order_relaxed);
+    uint64_t dequeued = atomic_load_explicit(&ring->header->dequeue_pos, memory_order_relaxed);
+    return enqueued > dequeued ? (size_t)(enqueued - dequeued) : 0;
+}
+
+static void shm_disconnect(obi_topology_transport_t *transport, void *peer) {
+    (void)transport;
+    obi_shm_ring_close(peer);
+}
+
+static void shm_destroy(obi_topology_transport_t *transport) {
+    shm_transport_t *shm = (shm_transport_t *)transport;
+    obi_shm_ring_close(shm->inbound);
+    pool_close(shm->outbound_pool);
+    for (uint32_t i = 0; i < OBI_SHM_MAX_POOLS; i++) {
+        pool_close(shm->pools[i]);
+    }
+    free(shm);
+}
+
+static const obi_topology_transport_ops_t shm_transport_ops = {
+    .name = "shm",
+    .bind = shm_bind,
+    .connect = shm_connect,
+    .send = shm_send,
+    .receive = shm_receive,
+    .flush = shm_flush,
+    .queue_depth = shm_queue_depth,
+    .broadcast = shm_broadcast,
+    .send_vector = shm_send_vector,
+    .disconnect = shm_disconnect,
+    .destroy = shm_destroy
+};
+
+obi_topology_transport_t *obi_topology_transport_shm_create(const obi_shm_config_t *config) {
+    shm_transport_t *shm = calloc(1, sizeof(*shm));
+    if (!shm) {
+        return NULL;
+    }
+
+    shm->config.slot_count = OBI_SHM_DEFAULT_SLOT_COUNT;
+    shm->config.slot_size = OBI_SHM_DEFAULT_SLOT_SIZE;
+    shm->config.single_producer = false;
+    if (config) {
+        shm->config = *config;
+    }
+    if (shm->config.slot_size <= sizeof(shm_slot_t) + sizeof(obi_topology_frame_t)) {
+        free(shm);
+        return NULL;
+    }
+
+    shm->base.ops = &shm_transport_ops;
+    shm->base.max_frame_payload = shm->config.slot_size - sizeof(shm_slot_t) - sizeof(obi_topology_frame_t);
+    // MPSC rings take sends from any thread; the SPSC fast path does not
+    shm->base.concurrent = !shm->config.single_producer;
+    atomic_flag_clear(&shm->pool_lock);
+    return &shm->base;
+}
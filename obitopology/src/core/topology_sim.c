@@ -0,0 +1,499 @@
+/*
+ * OBI Topology Simulated Transport
+ * In-memory links between transports of one process, so a whole topology
+ * runs as threads on one box. Each link is a bounded FIFO stamped with a
+ * delivery time from its latency, jitter and bandwidth, and drops frames
+ * at its loss rate; draws come from a per-link generator seeded by the
+ * network, so runs repeat
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "obitopology_transport.h"
+#include "topology_internal.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <sched.h>
+#include <pthread.h>
+
+typedef struct sim_endpoint sim_endpoint_t;
+
+typedef struct {
+    uint64_t deliver_ns;
+    uint64_t start;           // payload position in the byte ring
+    obi_topology_frame_t frame;
+} sim_entry_t;
+
+// One direction between a sending transport and an endpoint
+typedef struct sim_link {
+    atomic_flag lock;
+    sim_endpoint_t *to;
+    char from[OBI_TRANSPORT_MAX_ADDRESS];
+    obi_sim_link_config_t config;
+    uint64_t rng;
+    uint64_t wire_free_ns;    // when the wire finishes the last frame sent
+    uint64_t last_deliver_ns;
+
+    // FIFO of entries; payloads in a byte ring, positions counted up forever
+    sim_entry_t *entries;
+    uint32_t head;
+    uint32_t count;
+    uint8_t *data;
+    uint64_t data_head;
+    uint64_t data_tail;
+    struct sim_link *next;    // all links of the network
+} sim_link_t;
+
+struct sim_endpoint {
+    char name[OBI_TRANSPORT_MAX_ADDRESS];
+    _Atomic bool bound;
+    sim_link_t *inbound[OBI_SIM_MAX_INBOUND];
+    _Atomic uint32_t inbound_count;
+};
+
+typedef struct {
+    char from[OBI_TRANSPORT_MAX_ADDRESS];
+    char to[OBI_TRANSPORT_MAX_ADDRESS];
+    obi_sim_link_config_t config;
+} sim_override_t;
+
+struct obi_sim_network {
+    pthread_mutex_t lock;     // endpoints, links and overrides; never held on the data path
+    obi_sim_config_t config;
+    sim_endpoint_t *endpoints[OBI_SIM_MAX_ENDPOINTS];
+    uint32_t endpoint_count;
+    sim_link_t *links;
+    sim_override_t *overrides;
+    uint32_t override_count;
+    _Atomic uint64_t frames_sent;
+    _Atomic uint64_t frames_delivered;
+    _Atomic uint64_t frames_lost;
+    _Atomic uint64_t frames_refused;
+    _Atomic uint64_t bytes_delivered;
+};
+
+typedef struct {
+    obi_topology_transport_t base;
+    obi_sim_network_t *network;
+    sim_endpoint_t *endpoint;                     // NULL until bound
+    sim_link_t *links[OBI_SIM_MAX_ENDPOINTS];     // by endpoint index, made on first connect
+    uint32_t cursor;                              // inbound link receive starts at
+} sim_transport_t;
+
+static void lock_link(sim_link_t *link) {
+    while (atomic_flag_test_and_set_explicit(&link->lock, memory_order_acquire)) {
+        sched_yield();
+    }
+}
+
+static void unlock_link(sim_link_t *link) {
+    atomic_flag_clear_explicit(&link->lock, memory_order_release);
+}
+
+// xorshift64*; the state never reaches 0
+static uint64_t next_random(sim_link_t *link) {
+    link->rng ^= link->rng >> 12;
+    link->rng ^= link->rng << 25;
+    link->rng ^= link->rng >> 27;
+    return link->rng * 2685821657736338717ull;
+}
+
+static uint64_t name_hash(const char *name) {
+    return obi_topology_partition_key(name, strlen(name));
+}
+
+static sim_override_t *find_override(const obi_sim_network_t *network, const char *from, const char *to) {
+    for (uint32_t i = 0; i < network->override_count; i++) {
+        sim_override_t *entry = &network->overrides[i];
+        if (strcmp(entry->from, from) == 0 && strcmp(entry->to, to) == 0) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+static sim_endpoint_t *find_endpoint(const obi_sim_network_t *network, const char *name, uint32_t *index) {
+    for (uint32_t i = 0; i < network->endpoint_count; i++) {
+        if (strcmp(network->endpoints[i]->name, name) == 0) {
+            if (index) {
+                *index = i;
+            }
+            return network->endpoints[i];
+        }
+    }
+    return NULL;
+}
+
+// Frames still queued toward an endpoint that went away are lost with it
+static void purge_inbound(obi_sim_network_t *network, sim_endpoint_t *endpoint) {
+    uint32_t count = atomic_load_explicit(&endpoint->inbound_count, memory_order_acquire);
+    for (uint32_t i = 0; i < count; i++) {
+        sim_link_t *link = endpoint->inbound[i];
+        lock_link(link);
+        atomic_fetch_add_explicit(&network->frames_lost, link->count, memory_order_relaxed);
+        link->count = 0;
+        link->data_head = link->data_tail;
+        unlock_link(link);
+    }
+}
+
+static sim_link_t *link_create(obi_sim_network_t *network, const char *from, sim_endpoint_t *to) {
+    sim_link_t *link = calloc(1, sizeof(*link));
+    if (!link) {
+        return NULL;
+    }
+    link->entries = malloc(network->config.queue_frames * sizeof(*link->entries));
+    link->data = malloc(network->config.queue_bytes);
+    if (!link->entries || !link->data) {
+        free(link->entries);
+        free(link->data);
+        free(link);
+        return NULL;
+    }
+    atomic_flag_clear(&link->lock);
+    link->to = to;
+    snprintf(link->from, sizeof(link->from), "%s", from);
+    sim_override_t *entry = find_override(network, from, to->name);
+    link->config = entry ? entry->config : network->config.link;
+    link->rng = (network->config.seed ^ name_hash(from) ^ (name_hash(to->name) * 0x9e3779b97f4a7c15ull)) | 1ull;
+    return link;
+}
+
+static obi_result_t sim_bind(obi_topology_transport_t *transport, const char *local_address) {
+    sim_transport_t *sim = (sim_transport_t *)transport;
+    obi_sim_network_t *network = sim->network;
+    if (sim->endpoint || !local_address || strlen(local_address) >= OBI_TRANSPORT_MAX_ADDRESS) {
+        return OBI_ERROR_INVALID_INPUT;
+    }
+
+    obi_result_t result = OBI_SUCCESS;
+    pthread_mutex_lock(&network->lock);
+    sim_endpoint_t *endpoint = find_endpoint(network, local_address, NULL);
+    if (endpoint && atomic_load(&endpoint->bound)) {
+        result = OBI_ERROR_INVALID_INPUT;  // address in use
+    } else if (!endpoint && network->endpoint_count == OBI_SIM_MAX_ENDPOINTS) {
+        result = OBI_ERROR_OUT_OF_MEMORY;
+    } else if (!endpoint) {
+        endpoint = calloc(1, sizeof(*endpoint));
+        if (endpoint) {
+            snprintf(endpoint->name, sizeof(endpoint->name), "%s", local_address);
+            network->endpoints[network->endpoint_count++] = endpoint;
+        } else {
+            result = OBI_ERROR_OUT_OF_MEMORY;
+        }
+    }
+    if (result == OBI_SUCCESS) {
+        purge_inbound(network, endpoint);
+        atomic_store(&endpoint->bound, true);
+        sim->endpoint = endpoint;
+    }
+    pthread_mutex_unlock(&network->lock);
+    return result;
+}
+
+static obi_result_t sim_connect(obi_topology_transport_t *transport, const char *address, void **peer) {
+    sim_transport_t *sim = (sim_transport_t *)transport;
+    obi_sim_network_t *network = sim->network;
+    if (!peer || !address) {
+        return OBI_ERROR_INVALID_INPUT;
+    }
+
+    // Like a ring nobody created: an address never bound cannot be reached yet
+    obi_result_t result = OBI_SUCCESS;
+    uint32_t index;
+    pthread_mutex_lock(&network->lock);
+    sim_endpoint_t *to = find_endpoint(network, address, &index);
+    if (!to) {
+        result = OBI_ERROR_NETWORK_FAILURE;
+    } else if (!sim->links[index]) {
+        uint32_t count = atomic_load_explicit(&to->inbound_count, memory_order_relaxed);
+        sim_link_t *link = count < OBI_SIM_MAX_INBOUND
+            ? link_create(network, sim->endpoint ? sim->endpoint->name : "", to) : NULL;
+        if (link) {
+            link->next = network->links;
+            network->links = link;
+            to->inbound[count] = link;
+            atomic_store_explicit(&to->inbound_count, count + 1, memory_order_release);
+            sim->links[index] = link;
+        } else {
+            result = OBI_ERROR_OUT_OF_MEMORY;
+        }
+    }
+    if (result == OBI_SUCCESS) {
+        *peer = sim->links[index];
+    }
+    pthread_mutex_unlock(&network->lock);
+    return result;
+}
+
+// Byte ring position for length payload bytes; a payload never wraps, so a
+// tail too close to the end skips to the start
+static bool reserve_bytes(const obi_sim_network_t *network, sim_link_t *link, uint32_t length, uint64_t *start) {
+    uint64_t capacity = network->config.queue_bytes;
+    uint64_t position = link->data_tail;
+    uint64_t offset = position % capacity;
+    if (offset + length > capacity) {
+        position += capacity - offset;
+    }
+    if (position + length - link->data_head > capacity) {
+        return false;
+    }
+    *start = position;
+    link->data_tail = position + length;
+    return true;
+}
+
+static obi_result_t sim_send(obi_topology_transport_t *transport, void *peer,
+                             const obi_topology_frame_t *frame, const uint8_t *payload) {
+    sim_transport_t *sim = (sim_transport_t *)transport;
+    obi_sim_network_t *network = sim->network;
+    sim_link_t *link = peer;
+    if (frame->length > transport->max_frame_payload) {
+        return OBI_ERROR_BUFFER_OVERFLOW;
+    }
+
+    lock_link(link);
+    if (!atomic_load_explicit(&link->to->bound, memory_order_acquire)) {
+        unlock_link(link);
+        atomic_fetch_add_explicit(&network->frames_sent, 1, memory_order_relaxed);
+        atomic_fetch_add_explicit(&network->frames_lost, 1, memory_order_relaxed);
+        return OBI_SUCCESS;
+    }
+
+    // A full link refuses before the frame reaches the wire
+    uint64_t start = 0;
+    uint64_t tail = link->data_tail;
+    if (link->count == network->config.queue_frames || !reserve_bytes(network, link, frame->length, &start)) {
+        unlock_link(link);
+        atomic_fetch_add_explicit(&network->frames_refused, 1, memory_order_relaxed);
+        return OBI_ERROR_WOULD_BLOCK;
+    }
+
+    // Serialisation, then propagation; a lost frame still used the wire
+    const obi_sim_link_config_t *config = &link->config;
+    uint64_t now = obi_topology_now_ns();
+    uint64_t on_wire = link->wire_free_ns > now ? link->wire_free_ns : now;
+    if (config->bandwidth) {
+        on_wire += (sizeof(*frame) + frame->length) * 1000000000ull / config->bandwidth;
+    }
+    link->wire_free_ns = on_wire;
+    bool lost = config->loss_ppm && next_random(link) % 1000000u < config->loss_ppm;
+    atomic_fetch_add_explicit(&network->frames_sent, 1, memory_order_relaxed);
+    if (lost) {
+        link->data_tail = tail;
+        unlock_link(link);
+        atomic_fetch_add_explicit(&network->frames_lost, 1, memory_order_relaxed);
+        return OBI_SUCCESS;
+    }
+
+    uint64_t deliver = on_wire + (uint64_t)config->latency_us * 1000ull;
+    if (config->jitter_us) {
+        deliver += next_random(link) % ((uint64_t)config->jitter_us * 1000ull + 1);
+    }
+    if (deliver < link->last_deliver_ns) {
+        deliver = link->last_deliver_ns;
+    }
+    link->last_deliver_ns = deliver;
+
+    if (link->count == 0) {
+        link->data_head = start;
+    }
+    sim_entry_t *entry = &link->entries[(link->head + link->count) % network->config.queue_frames];
+    entry->deliver_ns = deliver;
+    entry->start = start;
+    entry->frame = *frame;
+    if (frame->length) {
+        memcpy(link->data + start % network->config.queue_bytes, payload, frame->length);
+    }
+    link->count++;
+    unlock_link(link);
+    return OBI_SUCCESS;
+}
+
+static obi_result_t sim_receive(obi_topology_transport_t *transport, obi_topology_frame_t *frame,
+                                uint8_t *payload, size_t capacity) {
+    sim_transport_t *sim = (sim_transport_t *)transport;
+    obi_sim_network_t *network = sim->network;
+    if (!sim->endpoint) {
+        return OBI_ERROR_NETWORK_FAILURE;
+    }
+
+    // Links take turns, so one busy sender cannot starve the rest
+    uint32_t count = atomic_load_explicit(&sim->endpoint->inbound_count, memory_order_acquire);
+    uint64_t now = obi_topology_now_ns();
+    for (uint32_t i = 0; i < count; i++) {
+        sim_link_t *link = sim->endpoint->inbound[(sim->cursor + i) % count];
+        lock_link(link);
+        if (link->count == 0 || link->entries[link->head].deliver_ns > now) {
+            unlock_link(link);
+            continue;
+        }
+        sim_entry_t *entry = &link->entries[link->head];
+        *frame = entry->frame;
+        if (frame->length > capacity) {
+            unlock_link(link);
+            return OBI_ERROR_BUFFER_OVERFLOW;  // left queued for a larger buffer
+        }
+        if (frame->length) {
+            memcpy(payload, link->data + entry->start % network->config.queue_bytes, frame->length);
+        }
+        link->data_head = entry->start + frame->length;
+        link->head = (link->head + 1) % network->config.queue_frames;
+        link->count--;
+        unlock_link(link);
+
+        sim->cursor = (sim->cursor + i + 1) % count;
+        atomic_fetch_add_explicit(&network->frames_delivered, 1, memory_order_relaxed);
+        atomic_fetch_add_explicit(&network->bytes_delivered, frame->length, memory_order_relaxed);
+        return OBI_SUCCESS;
+    }
+    return OBI_ERROR_WOULD_BLOCK;
+}
+
+static obi_result_t sim_flush(obi_topology_transport_t *transport) {
+    (void)transport;
+    return OBI_SUCCESS;
+}
+
+static size_t sim_queue_depth(obi_topology_transport_t *transport, void *peer) {
+    (void)transport;
+    sim_link_t *link = peer;
+    lock_link(link);
+    size_t depth = link->count;
+    unlock_link(link);
+    return depth;
+}
+
+// Links belong to the network and are kept for the next connect
+static void sim_disconnect(obi_topology_transport_t *transport, void *peer) {
+    (void)transport;
+    (void)peer;
+}
+
+static void sim_destroy(obi_topology_transport_t *transport) {
+    sim_transport_t *sim = (sim_transport_t *)transport;
+    obi_sim_network_t *network = sim->network;
+    if (sim->endpoint) {
+        pthread_mutex_lock(&network->lock);
+        atomic_store(&sim->endpoint->bound, false);
+        purge_inbound(network, sim->endpoint);
+        pthread_mutex_unlock(&network->lock);
+    }
+    free(sim);
+}
+
+static const obi_topology_transport_ops_t sim_transport_ops = {
+    .name = "sim",
+    .bind = sim_bind,
+    .connect = sim_connect,
+    .send = sim_send,
+    .receive = sim_receive,
+    .flush = sim_flush,
+    .queue_depth = sim_queue_depth,
+    .disconnect = sim_disconnect,
+    .destroy = sim_destroy
+};
+
+obi_topology_transport_t *obi_topology_transport_sim_create(obi_sim_network_t *network) {
+    if (!network) {
+        return NULL;
+    }
+    sim_transport_t *sim = calloc(1, sizeof(*sim));
+    if (!sim) {
+        return NULL;
+    }
+    sim->base.ops = &sim_transport_ops;
+    // Frames are sized like the default shm slot, so batching and fragmentation behave alike
+    sim->base.max_frame_payload = OBI_SHM_DEFAULT_SLOT_SIZE - sizeof(obi_topology_frame_t);
+    sim->base.concurrent = true;  // links lock themselves
+    sim->network = network;
+    return &sim->base;
+}
+
+obi_sim_network_t *obi_sim_network_create(const obi_sim_config_t *config) {
+    obi_sim_config_t defaults = { { 0, 0, 0, 0 }, OBI_SIM_DEFAULT_QUEUE_FRAMES, OBI_SIM_DEFAULT_QUEUE_BYTES,
+                                  OBI_SIM_DEFAULT_SEED };
+    if (!config) {
+        config = &defaults;
+    }
+    if (config->queue_frames == 0 || config->link.loss_ppm > 1000000u ||
+        config->queue_bytes < OBI_SHM_DEFAULT_SLOT_SIZE - sizeof(obi_topology_frame_t)) {
+        return NULL;
+    }
+
+    obi_sim_network_t *network = calloc(1, sizeof(*network));
+    if (!network || pthread_mutex_init(&network->lock, NULL) != 0) {
+        free(network);
+        return NULL;
+    }
+    network->config = *config;
+    return network;
+}
+
+void obi_sim_network_destroy(obi_sim_network_t *network) {
+    if (!network) {
+        return;
+    }
+    sim_link_t *link = network->links;
+    while (link) {
+        sim_link_t *next = link->next;
+        free(link->entries);
+        free(link->data);
+        free(link);
+        link = next;
+    }
+    for (uint32_t i = 0; i < network->endpoint_count; i++) {
+        free(network->endpoints[i]);
+    }
+    free(network->overrides);
+    pthread_mutex_destroy(&network->lock);
+    free(network);
+}
+
+obi_result_t obi_sim_network_set_link(obi_sim_network_t *network, const char *from, const char *to,
+                                      const obi_sim_link_config_t *config) {
+    if (!network || !from || !to || strlen(from) >= OBI_TRANSPORT_MAX_ADDRESS ||
+        strlen(to) >= OBI_TRANSPORT_MAX_ADDRESS || (config && config->loss_ppm > 1000000u)) {
+        return OBI_ERROR_INVALID_INPUT;
+    }
+
+    obi_result_t result = OBI_SUCCESS;
+    pthread_mutex_lock(&network->lock);
+    sim_override_t *entry = find_override(network, from, to);
+    if (!entry) {
+        sim_override_t *grown = realloc(network->overrides, (network->override_count + 1) * sizeof(*grown));
+        if (grown) {
+            network->overrides = grown;
+            entry = &grown[network->override_count++];
+            snprintf(entry->from, sizeof(entry->from), "%s", from);
+            snprintf(entry->to, sizeof(entry->to), "%s", to);
+        } else {
+            result = OBI_ERROR_OUT_OF_MEMORY;
+        }
+    }
+    if (result == OBI_SUCCESS) {
+        entry->config = config ? *config : network->config.link;
+        for (sim_link_t *link = network->links; link; link = link->next) {
+            if (strcmp(link->from, from) == 0 && strcmp(link->to->name, to) == 0) {
+                lock_link(link);
+                link->config = entry->config;
+                unlock_link(link);
+            }
+        }
+    }
+    pthread_mutex_unlock(&network->lock);
+    return result;
+}
+
+obi_result_t obi_sim_network_get_stats(obi_sim_network_t *network, obi_sim_stats_t *stats) {
+    if (!network || !stats) {
+        return OBI_ERROR_INVALID_INPUT;
+    }
+    stats->frames_sent = atomic_load_explicit(&network->frames_sent, memory_order_relaxed);
+    stats->frames_delivered = atomic_load_explicit(&network->frames_delivered, memory_order_relaxed);
+    stats->frames_lost = atomic_load_explicit(&network->frames_lost, memory_order_relaxed);
+    stats->frames_refused = atomic_load_explicit(&network->frames_refused, memory_order_relaxed);
+    stats->bytes_delivered = atomic_load_explicit(&network->bytes_delivered, memory_order_relaxed);
+    return OBI_SUCCESS;
+}
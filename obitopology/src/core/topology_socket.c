@@ -0,0 +1,616 @@
+/*
+ * OBI Topology Socket Transport
+ * Batched delivery to Unix-domain and loopback peers
+ * Outgoing frames queue per destination and leave in one sendmmsg/writev;
+ * the receive side drains datagrams with recvmmsg
+ */
+
+#define _GNU_SOURCE
+
+#include "obitopology_transport.h"
+#include "topology_internal.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+// Per-destination send queue
+typedef struct socket_peer {
+    int fd;
+    bool stream;
+    uint32_t count;
+    uint64_t first_queued_ns;
+    uint8_t *storage;         // batch_capacity slots of max_datagram bytes
+    uint32_t *lengths;
+    struct iovec *iov;
+    struct mmsghdr *msgs;
+    struct socket_peer *next;
+} socket_peer_t;
+
+// Accepted stream connection with partial-frame reassembly
+typedef struct {
+    int fd;
+    uint8_t *buffer;
+    size_t used;
+} socket_connection_t;
+
+typedef struct {
+    obi_topology_transport_t base;
+    obi_socket_config_t config;
+    uint32_t batch_capacity;  // slots per peer, room for the widest batch scale
+    uint32_t batch_limit;     // current flush threshold
+    uint64_t deadline_ns;     // current flush deadline
+    int rx_fd;
+    bool rx_stream;
+    char rx_path[sizeof(((struct sockaddr_un *)0)->sun_path)];
+
+    // Datagram receive batch filled by one recvmmsg
+    uint8_t *rx_storage;
+    struct iovec *rx_iov;
+    struct mmsghdr *rx_msgs;
+    uint32_t rx_count;
+    uint32_t rx_next;
+
+    // Stream receive connections
+    socket_connection_t connections[OBI_SOCKET_MAX_CONNECTIONS];
+    size_t connection_count;
+    size_t rx_buffer_size;
+
+    socket_peer_t *peers;
+    obi_socket_stats_t stats;
+} socket_transport_t;
+
+static const obi_topology_transport_ops_t socket_transport_ops;
+
+bool obi_topology_parse_socket_address(const char *address, obi_topology_socket_address_t *out) {
+    memset(out, 0, sizeof(*out));
+
+    if (strncmp(address, "unix:", 5) == 0) {
+        struct sockaddr_un *un = (struct sockaddr_un *)&out->addr;
+        const char *path = address + 5;
+        if (!*path || strlen(path) >= sizeof(un->sun_path)) {
+            return false;
+        }
+        un->sun_family = AF_UNIX;
+        strcpy(un->sun_path, path);
+        out->addr_len = sizeof(*un);
+        out->type = SOCK_DGRAM;
+        return true;
+    }
+
+    bool udp = strncmp(address, "udp:", 4) == 0;
+    bool tcp = strncmp(address, "tcp:", 4) == 0;
+    if (!udp && !tcp) {
+        return false;
+    }
+
+    char host[INET_ADDRSTRLEN];
+    const char *colon = strrchr(address + 4, ':');
+    size_t host_len = colon ? (size_t)(colon - (address + 4)) : 0;
+    if (!colon || host_len == 0 || host_len >= sizeof(host)) {
+        return false;
+    }
+    memcpy(host, address + 4, host_len);
+    host[host_len] = '\0';
+
+    char *end = NULL;
+    long port = strtol(colon + 1, &end, 10);
+    if (*end != '\0' || port <= 0 || port > 65535) {
+        return false;
+    }
+
+    struct sockaddr_in *in = (struct sockaddr_in *)&out->addr;
+    in->sin_family = AF_INET;
+    in->sin_port = htons((uint16_t)port);
+    if (inet_pton(AF_INET, host, &in->sin_addr) != 1) {
+        return false;
+    }
+    out->addr_len = sizeof(*in);
+    out->type = udp ? SOCK_DGRAM : SOCK_STREAM;
+    return true;
+}
+
+/*
+ * Send side
+ */
+
+static obi_result_t flush_peer(socket_transport_t *sock, socket_peer_t *peer) {
+    uint32_t sent = 0;
+
+    if (peer->count == 0) {
+        return OBI_SUCCESS;
+    }
+
+    if (peer->stream) {
+        // One writev per batch; loop only on short writes
+        struct iovec *iov = peer->iov;
+        int iov_count = (int)peer->count;
+        for (uint32_t i = 0; i < peer->count; i++) {
+            iov[i].iov_base = peer->storage + (size_t)i * sock->config.max_datagram;
+            iov[i].iov_len = peer->lengths[i];
+        }
+
+        while (iov_count > 0) {
+            ssize_t written = writev(peer->fd, iov, iov_count);
+            sock->stats.send_syscalls++;
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return OBI_ERROR_NETWORK_FAILURE;
+            }
+            while (iov_count > 0 && (size_t)written >= iov->iov_len) {
+                written -= (ssize_t)iov->iov_len;
+                iov++;
+                iov_count--;
+            }
+            if (iov_count > 0) {
+                iov->iov_base = (uint8_t *)iov->iov_base + written;
+                iov->iov_len -= (size_t)written;
+            }
+        }
+        sent = peer->count;
+    } else {
+        while (sent < peer->count) {
+            int result = sendmmsg(peer->fd, peer->msgs + sent, peer->count - sent, MSG_DONTWAIT);
+            sock->stats.send_syscalls++;
+            if (result < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    break;
+                }
+                return OBI_ERROR_NETWORK_FAILURE;
+            }
+            sent += (uint32_t)result;
+        }
+    }
+
+    sock->stats.messages_sent += sent;
+    if (sent < peer->count) {
+        // Receiver is backed up - keep the unsent tail queued in order
+        uint32_t remaining = peer->count - sent;
+        memmove(peer->storage, peer->storage + (size_t)sent * sock->config.max_datagram,
+                (size_t)remaining * sock->config.max_datagram);
+        memmove(peer->lengths, peer->lengths + sent, remaining * sizeof(uint32_t));
+        for (uint32_t i = 0; i < remaining; i++) {
+            peer->iov[i].iov_len = peer->lengths[i];
+        }
+        peer->count = remaining;
+        return OBI_ERROR_WOULD_BLOCK;
+    }
+
+    peer->count = 0;
+    return OBI_SUCCESS;
+}
+
+static obi_result_t flush_expired(socket_transport_t *sock, uint64_t now) {
+    obi_result_t status = OBI_SUCCESS;
+
+    for (socket_peer_t *peer = sock->peers; peer; peer = peer->next) {
+        if (peer->count > 0 && now - peer->first_queued_ns >= sock->deadline_ns) {
+            obi_result_t result = flush_peer(sock, peer);
+            if (result == OBI_ERROR_NETWORK_FAILURE) {
+                status = result;
+            }
+        }
+    }
+    return status;
+}
+
+static void free_peer(socket_peer_t *peer) {
+    if (peer->fd >= 0) {
+        close(peer->fd);
+    }
+    free(peer->storage);
+    free(peer->lengths);
+    free(peer->iov);
+    free(peer->msgs);
+    free(peer);
+}
+
+static obi_result_t socket_connect(obi_topology_transport_t *transport, const char *address, void **peer_out) {
+    socket_transport_t *sock = (socket_transport_t *)transport;
+    obi_topology_socket_address_t target;
+
+    if (!address || !peer_out || !obi_topology_parse_socket_address(address, &target)) {
+        return OBI_ERROR_INVALID_INPUT;
+    }
+
+    uint32_t batch = sock->batch_capacity;
+    socket_peer_t *peer = calloc(1, sizeof(*peer));
+    if (!peer) {
+        return OBI_ERROR_OUT_OF_MEMORY;
+    }
+    peer->fd = -1;
+    peer->storage = malloc((size_t)batch * sock->config.max_datagram);
+    peer->lengths = calloc(batch, sizeof(uint32_t));
+    peer->iov = calloc(batch, sizeof(struct iovec));
+    peer->msgs = calloc(batch, sizeof(struct mmsghdr));
+    if (!peer->storage || !peer->lengths || !peer->iov || !peer->msgs) {
+        free_peer(peer);
+        return OBI_ERROR_OUT_OF_MEMORY;
+    }
+
+    peer->stream = target.type == SOCK_STREAM;
+    peer->fd = socket(target.addr.ss_family, target.type | SOCK_CLOEXEC, 0);
+    if (peer->fd < 0 || connect(peer->fd, (struct sockaddr *)&target.addr, target.addr_len) != 0) {
+        free_peer(peer);
+        return OBI_ERROR_NETWORK_FAILURE;
+    }
+
+    if (peer->stream) {
+        int one = 1;
+        setsockopt(peer->fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+
+    // Datagram slots are wired to their iovec once; flushes only set lengths
+    for (uint32_t i = 0; i < batch; i++) {
+        peer->iov[i].iov_base = peer->storage + (size_t)i * sock->config.max_datagram;
+        peer->msgs[i].msg_hdr.msg_iov = &peer->iov[i];
+        peer->msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    peer->next = sock->peers;
+    sock->peers = peer;
+    *peer_out = peer;
+    return OBI_SUCCESS;
+}
+
+static obi_result_t socket_send(obi_topology_transport_t *transport, void *handle,
+                                const obi_topology_frame_t *frame, const uint8_t *payload) {
+    socket_transport_t *sock = (socket_transport_t *)transport;
+    socket_peer_t *peer = handle;
+    size_t total = sizeof(*frame) + frame->length;
+
+    if (total > sock->config.max_datagram) {
+        return OBI_ERROR_BUFFER_OVERFLOW;
+    }
+
+    if (peer->count >= sock->batch_limit) {
+        obi_result_t result = flush_peer(sock, peer);
+        if (result != OBI_SUCCESS) {
+            return result;
+        }
+    }
+
+    uint64_t now = obi_topology_now_ns();
+    uint8_t *slot = peer->storage + (size_t)peer->count * sock->config.max_datagram;
+    memcpy(slot, frame, sizeof(*frame));
+    if (frame->length > 0) {
+        memcpy(slot + sizeof(*frame), payload, frame->length);
+    }
+    peer->lengths[peer->count] = (uint32_t)total;
+    peer->iov[peer->count].iov_len = total;
+    if (peer->count == 0) {
+        peer->first_queued_ns = now;
+    }
+    peer->count++;
+
+    if (peer->count >= sock->batch_limit) {
+        obi_result_t result = flush_peer(sock, peer);
+        return result == OBI_ERROR_WOULD_BLOCK ? OBI_SUCCESS : result;  // tail stays queued
+    }
+
+    return flush_expired(sock, now);
+}
+
+static obi_result_t socket_flush(obi_topology_transport_t *transport) {
+    socket_transport_t *sock = (socket_transport_t *)transport;
+    obi_result_t status = OBI_SUCCESS;
+
+    for (socket_peer_t *peer = sock->peers; peer; peer = peer->next) {
+        obi_result_t result = flush_peer(sock, peer);
+        if (result != OBI_SUCCESS && status == OBI_SUCCESS) {
+            status = result;
+        }
+    }
+    return status;
+}
+
+static size_t socket_queue_depth(obi_topology_transport_t *transport, void *handle) {
+    (void)transport;
+    socket_peer_t *peer = handle;
+    return peer->count;
+}
+
+static void socket_set_batch_scale(obi_topology_transport_t *transport, uint32_t scale) {
+    socket_transport_t *sock = (socket_transport_t *)transport;
+    if (scale == 0 || scale > OBI_TRANSPORT_MAX_BATCH_SCALE) {
+        return;
+    }
+
+    // Larger batches and a longer deadline trade latency for fewer syscalls
+    uint32_t limit = sock->config.batch_size * scale;
+    sock->batch_limit = limit < sock->batch_capacity ? limit : sock->batch_capacity;
+    sock->deadline_ns = (uint64_t)sock->config.flush_deadline_us * 1000ull * scale;
+}
+
+static void socket_disconnect(obi_topology_transport_t *transport, void *handle) {
+    socket_transport_t *sock = (socket_transport_t *)transport;
+    socket_peer_t *peer = handle;
+
+    flush_peer(sock, peer);
+    for (socket_peer_t **link = &sock->peers; *link; link = &(*link)->next) {
+        if (*link == peer) {
+            *link = peer->next;
+            break;
+        }
+    }
+    free_peer(peer);
+}
+
+/*
+ * Receive side
+ */
+
+static obi_result_t socket_bind(obi_topology_transport_t *transport, const char *local_address) {
+    socket_transport_t *sock = (socket_transport_t *)transport;
+    obi_topology_socket_address_t local;
+
+    if (sock->rx_fd >= 0 || !local_address || !obi_topology_parse_socket_address(local_address, &local)) {
+        return OBI_ERROR_INVALID_INPUT;
+    }
+
+    int fd = socket(local.addr.ss_family, local.type | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+    if (fd < 0) {
+        return OBI_ERROR_NETWORK_FAILURE;
+    }
+
+    if (local.addr.ss_family == AF_UNIX) {
+        unlink(((struct sockaddr_un *)&local.addr)->sun_path);
+    } else {
+        int one = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    }
+
+    if (bind(fd, (struct sockaddr *)&local.addr, local.addr_len) != 0 ||
+        (local.type == SOCK_STREAM && listen(fd, OBI_SOCKET_MAX_CONNECTIONS) != 0)) {
+        close(fd);
+        return OBI_ERROR_NETWORK_FAILURE;
+    }
+
+    if (local.addr.ss_family == AF_UNIX) {
+        strcpy(sock->rx_path, ((struct sockaddr_un *)&local.addr)->sun_path);
+    }
+    sock->rx_fd = fd;
+    sock->rx_stream = local.type == SOCK_STREAM;
+    return OBI_SUCCESS;
+}
+
+static obi_result_t deliver(const uint8_t *data, size_t length, obi_topology_frame_t *frame,
+                            uint8_t *payload, size_t capacity) {
+    if (length < sizeof(*frame)) {
+        return OBI_ERROR_NETWORK_FAILURE;
+    }
+    memcpy(frame, data, sizeof(*frame));
+    if (frame->length > length - sizeof(*frame) || frame->length > capacity) {
+        return OBI_ERROR_BUFFER_OVERFLOW;
+    }
+    memcpy(payload, data + sizeof(*frame), frame->length);
+    return OBI_SUCCESS;
+}
+
+static obi_result_t receive_datagram(socket_transport_t *sock, obi_topology_frame_t *frame,
+                                     uint8_t *payload, size_t capacity) {
+    if (sock->rx_next == sock->rx_count) {
+        // Drain up to a full batch of datagrams in one syscall
+        int received = recvmmsg(sock->rx_fd, sock->rx_msgs, sock->config.batch_size, MSG_DONTWAIT, NULL);
+        sock->stats.receive_syscalls++;
+        if (received <= 0) {
+            return (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+                ? OBI_ERROR_NETWORK_FAILURE : OBI_ERROR_WOULD_BLOCK;
+        }
+        sock->rx_count = (uint32_t)received;
+        sock->rx_next = 0;
+    }
+
+    struct mmsghdr *msg = &sock->rx_msgs[sock->rx_next];
+    obi_result_t result = deliver(msg->msg_hdr.msg_iov->iov_base, msg->msg_len, frame, payload, capacity);
+    if (result != OBI_ERROR_BUFFER_OVERFLOW) {
+        sock->rx_next++;
+        sock->stats.messages_received += result == OBI_SUCCESS;
+    }
+    return result;
+}
+
+static obi_result_t take_stream_frame(socket_transport_t *sock, socket_connection_t *conn,
+                                      obi_topology_frame_t *frame, uint8_t *payload, size_t capacity) {
+    if (conn->used < sizeof(*frame)) {
+        return OBI_ERROR_WOULD_BLOCK;
+    }
+
+    obi_topology_frame_t header;
+    memcpy(&header, conn->buffer, sizeof(header));
+    size_t total = sizeof(header) + header.length;
+    if (total > sock->rx_buffer_size) {
+        return OBI_ERROR_NETWORK_FAILURE;
+    }
+    if (conn->used < total) {
+        return OBI_ERROR_WOULD_BLOCK;
+    }
+
+    obi_result_t result = deliver(conn->buffer, total, frame, payload, capacity);
+    if (result == OBI_SUCCESS) {
+        memmove(conn->buffer, conn->buffer + total, conn->used - total);
+        conn->used -= total;
+        sock->stats.messages_received++;
+    }
+    return result;
+}
+
+static void drop_connection(socket_transport_t *sock, size_t index) {
+    close(sock->connections[index].fd);
+    free(sock->connections[index].buffer);
+    sock->connections[index] = sock->connections[--sock->connection_count];
+}
+
+static obi_result_t receive_stream(socket_transport_t *sock, obi_topology_frame_t *frame,
+                                   uint8_t *payload, size_t capacity) {
+    // Frames already buffered are served before touching the sockets
+    for (size_t i = 0; i < sock->connection_count; i++) {
+        obi_result_t result = take_stream_frame(sock, &sock->connections[i], frame, payload, capacity);
+        if (result != OBI_ERROR_WOULD_BLOCK) {
+            return result;
+        }
+    }
+
+    while (sock->connection_count < OBI_SOCKET_MAX_CONNECTIONS) {
+        int fd = accept4(sock->rx_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            break;
+        }
+        uint8_t *buffer = malloc(sock->rx_buffer_size);
+        if (!buffer) {
+            close(fd);
+            return OBI_ERROR_OUT_OF_MEMORY;
+        }
+        sock->connections[sock->connection_count++] = (socket_connection_t){ fd, buffer, 0 };
+    }
+
+    for (size_t i = 0; i < sock->connection_count; ) {
+        socket_connection_t *conn = &sock->connections[i];
+        ssize_t got = read(conn->fd, conn->buffer + conn->used, sock->rx_buffer_size - conn->used);
+        sock->stats.receive_syscalls++;
+        if (got == 0 || (got < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+            drop_connection(sock, i);
+            continue;
+        }
+        if (got > 0) {
+            conn->used += (size_t)got;
+            obi_result_t result = take_stream_frame(sock, conn, frame, payload, capacity);
+            if (result != OBI_ERROR_WOULD_BLOCK) {
+                return result;
+            }
+        }
+        i++;
+    }
+
+    return OBI_ERROR_WOULD_BLOCK;
+}
+
+static obi_result_t socket_receive(obi_topology_transport_t *transport, obi_topology_frame_t *frame,
+                                   uint8_t *payload, size_t capacity) {
+    socket_transport_t *sock = (socket_transport_t *)transport;
+
+    if (sock->rx_fd < 0) {
+        return OBI_ERROR_NETWORK_FAILURE;
+    }
+
+    // Polling for input is also where idle send queues meet their deadline
+    flush_expired(sock, obi_topology_now_ns());
+
+    return sock->rx_stream ? receive_stream(sock, frame, payload, capacity)
+                           : receive_datagram(sock, frame, payload, capacity);
+}
+
+static int socket_event_fd(obi_topology_transport_t *transport) {
+    socket_transport_t *sock = (socket_transport_t *)transport;
+
+    // Stream data arrives on accepted connections, not on the listening socket
+    return sock->rx_stream ? -1 : sock->rx_fd;
+}
+
+static void socket_destroy(obi_topology_transport_t *transport) {
+    socket_transport_t *sock = (socket_transport_t *)transport;
+
+    while (sock->peers) {
+        socket_disconnect(transport, sock->peers);
+    }
+    while (sock->connection_count > 0) {
+        drop_connection(sock, 0);
+    }
+    if (sock->rx_fd >= 0) {
+        close(sock->rx_fd);
+        if (sock->rx_path[0]) {
+            unlink(sock->rx_path);
+        }
+    }
+
+    free(sock->rx_storage);
+    free(sock->rx_iov);
+    free(sock->rx_msgs);
+    free(sock);
+}
+
+static const obi_topology_transport_ops_t socket_transport_ops = {
+    .name = "socket",
+    .bind = socket_bind,
+    .connect = socket_connect,
+    .send = socket_send,
+    .receive = socket_receive,
+    .flush = socket_flush,
+    .queue_depth = socket_queue_depth,
+    .set_batch_scale = socket_set_batch_scale,
+    .event_fd = socket_event_fd,
+    .disconnect = socket_disconnect,
+    .destroy = socket_destroy
+};
+
+obi_topology_transport_t *obi_topology_transport_socket_create(const obi_socket_config_t *config) {
+    socket_transport_t *sock = calloc(1, sizeof(*sock));
+    if (!sock) {
+        return NULL;
+    }
+
+    sock->config.batch_size = OBI_SOCKET_DEFAULT_BATCH_SIZE;
+    sock->config.flush_deadline_us = OBI_SOCKET_DEFAULT_DEADLINE_US;
+    sock->config.max_datagram = OBI_SOCKET_DEFAULT_MAX_DATAGRAM;
+    if (config) {
+        sock->config = *config;
+    }
+
+    if (sock->config.batch_size == 0 || sock->config.batch_size > OBI_SOCKET_MAX_BATCH ||
+        sock->config.max_datagram <= sizeof(obi_topology_frame_t)) {
+        free(sock);
+        return NULL;
+    }
+
+    uint32_t widest = sock->config.batch_size * OBI_TRANSPORT_MAX_BATCH_SCALE;
+    sock->batch_capacity = widest < OBI_SOCKET_MAX_BATCH ? widest : OBI_SOCKET_MAX_BATCH;
+    sock->batch_limit = sock->config.batch_size;
+    sock->deadline_ns = (uint64_t)sock->config.flush_deadline_us * 1000ull;
+
+    uint32_t batch = sock->config.batch_size;
+    sock->rx_storage = malloc((size_t)batch * sock->config.max_datagram);
+    sock->rx_iov = calloc(batch, sizeof(struct iovec));
+    sock->rx_msgs = calloc(batch, sizeof(struct mmsghdr));
+    if (!sock->rx_storage || !sock->rx_iov || !sock->rx_msgs) {
+        free(sock->rx_storage);
+        free(sock->rx_iov);
+        free(sock->rx_msgs);
+        free(sock);
+        return NULL;
+    }
+
+    for (uint32_t i = 0; i < batch; i++) {
+        sock->rx_iov[i].iov_base = sock->rx_storage + (size_t)i * sock->config.max_datagram;
+        sock->rx_iov[i].iov_len = sock->config.max_datagram;
+        sock->rx_msgs[i].msg_hdr.msg_iov = &sock->rx_iov[i];
+        sock->rx_msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    sock->rx_fd = -1;
+    sock->rx_buffer_size = (size_t)batch * sock->config.max_datagram;
+    sock->base.ops = &socket_transport_ops;
+    sock->base.max_frame_payload = sock->config.max_datagram - sizeof(obi_topology_frame_t);
+    sock->base.concurrent = false;  // per-peer send queues are unlocked
+    return &sock->base;
+}
+
+obi_result_t obi_socket_transport_get_stats(obi_topology_transport_t *transport, obi_socket_stats_t *stats) {
+    if (!transport || !stats || transport->ops != &socket_transport_ops) {
+        return OBI_ERROR_INVALID_INPUT;
+    }
+
+    *stats = ((socket_transport_t *)transport)->stats;
+    return OBI_SUCCESS;
+}
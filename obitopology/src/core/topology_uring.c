@@ -0,0 +1,647 @@
+/*
+ * OBI Topology io_uring Transport
+ * Asynchronous datagram delivery for Linux hosts with io_uring
+ * Sends are WRITE_FIXED SQEs from registered buffers on fixed files;
+ * receives use one multishot RECV fed from a provided-buffer ring,
+ * and completions are reaped in batches
+ */
+
+#define _GNU_SOURCE
+
+#include "obitopology_transport.h"
+#include "topology_internal.h"
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+
+#ifdef OBI_TOPOLOGY_IO_URING
+
+#include <stdatomic.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/un.h>
+
+#define URING_RX_FILE_INDEX   0
+#define URING_BUFFER_GROUP    0
+#define URING_KIND_SEND       1ull
+#define URING_KIND_RECV       2ull
+#define URING_KIND_SHIFT      32
+
+// Connected peer - one slot in the fixed file table
+typedef struct {
+    int fd;
+    uint32_t file_index;
+} uring_peer_t;
+
+// Received datagram waiting for obi_topology_receive_message
+typedef struct {
+    uint16_t buffer_id;
+    uint32_t length;
+} uring_pending_t;
+
+typedef struct {
+    obi_topology_transport_t base;
+    obi_uring_config_t config;
+    int ring_fd;
+
+    // Submission queue
+    void *sq_map;
+    size_t sq_map_size;
+    uint32_t *sq_head;
+    uint32_t *sq_tail;
+    uint32_t sq_mask;
+    uint32_t *sq_array;
+    struct io_uring_sqe *sqes;
+    size_t sqes_size;
+    uint32_t sq_local_tail;
+    uint32_t sq_pending;
+    uint32_t submit_limit;    // submit_batch widened by governance
+
+    // Completion queue
+    void *cq_map;
+    size_t cq_map_size;
+    uint32_t *cq_head;
+    uint32_t *cq_tail;
+    uint32_t cq_mask;
+    struct io_uring_cqe *cqes;
+
+    // Registered send buffers with an index free-list
+    uint8_t *send_buffers;
+    uint32_t *send_free;
+    uint32_t send_free_count;
+
+    // Provided receive buffers for multishot RECV
+    struct io_uring_buf_ring *buf_ring;
+    size_t buf_ring_size;
+    uint8_t *recv_buffers;
+    uint16_t buf_ring_tail;
+    uring_pending_t *pending;
+    uint32_t pending_head;
+    uint32_t pending_count;
+    bool recv_armed;
+
+    // Fixed file table (slot 0 is the bound receive socket)
+    bool file_used[OBI_URING_MAX_FILES];
+    int rx_fd;
+    char rx_path[sizeof(((struct sockaddr_un *)0)->sun_path)];
+
+    obi_socket_stats_t stats;
+} uring_transport_t;
+
+static const obi_topology_transport_ops_t uring_transport_ops;
+
+static int sys_io_uring_setup(unsigned entries, struct io_uring_params *params) {
+    return (int)syscall(__NR_io_uring_setup, entries, params);
+}
+
+static int sys_io_uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+    return (int)syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, NULL, 0);
+}
+
+static int sys_io_uring_register(int fd, unsigned opcode, const void *arg, unsigned nr_args) {
+    return (int)syscall(__NR_io_uring_register, fd, opcode, arg, nr_args);
+}
+
+static uint32_t load_acquire(const uint32_t *ptr) {
+    return atomic_load_explicit((const _Atomic uint32_t *)ptr, memory_order_acquire);
+}
+
+static void store_release(uint32_t *ptr, uint32_t value) {
+    atomic_store_explicit((_Atomic uint32_t *)ptr, value, memory_order_release);
+}
+
+static uint8_t *send_buffer(uring_transport_t *uring, uint32_t index) {
+    return uring->send_buffers + (size_t)index * uring->config.buffer_size;
+}
+
+static uint8_t *recv_buffer(uring_transport_t *uring, uint32_t index) {
+    return uring->recv_buffers + (size_t)index * uring->config.buffer_size;
+}
+
+static void provide_buffer(uring_transport_t *uring, uint16_t buffer_id) {
+    uint32_t mask = uring->config.buffer_count - 1;
+    struct io_uring_buf *buf = &uring->buf_ring->bufs[uring->buf_ring_tail & mask];
+    buf->addr = (uint64_t)(uintptr_t)recv_buffer(uring, buffer_id);
+    buf->len = uring->config.buffer_size;
+    buf->bid = buffer_id;
+    uring->buf_ring_tail++;
+    atomic_store_explicit((_Atomic uint16_t *)&uring->buf_ring->tail, uring->buf_ring_tail,
+                          memory_order_release);
+}
+
+static struct io_uring_sqe *next_sqe(uring_transport_t *uring) {
+    uint32_t head = load_acquire(uring->sq_head);
+    if (uring->sq_local_tail - head > uring->sq_mask) {
+        return NULL;
+    }
+
+    uint32_t index = uring->sq_local_tail & uring->sq_mask;
+    struct io_uring_sqe *sqe = &uring->sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    uring->sq_array[index] = index;
+    uring->sq_local_tail++;
+    uring->sq_pending++;
+    return sqe;
+}
+
+static obi_result_t submit(uring_transport_t *uring, unsigned min_complete, uint64_t *syscalls) {
+    store_release(uring->sq_tail, uring->sq_local_tail);
+
+    if (uring->sq_pending == 0 && min_complete == 0) {
+        return OBI_SUCCESS;
+    }
+
+    int result;
+    do {
+        result = sys_io_uring_enter(uring->ring_fd, uring->sq_pending, min_complete,
+                                    min_complete ? IORING_ENTER_GETEVENTS : 0);
+    } while (result < 0 && errno == EINTR);
+    (*syscalls)++;
+
+    if (result < 0) {
+        return errno == EAGAIN || errno == EBUSY ? OBI_ERROR_WOULD_BLOCK : OBI_ERROR_NETWORK_FAILURE;
+    }
+    uring->sq_pending -= (uint32_t)result <= uring->sq_pending ? (uint32_t)result : uring->sq_pending;
+    return OBI_SUCCESS;
+}
+
+static void arm_receive(uring_transport_t *uring) {
+    struct io_uring_sqe *sqe = next_sqe(uring);
+    if (!sqe) {
+        return;
+    }
+
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = URING_RX_FILE_INDEX;
+    sqe->flags = IOSQE_FIXED_FILE | IOSQE_BUFFER_SELECT;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->buf_group = URING_BUFFER_GROUP;
+    sqe->user_data = URING_KIND_RECV << URING_KIND_SHIFT;
+    uring->recv_armed = true;
+}
+
+// Drain every available CQE, then publish the new head once
+static void reap_completions(uring_transport_t *uring) {
+    uint32_t head = *uring->cq_head;
+    uint32_t tail = load_acquire(uring->cq_tail);
+
+    while (head != tail) {
+        struct io_uring_cqe *cqe = &uring->cqes[head & uring->cq_mask];
+        uint64_t kind = cqe->user_data >> URING_KIND_SHIFT;
+
+        if (kind == URING_KIND_SEND) {
+            uring->send_free[uring->send_free_count++] = (uint32_t)cqe->user_data;
+            if (cqe->res >= 0) {
+                uring->stats.messages_sent++;
+            }
+        } else if (kind == URING_KIND_RECV) {
+            if (cqe->res > 0 && (cqe->flags & IORING_CQE_F_BUFFER)) {
+                uint32_t slot = (uring->pending_head + uring->pending_count) & (uring->config.buffer_count - 1);
+                uring->pending[slot].buffer_id = (uint16_t)(cqe->flags >> IORING_CQE_BUFFER_SHIFT);
+                uring->pending[slot].length = (uint32_t)cqe->res;
+                uring->pending_count++;
+            } else if (cqe->flags & IORING_CQE_F_BUFFER) {
+                provide_buffer(uring, (uint16_t)(cqe->flags >> IORING_CQE_BUFFER_SHIFT));
+            }
+            if (!(cqe->flags & IORING_CQE_F_MORE)) {
+                uring->recv_armed = false;  // multishot ended (e.g. buffers exhausted)
+            }
+        }
+        head++;
+    }
+
+    store_release(uring->cq_head, head);
+}
+
+static obi_result_t register_file(uring_transport_t *uring, int fd, uint32_t index) {
+    struct io_uring_files_update update;
+    memset(&update, 0, sizeof(update));
+    update.offset = index;
+    update.fds = (uint64_t)(uintptr_t)&fd;
+
+    if (sys_io_uring_register(uring->ring_fd, IORING_REGISTER_FILES_UPDATE, &update, 1) != 1) {
+        return OBI_ERROR_NETWORK_FAILURE;
+    }
+    uring->file_used[index] = fd >= 0;
+    return OBI_SUCCESS;
+}
+
+/*
+ * Transport operations
+ */
+
+static obi_result_t uring_bind(obi_topology_transport_t *transport, const char *local_address) {
+    uring_transport_t *uring = (uring_transport_t *)transport;
+    obi_topology_socket_address_t local;
+
+    if (uring->rx_fd >= 0 || !local_address ||
+        !obi_topology_parse_socket_address(local_address, &local) || local.type != SOCK_DGRAM) {
+        return OBI_ERROR_INVALID_INPUT;
+    }
+
+    int fd = socket(local.addr.ss_family, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return OBI_ERROR_NETWORK_FAILURE;
+    }
+    if (local.addr.ss_family == AF_UNIX) {
+        unlink(((struct sockaddr_un *)&local.addr)->sun_path);
+    }
+    if (bind(fd, (struct sockaddr *)&local.addr, local.addr_len) != 0 ||
+        register_file(uring, fd, URING_RX_FILE_INDEX) != OBI_SUCCESS) {
+        close(fd);
+        return OBI_ERROR_NETWORK_FAILURE;
+    }
+
+    if (local.addr.ss_family == AF_UNIX) {
+        strcpy(uring->rx_path, ((struct sockaddr_un *)&local.addr)->sun_path);
+    }
+    uring->rx_fd = fd;
+    arm_receive(uring);
+    return submit(uring, 0, &uring->stats.receive_syscalls);
+}
+
+static obi_result_t uring_connect(obi_topology_transport_t *transport, const char *address, void **peer_out) {
+    uring_transport_t *uring = (uring_transport_t *)transport;
+    obi_topology_socket_address_t target;
+
+    if (!address || !peer_out || !obi_topology_parse_socket_address(address, &target) ||
+        target.type != SOCK_DGRAM) {
+        return OBI_ERROR_INVALID_INPUT;
+    }
+
+    uint32_t index = URING_RX_FILE_INDEX + 1;
+    while (index < OBI_URING_MAX_FILES && uring->file_used[index]) {
+        index++;
+    }
+    if (index == OBI_URING_MAX_FILES) {
+        return OBI_ERROR_OUT_OF_MEMORY;
+    }
+
+    uring_peer_t *peer = malloc(sizeof(*peer));
+    if (!peer) {
+        return OBI_ERROR_OUT_OF_MEMORY;
+    }
+
+    peer->fd = socket(target.addr.ss_family, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (peer->fd < 0 || connect(peer->fd, (struct sockaddr *)&target.addr, target.addr_len) != 0 ||
+        register_file(uring, peer->fd, index) != OBI_SUCCESS) {
+        if (peer->fd >= 0) {
+            close(peer->fd);
+        }
+        free(peer);
+        return OBI_ERROR_NETWORK_FAILURE;
+    }
+
+    peer->file_index = index;
+    *peer_out = peer;
+    return OBI_SUCCESS;
+}
+
+static obi_result_t uring_send(obi_topology_transport_t *transport, void *handle,
+                               const obi_topology_frame_t *frame, const uint8_t *payload) {
+    uring_transport_t *uring = (uring_transport_t *)transport;
+    uring_peer_t *peer = handle;
+    size_t total = sizeof(*frame) + frame->length;
+
+    if (total > uring->config.buffer_size) {
+        return OBI_ERROR_BUFFER_OVERFLOW;
+    }
+
+    if (uring->send_free_count == 0) {
+        // Out of registered buffers: push pending SQEs and reclaim finished sends
+        submit(uring, 0, &uring->stats.send_syscalls);
+        reap_completions(uring);
+        if (uring->send_free_count == 0) {
+            return OBI_ERROR_WOULD_BLOCK;
+        }
+    }
+
+    struct io_uring_sqe *sqe = next_sqe(uring);
+    if (!sqe) {
+        submit(uring, 0, &uring->stats.send_syscalls);
+        sqe = next_sqe(uring);
+        if (!sqe) {
+            return OBI_ERROR_WOULD_BLOCK;
+        }
+    }
+
+    uint32_t index = uring->send_free[--uring->send_free_count];
+    uint8_t *buffer = send_buffer(uring, index);
+    memcpy(buffer, frame, sizeof(*frame));
+    if (frame->length > 0) {
+        memcpy(buffer + sizeof(*frame), payload, frame->length);
+    }
+
+    sqe->opcode = IORING_OP_WRITE_FIXED;
+    sqe->fd = (int32_t)peer->file_index;
+    sqe->flags = IOSQE_FIXED_FILE;
+    sqe->addr = (uint64_t)(uintptr_t)buffer;
+    sqe->len = (uint32_t)total;
+    sqe->buf_index = 0;
+    sqe->user_data = (URING_KIND_SEND << URING_KIND_SHIFT) | index;
+
+    if (uring->sq_pending >= uring->submit_limit) {
+        return submit(uring, 0, &uring->stats.send_syscalls);
+    }
+    return OBI_SUCCESS;
+}
+
+static obi_result_t uring_flush(obi_topology_transport_t *transport) {
+    uring_transport_t *uring = (uring_transport_t *)transport;
+    obi_result_t result = submit(uring, 0, &uring->stats.send_syscalls);
+    reap_completions(uring);
+    return result;
+}
+
+static obi_result_t uring_receive(obi_topology_transport_t *transport, obi_topology_frame_t *frame,
+                                  uint8_t *payload, size_t capacity) {
+    uring_transport_t *uring = (uring_transport_t *)transport;
+
+    if (uring->rx_fd < 0) {
+        return OBI_ERROR_NETWORK_FAILURE;
+    }
+
+    if (uring->pending_count == 0) {
+        if (!uring->recv_armed) {
+            arm_receive(uring);
+        }
+        if (uring->sq_pending > 0) {
+            submit(uring, 0, &uring->stats.receive_syscalls);
+        }
+        reap_completions(uring);
+        if (uring->pending_count == 0) {
+            return OBI_ERROR_WOULD_BLOCK;
+        }
+    }
+
+    uring_pending_t *next = &uring->pending[uring->pending_head];
+    const uint8_t *data = recv_buffer(uring, next->buffer_id);
+    obi_result_t result = OBI_SUCCESS;
+
+    if (next->length < sizeof(*frame)) {
+        result = OBI_ERROR_NETWORK_FAILURE;
+    } else {
+        memcpy(frame, data, sizeof(*frame));
+        if (frame->length > next->length - sizeof(*frame)) {
+            result = OBI_ERROR_NETWORK_FAILURE;
+        } else if (frame->length > capacity) {
+            return OBI_ERROR_BUFFER_OVERFLOW;  // left pending for a larger buffer
+        } else {
+            memcpy(payload, data + sizeof(*frame), frame->length);
+            uring->stats.messages_received++;
+        }
+    }
+
+    provide_buffer(uring, next->buffer_id);
+    uring->pending_head = (uring->pending_head + 1) & (uring->config.buffer_count - 1);
+    uring->pending_count--;
+    return result;
+}
+
+static void uring_set_batch_scale(obi_topology_transport_t *transport, uint32_t scale) {
+    uring_transport_t *uring = (uring_transport_t *)transport;
+    if (scale == 0 || scale > OBI_TRANSPORT_MAX_BATCH_SCALE) {
+        return;
+    }
+
+    uint32_t limit = uring->config.submit_batch * scale;
+    uring->submit_limit = limit < uring->config.queue_depth ? limit : uring->config.queue_depth;
+}
+
+// Sends share one registered buffer pool, so depth is per transport
+static size_t uring_queue_depth(obi_topology_transport_t *transport, void *handle) {
+    (void)handle;
+    uring_transport_t *uring = (uring_transport_t *)transport;
+    return uring->config.buffer_count - uring->send_free_count;
+}
+
+static void uring_disconnect(obi_topology_transport_t *transport, void *handle) {
+    uring_transport_t *uring = (uring_transport_t *)transport;
+    uring_peer_t *peer = handle;
+
+    uring_flush(transport);
+    register_file(uring, -1, peer->file_index);
+    close(peer->fd);
+    free(peer);
+}
+
+static int uring_event_fd(obi_topology_transport_t *transport) {
+    uring_transport_t *uring = (uring_transport_t *)transport;
+
+    // The ring fd polls readable while completions (receives included) are queued
+    return uring->rx_fd >= 0 ? uring->ring_fd : -1;
+}
+
+static void uring_destroy(obi_topology_transport_t *transport) {
+    uring_transport_t *uring = (uring_transport_t *)transport;
+
+    if (uring->ring_fd >= 0) {
+        close(uring->ring_fd);  // cancels the multishot receive and in-flight sends
+    }
+    if (uring->rx_fd >= 0) {
+        close(uring->rx_fd);
+        if (uring->rx_path[0]) {
+            unlink(uring->rx_path);
+        }
+    }
+    if (uring->sq_map) {
+        munmap(uring->sq_map, uring->sq_map_size);
+    }
+    if (uring->cq_map && uring->cq_map != uring->sq_map) {
+        munmap(uring->cq_map, uring->cq_map_size);
+    }
+    if (uring->sqes) {
+        munmap(uring->sqes, uring->sqes_size);
+    }
+    if (uring->buf_ring) {
+        munmap(uring->buf_ring, uring->buf_ring_size);
+    }
+    free(uring->send_buffers);
+    free(uring->send_free);
+    free(uring->recv_buffers);
+    free(uring->pending);
+    free(uring);
+}
+
+static const obi_topology_transport_ops_t uring_transport_ops = {
+    .name = "io_uring",
+    .bind = uring_bind,
+    .connect = uring_connect,
+    .send = uring_send,
+    .receive = uring_receive,
+    .flush = uring_flush,
+    .queue_depth = uring_queue_depth,
+    .set_batch_scale = uring_set_batch_scale,
+    .event_fd = uring_event_fd,
+    .disconnect = uring_disconnect,
+    .destroy = uring_destroy
+};
+
+static bool map_rings(uring_transport_t *uring, const struct io_uring_params *params) {
+    uring->sq_map_size = params->sq_off.array + params->sq_entries * sizeof(uint32_t);
+    uring->cq_map_size = params->cq_off.cqes + params->cq_entries * sizeof(struct io_uring_cqe);
+    if (params->features & IORING_FEAT_SINGLE_MMAP) {
+        if (uring->cq_map_size > uring->sq_map_size) {
+            uring->sq_map_size = uring->cq_map_size;
+        }
+    }
+
+    uring->sq_map = mmap(NULL, uring->sq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                         uring->ring_fd, IORING_OFF_SQ_RING);
+    if (uring->sq_map == MAP_FAILED) {
+        uring->sq_map = NULL;
+        return false;
+    }
+
+    if (params->features & IORING_FEAT_SINGLE_MMAP) {
+        uring->cq_map = uring->sq_map;
+    } else {
+        uring->cq_map = mmap(NULL, uring->cq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                             uring->ring_fd, IORING_OFF_CQ_RING);
+        if (uring->cq_map == MAP_FAILED) {
+            uring->cq_map = NULL;
+            return false;
+        }
+    }
+
+    uring->sqes_size = params->sq_entries * sizeof(struct io_uring_sqe);
+    uring->sqes = mmap(NULL, uring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                       uring->ring_fd, IORING_OFF_SQES);
+    if (uring->sqes == MAP_FAILED) {
+        uring->sqes = NULL;
+        return false;
+    }
+
+    uint8_t *sq = uring->sq_map;
+    uint8_t *cq = uring->cq_map;
+    uring->sq_head = (uint32_t *)(sq + params->sq_off.head);
+    uring->sq_tail = (uint32_t *)(sq + params->sq_off.tail);
+    uring->sq_mask = *(uint32_t *)(sq + params->sq_off.ring_mask);
+    uring->sq_array = (uint32_t *)(sq + params->sq_off.array);
+    uring->sq_local_tail = *uring->sq_tail;
+    uring->cq_head = (uint32_t *)(cq + params->cq_off.head);
+    uring->cq_tail = (uint32_t *)(cq + params->cq_off.tail);
+    uring->cq_mask = *(uint32_t *)(cq + params->cq_off.ring_mask);
+    uring->cqes = (struct io_uring_cqe *)(cq + params->cq_off.cqes);
+    return true;
+}
+
+static bool register_resources(uring_transport_t *uring) {
+    uint32_t count = uring->config.buffer_count;
+    size_t region = (size_t)count * uring->config.buffer_size;
+
+    // Send buffers: one registered region, addressed by offset with buf_index 0
+    uring->send_buffers = aligned_alloc(4096, (region + 4095) & ~(size_t)4095);
+    uring->send_free = malloc(count * sizeof(uint32_t));
+    uring->recv_buffers = malloc(region);
+    uring->pending = malloc(count * sizeof(uring_pending_t));
+    if (!uring->send_buffers || !uring->send_free || !uring->recv_buffers || !uring->pending) {
+        return false;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        uring->send_free[i] = count - 1 - i;
+    }
+    uring->send_free_count = count;
+
+    struct iovec iov = { uring->send_buffers, region };
+    if (sys_io_uring_register(uring->ring_fd, IORING_REGISTER_BUFFERS, &iov, 1) != 0) {
+        return false;
+    }
+
+    // Sparse fixed file table; sockets are slotted in as peers connect
+    int files[OBI_URING_MAX_FILES];
+    for (size_t i = 0; i < OBI_URING_MAX_FILES; i++) {
+        files[i] = -1;
+    }
+    if (sys_io_uring_register(uring->ring_fd, IORING_REGISTER_FILES, files, OBI_URING_MAX_FILES) != 0) {
+        return false;
+    }
+
+    // Provided-buffer ring for multishot receive
+    uring->buf_ring_size = count * sizeof(struct io_uring_buf);
+    uring->buf_ring = mmap(NULL, uring->buf_ring_size, PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (uring->buf_ring == MAP_FAILED) {
+        uring->buf_ring = NULL;
+        return false;
+    }
+
+    struct io_uring_buf_reg reg;
+    memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = (uint64_t)(uintptr_t)uring->buf_ring;
+    reg.ring_entries = count;
+    reg.bgid = URING_BUFFER_GROUP;
+    if (sys_io_uring_register(uring->ring_fd, IORING_REGISTER_PBUF_RING, &reg, 1) != 0) {
+        return false;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        provide_buffer(uring, (uint16_t)i);
+    }
+    return true;
+}
+
+obi_topology_transport_t *obi_topology_transport_uring_create(const obi_uring_config_t *config) {
+    uring_transport_t *uring = calloc(1, sizeof(*uring));
+    if (!uring) {
+        return NULL;
+    }
+
+    uring->config.queue_depth = OBI_URING_DEFAULT_QUEUE_DEPTH;
+    uring->config.buffer_count = OBI_URING_DEFAULT_BUFFER_COUNT;
+    uring->config.buffer_size = OBI_URING_DEFAULT_BUFFER_SIZE;
+    uring->config.submit_batch = OBI_URING_DEFAULT_SUBMIT_BATCH;
+    if (config) {
+        uring->config = *config;
+    }
+    uring->ring_fd = -1;
+    uring->rx_fd = -1;
+    uring->submit_limit = uring->config.submit_batch;
+
+    uint32_t count = uring->config.buffer_count;
+    if (count == 0 || count > 32768 || (count & (count - 1)) != 0 ||
+        uring->config.queue_depth == 0 || uring->config.submit_batch == 0 ||
+        uring->config.buffer_size <= sizeof(obi_topology_frame_t)) {
+        free(uring);
+        return NULL;
+    }
+
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    uring->ring_fd = sys_io_uring_setup(uring->config.queue_depth, &params);
+    if (uring->ring_fd < 0 || !map_rings(uring, &params) || !register_resources(uring)) {
+        uring_destroy(&uring->base);
+        return NULL;  // kernel without io_uring support - caller falls back to sockets
+    }
+
+    uring->base.ops = &uring_transport_ops;
+    uring->base.max_frame_payload = uring->config.buffer_size - sizeof(obi_topology_frame_t);
+    uring->base.concurrent = false;  // one SQ and CQ serve sends and receives alike
+    return &uring->base;
+}
+
+obi_result_t obi_uring_transport_get_stats(obi_topology_transport_t *transport, obi_socket_stats_t *stats) {
+    if (!transport || !stats || transport->ops != &uring_transport_ops) {
+        return OBI_ERROR_INVALID_INPUT;
+    }
+
+    *stats = ((uring_transport_t *)transport)->stats;
+    return OBI_SUCCESS;
+}
+
+#else /* !OBI_TOPOLOGY_IO_URING */
+
+obi_topology_transport_t *obi_topology_transport_uring_create(const obi_uring_config_t *config) {
+    (void)config;
+    errno = ENOSYS;
+    return NULL;
+}
+
+obi_result_t obi_uring_transport_get_stats(obi_topology_transport_t *transport, obi_socket_stats_t *stats) {
+    (void)transport;
+    (void)stats;
+    return OBI_ERROR_INVALID_INPUT;
+}
+
+#endif /* OBI_TOPOLOGY_IO_URING */
@@ -0,0 +1,147 @@
+/*
+ * Coalescing Benchmark
+ * 64-byte messages between two processes over shared memory, sent one
+ * frame each and then coalesced into batch frames; reports goodput and
+ * p50/p99 one-way latency measured by the receiver
+ */
+
+#define _GNU_SOURCE
+
+#include "obitopology.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+#define BENCH_MESSAGES 200000
+#define BENCH_PAYLOAD  64
+#define BENCH_DEADLINE_US 50
+
+typedef struct {
+    uint64_t sequence;
+    uint64_t sent_ns;
+    uint8_t padding[BENCH_PAYLOAD - 16];
+} probe_t;
+
+typedef struct {
+    _Atomic bool ready;
+    uint64_t first_ns;
+    uint64_t last_ns;
+    long received;
+    uint64_t latency_ns[BENCH_MESSAGES];
+} shared_state_t;
+
+static int protocol_placeholder;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static int compare_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+static obi_topology_context_t *join_pair(const char *self, bool coalesce) {
+    obi_node_id_t id;
+    obi_topology_init((obi_protocol_context_t *)&protocol_placeholder);
+    obi_topology_context_t *ctx = obi_topology_get_context();
+    obi_topology_add_node(ctx, "bench-co-tx", NULL, &id);
+    obi_topology_add_node(ctx, "bench-co-rx", NULL, &id);
+    if (coalesce) {
+        obi_coalesce_config_t config = { OBI_COALESCE_DEFAULT_MAX_MESSAGE, BENCH_DEADLINE_US };
+        obi_topology_set_coalescing(ctx, &config);
+    }
+    if (obi_topology_bind(ctx, self) != OBI_TOPOLOGY_SUCCESS) {
+        fprintf(stderr, "bind failed for %s\n", self);
+        exit(1);
+    }
+    return ctx;
+}
+
+static void run_receiver(shared_state_t *shared) {
+    obi_topology_context_t *ctx = join_pair("bench-co-rx", false);
+    probe_t probe;
+    obi_buffer_t buffer = { (uint8_t *)&probe, 0, sizeof(probe) };
+    atomic_store(&shared->ready, true);
+
+    while (shared->received < BENCH_MESSAGES) {
+        if (obi_topology_receive_message(ctx, &buffer) != OBI_SUCCESS) {
+            sched_yield();
+            continue;
+        }
+        uint64_t now = now_ns();
+        if (shared->received == 0) {
+            shared->first_ns = now;
+        }
+        shared->last_ns = now;
+        shared->latency_ns[shared->received++] = now - probe.sent_ns;
+    }
+    obi_topology_cleanup();
+    _exit(0);
+}
+
+static void bench(const char *label, bool coalesce, shared_state_t *shared) {
+    memset(shared, 0, sizeof(*shared));
+    pid_t receiver = fork();
+    if (receiver == 0) {
+        run_receiver(shared);
+    }
+    while (!atomic_load(&shared->ready)) {
+        sched_yield();
+    }
+
+    obi_topology_context_t *ctx = join_pair("bench-co-tx", coalesce);
+    obi_node_id_t target = 1;
+    probe_t probe = {0};
+    obi_buffer_t buffer = { (uint8_t *)&probe, sizeof(probe), sizeof(probe) };
+
+    for (long i = 0; i < BENCH_MESSAGES; ) {
+        probe.sequence = (uint64_t)i;
+        probe.sent_ns = now_ns();
+        if (obi_topology_send_to(ctx, &buffer, target) == OBI_SUCCESS) {
+            i++;
+        } else {
+            obi_topology_poll(ctx);  // ring full: let the receiver catch up
+            sched_yield();
+        }
+    }
+    while (obi_topology_flush(ctx) != OBI_SUCCESS) {
+        sched_yield();  // the last batch waits for ring space like any send
+    }
+    waitpid(receiver, NULL, 0);
+
+    obi_topology_metrics_t metrics;
+    obi_topology_get_metrics(ctx, &metrics);
+    obi_topology_cleanup();
+
+    qsort(shared->latency_ns, BENCH_MESSAGES, sizeof(uint64_t), compare_u64);
+    double seconds = (double)(shared->last_ns - shared->first_ns) / 1e9;
+    printf("%-14s %10.0f msg/s %8.1f MB/s  p50 %7.1f us  p99 %7.1f us  %llu batch frames\n", label,
+           BENCH_MESSAGES / seconds, BENCH_MESSAGES * (double)BENCH_PAYLOAD / seconds / 1e6,
+           shared->latency_ns[BENCH_MESSAGES / 2] / 1e3,
+           shared->latency_ns[BENCH_MESSAGES * 99 / 100] / 1e3,
+           (unsigned long long)metrics.coalesced_batches);
+}
+
+int main(void) {
+    shared_state_t *shared = mmap(NULL, sizeof(*shared), PROT_READ | PROT_WRITE,
+                                  MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+
+    printf("📈 OBI Topology Coalescing Benchmark (%d x %d-byte messages, deadline %d us)\n",
+           BENCH_MESSAGES, BENCH_PAYLOAD, BENCH_DEADLINE_US);
+    printf("==========================================================================\n");
+
+    bench("frame each", false, shared);
+    bench("coalesced", true, shared);
+
+    munmap(shared, sizeof(*shared));
+    return 0;
+}
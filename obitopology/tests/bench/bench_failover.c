@@ -0,0 +1,184 @@
+/*
+ * Failover Benchmark
+ * Four shm nodes in a MESH: source -> primary -> sink, with a costlier
+ * backup path through a fourth node. The primary is killed mid-stream;
+ * the benchmark reports detection time, time until delivery resumes and
+ * how many messages were lost in between
+ */
+
+#define _GNU_SOURCE
+
+#include "obitopology.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+#define SEND_INTERVAL_NS   20000ull      // paced source: 50k msg/s
+#define WARMUP_NS          300000000ull
+#define AFTER_KILL_NS      700000000ull
+#define HEARTBEAT_US       50
+
+typedef struct {
+    _Atomic bool stop;
+    _Atomic uint64_t killed_ns;
+    _Atomic uint64_t detected_ns;
+    _Atomic uint64_t resumed_ns;
+    _Atomic long sent;
+    _Atomic long received;
+} shared_state_t;
+
+typedef struct {
+    uint64_t sequence;
+    uint64_t sent_ns;
+} probe_t;
+
+static int protocol_placeholder;
+static const char *const node_names[] = { "fo-source", "fo-primary", "fo-backup", "fo-sink" };
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static obi_topology_context_t *join_mesh(int self) {
+    obi_node_id_t ids[4];
+    obi_topology_init((obi_protocol_context_t *)&protocol_placeholder);
+    obi_topology_context_t *ctx = obi_topology_get_context();
+
+    for (int i = 0; i < 4; i++) {
+        obi_topology_add_node(ctx, node_names[i], NULL, &ids[i]);
+    }
+    obi_topology_configure(ctx, OBI_TOPOLOGY_MESH);
+    obi_topology_add_link(ctx, ids[0], ids[1], 1);
+    obi_topology_add_link(ctx, ids[1], ids[3], 1);
+    obi_topology_add_link(ctx, ids[0], ids[2], 2);
+    obi_topology_add_link(ctx, ids[2], ids[3], 2);
+
+    obi_heartbeat_config_t heartbeat = { HEARTBEAT_US, OBI_HEARTBEAT_DEFAULT_PHI };
+    obi_topology_set_heartbeat(ctx, &heartbeat);
+    if (obi_topology_bind(ctx, node_names[self]) != OBI_TOPOLOGY_SUCCESS) {
+        fprintf(stderr, "bind failed for %s\n", node_names[self]);
+        _exit(1);
+    }
+    return ctx;
+}
+
+static void run_node(int self, shared_state_t *shared) {
+    obi_topology_context_t *ctx = join_mesh(self);
+    probe_t probe = {0};
+    obi_buffer_t buffer = { (uint8_t *)&probe, 0, sizeof(probe) };
+    obi_node_id_t sink = 3;
+    uint64_t next_send = now_ns() + 50000000ull;  // let every node bind first
+    uint64_t failovers_at_kill = UINT64_MAX;
+
+    while (!atomic_load(&shared->stop)) {
+        obi_topology_poll(ctx);
+
+        // Relays forward inside receive; only the sink sees deliveries
+        while (obi_topology_receive_message(ctx, &buffer) == OBI_SUCCESS) {
+            atomic_fetch_add(&shared->received, 1);
+            uint64_t killed = atomic_load(&shared->killed_ns);
+            if (killed && probe.sent_ns > killed && atomic_load(&shared->resumed_ns) == 0) {
+                atomic_store(&shared->resumed_ns, now_ns());
+            }
+            buffer.size = 0;
+        }
+
+        if (self == 0) {
+            obi_topology_metrics_t metrics;
+            uint64_t now = now_ns();
+            if (now >= next_send) {
+                probe.sequence++;
+                probe.sent_ns = now;
+                obi_buffer_t out = { (uint8_t *)&probe, sizeof(probe), sizeof(probe) };
+                if (obi_topology_send_to(ctx, &out, sink) == OBI_SUCCESS) {
+                    atomic_fetch_add(&shared->sent, 1);
+                }
+                next_send += SEND_INTERVAL_NS;
+            }
+            // Earlier (false) suspicions on a loaded host must not count
+            if (atomic_load(&shared->killed_ns) && atomic_load(&shared->detected_ns) == 0 &&
+                obi_topology_get_metrics(ctx, &metrics) == OBI_TOPOLOGY_SUCCESS) {
+                if (failovers_at_kill == UINT64_MAX) {
+                    failovers_at_kill = metrics.failovers;
+                } else if (metrics.failovers > failovers_at_kill) {
+                    atomic_store(&shared->detected_ns, now_ns());
+                }
+            }
+        }
+        sched_yield();  // four busy nodes may share one CPU
+    }
+
+    obi_topology_cleanup();
+    _exit(0);
+}
+
+int main(void) {
+    shared_state_t *shared = mmap(NULL, sizeof(*shared), PROT_READ | PROT_WRITE,
+                                  MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    memset(shared, 0, sizeof(*shared));
+
+    printf("📈 OBI Topology Failover Benchmark (heartbeat %d us, phi %.1f)\n",
+           HEARTBEAT_US, OBI_HEARTBEAT_DEFAULT_PHI);
+    printf("==============================================================\n");
+
+    pid_t pids[4];
+    for (int i = 3; i >= 0; i--) {
+        pids[i] = fork();
+        if (pids[i] == 0) {
+            run_node(i, shared);
+        }
+    }
+
+    struct timespec pause = { 0, (long)WARMUP_NS };
+    nanosleep(&pause, NULL);
+    long before_kill = atomic_load(&shared->received);
+
+    kill(pids[1], SIGKILL);
+    atomic_store(&shared->killed_ns, now_ns());
+    waitpid(pids[1], NULL, 0);
+
+    pause.tv_sec = (time_t)(AFTER_KILL_NS / 1000000000ull);
+    pause.tv_nsec = (long)(AFTER_KILL_NS % 1000000000ull);
+    nanosleep(&pause, NULL);
+    atomic_store(&shared->stop, true);
+    for (int i = 0; i < 4; i++) {
+        if (i != 1) {
+            waitpid(pids[i], NULL, 0);
+        }
+    }
+
+    // The killed node never unlinked its inbound ring
+    shm_unlink("/obitopo.fo-primary");
+
+    uint64_t killed = atomic_load(&shared->killed_ns);
+    uint64_t detected = atomic_load(&shared->detected_ns);
+    uint64_t resumed = atomic_load(&shared->resumed_ns);
+    long sent = atomic_load(&shared->sent);
+    long received = atomic_load(&shared->received);
+
+    printf("delivered before kill         %10ld msgs\n", before_kill);
+    if (detected) {
+        printf("failure detected after        %10.3f ms\n", (double)(detected - killed) / 1e6);
+    } else {
+        printf("failure detected after              never\n");
+    }
+    if (resumed) {
+        printf("delivery resumed after        %10.3f ms\n", (double)(resumed - killed) / 1e6);
+    } else {
+        printf("delivery resumed after              never\n");
+    }
+    printf("messages lost                 %10ld of %ld (%.3f%%)\n", sent - received, sent,
+           sent ? 100.0 * (double)(sent - received) / (double)sent : 0.0);
+
+    munmap(shared, sizeof(*shared));
+    return 0;
+}
@@ -0,0 +1,144 @@
+/*
+ * Gossip Membership Benchmark
+ * MESH meshes of growing size over shared memory, one process per member.
+ * Reports membership frames and bytes each member sends per protocol
+ * period, and how many periods pass between a member stopping and every
+ * other member dropping it
+ */
+
+#define _GNU_SOURCE
+
+#include "obitopology.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+#define BENCH_MAX_MEMBERS 32
+#define BENCH_INTERVAL_US 5000
+#define BENCH_STEADY_NS   500000000ull
+
+typedef struct {
+    _Atomic bool leave;
+    _Atomic bool stop;
+    _Atomic int view[BENCH_MAX_MEMBERS];
+    _Atomic uint64_t frames[BENCH_MAX_MEMBERS];
+} shared_state_t;
+
+static int protocol_placeholder;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void run_member(int self, int members, shared_state_t *shared) {
+    char name[24];
+    obi_node_id_t id;
+    obi_topology_init((obi_protocol_context_t *)&protocol_placeholder);
+    obi_topology_context_t *ctx = obi_topology_get_context();
+    for (int i = 0; i < members; i++) {
+        snprintf(name, sizeof(name), "bench-gossip-%d", i);
+        obi_topology_add_node(ctx, name, NULL, &id);
+    }
+    obi_topology_configure(ctx, OBI_TOPOLOGY_MESH);
+    snprintf(name, sizeof(name), "bench-gossip-%d", self);
+    if (obi_topology_bind(ctx, name) != OBI_TOPOLOGY_SUCCESS) {
+        fprintf(stderr, "bind failed for %s\n", name);
+        _exit(1);
+    }
+    obi_gossip_config_t config = { BENCH_INTERVAL_US, OBI_GOSSIP_DEFAULT_INDIRECT, OBI_GOSSIP_DEFAULT_SUSPICION };
+    obi_topology_set_gossip(ctx, &config);
+
+    // Member 0 is the one that leaves
+    uint8_t storage[64];
+    obi_buffer_t buffer = { storage, 0, sizeof(storage) };
+    obi_topology_metrics_t metrics;
+    while (!atomic_load(&shared->stop) && !(self == 0 && atomic_load(&shared->leave))) {
+        obi_topology_poll(ctx);
+        obi_topology_receive_message(ctx, &buffer);
+        obi_topology_get_metrics(ctx, &metrics);
+        atomic_store(&shared->view[self], metrics.active_nodes);
+        if (!atomic_load(&shared->leave)) {
+            atomic_store(&shared->frames[self], metrics.gossip_frames);
+        }
+        usleep(500);
+    }
+    obi_topology_cleanup();
+    _exit(0);
+}
+
+static void bench(int members, shared_state_t *shared) {
+    memset(shared, 0, sizeof(*shared));
+    pid_t pids[BENCH_MAX_MEMBERS];
+    for (int i = 0; i < members; i++) {
+        pids[i] = fork();
+        if (pids[i] == 0) {
+            run_member(i, members, shared);
+        }
+    }
+
+    // Steady state: frames sent per member per period
+    usleep(BENCH_STEADY_NS / 1000);
+    uint64_t before[BENCH_MAX_MEMBERS];
+    for (int i = 0; i < members; i++) {
+        before[i] = atomic_load(&shared->frames[i]);
+    }
+    uint64_t started = now_ns();
+    usleep(BENCH_STEADY_NS / 1000);
+    double periods = (double)(now_ns() - started) / (BENCH_INTERVAL_US * 1000.0);
+    uint64_t frames = 0;
+    for (int i = 0; i < members; i++) {
+        frames += atomic_load(&shared->frames[i]) - before[i];
+    }
+    double per_member = (double)frames / members / periods;
+
+    // Detection: from member 0 stopping until every other member drops it
+    atomic_store(&shared->leave, true);
+    waitpid(pids[0], NULL, 0);
+    uint64_t left = now_ns();
+    bool detected = false;
+    while (!detected && now_ns() - left < 10000000000ull) {
+        detected = true;
+        for (int i = 1; i < members && detected; i++) {
+            detected = atomic_load(&shared->view[i]) == members - 1;
+        }
+        usleep(1000);
+    }
+    double detection = (double)(now_ns() - left) / (BENCH_INTERVAL_US * 1000.0);
+
+    atomic_store(&shared->stop, true);
+    for (int i = 1; i < members; i++) {
+        waitpid(pids[i], NULL, 0);
+    }
+
+    // A membership frame is a 20-byte header, 16 bytes of probe and up to 8 x 12-byte updates
+    printf("%3d members  %5.2f frames/member/period  <= %4.0f bytes/member/period  ",
+           members, per_member, per_member * (20 + 16 + OBI_GOSSIP_MAX_UPDATES * 12));
+    if (detected) {
+        printf("removed by all after %5.1f periods\n", detection);
+    } else {
+        printf("not removed within 10 s\n");
+    }
+}
+
+int main(void) {
+    shared_state_t *shared = mmap(NULL, sizeof(*shared), PROT_READ | PROT_WRITE,
+                                  MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+
+    printf("📈 OBI Topology Gossip Membership Benchmark (period %d us)\n", BENCH_INTERVAL_US);
+    printf("==========================================================\n");
+
+    int sizes[] = { 4, 8, 16, 32 };
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        bench(sizes[i], shared);
+    }
+
+    munmap(shared, sizeof(*shared));
+    return 0;
+}
@@ -0,0 +1,178 @@
+/*
+ * Hub Aggregation Benchmark
+ * A STAR of one hub and S spokes, one process each. Every spoke streams
+ * small messages to the next spoke, so all traffic crosses the hub; reports
+ * the hub's relay rate against spoke count with aggregation off, and on
+ * with a batch validator and its verdict cache
+ */
+
+#define _GNU_SOURCE
+
+#include "obitopology.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+#define MAX_SPOKES    16
+#define MESSAGES      20000   // per spoke
+#define MESSAGE_SIZE  64
+#define DISTINCT      256     // payloads repeat, as broadcasts and heartbeating state do
+#define VALIDATE_PASSES 8       // makes a verdict cost about what a real one does
+
+typedef struct {
+    _Atomic bool stop;
+    _Atomic uint32_t ready;
+    _Atomic uint64_t delivered;
+} shared_state_t;
+
+static int protocol_placeholder;
+static const uint32_t spoke_counts[] = { 2, 4, 8, 16 };
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// Stand-in for a schema and DFA validator: a few dependent passes over every byte
+static void checksum_validator(void *user, const obi_buffer_t *messages, size_t count, bool *valid) {
+    (void)user;
+    for (size_t i = 0; i < count; i++) {
+        uint32_t sum = 0;
+        for (int pass = 0; pass < VALIDATE_PASSES; pass++) {
+            for (size_t b = 0; b < messages[i].size; b++) {
+                sum = sum * 31 + messages[i].data[b];
+            }
+        }
+        valid[i] = sum != 0xffffffffu;
+    }
+}
+
+static obi_topology_context_t *join_star(uint32_t spokes, uint32_t self) {
+    obi_topology_init((obi_protocol_context_t *)&protocol_placeholder);
+    obi_topology_context_t *ctx = obi_topology_get_context();
+    char name[32];
+    obi_node_id_t id;
+    for (uint32_t i = 0; i <= spokes; i++) {
+        snprintf(name, sizeof(name), "hb-%u", i);
+        obi_topology_add_node(ctx, name, NULL, &id);
+    }
+    obi_topology_configure(ctx, OBI_TOPOLOGY_STAR);
+    snprintf(name, sizeof(name), "hb-%u", self);
+    if (obi_topology_bind(ctx, name) != OBI_TOPOLOGY_SUCCESS) {
+        fprintf(stderr, "bind failed for %s\n", name);
+        _exit(1);
+    }
+    return ctx;
+}
+
+// Spoke i (node i + 1) sends to the next spoke round the star and counts what it receives
+static void run_spoke(uint32_t spokes, uint32_t self, shared_state_t *shared) {
+    obi_topology_context_t *ctx = join_star(spokes, self);
+    atomic_fetch_add(&shared->ready, 1);
+    while (atomic_load(&shared->ready) <= spokes) {  // the hub counts itself in last
+        sched_yield();
+    }
+
+    obi_node_id_t next = self % spokes + 1;
+    uint8_t payload[MESSAGE_SIZE];
+    memset(payload, 0, sizeof(payload));
+    uint32_t sent = 0;
+    while (!atomic_load(&shared->stop)) {
+        bool progress = false;
+        if (sent < MESSAGES) {
+            uint32_t key = sent % DISTINCT;
+            memcpy(payload, &key, sizeof(key));
+            obi_buffer_t message = { payload, sizeof(payload), sizeof(payload) };
+            if (obi_topology_send_to(ctx, &message, next) == OBI_SUCCESS) {
+                sent++;
+                progress = true;
+            }
+        }
+        obi_buffer_t message;
+        while (obi_topology_receive_view(ctx, &message) == OBI_SUCCESS) {
+            atomic_fetch_add_explicit(&shared->delivered, 1, memory_order_relaxed);
+            progress = true;
+        }
+        if (!progress) {
+            sched_yield();  // the hub and every spoke share the CPUs
+        }
+    }
+
+    obi_topology_cleanup();
+    _exit(0);
+}
+
+static double bench(uint32_t spokes, bool aggregate) {
+    shared_state_t *shared = mmap(NULL, sizeof(*shared), PROT_READ | PROT_WRITE,
+                                  MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    memset(shared, 0, sizeof(*shared));
+
+    pid_t pids[MAX_SPOKES];
+    for (uint32_t i = 0; i < spokes; i++) {
+        pids[i] = fork();
+        if (pids[i] == 0) {
+            run_spoke(spokes, i + 1, shared);
+        }
+    }
+    obi_topology_context_t *ctx = join_star(spokes, 0);
+    // Per frame still validates every message, one validator call and one send each
+    obi_hub_config_t config = { aggregate ? OBI_HUB_DEFAULT_BATCH : 1, OBI_HUB_DEFAULT_DELAY_US,
+                                checksum_validator, NULL, aggregate ? OBI_HUB_DEFAULT_CACHE : 0 };
+    obi_topology_set_hub_aggregation(ctx, &config);
+    while (atomic_load(&shared->ready) < spokes) {
+        sched_yield();
+    }
+
+    // Spokes start sending once every ring exists
+    uint64_t total = (uint64_t)spokes * MESSAGES;
+    uint64_t started = now_ns();
+    atomic_fetch_add(&shared->ready, 1);
+    while (atomic_load_explicit(&shared->delivered, memory_order_relaxed) < total) {
+        obi_buffer_t message;
+        if (obi_topology_receive_view(ctx, &message) != OBI_SUCCESS) {
+            sched_yield();
+        }
+    }
+    double seconds = (double)(now_ns() - started) / 1e9;
+
+    atomic_store(&shared->stop, true);
+    for (uint32_t i = 0; i < spokes; i++) {
+        waitpid(pids[i], NULL, 0);
+    }
+    obi_topology_metrics_t metrics;
+    obi_topology_get_metrics(ctx, &metrics);
+    if (aggregate && metrics.hub_batches) {
+        printf("      %u spokes: %.1f frames per batch, %llu of %llu verdicts cached\n", spokes,
+               (double)metrics.hub_batched_frames / (double)metrics.hub_batches,
+               (unsigned long long)metrics.hub_cache_hits,
+               (unsigned long long)(metrics.hub_cache_hits + metrics.hub_validated));
+    }
+    obi_topology_cleanup();
+    munmap(shared, sizeof(*shared));
+    return (double)total / seconds;
+}
+
+int main(void) {
+    printf("📈 OBI Topology Hub Aggregation Benchmark (shm STAR, one process per node)\n");
+    printf("==========================================================================\n");
+
+    double plain[sizeof(spoke_counts) / sizeof(spoke_counts[0])];
+    double batched[sizeof(spoke_counts) / sizeof(spoke_counts[0])];
+    for (size_t i = 0; i < sizeof(spoke_counts) / sizeof(spoke_counts[0]); i++) {
+        plain[i] = bench(spoke_counts[i], false);
+        batched[i] = bench(spoke_counts[i], true);
+    }
+
+    printf("%7s %18s %18s %9s\n", "spokes", "per-frame msgs/s", "aggregated msgs/s", "speedup");
+    for (size_t i = 0; i < sizeof(spoke_counts) / sizeof(spoke_counts[0]); i++) {
+        printf("%7u %18.0f %18.0f %8.2fx\n", spoke_counts[i], plain[i], batched[i], batched[i] / plain[i]);
+    }
+    return 0;
+}
@@ -0,0 +1,175 @@
+/*
+ * Ring Forwarding Benchmark
+ * N shm nodes in a RING, one process each. Node 0 pings the node half way
+ * round, which echoes; reports one-way latency for small messages and the
+ * round trip of a fragmented 1 MiB message against ring size, next to what
+ * store-and-forward of the whole message at every hop would cost. Relays
+ * forward each fragment as it arrives, so the large message pays about one
+ * hop's streaming time plus a small per-hop delay
+ */
+
+#define _GNU_SOURCE
+
+#include "obitopology.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+#define MAX_RING      16
+#define PINGS         200
+#define LARGE_ROUNDS  5
+#define LARGE_MESSAGE (1u << 20)
+
+typedef struct {
+    _Atomic bool stop;
+    _Atomic uint32_t ready;
+} shared_state_t;
+
+static int protocol_placeholder;
+static const uint32_t ring_sizes[] = { 2, 4, 8, 16 };
+static double one_hop_ms;  // large round trip over a single hop, measured first
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static obi_topology_context_t *join_ring(uint32_t size, uint32_t self) {
+    obi_topology_init((obi_protocol_context_t *)&protocol_placeholder);
+    obi_topology_context_t *ctx = obi_topology_get_context();
+    char name[32];
+    obi_node_id_t id;
+    for (uint32_t i = 0; i < size; i++) {
+        snprintf(name, sizeof(name), "rb-%u", i);
+        obi_topology_add_node(ctx, name, NULL, &id);
+    }
+    obi_topology_configure(ctx, OBI_TOPOLOGY_RING);
+    obi_reassembly_config_t reassembly = { LARGE_MESSAGE, 2, 1000 };
+    obi_topology_set_reassembly(ctx, &reassembly);
+    snprintf(name, sizeof(name), "rb-%u", self);
+    if (obi_topology_bind(ctx, name) != OBI_TOPOLOGY_SUCCESS) {
+        fprintf(stderr, "bind failed for %s\n", name);
+        _exit(1);
+    }
+    return ctx;
+}
+
+static void send_retrying(obi_topology_context_t *ctx, const obi_buffer_t *buffer, obi_node_id_t destination) {
+    obi_buffer_t message = *buffer;
+    while (obi_topology_send_to(ctx, &message, destination) != OBI_SUCCESS) {
+        obi_buffer_t scratch;
+        obi_topology_receive_view(ctx, &scratch);  // keep relaying while we wait
+        sched_yield();
+    }
+}
+
+// Every node relays; the far node also echoes each message back to node 0
+static void run_node(uint32_t size, uint32_t self, shared_state_t *shared) {
+    obi_topology_context_t *ctx = join_ring(size, self);
+    atomic_fetch_add(&shared->ready, 1);
+    uint64_t ack = 0;
+    obi_buffer_t reply = { (uint8_t *)&ack, sizeof(ack), sizeof(ack) };
+
+    while (!atomic_load(&shared->stop)) {
+        obi_buffer_t message;
+        if (obi_topology_receive_view(ctx, &message) == OBI_SUCCESS) {
+            if (self == size / 2) {
+                send_retrying(ctx, &reply, 0);
+            }
+        } else {
+            sched_yield();  // many busy nodes may share one CPU
+        }
+    }
+
+    obi_topology_cleanup();
+    _exit(0);
+}
+
+static double round_trip_us(obi_topology_context_t *ctx, const obi_buffer_t *buffer, obi_node_id_t far) {
+    uint64_t started = now_ns();
+    send_retrying(ctx, buffer, far);
+    obi_buffer_t message;
+    while (obi_topology_receive_view(ctx, &message) != OBI_SUCCESS) {
+        sched_yield();
+    }
+    return (double)(now_ns() - started) / 1e3;
+}
+
+static int compare(const void *a, const void *b) {
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static void bench(uint32_t size, uint8_t *large) {
+    shared_state_t *shared = mmap(NULL, sizeof(*shared), PROT_READ | PROT_WRITE,
+                                  MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    memset(shared, 0, sizeof(*shared));
+
+    pid_t pids[MAX_RING];
+    for (uint32_t i = 1; i < size; i++) {
+        pids[i] = fork();
+        if (pids[i] == 0) {
+            run_node(size, i, shared);
+        }
+    }
+    obi_topology_context_t *ctx = join_ring(size, 0);
+    while (atomic_load(&shared->ready) < size - 1) {
+        sched_yield();
+    }
+
+    obi_node_id_t far = size / 2;
+    uint64_t probe = 0;
+    obi_buffer_t small = { (uint8_t *)&probe, sizeof(probe), sizeof(probe) };
+    double samples[PINGS];
+    for (int i = 0; i < PINGS; i++) {
+        samples[i] = round_trip_us(ctx, &small, far) / 2.0;
+    }
+    qsort(samples, PINGS, sizeof(double), compare);
+
+    obi_buffer_t message = { large, LARGE_MESSAGE, LARGE_MESSAGE };
+    double best = 0.0;
+    for (int i = 0; i < LARGE_ROUNDS; i++) {
+        double trip = round_trip_us(ctx, &message, far);
+        if (i == 0 || trip < best) {
+            best = trip;
+        }
+    }
+
+    // Store-and-forward would pay the whole single-hop time again at every hop
+    if (one_hop_ms == 0.0) {
+        one_hop_ms = best / 1e3;
+    }
+    printf("%4u %5u %14.1f %14.1f %16.3f %16.3f\n", size, far, samples[PINGS / 2], samples[PINGS * 99 / 100],
+           best / 1e3, one_hop_ms * far);
+
+    atomic_store(&shared->stop, true);
+    for (uint32_t i = 1; i < size; i++) {
+        waitpid(pids[i], NULL, 0);
+    }
+    obi_topology_cleanup();
+    munmap(shared, sizeof(*shared));
+}
+
+int main(void) {
+    uint8_t *large = malloc(LARGE_MESSAGE);
+    memset(large, 0x5a, LARGE_MESSAGE);
+
+    printf("📈 OBI Topology Ring Forwarding Benchmark (shm, one process per node)\n");
+    printf("=====================================================================\n");
+    printf("%4s %5s %14s %14s %16s %16s\n", "ring", "hops", "p50 1-way us", "p99 1-way us", "1 MiB round ms",
+           "s&f estimate ms");
+    for (size_t i = 0; i < sizeof(ring_sizes) / sizeof(ring_sizes[0]); i++) {
+        bench(ring_sizes[i], large);
+    }
+
+    free(large);
+    return 0;
+}
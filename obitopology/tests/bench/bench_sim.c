@@ -0,0 +1,379 @@
+/*
+ * Simulated Network Benchmark
+ * Runs whole topologies in one process: every node is an independent
+ * context on its own thread, linked through the in-memory simulated
+ * transport. Reports, reproducibly on one box:
+ * - paced load on every topology type over LAN-like and lossy WAN-like links
+ * - failover: a MESH relay cut off mid-stream, with heartbeat detection
+ * - backpressure: STAR spokes flooding one spoke behind a narrow link
+ */
+
+#define _GNU_SOURCE
+
+#include "obitopology.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
+
+#define LOAD_NODES       8
+#define LOAD_INTERVAL_NS 100000ull     // 10k msg/s offered per node
+#define RUN_NS           300000000ull
+#define MAX_NODES        8
+#define MAX_SAMPLES      65536         // latency samples kept per node
+#define HEARTBEAT_US     200
+#define DRAIN_NS         50000000ull   // senders stop this long before the nodes do
+
+typedef struct {
+    uint64_t sequence;
+    uint64_t sent_ns;
+} probe_t;
+
+typedef struct harness harness_t;
+
+typedef struct {
+    harness_t *harness;
+    uint32_t self;
+    uint32_t samples;
+    uint64_t *latency;
+} sim_node_t;
+
+// One simulated run; nodes read it, only main writes after start
+struct harness {
+    obi_sim_network_t *network;
+    obi_topology_type_t type;
+    uint32_t nodes;
+    uint32_t heartbeat_us;            // 0 = no failure detection
+    const uint16_t (*links)[3];       // explicit {a, b, cost} links
+    size_t link_count;
+    uint64_t sender_mask;
+    obi_node_id_t target;             // OBI_NODE_INVALID = every other node in turn
+    uint64_t interval_ns;             // per sender; 0 = as fast as the links take it
+    _Atomic uint32_t bound;
+    _Atomic bool draining;
+    _Atomic bool stop;
+    _Atomic uint64_t sent;
+    _Atomic uint64_t received;
+    _Atomic uint64_t cut_ns;
+    _Atomic uint64_t detected_ns;
+    _Atomic uint64_t resumed_ns;
+    _Atomic uint64_t relay_stalls;
+    _Atomic uint64_t relay_drops;
+    sim_node_t node[MAX_NODES];
+};
+
+typedef struct {
+    const char *name;
+    obi_sim_link_config_t link;
+} profile_t;
+
+static int protocol_placeholder;
+
+static const profile_t profiles[] = {
+    { "lan", { 50, 10, 1250000000ull, 0 } },     // 10 Gbit/s
+    { "wan", { 2000, 500, 12500000ull, 1000 } }  // 100 Mbit/s, 0.1% loss
+};
+
+static const struct {
+    const char *name;
+    obi_topology_type_t type;
+} types[] = {
+    { "P2P", OBI_TOPOLOGY_P2P }, { "BUS", OBI_TOPOLOGY_BUS }, { "RING", OBI_TOPOLOGY_RING },
+    { "STAR", OBI_TOPOLOGY_STAR }, { "MESH", OBI_TOPOLOGY_MESH }, { "HYBRID", OBI_TOPOLOGY_HYBRID }
+};
+
+// source -> primary -> sink, with a costlier backup path, as in bench_failover
+static const uint16_t failover_links[][3] = { { 0, 1, 1 }, { 1, 3, 1 }, { 0, 2, 2 }, { 2, 3, 2 } };
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void sleep_ns(uint64_t ns) {
+    struct timespec pause = { (time_t)(ns / 1000000000ull), (long)(ns % 1000000000ull) };
+    nanosleep(&pause, NULL);
+}
+
+static obi_topology_context_t *join(harness_t *harness, uint32_t self) {
+    obi_topology_context_t *ctx = obi_topology_context_create((obi_protocol_context_t *)&protocol_placeholder);
+    if (!ctx || obi_topology_set_transport(ctx, obi_topology_transport_sim_create(harness->network)) !=
+                    OBI_TOPOLOGY_SUCCESS) {
+        fprintf(stderr, "context setup failed\n");
+        exit(1);
+    }
+    char name[16];
+    obi_node_id_t id;
+    for (uint32_t i = 0; i < harness->nodes; i++) {
+        snprintf(name, sizeof(name), "sim-%u", i);
+        obi_topology_add_node(ctx, name, NULL, &id);
+    }
+    obi_topology_configure(ctx, harness->type);
+    for (size_t i = 0; i < harness->link_count; i++) {
+        obi_topology_add_link(ctx, harness->links[i][0], harness->links[i][1], harness->links[i][2]);
+    }
+    if (harness->heartbeat_us) {
+        obi_heartbeat_config_t heartbeat = { harness->heartbeat_us, OBI_HEARTBEAT_DEFAULT_PHI };
+        obi_topology_set_heartbeat(ctx, &heartbeat);
+    }
+    snprintf(name, sizeof(name), "sim-%u", self);
+    if (obi_topology_bind(ctx, name) != OBI_TOPOLOGY_SUCCESS) {
+        fprintf(stderr, "bind failed for %s\n", name);
+        exit(1);
+    }
+    return ctx;
+}
+
+static void *run_node(void *arg) {
+    sim_node_t *node = arg;
+    harness_t *harness = node->harness;
+    obi_topology_context_t *ctx = join(harness, node->self);
+    atomic_fetch_add(&harness->bound, 1);
+    while (atomic_load(&harness->bound) < harness->nodes) {
+        sched_yield();
+    }
+
+    bool sender = (harness->sender_mask >> node->self) & 1;
+    uint64_t next_send = now_ns();
+    uint64_t sequence = 0;
+    uint64_t failovers_at_cut = UINT64_MAX;
+    probe_t probe;
+    obi_buffer_t buffer = { (uint8_t *)&probe, 0, sizeof(probe) };
+
+    while (!atomic_load(&harness->stop)) {
+        if (harness->heartbeat_us) {
+            obi_topology_poll(ctx);
+        }
+        while (obi_topology_receive_message(ctx, &buffer) == OBI_SUCCESS) {
+            uint64_t now = now_ns();
+            atomic_fetch_add_explicit(&harness->received, 1, memory_order_relaxed);
+            if (node->samples < MAX_SAMPLES) {
+                node->latency[node->samples++] = now - probe.sent_ns;
+            }
+            uint64_t cut = atomic_load(&harness->cut_ns);
+            if (cut && probe.sent_ns > cut && atomic_load(&harness->resumed_ns) == 0) {
+                atomic_store(&harness->resumed_ns, now);
+            }
+            buffer.size = 0;
+        }
+
+        uint64_t now = now_ns();
+        if (sender && now >= next_send && !atomic_load(&harness->draining)) {
+            obi_node_id_t destination = harness->target;
+            if (destination == OBI_NODE_INVALID) {
+                destination = (node->self + 1 + sequence % (harness->nodes - 1)) % harness->nodes;
+            }
+            probe.sequence = sequence;
+            probe.sent_ns = now;
+            obi_buffer_t out = { (uint8_t *)&probe, sizeof(probe), sizeof(probe) };
+            // Paced senders give up a refused slot, as a real source would, and count it lost
+            if (obi_topology_send_to(ctx, &out, destination) == OBI_SUCCESS || harness->interval_ns) {
+                sequence++;
+                atomic_fetch_add_explicit(&harness->sent, 1, memory_order_relaxed);
+            }
+            next_send += harness->interval_ns;
+        }
+
+        // Earlier (false) suspicions on a loaded host must not count
+        if (node->self == 0 && harness->heartbeat_us && atomic_load(&harness->cut_ns) &&
+            atomic_load(&harness->detected_ns) == 0) {
+            obi_topology_metrics_t metrics;
+            obi_topology_get_metrics(ctx, &metrics);
+            if (failovers_at_cut == UINT64_MAX) {
+                failovers_at_cut = metrics.failovers;
+            } else if (metrics.failovers > failovers_at_cut) {
+                atomic_store(&harness->detected_ns, now_ns());
+            }
+        }
+        sched_yield();  // every node of the topology may share one CPU
+    }
+
+    obi_topology_metrics_t metrics;
+    obi_topology_get_metrics(ctx, &metrics);
+    atomic_fetch_add(&harness->relay_stalls, metrics.relay_stalls);
+    atomic_fetch_add(&harness->relay_drops, metrics.relay_drops);
+    obi_topology_context_destroy(ctx);
+    return NULL;
+}
+
+static harness_t *harness_create(const obi_sim_link_config_t *link, obi_topology_type_t type, uint32_t nodes) {
+    harness_t *harness = calloc(1, sizeof(*harness));
+    obi_sim_config_t config = { *link, OBI_SIM_DEFAULT_QUEUE_FRAMES, OBI_SIM_DEFAULT_QUEUE_BYTES,
+                                OBI_SIM_DEFAULT_SEED };
+    harness->network = obi_sim_network_create(&config);
+    harness->type = type;
+    harness->nodes = nodes;
+    harness->target = OBI_NODE_INVALID;
+    for (uint32_t i = 0; i < nodes; i++) {
+        harness->node[i] = (sim_node_t){ harness, i, 0, malloc(MAX_SAMPLES * sizeof(uint64_t)) };
+    }
+    return harness;
+}
+
+static void harness_start(harness_t *harness, pthread_t *threads) {
+    for (uint32_t i = 0; i < harness->nodes; i++) {
+        pthread_create(&threads[i], NULL, run_node, &harness->node[i]);
+    }
+    while (atomic_load(&harness->bound) < harness->nodes) {
+        sched_yield();
+    }
+}
+
+// Frames in flight are delivered before the count, so lost means lost
+static void harness_stop(harness_t *harness, pthread_t *threads) {
+    atomic_store(&harness->draining, true);
+    sleep_ns(DRAIN_NS);
+    atomic_store(&harness->stop, true);
+    for (uint32_t i = 0; i < harness->nodes; i++) {
+        pthread_join(threads[i], NULL);
+    }
+}
+
+static void harness_destroy(harness_t *harness) {
+    for (uint32_t i = 0; i < harness->nodes; i++) {
+        free(harness->node[i].latency);
+    }
+    obi_sim_network_destroy(harness->network);
+    free(harness);
+}
+
+static int compare(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+// p50 and p99 over every node's samples, in microseconds
+static void percentiles(const harness_t *harness, double *p50, double *p99) {
+    size_t total = 0;
+    for (uint32_t i = 0; i < harness->nodes; i++) {
+        total += harness->node[i].samples;
+    }
+    *p50 = *p99 = 0.0;
+    if (total == 0) {
+        return;
+    }
+    uint64_t *all = malloc(total * sizeof(uint64_t));
+    size_t used = 0;
+    for (uint32_t i = 0; i < harness->nodes; i++) {
+        memcpy(all + used, harness->node[i].latency, harness->node[i].samples * sizeof(uint64_t));
+        used += harness->node[i].samples;
+    }
+    qsort(all, total, sizeof(uint64_t), compare);
+    *p50 = (double)all[total / 2] / 1e3;
+    *p99 = (double)all[total * 99 / 100] / 1e3;
+    free(all);
+}
+
+static void bench_load(const profile_t *profile) {
+    printf("\n%s links: %u us +- %u us, %.0f Mbit/s, %.2f%% loss; %u nodes, %.0f msg/s offered each\n",
+           profile->name, profile->link.latency_us, profile->link.jitter_us,
+           (double)profile->link.bandwidth * 8 / 1e6, (double)profile->link.loss_ppm / 1e4, LOAD_NODES,
+           1e9 / (double)LOAD_INTERVAL_NS);
+    printf("%7s %14s %12s %12s %9s %10s\n", "type", "delivered/s", "p50 us", "p99 us", "lost %", "refused");
+    for (size_t t = 0; t < sizeof(types) / sizeof(types[0]); t++) {
+        harness_t *harness = harness_create(&profile->link, types[t].type, LOAD_NODES);
+        harness->sender_mask = (1ull << LOAD_NODES) - 1;
+        harness->interval_ns = LOAD_INTERVAL_NS;
+        pthread_t threads[MAX_NODES];
+        harness_start(harness, threads);
+        sleep_ns(RUN_NS);
+        harness_stop(harness, threads);
+
+        double p50;
+        double p99;
+        percentiles(harness, &p50, &p99);
+        uint64_t sent = atomic_load(&harness->sent);
+        uint64_t received = atomic_load(&harness->received);
+        obi_sim_stats_t stats;
+        obi_sim_network_get_stats(harness->network, &stats);
+        printf("%7s %14.0f %12.1f %12.1f %9.3f %10llu\n", types[t].name, (double)received * 1e9 / RUN_NS, p50, p99,
+               sent ? 100.0 * (double)(sent > received ? sent - received : 0) / (double)sent : 0.0,
+               (unsigned long long)stats.frames_refused);
+        harness_destroy(harness);
+    }
+}
+
+static void bench_failover(void) {
+    obi_sim_link_config_t link = profiles[0].link;
+    harness_t *harness = harness_create(&link, OBI_TOPOLOGY_MESH, 4);
+    harness->links = failover_links;
+    harness->link_count = sizeof(failover_links) / sizeof(failover_links[0]);
+    harness->heartbeat_us = HEARTBEAT_US;
+    harness->sender_mask = 1;
+    harness->target = 3;
+    harness->interval_ns = 20000;
+    pthread_t threads[MAX_NODES];
+    harness_start(harness, threads);
+    sleep_ns(RUN_NS);
+
+    // Cut the primary off in both directions without stopping its thread
+    obi_sim_link_config_t cut = link;
+    cut.loss_ppm = 1000000;
+    const char *peers[] = { "sim-0", "sim-3" };
+    for (int i = 0; i < 2; i++) {
+        obi_sim_network_set_link(harness->network, "sim-1", peers[i], &cut);
+        obi_sim_network_set_link(harness->network, peers[i], "sim-1", &cut);
+    }
+    uint64_t cut_ns = now_ns();
+    atomic_store(&harness->cut_ns, cut_ns);
+    sleep_ns(RUN_NS);
+    harness_stop(harness, threads);
+
+    uint64_t detected = atomic_load(&harness->detected_ns);
+    uint64_t resumed = atomic_load(&harness->resumed_ns);
+    uint64_t sent = atomic_load(&harness->sent);
+    uint64_t received = atomic_load(&harness->received);
+    printf("\nfailover: MESH relay cut off, heartbeat %d us over lan links\n", HEARTBEAT_US);
+    printf("failure detected after        %10.3f ms\n", detected ? (double)(detected - cut_ns) / 1e6 : -1.0);
+    printf("delivery resumed after        %10.3f ms\n", resumed ? (double)(resumed - cut_ns) / 1e6 : -1.0);
+    printf("messages lost                 %10llu of %llu\n",
+           (unsigned long long)(sent > received ? sent - received : 0), (unsigned long long)sent);
+    harness_destroy(harness);
+}
+
+static void bench_backpressure(void) {
+    obi_sim_link_config_t link = profiles[0].link;
+    harness_t *harness = harness_create(&link, OBI_TOPOLOGY_STAR, 6);
+    harness->sender_mask = 0x3c;  // spokes 2-5 flood spoke 1
+    harness->target = 1;
+
+    // Only the hub's link to the sink is narrow: 10 MB/s, about 300k frames/s of 32 bytes
+    obi_sim_link_config_t narrow = link;
+    narrow.bandwidth = 10000000ull;
+    obi_sim_network_set_link(harness->network, "sim-0", "sim-1", &narrow);
+    pthread_t threads[MAX_NODES];
+    harness_start(harness, threads);
+    sleep_ns(RUN_NS);
+    harness_stop(harness, threads);
+
+    double p50;
+    double p99;
+    percentiles(harness, &p50, &p99);
+    obi_sim_stats_t stats;
+    obi_sim_network_get_stats(harness->network, &stats);
+    uint64_t received = atomic_load(&harness->received);
+    printf("\nbackpressure: 4 STAR spokes flood one spoke behind a 10 MB/s hub link\n");
+    printf("delivered                     %10.0f msg/s (link carries %.0f)\n", (double)received * 1e9 / RUN_NS,
+           10000000.0 / (sizeof(obi_topology_frame_t) + sizeof(probe_t)));
+    printf("latency p50 / p99             %10.1f / %.1f us\n", p50, p99);
+    printf("sends refused by full links   %10llu\n", (unsigned long long)stats.frames_refused);
+    printf("relay stalls / drops          %10llu / %llu\n", (unsigned long long)atomic_load(&harness->relay_stalls),
+           (unsigned long long)atomic_load(&harness->relay_drops));
+    harness_destroy(harness);
+}
+
+int main(void) {
+    printf("📈 OBI Topology Simulated Network Benchmark (one thread per node)\n");
+    printf("=================================================================\n");
+    for (size_t i = 0; i < sizeof(profiles) / sizeof(profiles[0]); i++) {
+        bench_load(&profiles[i]);
+    }
+    bench_failover();
+    bench_backpressure();
+    return 0;
+}
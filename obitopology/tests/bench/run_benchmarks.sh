@@ -0,0 +1,17 @@
+#!/bin/bash
+# Topology Benchmark Runner
+
+set -e
+
+echo "📈 Running Topology Benchmarks..."
+echo "================================="
+
+for bench in bench_*.c; do
+    name=${bench%.c}
+    gcc -std=c11 -O2 -I../../include -I../../../obiprotocol/include \
+        $bench -o $name \
+        -L../../../dist/lib -l:obitopology.a -l:libobiprotocol.a -lrt -lpthread
+    ./$name "$@"
+done
+
+echo "✅ Topology benchmarks completed"
@@ -0,0 +1,16 @@
+#!/bin/bash
+# Topology Flow Control Unit Test Runner
+
+set -e
+
+echo "🧪 Running Topology Flow Control Unit Tests..."
+echo "=============================================="
+
+for test in test_flow_control test_coalescing test_async_send test_pipeline test_ordering test_rate_limit test_traffic_classes; do
+    gcc -std=c11 -I../../../include -I../../../../obiprotocol/include \
+        $test.c -o $test \
+        -L../../../../dist/lib -l:obitopology.a -lrt -lpthread
+    ./$test
+done
+
+echo "✅ Topology flow control unit tests completed"
@@ -0,0 +1,303 @@
+/*
+ * Asynchronous Send Tests
+ * Validates handles and completion callbacks, held sends under backpressure,
+ * receive delivery from the event loop and waking a sleeping loop
+ */
+
+#define _DEFAULT_SOURCE
+
+#include "obitopology.h"
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/wait.h>
+
+#define ASYNC_WINDOW   4
+#define ASYNC_MESSAGES 500
+
+static int protocol_placeholder;
+
+typedef struct {
+    obi_send_handle_t handles[64];
+    obi_result_t results[64];
+    size_t count;
+} completions_t;
+
+static void record_completion(void *user, obi_send_handle_t handle, obi_result_t result) {
+    completions_t *completions = user;
+    completions->handles[completions->count] = handle;
+    completions->results[completions->count++] = result;
+}
+
+static double elapsed_ms(const struct timespec *start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) * 1e3 + (now.tv_nsec - start->tv_nsec) / 1e6;
+}
+
+void test_completion_callbacks() {
+    printf("Testing handles and completion callbacks...\n");
+
+    assert(obi_topology_init((obi_protocol_context_t *)&protocol_placeholder) == OBI_TOPOLOGY_SUCCESS);
+    obi_topology_context_t *ctx = obi_topology_get_context();
+
+    obi_shm_config_t config = { 64, OBI_SHM_DEFAULT_SLOT_SIZE, false };
+    obi_shm_ring_t *sink = NULL;
+    assert(obi_shm_ring_create(OBI_SHM_NAME_PREFIX "async-sink", &config, &sink) == OBI_SUCCESS);
+
+    obi_node_id_t id;
+    assert(obi_topology_add_node(ctx, "sink", "async-sink", &id) == OBI_TOPOLOGY_SUCCESS);
+    assert(obi_topology_bind(ctx, "async-local") == OBI_TOPOLOGY_SUCCESS);
+
+    // Submission returns at once; nothing reaches the transport before the loop runs
+    completions_t completions = {0};
+    obi_send_handle_t handles[3];
+    for (uint32_t i = 0; i < 3; i++) {
+        obi_buffer_t buffer = { (uint8_t *)&i, sizeof(i), sizeof(i) };
+        assert(obi_topology_send_async(ctx, &buffer, id, OBI_PRIORITY_NORMAL,
+                                       record_completion, &completions, &handles[i]) == OBI_SUCCESS);
+        assert(handles[i] != 0);
+    }
+    assert(handles[0] != handles[1] && handles[1] != handles[2]);
+    size_t length = 0;
+    assert(obi_shm_ring_peek(sink, &length) == NULL);
+    assert(completions.count == 0);
+
+    size_t completed = 0;
+    assert(obi_topology_run_events(ctx, 0, &completed) == OBI_SUCCESS);
+    assert(completed == 3 && completions.count == 3);
+    for (uint32_t i = 0; i < 3; i++) {
+        assert(completions.handles[i] == handles[i]);
+        assert(completions.results[i] == OBI_SUCCESS);
+
+        // Payloads were copied at submission and leave in order
+        const uint8_t *slot = obi_shm_ring_peek(sink, &length);
+        assert(slot != NULL);
+        uint32_t value;
+        memcpy(&value, slot + sizeof(obi_topology_frame_t), sizeof(value));
+        assert(value == i);
+        obi_shm_ring_release(sink);
+    }
+
+    // A recycled slot never hands out a handle seen before
+    obi_send_handle_t again;
+    obi_buffer_t empty = { NULL, 0, 0 };
+    assert(obi_topology_send_async(ctx, &empty, id, OBI_PRIORITY_NORMAL, NULL, NULL, &again) == OBI_SUCCESS);
+    assert(again != handles[0] && again != handles[1] && again != handles[2]);
+    assert(obi_topology_run_events(ctx, 0, &completed) == OBI_SUCCESS && completed == 1);
+
+    obi_topology_cleanup();
+    obi_shm_ring_close(sink);
+    printf("✅ Completion callbacks test passed\n");
+}
+
+void test_held_under_backpressure() {
+    printf("Testing sends held for credit instead of failing...\n");
+
+    assert(obi_topology_init((obi_protocol_context_t *)&protocol_placeholder) == OBI_TOPOLOGY_SUCCESS);
+    obi_topology_context_t *ctx = obi_topology_get_context();
+
+    obi_shm_config_t config = { 64, OBI_SHM_DEFAULT_SLOT_SIZE, false };
+    obi_shm_ring_t *sink = NULL;
+    assert(obi_shm_ring_create(OBI_SHM_NAME_PREFIX "async-held", &config, &sink) == OBI_SUCCESS);
+
+    obi_node_id_t id;
+    assert(obi_topology_add_node(ctx, "held", "async-held", &id) == OBI_TOPOLOGY_SUCCESS);
+    assert(obi_topology_bind(ctx, "async-local") == OBI_TOPOLOGY_SUCCESS);
+    obi_flow_config_t flow = { ASYNC_WINDOW, 0 };
+    assert(obi_topology_set_flow_control(ctx, &flow) == OBI_TOPOLOGY_SUCCESS);
+
+    completions_t completions = {0};
+    obi_send_handle_t handle;
+    for (uint32_t i = 0; i < ASYNC_WINDOW * 2; i++) {
+        obi_buffer_t buffer = { (uint8_t *)&i, sizeof(i), sizeof(i) };
+        assert(obi_topology_send_async(ctx, &buffer, id, OBI_PRIORITY_NORMAL,
+                                       record_completion, &completions, &handle) == OBI_SUCCESS);
+    }
+
+    // The window admits half; the rest wait on the retry tick rather than complete with OBI_BUSY
+    size_t completed = 0;
+    assert(obi_topology_run_events(ctx, 0, &completed) == OBI_SUCCESS && completed == ASYNC_WINDOW);
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    assert(obi_topology_run_events(ctx, 20, &completed) == OBI_SUCCESS && completed == 0);
+    assert(elapsed_ms(&start) < 20.0);
+    for (size_t i = 0; i < completions.count; i++) {
+        assert(completions.results[i] == OBI_SUCCESS);
+    }
+
+    // Play the sink: a grant for the whole window releases the held sends
+    size_t length = 0;
+    const uint8_t *slot = obi_shm_ring_peek(sink, &length);
+    obi_topology_frame_t sent;
+    memcpy(&sent, slot, sizeof(sent));
+    obi_shm_ring_t *local = NULL;
+    assert(obi_shm_ring_attach(OBI_SHM_NAME_PREFIX "async-local", false, &local) == OBI_SUCCESS);
+    obi_topology_frame_t grant = {0};
+    grant.type = OBI_FRAME_CREDIT;
+    grant.flags = OBI_FRAME_FLAG_CREDIT;
+    grant.source = sent.destination;
+    grant.destination = sent.source;
+    grant.credit = ASYNC_WINDOW;
+    obi_shm_reservation_t reservation;
+    uint8_t *write = obi_shm_ring_reserve(local, sizeof(grant), &reservation);
+    memcpy(write, &grant, sizeof(grant));
+    obi_shm_ring_publish(local, &reservation, sizeof(grant));
+
+    uint8_t storage[64];
+    obi_buffer_t inbound = { storage, 0, sizeof(storage) };
+    assert(obi_topology_receive_message(ctx, &inbound) == OBI_ERROR_WOULD_BLOCK);
+    assert(obi_topology_run_events(ctx, 0, &completed) == OBI_SUCCESS && completed == ASYNC_WINDOW);
+    assert(completions.count == ASYNC_WINDOW * 2);
+
+    // Sends queued at cleanup still complete, with a failure
+    for (uint32_t i = 0; i < 2; i++) {
+        obi_buffer_t buffer = { (uint8_t *)&i, sizeof(i), sizeof(i) };
+        assert(obi_topology_send_async(ctx, &buffer, id, OBI_PRIORITY_NORMAL,
+                                       record_completion, &completions, &handle) == OBI_SUCCESS);
+    }
+    obi_shm_ring_close(local);
+    obi_topology_cleanup();
+    assert(completions.count == ASYNC_WINDOW * 2 + 2);
+    assert(completions.results[ASYNC_WINDOW * 2 + 1] == OBI_ERROR_NETWORK_FAILURE);
+    obi_shm_ring_close(sink);
+    printf("✅ Backpressure hold test passed\n");
+}
+
+static void join_pair(const char *self) {
+    obi_node_id_t id;
+    assert(obi_topology_init((obi_protocol_context_t *)&protocol_placeholder) == OBI_TOPOLOGY_SUCCESS);
+    obi_topology_context_t *ctx = obi_topology_get_context();
+
+    assert(obi_topology_add_node(ctx, "async-producer", NULL, &id) == OBI_TOPOLOGY_SUCCESS);
+    assert(obi_topology_add_node(ctx, "async-consumer", NULL, &id) == OBI_TOPOLOGY_SUCCESS);
+    obi_flow_config_t flow = { 64, 0 };
+    assert(obi_topology_set_flow_control(ctx, &flow) == OBI_TOPOLOGY_SUCCESS);
+    assert(obi_topology_bind(ctx, self) == OBI_TOPOLOGY_SUCCESS);
+}
+
+static void count_received(void *user, const obi_buffer_t *message) {
+    int *expected = user;
+    int value;
+    assert(message->size == sizeof(value));
+    memcpy(&value, message->data, sizeof(value));
+    assert(value == (*expected)++);
+}
+
+static void run_consumer(void) {
+    join_pair("async-consumer");
+    obi_topology_context_t *ctx = obi_topology_get_context();
+
+    // The loop delivers receives and returns credit with no explicit receive calls
+    int expected = 0;
+    assert(obi_topology_set_receive_callback(ctx, count_received, &expected) == OBI_TOPOLOGY_SUCCESS);
+    while (expected < ASYNC_MESSAGES) {
+        assert(obi_topology_run_events(ctx, 100, NULL) == OBI_SUCCESS);
+    }
+    obi_topology_cleanup();
+    _exit(0);
+}
+
+static void unexpected_message(void *user, const obi_buffer_t *message) {
+    (void)user;
+    (void)message;
+    assert(!"the consumer only returns credit");
+}
+
+static void count_completed(void *user, obi_send_handle_t handle, obi_result_t result) {
+    (void)handle;
+    assert(result == OBI_SUCCESS);
+    (*(int *)user)++;
+}
+
+void test_receive_loop() {
+    printf("Testing many sends in flight through two event loops...\n");
+
+    pid_t consumer = fork();
+    if (consumer == 0) {
+        run_consumer();
+    }
+
+    join_pair("async-producer");
+    obi_topology_context_t *ctx = obi_topology_get_context();
+    usleep(100000);  // let the consumer bind its ring
+
+    // Far more than the window: the loop holds the excess until credit returns
+    int done = 0;
+    obi_send_handle_t handle;
+    for (int i = 0; i < ASYNC_MESSAGES; i++) {
+        obi_buffer_t buffer = { (uint8_t *)&i, sizeof(i), sizeof(i) };
+        assert(obi_topology_send_async(ctx, &buffer, 1, OBI_PRIORITY_NORMAL,
+                                       count_completed, &done, &handle) == OBI_SUCCESS);
+    }
+    // Grants arrive through the loop's receive pass
+    assert(obi_topology_set_receive_callback(ctx, unexpected_message, NULL) == OBI_TOPOLOGY_SUCCESS);
+    while (done < ASYNC_MESSAGES) {
+        assert(obi_topology_run_events(ctx, 100, NULL) == OBI_SUCCESS);
+    }
+
+    int status = 0;
+    waitpid(consumer, &status, 0);
+    assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    obi_topology_cleanup();
+    printf("✅ Receive loop test passed\n");
+}
+
+static void *submit_later(void *arg) {
+    obi_topology_context_t *ctx = obi_topology_get_context();
+    uint32_t value = 7;
+    obi_buffer_t buffer = { (uint8_t *)&value, sizeof(value), sizeof(value) };
+    obi_send_handle_t handle;
+    usleep(20000);
+    assert(obi_topology_send_async(ctx, &buffer, *(obi_node_id_t *)arg, OBI_PRIORITY_HIGH,
+                                   NULL, NULL, &handle) == OBI_SUCCESS);
+    return NULL;
+}
+
+void test_wake_sleeping_loop() {
+    printf("Testing a submission wakes an idle loop...\n");
+
+    assert(obi_topology_init((obi_protocol_context_t *)&protocol_placeholder) == OBI_TOPOLOGY_SUCCESS);
+    obi_topology_context_t *ctx = obi_topology_get_context();
+
+    obi_shm_config_t config = { 64, OBI_SHM_DEFAULT_SLOT_SIZE, false };
+    obi_shm_ring_t *sink = NULL;
+    assert(obi_shm_ring_create(OBI_SHM_NAME_PREFIX "async-wake", &config, &sink) == OBI_SUCCESS);
+    obi_node_id_t id;
+    assert(obi_topology_add_node(ctx, "wake", "async-wake", &id) == OBI_TOPOLOGY_SUCCESS);
+    assert(obi_topology_bind(ctx, "async-local") == OBI_TOPOLOGY_SUCCESS);
+    assert(obi_topology_event_fd(ctx) >= 0);
+
+    // No tick is armed while idle, so only the wake descriptor can end the wait early
+    pthread_t submitter;
+    pthread_create(&submitter, NULL, submit_later, &id);
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    size_t completed = 0;
+    assert(obi_topology_run_events(ctx, 5000, &completed) == OBI_SUCCESS);
+    assert(completed == 1);
+    assert(elapsed_ms(&start) < 1000.0);
+    pthread_join(submitter, NULL);
+    size_t length = 0;
+    assert(obi_shm_ring_peek(sink, &length) != NULL);
+
+    obi_topology_cleanup();
+    obi_shm_ring_close(sink);
+    printf("✅ Wake sleeping loop test passed\n");
+}
+
+int main() {
+    printf("🧪 Running OBI Topology Asynchronous Send Tests\n");
+    printf("===============================================\n");
+
+    test_completion_callbacks();
+    test_held_under_backpressure();
+    test_receive_loop();
+    test_wake_sleeping_loop();
+
+    printf("\n✅ All asynchronous send tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,187 @@
+/*
+ * Coalescing Tests
+ * Validates batch framing, fill/deadline/explicit flushes, ordering
+ * against large sends and unpacking on the receive path
+ */
+
+#define _DEFAULT_SOURCE
+
+#include "obitopology.h"
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#define COALESCE_MESSAGES 5000
+
+static int protocol_placeholder;
+
+static obi_topology_frame_t take_frame(obi_shm_ring_t *ring, uint8_t *payload, size_t capacity) {
+    size_t length = 0;
+    const uint8_t *slot = obi_shm_ring_peek(ring, &length);
+    assert(slot != NULL);
+
+    obi_topology_frame_t frame;
+    memcpy(&frame, slot, sizeof(frame));
+    assert(frame.length <= capacity);
+    memcpy(payload, slot + sizeof(frame), frame.length);
+    obi_shm_ring_release(ring);
+    return frame;
+}
+
+void test_batch_flushes() {
+    printf("Testing explicit, fill and deadline flushes...\n");
+
+    assert(obi_topology_init((obi_protocol_context_t *)&protocol_placeholder) == OBI_TOPOLOGY_SUCCESS);
+    obi_topology_context_t *ctx = obi_topology_get_context();
+    obi_topology_metrics_t metrics;
+
+    obi_shm_config_t config = { 64, OBI_SHM_DEFAULT_SLOT_SIZE, false };
+    obi_shm_ring_t *sink = NULL;
+    assert(obi_shm_ring_create(OBI_SHM_NAME_PREFIX "coalesce-sink", &config, &sink) == OBI_SUCCESS);
+
+    obi_node_id_t id;
+    assert(obi_topology_add_node(ctx, "sink", "coalesce-sink", &id) == OBI_TOPOLOGY_SUCCESS);
+    obi_coalesce_config_t coalesce = { 64, 1000 };
+    assert(obi_topology_set_coalescing(ctx, &coalesce) == OBI_TOPOLOGY_SUCCESS);
+
+    // Small sends wait in the batch until flushed
+    uint32_t value;
+    obi_buffer_t small = { (uint8_t *)&value, sizeof(value), sizeof(value) };
+    for (value = 0; value < 10; value++) {
+        assert(obi_topology_send_to(ctx, &small, id) == OBI_SUCCESS);
+    }
+    size_t length = 0;
+    assert(obi_shm_ring_peek(sink, &length) == NULL);
+    assert(obi_topology_flush(ctx) == OBI_SUCCESS);
+
+    uint8_t payload[OBI_SHM_DEFAULT_SLOT_SIZE];
+    obi_topology_frame_t frame = take_frame(sink, payload, sizeof(payload));
+    assert(frame.type == OBI_FRAME_BATCH);
+    assert(frame.length == 10 * (sizeof(uint32_t) + sizeof(value)));
+    for (uint32_t i = 0; i < 10; i++) {
+        uint32_t record_length, record_value;
+        memcpy(&record_length, payload + i * 8, sizeof(record_length));
+        memcpy(&record_value, payload + i * 8 + 4, sizeof(record_value));
+        assert(record_length == sizeof(value) && record_value == i);
+    }
+    assert(obi_topology_get_metrics(ctx, &metrics) == OBI_TOPOLOGY_SUCCESS);
+    assert(metrics.coalesced_messages == 10 && metrics.coalesced_batches == 1);
+
+    // A large send drains the batch first so it never overtakes it
+    uint8_t large_data[100] = {0};
+    obi_buffer_t large = { large_data, sizeof(large_data), sizeof(large_data) };
+    assert(obi_topology_send_to(ctx, &small, id) == OBI_SUCCESS);
+    assert(obi_topology_send_to(ctx, &large, id) == OBI_SUCCESS);
+    assert(take_frame(sink, payload, sizeof(payload)).type == OBI_FRAME_BATCH);
+    frame = take_frame(sink, payload, sizeof(payload));
+    assert(frame.type == OBI_FRAME_DATA && frame.length == sizeof(large_data));
+
+    // A full batch leaves without waiting for its deadline
+    for (value = 0; value < 300; value++) {
+        assert(obi_topology_send_to(ctx, &small, id) == OBI_SUCCESS);
+    }
+    frame = take_frame(sink, payload, sizeof(payload));
+    assert(frame.type == OBI_FRAME_BATCH && frame.length > 200 * 8);
+
+    // The rest goes once its deadline passes and the owner polls
+    assert(obi_shm_ring_peek(sink, &length) == NULL);
+    usleep(2000);
+    assert(obi_topology_poll(ctx) == OBI_TOPOLOGY_SUCCESS);
+    assert(take_frame(sink, payload, sizeof(payload)).type == OBI_FRAME_BATCH);
+    assert(obi_topology_get_metrics(ctx, &metrics) == OBI_TOPOLOGY_SUCCESS);
+    assert(metrics.coalesced_messages == 311);
+
+    // Coalesced messages must fit a batch frame
+    coalesce.max_message = OBI_SHM_DEFAULT_SLOT_SIZE;
+    assert(obi_topology_set_coalescing(ctx, &coalesce) == OBI_TOPOLOGY_ERROR_INVALID_CONFIG);
+
+    obi_topology_cleanup();
+    obi_shm_ring_close(sink);
+    printf("✅ Batch flush test passed\n");
+}
+
+static void join_pair(const char *self) {
+    obi_node_id_t id;
+    assert(obi_topology_init((obi_protocol_context_t *)&protocol_placeholder) == OBI_TOPOLOGY_SUCCESS);
+    obi_topology_context_t *ctx = obi_topology_get_context();
+
+    assert(obi_topology_add_node(ctx, "coalesce-tx", NULL, &id) == OBI_TOPOLOGY_SUCCESS);
+    assert(obi_topology_add_node(ctx, "coalesce-rx", NULL, &id) == OBI_TOPOLOGY_SUCCESS);
+    assert(obi_topology_set_coalescing(ctx, NULL) == OBI_TOPOLOGY_SUCCESS);
+    assert(obi_topology_bind(ctx, self) == OBI_TOPOLOGY_SUCCESS);
+}
+
+static void run_receiver(void) {
+    join_pair("coalesce-rx");
+    obi_topology_context_t *ctx = obi_topology_get_context();
+    uint8_t storage[OBI_SHM_DEFAULT_SLOT_SIZE];
+    obi_buffer_t buffer = { storage, 0, sizeof(storage) };
+
+    // Batches unpack into the original messages, in order, whether the
+    // buffer holds a whole frame or only one message
+    for (int expected = 0; expected < COALESCE_MESSAGES; ) {
+        buffer.capacity = expected < COALESCE_MESSAGES / 2 ? sizeof(storage) : sizeof(int);
+        obi_result_t result = obi_topology_receive_message(ctx, &buffer);
+        if (result == OBI_ERROR_WOULD_BLOCK) {
+            usleep(50);
+            continue;
+        }
+        int value;
+        assert(result == OBI_SUCCESS && buffer.size == sizeof(value));
+        memcpy(&value, buffer.data, sizeof(value));
+        assert(value == expected++);
+    }
+    obi_topology_cleanup();
+    _exit(0);
+}
+
+void test_unpack_on_receive() {
+    printf("Testing batch unpacking across processes...\n");
+
+    pid_t receiver = fork();
+    if (receiver == 0) {
+        run_receiver();
+    }
+
+    join_pair("coalesce-tx");
+    obi_topology_context_t *ctx = obi_topology_get_context();
+    obi_node_id_t target = 1;
+    usleep(100000);  // let the receiver bind its ring
+
+    for (int i = 0; i < COALESCE_MESSAGES; ) {
+        obi_buffer_t buffer = { (uint8_t *)&i, sizeof(i), sizeof(i) };
+        obi_result_t result = obi_topology_send_to(ctx, &buffer, target);
+        if (result == OBI_ERROR_WOULD_BLOCK) {
+            usleep(50);
+            continue;
+        }
+        assert(result == OBI_SUCCESS);
+        i++;
+    }
+    assert(obi_topology_flush(ctx) == OBI_SUCCESS);
+
+    int status = 0;
+    waitpid(receiver, &status, 0);
+    assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+    obi_topology_metrics_t metrics;
+    assert(obi_topology_get_metrics(ctx, &metrics) == OBI_TOPOLOGY_SUCCESS);
+    assert(metrics.coalesced_messages == COALESCE_MESSAGES);
+    assert(metrics.coalesced_batches < COALESCE_MESSAGES / 10);
+    obi_topology_cleanup();
+
+    printf("✅ Receive unpacking test passed\n");
+}
+
+int main() {
+    printf("🧪 Running OBI Topology Coalescing Tests\n");
+    printf("========================================\n");
+
+    test_batch_flushes();
+    test_unpack_on_receive();
+
+    printf("\n✅ All coalescing tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,177 @@
+/*
+ * In-Order Delivery Tests
+ * Validates the reorder ring: early frames are held and released in
+ * sequence order, missing frames are skipped after the timeout, late
+ * frames are dropped and a frame a whole window ahead moves the window
+ */
+
+#define _DEFAULT_SOURCE
+
+#include "obitopology.h"
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <unistd.h>
+
+#define ORDER_WINDOW     8
+#define ORDER_TIMEOUT_US 20000
+
+static int protocol_placeholder;
+static obi_shm_ring_t *ring;
+static uint32_t source_a;
+static uint32_t source_b;
+
+// Node keys are the FNV-1a hash of the node name
+static uint32_t node_key(const char *name) {
+    uint32_t hash = 2166136261u;
+    while (*name) {
+        hash ^= (uint8_t)*name++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Inject a frame straight into the local ring, as if it took another path
+static void inject(uint32_t source, uint32_t sequence) {
+    obi_topology_frame_t frame = {0};
+    frame.length = sizeof(sequence);
+    frame.type = OBI_FRAME_DATA;
+    frame.source = source;
+    frame.sequence = sequence;
+    obi_shm_reservation_t reservation;
+    uint8_t *slot = obi_shm_ring_reserve(ring, sizeof(frame) + sizeof(sequence), &reservation);
+    assert(slot != NULL);
+    memcpy(slot, &frame, sizeof(frame));
+    memcpy(slot + sizeof(frame), &sequence, sizeof(sequence));
+    obi_shm_ring_publish(ring, &reservation, sizeof(frame) + sizeof(sequence));
+}
+
+static void expect(obi_topology_context_t *ctx, uint32_t sequence) {
+    uint32_t value = 0;
+    obi_buffer_t buffer = { (uint8_t *)&value, 0, sizeof(value) };
+    assert(obi_topology_receive_message(ctx, &buffer) == OBI_SUCCESS);
+    assert(buffer.size == sizeof(value) && value == sequence);
+}
+
+static void expect_nothing(obi_topology_context_t *ctx) {
+    uint32_t value;
+    obi_buffer_t buffer = { (uint8_t *)&value, 0, sizeof(value) };
+    assert(obi_topology_receive_message(ctx, &buffer) == OBI_ERROR_WOULD_BLOCK);
+}
+
+static obi_topology_context_t *join(void) {
+    assert(obi_topology_init((obi_protocol_context_t *)&protocol_placeholder) == OBI_TOPOLOGY_SUCCESS);
+    obi_topology_context_t *ctx = obi_topology_get_context();
+    obi_node_id_t id;
+    assert(obi_topology_add_node(ctx, "order-a", NULL, &id) == OBI_TOPOLOGY_SUCCESS);
+    assert(obi_topology_add_node(ctx, "order-b", NULL, &id) == OBI_TOPOLOGY_SUCCESS);
+    assert(obi_topology_bind(ctx, "order-rx") == OBI_TOPOLOGY_SUCCESS);
+    assert(obi_shm_ring_attach(OBI_SHM_NAME_PREFIX "order-rx", false, &ring) == OBI_SUCCESS);
+    source_a = node_key("order-a");
+    source_b = node_key("order-b");
+
+    obi_order_config_t config = { ORDER_WINDOW, ORDER_TIMEOUT_US };
+    assert(obi_topology_set_ordering(ctx, &config) == OBI_TOPOLOGY_SUCCESS);
+    return ctx;
+}
+
+static void leave(void) {
+    obi_shm_ring_close(ring);
+    obi_topology_cleanup();
+}
+
+void test_reorder() {
+    printf("Testing held frames released in sequence order...\n");
+
+    obi_topology_context_t *ctx = join();
+
+    // Sources are ordered independently; B is never held behind A's gap
+    inject(source_a, 1);
+    inject(source_a, 3);
+    inject(source_a, 4);
+    inject(source_b, 1);
+    inject(source_a, 2);
+    inject(source_a, 5);
+    expect(ctx, 1);
+    expect(ctx, 1);
+    expect(ctx, 2);
+    expect(ctx, 3);
+    expect(ctx, 4);
+    expect(ctx, 5);
+    expect_nothing(ctx);
+
+    obi_topology_metrics_t metrics;
+    assert(obi_topology_get_metrics(ctx, &metrics) == OBI_TOPOLOGY_SUCCESS);
+    assert(metrics.reordered_frames == 2 && metrics.sequence_gaps == 0 && metrics.late_frames == 0);
+
+    leave();
+    printf("✅ Reorder test passed\n");
+}
+
+void test_gap_timeout() {
+    printf("Testing missing frames skipped after the timeout...\n");
+
+    obi_topology_context_t *ctx = join();
+    inject(source_a, 6);
+    inject(source_a, 8);
+    inject(source_a, 9);
+    expect(ctx, 6);
+    expect_nothing(ctx);  // 8 and 9 wait for 7
+
+    usleep(2 * ORDER_TIMEOUT_US);
+    expect(ctx, 8);
+    expect(ctx, 9);
+
+    // 7 turning up after its turn is dropped, as is a duplicate
+    inject(source_a, 7);
+    inject(source_a, 9);
+    expect_nothing(ctx);
+
+    obi_topology_metrics_t metrics;
+    assert(obi_topology_get_metrics(ctx, &metrics) == OBI_TOPOLOGY_SUCCESS);
+    assert(metrics.sequence_gaps == 1 && metrics.reorder_timeouts == 1 && metrics.late_frames == 2);
+
+    leave();
+    printf("✅ Gap timeout test passed\n");
+}
+
+void test_window_overflow() {
+    printf("Testing a frame a whole window ahead...\n");
+
+    obi_topology_context_t *ctx = join();
+    inject(source_a, 10);
+    inject(source_a, 12);
+    inject(source_a, 12 + ORDER_WINDOW);
+    expect(ctx, 10);
+
+    // The far frame gives up on 11 at once and is held at the window's end
+    expect(ctx, 12);
+    expect_nothing(ctx);
+    usleep(2 * ORDER_TIMEOUT_US);
+    expect(ctx, 12 + ORDER_WINDOW);
+
+    obi_topology_metrics_t metrics;
+    assert(obi_topology_get_metrics(ctx, &metrics) == OBI_TOPOLOGY_SUCCESS);
+    assert(metrics.sequence_gaps == ORDER_WINDOW && metrics.reorder_timeouts == 1);
+
+    // A source that restarts its numbering is picked up again
+    inject(source_a, 1);
+    inject(source_a, 2);
+    expect(ctx, 1);
+    expect(ctx, 2);
+
+    leave();
+    printf("✅ Window overflow test passed\n");
+}
+
+int main() {
+    printf("🧪 Running OBI Topology In-Order Delivery Tests\n");
+    printf("===============================================\n");
+
+    test_reorder();
+    test_gap_timeout();
+    test_window_overflow();
+
+    printf("\n✅ All in-order delivery tests passed!\n");
+    return 0;
+}
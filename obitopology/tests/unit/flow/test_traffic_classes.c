@@ -0,0 +1,221 @@
+/*
+ * Traffic Class Tests
+ * Validates strict priority for security and audit sends over a bulk
+ * flood, weighted sharing between the other classes, the bound on how
+ * long strict traffic may hold weighted classes back, and that shed
+ * requests spend no class's share
+ */
+
+#include "obitopology.h"
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+
+#define MESSAGE_SIZE 256
+#define SINK_SLOTS   64
+
+static int protocol_placeholder;
+static obi_shm_ring_t *sink;
+static obi_node_id_t sink_id;
+
+static obi_topology_context_t *join(void) {
+    assert(obi_topology_init((obi_protocol_context_t *)&protocol_placeholder) == OBI_TOPOLOGY_SUCCESS);
+    obi_topology_context_t *ctx = obi_topology_get_context();
+    obi_shm_config_t config = { SINK_SLOTS, OBI_SHM_DEFAULT_SLOT_SIZE, false };
+    assert(obi_shm_ring_create(OBI_SHM_NAME_PREFIX "class-sink", &config, &sink) == OBI_SUCCESS);
+    assert(obi_topology_add_node(ctx, "class-sink", "class-sink", &sink_id) == OBI_TOPOLOGY_SUCCESS);
+    return ctx;
+}
+
+static void leave(void) {
+    obi_topology_cleanup();
+    obi_shm_ring_close(sink);
+}
+
+static void submit(obi_topology_context_t *ctx, obi_traffic_class_t traffic_class, uint32_t count) {
+    uint8_t payload[MESSAGE_SIZE] = {0};
+    for (uint32_t i = 0; i < count; i++) {
+        payload[0] = (uint8_t)traffic_class;
+        obi_buffer_t buffer = { payload, sizeof(payload), sizeof(payload) };
+        obi_send_handle_t handle;
+        assert(obi_topology_send_async_class(ctx, &buffer, sink_id, traffic_class, NULL, NULL, &handle) ==
+               OBI_SUCCESS);
+    }
+}
+
+// Class of each frame in the sink, in arrival order
+static size_t collect(obi_traffic_class_t *classes, size_t max) {
+    size_t count = 0;
+    size_t length;
+    const uint8_t *frame;
+    while (count < max && (frame = obi_shm_ring_peek(sink, &length)) != NULL) {
+        assert(length == sizeof(obi_topology_frame_t) + MESSAGE_SIZE);
+        classes[count++] = (obi_traffic_class_t)frame[sizeof(obi_topology_frame_t)];
+        obi_shm_ring_release(sink);
+    }
+    return count;
+}
+
+void test_pattern_mapping() {
+    printf("Testing semantic patterns mapped to classes...\n");
+
+    assert(obi_topology_class_for_pattern(PATTERN_SECURITY_TOKEN) == OBI_CLASS_SECURITY);
+    assert(obi_topology_class_for_pattern(PATTERN_AUDIT_MARKER) == OBI_CLASS_AUDIT);
+    assert(obi_topology_class_for_pattern(PATTERN_DATA_PAYLOAD) == OBI_CLASS_BULK);
+    assert(obi_topology_class_for_pattern(PATTERN_SCHEMA_REFERENCE) == OBI_CLASS_CONTROL);
+    assert(obi_topology_class_for_pattern(PATTERN_CANONICAL_DELIMITER) == OBI_CLASS_DEFAULT);
+
+    obi_topology_context_t *ctx = join();
+    obi_class_config_t config = { { 0, 0, 1, 0, 1 }, 8 };
+    assert(obi_topology_set_traffic_classes(ctx, &config) == OBI_TOPOLOGY_ERROR_INVALID_CONFIG);
+    assert(obi_topology_set_traffic_classes(ctx, NULL) == OBI_TOPOLOGY_SUCCESS);
+    uint8_t byte = 0;
+    obi_buffer_t buffer = { &byte, 1, 1 };
+    obi_send_handle_t handle;
+    assert(obi_topology_send_async_class(ctx, &buffer, sink_id, OBI_CLASS_COUNT, NULL, NULL, &handle) ==
+           OBI_ERROR_INVALID_INPUT);
+    leave();
+
+    printf("✅ Pattern mapping test passed\n");
+}
+
+void test_strict_priority() {
+    printf("Testing audit records ahead of a bulk flood...\n");
+
+    obi_topology_context_t *ctx = join();
+
+    // The flood is queued first and already fills the sink several times over
+    submit(ctx, OBI_CLASS_BULK, 4 * SINK_SLOTS);
+    submit(ctx, OBI_CLASS_AUDIT, 3);
+    submit(ctx, OBI_CLASS_SECURITY, 2);
+    size_t completed = 0;
+    assert(obi_topology_run_events(ctx, 0, &completed) == OBI_SUCCESS);
+    assert(completed == SINK_SLOTS);
+
+    obi_traffic_class_t classes[SINK_SLOTS];
+    assert(collect(classes, SINK_SLOTS) == SINK_SLOTS);
+    assert(classes[0] == OBI_CLASS_SECURITY && classes[1] == OBI_CLASS_SECURITY);
+    for (int i = 2; i < 5; i++) {
+        assert(classes[i] == OBI_CLASS_AUDIT);
+    }
+    assert(classes[5] == OBI_CLASS_BULK);
+
+    // Audit submitted behind the queued flood still goes out next
+    submit(ctx, OBI_CLASS_AUDIT, 1);
+    assert(obi_topology_run_events(ctx, 0, &completed) == OBI_SUCCESS);
+    assert(collect(classes, 1) == 1 && classes[0] == OBI_CLASS_AUDIT);
+
+    obi_topology_metrics_t metrics;
+    assert(obi_topology_get_metrics(ctx, &metrics) == OBI_TOPOLOGY_SUCCESS);
+    assert(metrics.class_sent[OBI_CLASS_AUDIT] == 4 && metrics.class_sent[OBI_CLASS_SECURITY] == 2);
+    assert(metrics.starvation_breaks == 0);
+
+    leave();
+    printf("✅ Strict priority test passed\n");
+}
+
+void test_weighted_sharing() {
+    printf("Testing weighted sharing between classes...\n");
+
+    obi_topology_context_t *ctx = join();
+    obi_class_config_t config = { { 0, 0, 1, 1, 3 }, OBI_CLASS_DEFAULT_STRICT_BURST };
+    assert(obi_topology_set_traffic_classes(ctx, &config) == OBI_TOPOLOGY_SUCCESS);
+
+    // Each round control earns four messages' worth and bulk twelve
+    submit(ctx, OBI_CLASS_CONTROL, 2 * SINK_SLOTS);
+    submit(ctx, OBI_CLASS_BULK, 2 * SINK_SLOTS);
+    assert(obi_topology_run_events(ctx, 0, NULL) == OBI_SUCCESS);
+
+    obi_traffic_class_t classes[SINK_SLOTS];
+    assert(collect(classes, SINK_SLOTS) == SINK_SLOTS);
+    size_t control = 0;
+    for (int i = 0; i < SINK_SLOTS; i++) {
+        control += classes[i] == OBI_CLASS_CONTROL;
+    }
+    assert(control == SINK_SLOTS / 4);
+
+    leave();
+    printf("✅ Weighted sharing test passed\n");
+}
+
+void test_bounded_starvation() {
+    printf("Testing weighted sends let through a strict stream...\n");
+
+    obi_topology_context_t *ctx = join();
+    obi_class_config_t config = { OBI_CLASS_DEFAULT_WEIGHTS, 4 };
+    assert(obi_topology_set_traffic_classes(ctx, &config) == OBI_TOPOLOGY_SUCCESS);
+
+    submit(ctx, OBI_CLASS_BULK, 10);
+    submit(ctx, OBI_CLASS_AUDIT, 40);
+    assert(obi_topology_run_events(ctx, 0, NULL) == OBI_SUCCESS);
+
+    // Four audit records, then one bulk send, while audit keeps waiting
+    obi_traffic_class_t classes[50];
+    assert(collect(classes, 50) == 50);
+    for (int i = 0; i < 45; i++) {
+        assert(classes[i] == (i % 5 == 4 ? OBI_CLASS_BULK : OBI_CLASS_AUDIT));
+    }
+
+    obi_topology_metrics_t metrics;
+    assert(obi_topology_get_metrics(ctx, &metrics) == OBI_TOPOLOGY_SUCCESS);
+    assert(metrics.starvation_breaks == 9);
+    assert(metrics.class_sent[OBI_CLASS_BULK] == 10 && metrics.class_sent[OBI_CLASS_AUDIT] == 40);
+
+    leave();
+    printf("✅ Bounded starvation test passed\n");
+}
+
+void test_shed_uncharged() {
+    printf("Testing shed bulk requests spend no share...\n");
+
+    obi_topology_context_t *ctx = join();
+    obi_class_config_t config = { OBI_CLASS_DEFAULT_WEIGHTS, 4 };
+    assert(obi_topology_set_traffic_classes(ctx, &config) == OBI_TOPOLOGY_SUCCESS);
+
+    // Nobody drains the sink until the refused frames raise the zone to Warning
+    obi_topology_metrics_t metrics;
+    assert(obi_topology_get_metrics(ctx, &metrics) == OBI_TOPOLOGY_SUCCESS);
+    uint32_t value = 0;
+    obi_buffer_t buffer = { (uint8_t *)&value, sizeof(value), sizeof(value) };
+    for (int round = 0; round < 40 && metrics.zone == OBI_ZONE_AUTONOMOUS; round++) {
+        for (int i = 0; i < 256; i++) {
+            obi_topology_send_to(ctx, &buffer, sink_id);
+        }
+        assert(obi_topology_get_metrics(ctx, &metrics) == OBI_TOPOLOGY_SUCCESS);
+    }
+    assert(metrics.zone == OBI_ZONE_WARNING);
+    size_t length;
+    while (obi_shm_ring_peek(sink, &length)) {
+        obi_shm_ring_release(sink);
+    }
+
+    // Bulk is shed in Warning; shed requests never break the audit stream
+    submit(ctx, OBI_CLASS_BULK, 10);
+    submit(ctx, OBI_CLASS_AUDIT, 12);
+    size_t completed = 0;
+    assert(obi_topology_run_events(ctx, 0, &completed) == OBI_SUCCESS);
+    assert(completed == 22);
+
+    obi_traffic_class_t classes[SINK_SLOTS];
+    assert(collect(classes, SINK_SLOTS) == 12);
+    assert(obi_topology_get_metrics(ctx, &metrics) == OBI_TOPOLOGY_SUCCESS);
+    assert(metrics.shed_messages == 10 && metrics.starvation_breaks == 0);
+    assert(metrics.class_sent[OBI_CLASS_BULK] == 0 && metrics.class_sent[OBI_CLASS_AUDIT] == 12);
+
+    leave();
+    printf("✅ Shed uncharged test passed\n");
+}
+
+int main() {
+    printf("🧪 Running OBI Topology Traffic Class Tests\n");
+    printf("===========================================\n");
+
+    test_pattern_mapping();
+    test_strict_priority();
+    test_weighted_sharing();
+    test_bounded_starvation();
+    test_shed_uncharged();
+
+    printf("\n✅ All traffic class tests passed!\n");
+    return 0;
+}
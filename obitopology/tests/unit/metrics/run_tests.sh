@@ -0,0 +1,16 @@
+#!/bin/bash
+# Topology Metrics Unit Test Runner
+
+set -e
+
+echo "🧪 Running Topology Metrics Unit Tests..."
+echo "========================================="
+
+for test in test_cost_function test_governance test_latency_histogram; do
+    gcc -std=c11 -I../../../include -I../../../../obiprotocol/include \
+        $test.c -o $test \
+        -L../../../../dist/lib -l:obitopology.a -lrt -lpthread
+    ./$test
+done
+
+echo "✅ Topology metrics unit tests completed"
@@ -0,0 +1,92 @@
+/*
+ * Governance Zone Tests
+ * Validates zone hysteresis and load shedding under a congested link
+ */
+
+#include "obitopology.h"
+#include <stdio.h>
+#include <assert.h>
+
+static int protocol_placeholder;
+
+void test_zone_hysteresis() {
+    printf("Testing zone transitions with hysteresis...\n");
+
+    assert(obi_topology_governance_next_zone(OBI_ZONE_AUTONOMOUS, 0.50) == OBI_ZONE_AUTONOMOUS);
+    assert(obi_topology_governance_next_zone(OBI_ZONE_AUTONOMOUS, 0.52) == OBI_ZONE_WARNING);
+    assert(obi_topology_governance_next_zone(OBI_ZONE_AUTONOMOUS, 0.70) == OBI_ZONE_GOVERNANCE);
+
+    // Warning holds until the cost falls clearly below the entry threshold
+    assert(obi_topology_governance_next_zone(OBI_ZONE_WARNING, 0.48) == OBI_ZONE_WARNING);
+    assert(obi_topology_governance_next_zone(OBI_ZONE_WARNING, 0.45) == OBI_ZONE_AUTONOMOUS);
+    assert(obi_topology_governance_next_zone(OBI_ZONE_WARNING, 0.60) == OBI_ZONE_GOVERNANCE);
+
+    assert(obi_topology_governance_next_zone(OBI_ZONE_GOVERNANCE, 0.58) == OBI_ZONE_GOVERNANCE);
+    assert(obi_topology_governance_next_zone(OBI_ZONE_GOVERNANCE, 0.55) == OBI_ZONE_WARNING);
+    assert(obi_topology_governance_next_zone(OBI_ZONE_GOVERNANCE, 0.30) == OBI_ZONE_AUTONOMOUS);
+
+    printf("✅ Zone hysteresis test passed\n");
+}
+
+void test_load_shedding() {
+    printf("Testing load shedding under a saturated link...\n");
+
+    assert(obi_topology_init((obi_protocol_context_t *)&protocol_placeholder) == OBI_TOPOLOGY_SUCCESS);
+    obi_topology_context_t *ctx = obi_topology_get_context();
+    obi_topology_metrics_t metrics;
+
+    obi_shm_config_t config = { 1024, 128, false };
+    obi_shm_ring_t *sink = NULL;
+    assert(obi_shm_ring_create(OBI_SHM_NAME_PREFIX "governance-sink", &config, &sink) == OBI_SUCCESS);
+
+    obi_node_id_t id;
+    assert(obi_topology_add_node(ctx, "sink", "governance-sink", &id) == OBI_TOPOLOGY_SUCCESS);
+    assert(obi_topology_get_metrics(ctx, &metrics) == OBI_TOPOLOGY_SUCCESS);
+    assert(metrics.zone == OBI_ZONE_AUTONOMOUS);
+
+    // Nobody drains the sink: the queue fills and the transport refuses frames
+    uint32_t value = 0;
+    obi_buffer_t buffer = { (uint8_t *)&value, sizeof(value), sizeof(value) };
+    for (int round = 0; round < 40 && metrics.zone == OBI_ZONE_AUTONOMOUS; round++) {
+        for (int i = 0; i < 256; i++) {
+            obi_topology_send_to(ctx, &buffer, id);
+        }
+        assert(obi_topology_get_metrics(ctx, &metrics) == OBI_TOPOLOGY_SUCCESS);
+    }
+    assert(metrics.zone == OBI_ZONE_WARNING);
+    assert(metrics.cost_function > OBI_GOVERNANCE_WARNING_ENTER);
+
+    // Warning sheds low priority only
+    assert(obi_topology_send_priority(ctx, &buffer, id, OBI_PRIORITY_LOW) == OBI_ERROR_WOULD_BLOCK);
+    obi_topology_send_priority(ctx, &buffer, id, OBI_PRIORITY_NORMAL);
+    assert(obi_topology_get_metrics(ctx, &metrics) == OBI_TOPOLOGY_SUCCESS);
+    assert(metrics.shed_messages == 1);
+
+    // Once drained, the cost decays back through the exit threshold
+    for (int round = 0; round < 40 && metrics.zone != OBI_ZONE_AUTONOMOUS; round++) {
+        size_t length;
+        while (obi_shm_ring_peek(sink, &length)) {
+            obi_shm_ring_release(sink);
+        }
+        assert(obi_topology_send_to(ctx, &buffer, id) == OBI_SUCCESS);
+        assert(obi_topology_get_metrics(ctx, &metrics) == OBI_TOPOLOGY_SUCCESS);
+        assert(metrics.zone == OBI_ZONE_AUTONOMOUS || metrics.cost_function > OBI_GOVERNANCE_WARNING_EXIT);
+    }
+    assert(metrics.zone == OBI_ZONE_AUTONOMOUS);
+    assert(obi_topology_send_priority(ctx, &buffer, id, OBI_PRIORITY_LOW) == OBI_SUCCESS);
+
+    obi_topology_cleanup();
+    obi_shm_ring_close(sink);
+    printf("✅ Load shedding test passed\n");
+}
+
+int main() {
+    printf("🧪 Running OBI Topology Governance Tests\n");
+    printf("========================================\n");
+
+    test_zone_hysteresis();
+    test_load_shedding();
+
+    printf("\n✅ All governance tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,158 @@
+/*
+ * Latency Histogram Tests
+ * Validates tail percentiles per destination and per topology type using
+ * a transport whose sends take a known time
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "obitopology.h"
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <time.h>
+
+static int protocol_placeholder;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// Each payload names how long its send takes
+static obi_result_t timed_send(obi_topology_transport_t *transport, void *peer,
+                               const obi_topology_frame_t *frame, const uint8_t *payload) {
+    (void)transport; (void)peer;
+    uint64_t duration_ns = 0;
+    if (frame->length == sizeof(duration_ns)) {
+        memcpy(&duration_ns, payload, sizeof(duration_ns));
+    }
+    uint64_t until = now_ns() + duration_ns;
+    while (now_ns() < until) {
+    }
+    return OBI_SUCCESS;
+}
+
+static obi_result_t timed_bind(obi_topology_transport_t *transport, const char *local_address) {
+    (void)transport; (void)local_address;
+    return OBI_SUCCESS;
+}
+
+static obi_result_t timed_connect(obi_topology_transport_t *transport, const char *address, void **peer) {
+    (void)address;
+    *peer = transport;
+    return OBI_SUCCESS;
+}
+
+static obi_result_t timed_receive(obi_topology_transport_t *transport, obi_topology_frame_t *frame,
+                                  uint8_t *payload, size_t capacity) {
+    (void)transport; (void)frame; (void)payload; (void)capacity;
+    return OBI_ERROR_WOULD_BLOCK;
+}
+
+static obi_result_t timed_flush(obi_topology_transport_t *transport) {
+    (void)transport;
+    return OBI_SUCCESS;
+}
+
+static void timed_disconnect(obi_topology_transport_t *transport, void *peer) {
+    (void)transport; (void)peer;
+}
+
+static void timed_destroy(obi_topology_transport_t *transport) {
+    (void)transport;
+}
+
+static const obi_topology_transport_ops_t timed_ops = {
+    .name = "timed",
+    .bind = timed_bind,
+    .connect = timed_connect,
+    .send = timed_send,
+    .receive = timed_receive,
+    .flush = timed_flush,
+    .disconnect = timed_disconnect,
+    .destroy = timed_destroy,
+};
+
+static obi_topology_transport_t timed_transport = { &timed_ops, 1024 };
+
+static void send_timed(obi_topology_context_t *ctx, obi_node_id_t id, uint64_t duration_ns, int count) {
+    obi_buffer_t buffer = { (uint8_t *)&duration_ns, sizeof(duration_ns), sizeof(duration_ns) };
+    for (int i = 0; i < count; i++) {
+        assert(obi_topology_send_to(ctx, &buffer, id) == OBI_SUCCESS);
+    }
+}
+
+void test_destination_percentiles() {
+    printf("Testing p50/p99/p999/max per destination...\n");
+
+    assert(obi_topology_init((obi_protocol_context_t *)&protocol_placeholder) == OBI_TOPOLOGY_SUCCESS);
+    obi_topology_context_t *ctx = obi_topology_get_context();
+    assert(obi_topology_set_transport(ctx, &timed_transport) == OBI_TOPOLOGY_SUCCESS);
+
+    obi_node_id_t slow, idle;
+    assert(obi_topology_add_node(ctx, "latency-slow", NULL, &slow) == OBI_TOPOLOGY_SUCCESS);
+    assert(obi_topology_add_node(ctx, "latency-idle", NULL, &idle) == OBI_TOPOLOGY_SUCCESS);
+
+    // 98% at 10 us, a 1.9% tail at 1 ms and one 5 ms outlier
+    send_timed(ctx, slow, 10000, 980);
+    send_timed(ctx, slow, 1000000, 19);
+    send_timed(ctx, slow, 5000000, 1);
+
+    obi_latency_summary_t summary;
+    assert(obi_topology_get_latency(ctx, slow, &summary) == OBI_TOPOLOGY_SUCCESS);
+    assert(summary.count == 1000);
+    assert(summary.p50_us >= 9.0 && summary.p50_us < 15.0);
+    assert(summary.p99_us >= 900.0 && summary.p99_us < 1200.0);
+    assert(summary.max_us >= 5000.0 && summary.max_us < 8000.0);
+    assert(summary.p999_us >= 900.0 && summary.p999_us <= summary.max_us);  // a preempted send may land here
+
+    assert(obi_topology_get_latency(ctx, idle, &summary) == OBI_TOPOLOGY_SUCCESS);
+    assert(summary.count == 0 && summary.p99_us == 0.0 && summary.max_us == 0.0);
+    assert(obi_topology_get_latency(ctx, 7, &summary) == OBI_TOPOLOGY_ERROR_INVALID_CONFIG);
+
+    obi_topology_cleanup();
+    printf("✅ Destination percentile test passed\n");
+}
+
+void test_type_percentiles() {
+    printf("Testing histograms per topology type...\n");
+
+    assert(obi_topology_init((obi_protocol_context_t *)&protocol_placeholder) == OBI_TOPOLOGY_SUCCESS);
+    obi_topology_context_t *ctx = obi_topology_get_context();
+    assert(obi_topology_set_transport(ctx, &timed_transport) == OBI_TOPOLOGY_SUCCESS);
+
+    obi_node_id_t id;
+    assert(obi_topology_add_node(ctx, "latency-peer", NULL, &id) == OBI_TOPOLOGY_SUCCESS);
+    send_timed(ctx, id, 2000, 100);
+    assert(obi_topology_configure(ctx, OBI_TOPOLOGY_MESH) == OBI_TOPOLOGY_SUCCESS);
+    send_timed(ctx, id, 200000, 50);
+
+    obi_latency_summary_t summary;
+    assert(obi_topology_get_type_latency(ctx, OBI_TOPOLOGY_P2P, &summary) == OBI_TOPOLOGY_SUCCESS);
+    assert(summary.count == 100 && summary.p50_us >= 1.8 && summary.p50_us < 5.0);
+    assert(obi_topology_get_type_latency(ctx, OBI_TOPOLOGY_MESH, &summary) == OBI_TOPOLOGY_SUCCESS);
+    assert(summary.count == 50 && summary.p50_us >= 180.0 && summary.p50_us < 250.0);
+    assert(obi_topology_get_type_latency(ctx, OBI_TOPOLOGY_RING, &summary) == OBI_TOPOLOGY_SUCCESS);
+    assert(summary.count == 0);
+
+    // The metrics snapshot reports the current type
+    obi_topology_metrics_t metrics;
+    assert(obi_topology_get_metrics(ctx, &metrics) == OBI_TOPOLOGY_SUCCESS);
+    assert(metrics.send_latency.count == 50 && metrics.send_latency.max_us >= 200.0);
+
+    obi_topology_cleanup();
+    printf("✅ Topology type percentile test passed\n");
+}
+
+int main() {
+    printf("🧪 Running OBI Topology Latency Histogram Tests\n");
+    printf("===============================================\n");
+
+    test_destination_percentiles();
+    test_type_percentiles();
+
+    printf("\n✅ All latency histogram tests passed!\n");
+    return 0;
+}
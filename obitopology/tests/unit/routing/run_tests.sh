@@ -0,0 +1,16 @@
+#!/bin/bash
+# Topology Routing Unit Test Runner
+
+set -e
+
+echo "🧪 Running Topology Routing Unit Tests..."
+echo "========================================="
+
+for test in test_route_table test_node_registry test_star_relay test_broadcast test_partition test_gossip test_dedup test_ring_forwarding test_hub_aggregation; do
+    gcc -std=c11 -I../../../include -I../../../../obiprotocol/include \
+        $test.c -o $test \
+        -L../../../../dist/lib -l:obitopology.a -lrt -lpthread
+    ./$test
+done
+
+echo "✅ Topology routing unit tests completed"
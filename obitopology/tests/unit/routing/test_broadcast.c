@@ -0,0 +1,193 @@
+/*
+ * Broadcast Tests
+ * Validates MESH fan-out: neighbours share one payload, others get relayed
+ * copies, and every recipient's copy carries its own credit and sequence
+ */
+
+#define _DEFAULT_SOURCE
+
+#include "obitopology.h"
+#include "obitopology_transport.h"
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#define BROADCAST_MESSAGES 200
+
+static int protocol_placeholder;
+static const char *const mesh_names[] = { "bcast-src", "bcast-a", "bcast-b", "bcast-far" };
+
+// bcast-far hangs off bcast-a, so only bcast-a and bcast-b are neighbours of the source
+static void join_mesh(const char *self) {
+    obi_node_id_t ids[4];
+    assert(obi_topology_init((obi_protocol_context_t *)&protocol_placeholder) == OBI_TOPOLOGY_SUCCESS);
+    obi_topology_context_t *ctx = obi_topology_get_context();
+
+    for (int i = 0; i < 4; i++) {
+        assert(obi_topology_add_node(ctx, mesh_names[i], NULL, &ids[i]) == OBI_TOPOLOGY_SUCCESS);
+    }
+    assert(obi_topology_configure(ctx, OBI_TOPOLOGY_MESH) == OBI_TOPOLOGY_SUCCESS);
+    assert(obi_topology_add_link(ctx, ids[0], ids[1], 1) == OBI_TOPOLOGY_SUCCESS);
+    assert(obi_topology_add_link(ctx, ids[0], ids[2], 1) == OBI_TOPOLOGY_SUCCESS);
+    assert(obi_topology_add_link(ctx, ids[1], ids[3], 1) == OBI_TOPOLOGY_SUCCESS);
+    assert(obi_topology_bind(ctx, self) == OBI_TOPOLOGY_SUCCESS);
+}
+
+static void run_recipient(int self) {
+    join_mesh(mesh_names[self]);
+    obi_topology_context_t *ctx = obi_topology_get_context();
+    uint8_t storage[64];
+    obi_buffer_t buffer = { storage, 0, sizeof(storage) };
+
+    // Every recipient sees each broadcast exactly once and in order
+    for (int expected = 0; expected < BROADCAST_MESSAGES; ) {
+        obi_result_t result = obi_topology_receive_message(ctx, &buffer);
+        if (result == OBI_ERROR_WOULD_BLOCK) {
+            usleep(100);
+            continue;
+        }
+        int value;
+        assert(result == OBI_SUCCESS && buffer.size == sizeof(value));
+        memcpy(&value, buffer.data, sizeof(value));
+        assert(value == expected++);
+    }
+
+    // bcast-a keeps relaying for bcast-far until everyone is done
+    if (self == 1) {
+        for (int i = 0; i < 500; i++) {
+            assert(obi_topology_receive_message(ctx, &buffer) == OBI_ERROR_WOULD_BLOCK);
+            usleep(1000);
+        }
+    }
+    obi_topology_cleanup();
+    _exit(0);
+}
+
+void test_mesh_broadcast() {
+    printf("Testing MESH broadcast to neighbours and a relayed node...\n");
+
+    pid_t children[3];
+    for (int i = 0; i < 3; i++) {
+        children[i] = fork();
+        if (children[i] == 0) {
+            run_recipient(i + 1);
+        }
+    }
+
+    join_mesh("bcast-src");
+    obi_topology_context_t *ctx = obi_topology_get_context();
+    usleep(100000);  // let every recipient bind its ring
+
+    for (int i = 0; i < BROADCAST_MESSAGES; i++) {
+        obi_buffer_t buffer = { (uint8_t *)&i, sizeof(i), sizeof(i) };
+        size_t delivered = 0;
+        assert(obi_topology_broadcast(ctx, &buffer, NULL, 0, &delivered) == OBI_SUCCESS);
+        assert(delivered == 3);
+    }
+
+    // Explicit recipient lists are checked against the node set
+    obi_node_id_t unknown = 9;
+    int value = 0;
+    obi_buffer_t buffer = { (uint8_t *)&value, sizeof(value), sizeof(value) };
+    assert(obi_topology_broadcast(ctx, &buffer, &unknown, 1, NULL) == OBI_ERROR_INVALID_INPUT);
+
+    for (int i = 0; i < 3; i++) {
+        int status = 0;
+        waitpid(children[i], &status, 0);
+        assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    }
+
+    // Only BUS and MESH define one-to-many delivery
+    assert(obi_topology_configure(ctx, OBI_TOPOLOGY_STAR) == OBI_TOPOLOGY_SUCCESS);
+    assert(obi_topology_broadcast(ctx, &buffer, NULL, 0, NULL) == OBI_ERROR_INVALID_INPUT);
+    obi_topology_cleanup();
+
+    printf("✅ MESH broadcast test passed\n");
+}
+
+static const char *const bus_names[] = { "credit-src", "credit-a", "credit-b" };
+
+static obi_topology_context_t *join_bus(obi_sim_network_t *network, const char *self) {
+    obi_topology_context_t *ctx = obi_topology_context_create((obi_protocol_context_t *)&protocol_placeholder);
+    assert(ctx != NULL);
+    assert(obi_topology_set_transport(ctx, obi_topology_transport_sim_create(network)) == OBI_TOPOLOGY_SUCCESS);
+    obi_node_id_t id;
+    for (int i = 0; i < 3; i++) {
+        assert(obi_topology_add_node(ctx, bus_names[i], NULL, &id) == OBI_TOPOLOGY_SUCCESS);
+    }
+    assert(obi_topology_configure(ctx, OBI_TOPOLOGY_BUS) == OBI_TOPOLOGY_SUCCESS);
+    // Probes are slow enough that only the marks on the broadcasts return credit
+    obi_flow_config_t flow = { 2, 0, 1000000 };
+    assert(obi_topology_set_flow_control(ctx, &flow) == OBI_TOPOLOGY_SUCCESS);
+    obi_order_config_t order = { 8, 1000000 };
+    assert(obi_topology_set_ordering(ctx, &order) == OBI_TOPOLOGY_SUCCESS);
+    assert(obi_topology_bind(ctx, self) == OBI_TOPOLOGY_SUCCESS);
+    return ctx;
+}
+
+static void expect_values(obi_topology_context_t *ctx, int first, int count) {
+    int value;
+    obi_buffer_t buffer = { (uint8_t *)&value, 0, sizeof(value) };
+    for (int i = first; i < first + count; i++) {
+        assert(obi_topology_receive_message(ctx, &buffer) == OBI_SUCCESS && value == i);
+    }
+    assert(obi_topology_receive_message(ctx, &buffer) == OBI_ERROR_WOULD_BLOCK);
+}
+
+void test_broadcast_credit() {
+    printf("Testing broadcast credit, sequencing and rate refunds...\n");
+
+    obi_sim_config_t config = { { 0, 0, 0, 0 }, 64, OBI_SIM_DEFAULT_QUEUE_BYTES, 1 };
+    obi_sim_network_t *network = obi_sim_network_create(&config);
+    assert(network != NULL);
+    obi_topology_context_t *sender = join_bus(network, "credit-src");
+    obi_topology_context_t *receivers[2] = { join_bus(network, "credit-a"), join_bus(network, "credit-b") };
+    // Three sends per second to credit-a, all usable back to back
+    obi_rate_limit_t limit = { 3, 3 };
+    assert(obi_topology_set_rate_limit(sender, 1, &limit) == OBI_TOPOLOGY_SUCCESS);
+
+    int value = 0;
+    obi_buffer_t buffer = { (uint8_t *)&value, sizeof(value), sizeof(value) };
+    size_t delivered = 0;
+    for (value = 0; value < 2; value++) {
+        assert(obi_topology_broadcast(sender, &buffer, NULL, 0, &delivered) == OBI_SUCCESS && delivered == 2);
+    }
+    // The window is spent; the refusal gives credit-a's rate token back
+    assert(obi_topology_broadcast(sender, &buffer, NULL, 0, &delivered) == OBI_BUSY && delivered == 0);
+
+    // Each copy is sequenced for its recipient and marked, so reading it grants credit
+    for (int i = 0; i < 2; i++) {
+        expect_values(receivers[i], 0, 2);
+    }
+    int echo;
+    obi_buffer_t inbound = { (uint8_t *)&echo, 0, sizeof(echo) };
+    assert(obi_topology_receive_message(sender, &inbound) == OBI_ERROR_WOULD_BLOCK);
+    assert(obi_topology_broadcast(sender, &buffer, NULL, 0, &delivered) == OBI_SUCCESS && delivered == 2);
+    for (int i = 0; i < 2; i++) {
+        expect_values(receivers[i], 2, 1);
+    }
+
+    obi_topology_metrics_t metrics;
+    assert(obi_topology_get_metrics(sender, &metrics) == OBI_TOPOLOGY_SUCCESS);
+    assert(metrics.rate_limited == 0);
+    for (int i = 0; i < 2; i++) {
+        obi_topology_context_destroy(receivers[i]);
+    }
+    obi_topology_context_destroy(sender);
+    obi_sim_network_destroy(network);
+
+    printf("✅ Broadcast credit test passed\n");
+}
+
+int main() {
+    printf("🧪 Running OBI Topology Broadcast Tests\n");
+    printf("=======================================\n");
+
+    test_mesh_broadcast();
+    test_broadcast_credit();
+
+    printf("\n✅ All broadcast tests passed!\n");
+    return 0;
+}
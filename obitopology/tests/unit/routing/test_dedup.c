@@ -0,0 +1,313 @@
+/*
+ * Duplicate Suppression Tests
+ * Validates that flooded copies of a message arriving from several relays
+ * are delivered once, keyed on origin and message id where frames carry
+ * them, that the window expires, and that a filter far smaller than the
+ * traffic never drops a message it has not seen
+ */
+
+#define _DEFAULT_SOURCE
+
+#include "obitopology.h"
+#include "obitopology_transport.h"
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <unistd.h>
+
+#define DEDUP_RING     OBI_SHM_NAME_PREFIX "dedup-rx"
+#define DEDUP_MESSAGES 5000
+
+static int protocol_placeholder;
+
+// Inject a frame straight into the local ring, as a relay would
+static void inject_message(obi_shm_ring_t *ring, uint32_t source, uint32_t origin, uint32_t message_id,
+                           uint16_t type, const void *payload, uint32_t length) {
+    obi_topology_frame_t frame = {0};
+    frame.length = length;
+    frame.type = type;
+    frame.source = source;
+    frame.origin = origin;
+    frame.message_id = message_id;
+    obi_shm_reservation_t reservation;
+    uint8_t *slot = obi_shm_ring_reserve(ring, sizeof(frame) + length, &reservation);
+    assert(slot != NULL);
+    memcpy(slot, &frame, sizeof(frame));
+    memcpy(slot + sizeof(frame), payload, length);
+    obi_shm_ring_publish(ring, &reservation, sizeof(frame) + length);
+}
+
+// A whole message as one fragment, as a sender beyond the frame size would
+static void inject_fragment(obi_shm_ring_t *ring, uint32_t source, uint32_t origin, uint32_t message_id,
+                            uint32_t train, const void *payload, uint32_t length) {
+    uint8_t body[sizeof(obi_fragment_header_t) + 64];
+    obi_fragment_header_t header = { train, length, 0 };
+    assert(length <= 64);
+    memcpy(body, &header, sizeof(header));
+    memcpy(body + sizeof(header), payload, length);
+    inject_message(ring, source, origin, message_id, OBI_FRAME_FRAGMENT, body, sizeof(header) + length);
+}
+
+// A frame without an identity, so suppression falls back to the payload
+static void inject(obi_shm_ring_t *ring, uint32_t source, uint16_t type, const void *payload, uint32_t length) {
+    inject_message(ring, source, 0, 0, type, payload, length);
+}
+
+static int drain(obi_topology_context_t *ctx, uint32_t *values, int limit) {
+    uint8_t storage[64];
+    obi_buffer_t buffer = { storage, 0, sizeof(storage) };
+    int received = 0;
+    obi_result_t result;
+    while ((result = obi_topology_receive_message(ctx, &buffer)) == OBI_SUCCESS) {
+        assert(buffer.size == sizeof(uint32_t) && received < limit);
+        memcpy(&values[received++], buffer.data, sizeof(uint32_t));
+    }
+    assert(result == OBI_ERROR_WOULD_BLOCK);
+    return received;
+}
+
+static obi_shm_ring_t *join(void) {
+    assert(obi_topology_init((obi_protocol_context_t *)&protocol_placeholder) == OBI_TOPOLOGY_SUCCESS);
+    obi_topology_context_t *ctx = obi_topology_get_context();
+    assert(obi_topology_configure(ctx, OBI_TOPOLOGY_MESH) == OBI_TOPOLOGY_SUCCESS);
+    assert(obi_topology_bind(ctx, "dedup-rx") == OBI_TOPOLOGY_SUCCESS);
+    obi_shm_ring_t *ring = NULL;
+    assert(obi_shm_ring_attach(DEDUP_RING, false, &ring) == OBI_SUCCESS);
+    return ring;
+}
+
+void test_flooded_copies() {
+    printf("Testing flooded copies from several relays...\n");
+
+    obi_shm_ring_t *ring = join();
+    obi_topology_context_t *ctx = obi_topology_get_context();
+    uint32_t values[16];
+    uint32_t first = 7, second = 8;
+
+    // Disabled by default: every copy is delivered
+    inject(ring, 0x1001, OBI_FRAME_DATA, &first, sizeof(first));
+    inject(ring, 0x1002, OBI_FRAME_DATA, &first, sizeof(first));
+    assert(drain(ctx, values, 16) == 2);
+
+    obi_dedup_config_t config = { 1024, 50 };
+    assert(obi_topology_set_dedup(ctx, &config) == OBI_TOPOLOGY_SUCCESS);
+    obi_dedup_config_t invalid = { 1024, 0 };
+    assert(obi_topology_set_dedup(ctx, &invalid) == OBI_TOPOLOGY_ERROR_INVALID_CONFIG);
+
+    // Three relays deliver the same message; a batch frame repeats it once more
+    uint8_t batch[2 * (sizeof(uint32_t) + sizeof(uint32_t))];
+    uint32_t record = sizeof(uint32_t);
+    memcpy(batch, &record, sizeof(record));
+    memcpy(batch + 4, &first, sizeof(first));
+    memcpy(batch + 8, &record, sizeof(record));
+    memcpy(batch + 12, &second, sizeof(second));
+    inject(ring, 0x1001, OBI_FRAME_DATA, &first, sizeof(first));
+    inject(ring, 0x1002, OBI_FRAME_DATA, &first, sizeof(first));
+    inject(ring, 0x1003, OBI_FRAME_DATA, &first, sizeof(first));
+    inject(ring, 0x1002, OBI_FRAME_BATCH, batch, sizeof(batch));
+    inject(ring, 0x1003, OBI_FRAME_DATA, &second, sizeof(second));
+
+    assert(drain(ctx, values, 16) == 2);
+    assert(values[0] == first && values[1] == second);
+
+    obi_topology_metrics_t metrics;
+    assert(obi_topology_get_metrics(ctx, &metrics) == OBI_TOPOLOGY_SUCCESS);
+    assert(metrics.duplicates_dropped == 4 && metrics.dedup_overflows == 0);
+
+    // Once two windows have passed the message is new again
+    usleep(120000);
+    inject(ring, 0x1001, OBI_FRAME_DATA, &first, sizeof(first));
+    inject(ring, 0x1002, OBI_FRAME_DATA, &first, sizeof(first));
+    assert(drain(ctx, values, 16) == 1 && values[0] == first);
+
+    obi_shm_ring_close(ring);
+    obi_topology_cleanup();
+    printf("✅ Flooded copies test passed\n");
+}
+
+void test_fixed_capacity() {
+    printf("Testing a filter much smaller than the traffic...\n");
+
+    obi_shm_ring_t *ring = join();
+    obi_topology_context_t *ctx = obi_topology_get_context();
+    obi_dedup_config_t config = { 256, 60000 };
+    assert(obi_topology_set_dedup(ctx, &config) == OBI_TOPOLOGY_SUCCESS);
+
+    // Every distinct message gets through even as full windows retire early
+    uint32_t values[64];
+    for (uint32_t i = 0; i < DEDUP_MESSAGES; i++) {
+        inject(ring, 0x2001, OBI_FRAME_DATA, &i, sizeof(i));
+        assert(drain(ctx, values, 64) == 1 && values[0] == i);
+    }
+
+    obi_topology_metrics_t metrics;
+    assert(obi_topology_get_metrics(ctx, &metrics) == OBI_TOPOLOGY_SUCCESS);
+    assert(metrics.duplicates_dropped == 0 && metrics.dedup_overflows > 0);
+
+    // The most recent messages are still remembered
+    for (uint32_t i = DEDUP_MESSAGES - 32; i < DEDUP_MESSAGES; i++) {
+        inject(ring, 0x2002, OBI_FRAME_DATA, &i, sizeof(i));
+    }
+    assert(drain(ctx, values, 64) == 0);
+
+    // Capacity 0 switches suppression off
+    obi_dedup_config_t off = { 0, 0 };
+    assert(obi_topology_set_dedup(ctx, &off) == OBI_TOPOLOGY_SUCCESS);
+    uint32_t last = DEDUP_MESSAGES - 1;
+    inject(ring, 0x2002, OBI_FRAME_DATA, &last, sizeof(last));
+    assert(drain(ctx, values, 64) == 1);
+
+    obi_shm_ring_close(ring);
+    obi_topology_cleanup();
+    printf("✅ Fixed capacity test passed\n");
+}
+
+void test_origin_identity() {
+    printf("Testing suppression keyed on origin and message id...\n");
+
+    obi_shm_ring_t *ring = join();
+    obi_topology_context_t *ctx = obi_topology_get_context();
+    assert(obi_topology_set_dedup(ctx, NULL) == OBI_TOPOLOGY_SUCCESS);
+    uint32_t values[16];
+    uint32_t first = 7, second = 8;
+
+    // Two relays pass on one message of origin 0x3001: delivered once
+    inject_message(ring, 0x1001, 0x3001, 40, OBI_FRAME_DATA, &first, sizeof(first));
+    inject_message(ring, 0x1002, 0x3001, 40, OBI_FRAME_DATA, &first, sizeof(first));
+    assert(drain(ctx, values, 16) == 1);
+
+    // Equal payloads that are different messages all get through
+    inject_message(ring, 0x1001, 0x3002, 40, OBI_FRAME_DATA, &first, sizeof(first));
+    inject_message(ring, 0x1001, 0x3001, 41, OBI_FRAME_DATA, &first, sizeof(first));
+    assert(drain(ctx, values, 16) == 2);
+
+    // Batch records take consecutive ids from the frame's
+    uint8_t batch[2 * (sizeof(uint32_t) + sizeof(uint32_t))];
+    uint32_t record = sizeof(uint32_t);
+    memcpy(batch, &record, sizeof(record));
+    memcpy(batch + 4, &first, sizeof(first));
+    memcpy(batch + 8, &record, sizeof(record));
+    memcpy(batch + 12, &second, sizeof(second));
+    inject_message(ring, 0x3003, 0x3003, 90, OBI_FRAME_BATCH, batch, sizeof(batch));
+    inject_message(ring, 0x1002, 0x3003, 91, OBI_FRAME_DATA, &second, sizeof(second));
+    inject_message(ring, 0x1002, 0x3003, 92, OBI_FRAME_DATA, &second, sizeof(second));
+    assert(drain(ctx, values, 16) == 3);
+    assert(values[0] == first && values[1] == second && values[2] == second);
+
+    obi_topology_metrics_t metrics;
+    assert(obi_topology_get_metrics(ctx, &metrics) == OBI_TOPOLOGY_SUCCESS);
+    assert(metrics.duplicates_dropped == 2);
+
+    obi_shm_ring_close(ring);
+    obi_topology_cleanup();
+    printf("✅ Origin identity test passed\n");
+}
+
+void test_fragmented_identity() {
+    printf("Testing a reassembled message after a small one...\n");
+
+    obi_shm_ring_t *ring = join();
+    obi_topology_context_t *ctx = obi_topology_get_context();
+    obi_dedup_config_t config = { 1024, 1000 };
+    assert(obi_topology_set_dedup(ctx, &config) == OBI_TOPOLOGY_SUCCESS);
+    assert(obi_topology_set_reassembly(ctx, NULL) == OBI_TOPOLOGY_SUCCESS);
+
+    // The reassembled message must not inherit the data frame's identity
+    uint32_t small = 7;
+    uint32_t large[4] = { 1, 2, 3, 4 };
+    inject_message(ring, 0x1001, 0x1001, 55, OBI_FRAME_DATA, &small, sizeof(small));
+    inject_fragment(ring, 0x1001, 0x1001, 56, 9, large, sizeof(large));
+    // A relayed copy of the fragmented message is still one message
+    inject_fragment(ring, 0x1002, 0x1001, 56, 3, large, sizeof(large));
+    // A train without an identity falls back to its payload
+    inject_fragment(ring, 0x1003, 0, 0, 4, large, sizeof(large));
+
+    uint8_t storage[64];
+    obi_buffer_t buffer = { storage, 0, sizeof(storage) };
+    assert(obi_topology_receive_message(ctx, &buffer) == OBI_SUCCESS && buffer.size == sizeof(small));
+    assert(obi_topology_receive_message(ctx, &buffer) == OBI_SUCCESS && buffer.size == sizeof(large));
+    assert(memcmp(storage, large, sizeof(large)) == 0);
+    assert(obi_topology_receive_message(ctx, &buffer) == OBI_SUCCESS && buffer.size == sizeof(large));
+    assert(obi_topology_receive_message(ctx, &buffer) == OBI_ERROR_WOULD_BLOCK);
+
+    obi_topology_metrics_t metrics;
+    assert(obi_topology_get_metrics(ctx, &metrics) == OBI_TOPOLOGY_SUCCESS);
+    assert(metrics.reassembled_messages == 2 && metrics.duplicates_dropped == 1);
+
+    obi_shm_ring_close(ring);
+    obi_topology_cleanup();
+    printf("✅ Fragmented identity test passed\n");
+}
+
+static const char *const flood_names[] = { "flood-src", "flood-relay", "flood-sink" };
+
+static obi_topology_context_t *join_flood(obi_sim_network_t *network, const char *self) {
+    obi_topology_context_t *ctx = obi_topology_context_create((obi_protocol_context_t *)&protocol_placeholder);
+    assert(ctx != NULL);
+    assert(obi_topology_set_transport(ctx, obi_topology_transport_sim_create(network)) == OBI_TOPOLOGY_SUCCESS);
+    obi_node_id_t id;
+    for (int i = 0; i < 3; i++) {
+        assert(obi_topology_add_node(ctx, flood_names[i], NULL, &id) == OBI_TOPOLOGY_SUCCESS);
+    }
+    assert(obi_topology_configure(ctx, OBI_TOPOLOGY_BUS) == OBI_TOPOLOGY_SUCCESS);
+    assert(obi_topology_set_dedup(ctx, NULL) == OBI_TOPOLOGY_SUCCESS);
+    assert(obi_topology_bind(ctx, self) == OBI_TOPOLOGY_SUCCESS);
+    return ctx;
+}
+
+void test_forwarded_flood() {
+    printf("Testing a relay re-flooding with obi_topology_forward...\n");
+
+    obi_sim_config_t config = { { 0, 0, 0, 0 }, 64, OBI_SIM_DEFAULT_QUEUE_BYTES, 1 };
+    obi_sim_network_t *network = obi_sim_network_create(&config);
+    assert(network != NULL);
+    obi_topology_context_t *source = join_flood(network, "flood-src");
+    obi_topology_context_t *relay = join_flood(network, "flood-relay");
+    obi_topology_context_t *sink = join_flood(network, "flood-sink");
+
+    // The same payload twice is two messages; each reaches the sink directly
+    // and through the relay
+    uint32_t value = 5;
+    obi_buffer_t buffer = { (uint8_t *)&value, sizeof(value), sizeof(value) };
+    size_t delivered;
+    for (int i = 0; i < 2; i++) {
+        assert(obi_topology_broadcast(source, &buffer, NULL, 0, &delivered) == OBI_SUCCESS && delivered == 2);
+    }
+    uint32_t received;
+    obi_buffer_t inbound = { (uint8_t *)&received, 0, sizeof(received) };
+    obi_node_id_t onward = 2;
+    for (int i = 0; i < 2; i++) {
+        assert(obi_topology_receive_message(relay, &inbound) == OBI_SUCCESS && received == value);
+        assert(obi_topology_forward(relay, &inbound, &onward, 1, &delivered) == OBI_SUCCESS && delivered == 1);
+    }
+
+    int copies = 0;
+    while (obi_topology_receive_message(sink, &inbound) == OBI_SUCCESS) {
+        assert(received == value);
+        copies++;
+    }
+    assert(copies == 2);
+    obi_topology_metrics_t metrics;
+    assert(obi_topology_get_metrics(sink, &metrics) == OBI_TOPOLOGY_SUCCESS);
+    assert(metrics.duplicates_dropped == 2);
+
+    obi_topology_context_destroy(sink);
+    obi_topology_context_destroy(relay);
+    obi_topology_context_destroy(source);
+    obi_sim_network_destroy(network);
+    printf("✅ Forwarded flood test passed\n");
+}
+
+int main() {
+    printf("🧪 Running OBI Topology Duplicate Suppression Tests\n");
+    printf("===================================================\n");
+
+    test_flooded_copies();
+    test_fixed_capacity();
+    test_origin_identity();
+    test_fragmented_identity();
+    test_forwarded_flood();
+
+    printf("\n✅ All duplicate suppression tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,167 @@
+/*
+ * Gossip Membership Tests
+ * Validates SWIM membership across processes: convergence, detection of a
+ * member that stops, its rejoin after a restart, and bounded probe traffic
+ */
+
+#define _DEFAULT_SOURCE
+
+#include "obitopology.h"
+#include <stdio.h>
+#include <assert.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+#define GOSSIP_MEMBERS     6
+#define GOSSIP_INTERVAL_US 2000
+#define GOSSIP_LEAVER      (GOSSIP_MEMBERS - 1)
+
+typedef struct {
+    _Atomic int phase;
+    _Atomic int view[GOSSIP_MEMBERS];              // active nodes as each member sees them
+    _Atomic int leaver_status[GOSSIP_MEMBERS];     // each member's view of the leaver
+    _Atomic double frames_per_period[GOSSIP_MEMBERS];
+} shared_state_t;
+
+static int protocol_placeholder;
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static void run_member(int self, shared_state_t *shared, int stop_phase) {
+    char name[16];
+    obi_node_id_t id;
+    assert(obi_topology_init((obi_protocol_context_t *)&protocol_placeholder) == OBI_TOPOLOGY_SUCCESS);
+    obi_topology_context_t *ctx = obi_topology_get_context();
+    for (int i = 0; i < GOSSIP_MEMBERS; i++) {
+        snprintf(name, sizeof(name), "gossip-%d", i);
+        assert(obi_topology_add_node(ctx, name, NULL, &id) == OBI_TOPOLOGY_SUCCESS);
+    }
+    assert(obi_topology_configure(ctx, OBI_TOPOLOGY_MESH) == OBI_TOPOLOGY_SUCCESS);
+    snprintf(name, sizeof(name), "gossip-%d", self);
+    assert(obi_topology_bind(ctx, name) == OBI_TOPOLOGY_SUCCESS);
+
+    obi_gossip_config_t config = { GOSSIP_INTERVAL_US, OBI_GOSSIP_DEFAULT_INDIRECT, OBI_GOSSIP_DEFAULT_SUSPICION };
+    assert(obi_topology_set_gossip(ctx, &config) == OBI_TOPOLOGY_SUCCESS);
+
+    uint8_t storage[64];
+    obi_buffer_t buffer = { storage, 0, sizeof(storage) };
+    obi_topology_metrics_t metrics;
+    double started = now_s();
+    while (atomic_load(&shared->phase) < stop_phase) {
+        assert(obi_topology_poll(ctx) == OBI_TOPOLOGY_SUCCESS);
+        assert(obi_topology_receive_message(ctx, &buffer) == OBI_ERROR_WOULD_BLOCK);  // membership only
+
+        obi_member_status_t status;
+        assert(obi_topology_get_metrics(ctx, &metrics) == OBI_TOPOLOGY_SUCCESS);
+        assert(obi_topology_member_status(ctx, GOSSIP_LEAVER, &status) == OBI_TOPOLOGY_SUCCESS);
+        atomic_store(&shared->view[self], metrics.active_nodes);
+        atomic_store(&shared->leaver_status[self], (int)status);
+        usleep(200);
+    }
+
+    double periods = (now_s() - started) * 1e6 / GOSSIP_INTERVAL_US;
+    atomic_store(&shared->frames_per_period[self], (double)metrics.gossip_frames / periods);
+    obi_topology_cleanup();
+    _exit(0);
+}
+
+static pid_t spawn(int self, shared_state_t *shared, int stop_phase) {
+    pid_t pid = fork();
+    if (pid == 0) {
+        run_member(self, shared, stop_phase);
+    }
+    return pid;
+}
+
+// Wait until every member in [first, last) sees the given view
+static bool converged(shared_state_t *shared, int first, int last, int view, int leaver_status) {
+    for (double deadline = now_s() + 5.0; now_s() < deadline; usleep(1000)) {
+        bool all = true;
+        for (int i = first; i < last && all; i++) {
+            all = atomic_load(&shared->view[i]) == view && atomic_load(&shared->leaver_status[i]) == leaver_status;
+        }
+        if (all) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void reap(pid_t pid) {
+    int status = 0;
+    waitpid(pid, &status, 0);
+    assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+}
+
+void test_membership_lifecycle() {
+    printf("Testing detection and rejoin of a stopped member...\n");
+
+    shared_state_t *shared = mmap(NULL, sizeof(*shared), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    assert(shared != MAP_FAILED);
+    pid_t members[GOSSIP_MEMBERS];
+    for (int i = 0; i < GOSSIP_MEMBERS; i++) {
+        members[i] = spawn(i, shared, i == GOSSIP_LEAVER ? 1 : 3);
+    }
+    assert(converged(shared, 0, GOSSIP_MEMBERS, GOSSIP_MEMBERS, OBI_MEMBER_ALIVE));
+
+    // The leaver stops answering probes; the rest suspect it, then drop it from the graph
+    atomic_store(&shared->phase, 1);
+    reap(members[GOSSIP_LEAVER]);
+    assert(converged(shared, 0, GOSSIP_LEAVER, GOSSIP_MEMBERS - 1, OBI_MEMBER_DEAD));
+
+    // Restarted, it learns it was declared dead, refutes and is readmitted
+    atomic_store(&shared->phase, 2);
+    members[GOSSIP_LEAVER] = spawn(GOSSIP_LEAVER, shared, 3);
+    assert(converged(shared, 0, GOSSIP_MEMBERS, GOSSIP_MEMBERS, OBI_MEMBER_ALIVE));
+
+    atomic_store(&shared->phase, 3);
+    for (int i = 0; i < GOSSIP_MEMBERS; i++) {
+        reap(members[i]);
+    }
+
+    // Per period: one probe, on average one ack, and indirect probes only on silence
+    for (int i = 0; i < GOSSIP_MEMBERS; i++) {
+        assert(atomic_load(&shared->frames_per_period[i]) < 1.0 + 1.0 + OBI_GOSSIP_DEFAULT_INDIRECT);
+    }
+
+    munmap(shared, sizeof(*shared));
+    printf("✅ Membership lifecycle test passed\n");
+}
+
+void test_gossip_config() {
+    printf("Testing gossip configuration...\n");
+
+    assert(obi_topology_init((obi_protocol_context_t *)&protocol_placeholder) == OBI_TOPOLOGY_SUCCESS);
+    obi_topology_context_t *ctx = obi_topology_get_context();
+    obi_node_id_t id;
+    obi_member_status_t status;
+    assert(obi_topology_add_node(ctx, "gossip-solo", NULL, &id) == OBI_TOPOLOGY_SUCCESS);
+
+    // Membership gossip is defined for MESH only
+    assert(obi_topology_set_gossip(ctx, NULL) == OBI_TOPOLOGY_ERROR_INVALID_CONFIG);
+    assert(obi_topology_configure(ctx, OBI_TOPOLOGY_MESH) == OBI_TOPOLOGY_SUCCESS);
+    assert(obi_topology_set_gossip(ctx, NULL) == OBI_TOPOLOGY_SUCCESS);
+    assert(obi_topology_member_status(ctx, id, &status) == OBI_TOPOLOGY_SUCCESS && status == OBI_MEMBER_ALIVE);
+    assert(obi_topology_member_status(ctx, 5, &status) == OBI_TOPOLOGY_ERROR_INVALID_CONFIG);
+
+    obi_topology_cleanup();
+    printf("✅ Gossip configuration test passed\n");
+}
+
+int main() {
+    printf("🧪 Running OBI Topology Gossip Membership Tests\n");
+    printf("===============================================\n");
+
+    test_gossip_config();
+    test_membership_lifecycle();
+
+    printf("\n✅ All gossip membership tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,229 @@
+/*
+ * Hub Aggregation Tests
+ * Validates that a STAR hub batches transit data per destination without
+ * reordering it, drops what the batch validator refuses, reuses cached
+ * verdicts for identical payloads, and resumes a batch a full spoke refused
+ */
+
+#include "obitopology.h"
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+
+#define SPOKES      3
+#define SPOKE_SLOTS 8
+
+static int protocol_placeholder;
+static obi_shm_ring_t *inbound;
+static obi_shm_ring_t *spokes[SPOKES];
+static const char *spoke_names[SPOKES] = { "hub-b", "hub-c", "hub-d" };
+static uint32_t validator_calls;
+
+// Node keys are the FNV-1a hash of the node name
+static uint32_t node_key(const char *name) {
+    uint32_t hash = 2166136261u;
+    while (*name) {
+        hash ^= (uint8_t)*name++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static void inject(int spoke, obi_topology_frame_type_t type, uint32_t value) {
+    obi_topology_frame_t frame = {0};
+    frame.length = sizeof(value);
+    frame.type = type;
+    frame.source = node_key("hub-b");
+    frame.destination = node_key(spoke_names[spoke]);
+    obi_shm_reservation_t reservation;
+    uint8_t *slot = obi_shm_ring_reserve(inbound, sizeof(frame) + sizeof(value), &reservation);
+    assert(slot != NULL);
+    memcpy(slot, &frame, sizeof(frame));
+    memcpy(slot + sizeof(frame), &value, sizeof(value));
+    obi_shm_ring_publish(inbound, &reservation, sizeof(frame) + sizeof(value));
+}
+
+// Next frame the spoke received, or false when it has none
+static bool take(int spoke, obi_topology_frame_type_t *type, uint32_t *value) {
+    size_t length;
+    const uint8_t *data = obi_shm_ring_peek(spokes[spoke], &length);
+    if (!data) {
+        return false;
+    }
+    obi_topology_frame_t frame;
+    memcpy(&frame, data, sizeof(frame));
+    memcpy(value, data + sizeof(frame), sizeof(*value));
+    *type = frame.type;
+    obi_shm_ring_release(spokes[spoke]);
+    return true;
+}
+
+static void expect(int spoke, const uint32_t *values, size_t count) {
+    obi_topology_frame_type_t type;
+    uint32_t value;
+    for (size_t i = 0; i < count; i++) {
+        assert(take(spoke, &type, &value) && type == OBI_FRAME_DATA && value == values[i]);
+    }
+    assert(!take(spoke, &type, &value));
+}
+
+static void pump(void) {
+    uint32_t value;
+    obi_buffer_t buffer = { (uint8_t *)&value, 0, sizeof(value) };
+    assert(obi_topology_receive_message(obi_topology_get_context(), &buffer) == OBI_ERROR_WOULD_BLOCK);
+}
+
+// Refuses odd values
+static void reject_odd(void *user, const obi_buffer_t *messages, size_t count, bool *valid) {
+    (void)user;
+    validator_calls++;
+    for (size_t i = 0; i < count; i++) {
+        uint32_t value;
+        memcpy(&value, messages[i].data, sizeof(value));
+        valid[i] = (value & 1) == 0;
+    }
+}
+
+static obi_topology_context_t *join_hub(const obi_hub_config_t *config) {
+    assert(obi_topology_init((obi_protocol_context_t *)&protocol_placeholder) == OBI_TOPOLOGY_SUCCESS);
+    obi_topology_context_t *ctx = obi_topology_get_context();
+    obi_node_id_t id;
+    assert(obi_topology_add_node(ctx, "hub-a", NULL, &id) == OBI_TOPOLOGY_SUCCESS);
+    obi_shm_config_t ring = { SPOKE_SLOTS, OBI_SHM_DEFAULT_SLOT_SIZE, false };
+    char name[64];
+    for (int i = 0; i < SPOKES; i++) {
+        assert(obi_topology_add_node(ctx, spoke_names[i], NULL, &id) == OBI_TOPOLOGY_SUCCESS);
+        snprintf(name, sizeof(name), OBI_SHM_NAME_PREFIX "%s", spoke_names[i]);
+        assert(obi_shm_ring_create(name, &ring, &spokes[i]) == OBI_SUCCESS);
+    }
+    assert(obi_topology_configure(ctx, OBI_TOPOLOGY_STAR) == OBI_TOPOLOGY_SUCCESS);
+    assert(obi_topology_bind(ctx, "hub-a") == OBI_TOPOLOGY_SUCCESS);
+    assert(obi_shm_ring_attach(OBI_SHM_NAME_PREFIX "hub-a", false, &inbound) == OBI_SUCCESS);
+    assert(obi_topology_set_hub_aggregation(ctx, config) == OBI_TOPOLOGY_SUCCESS);
+    validator_calls = 0;
+    return ctx;
+}
+
+static void leave(void) {
+    obi_shm_ring_close(inbound);
+    obi_topology_cleanup();
+    for (int i = 0; i < SPOKES; i++) {
+        obi_shm_ring_close(spokes[i]);
+    }
+}
+
+void test_batching_order() {
+    printf("Testing per-destination batches in arrival order...\n");
+
+    obi_hub_config_t config = { 4, OBI_HUB_DEFAULT_DELAY_US, NULL, NULL, 0 };
+    obi_topology_context_t *ctx = join_hub(&config);
+    config.max_batch = OBI_HUB_MAX_BATCH + 1;
+    assert(obi_topology_set_hub_aggregation(ctx, &config) == OBI_TOPOLOGY_ERROR_INVALID_CONFIG);
+
+    // Two destinations interleaved; full batches leave at once, the rest when input runs dry
+    for (uint32_t i = 0; i < 5; i++) {
+        inject(0, OBI_FRAME_DATA, i);
+        inject(1, OBI_FRAME_DATA, 100 + i);
+    }
+    pump();
+    expect(0, (const uint32_t[]){ 0, 1, 2, 3, 4 }, 5);
+    expect(1, (const uint32_t[]){ 100, 101, 102, 103, 104 }, 5);
+
+    obi_topology_metrics_t metrics;
+    assert(obi_topology_get_metrics(ctx, &metrics) == OBI_TOPOLOGY_SUCCESS);
+    assert(metrics.hub_batches == 4 && metrics.hub_batched_frames == 10 && metrics.relayed_frames == 10);
+
+    // Other frame types do not overtake data batched ahead of them
+    inject(2, OBI_FRAME_DATA, 1);
+    inject(2, OBI_FRAME_DATA, 2);
+    inject(2, OBI_FRAME_CREDIT, 3);
+    pump();
+    obi_topology_frame_type_t type;
+    uint32_t value;
+    assert(take(2, &type, &value) && type == OBI_FRAME_DATA && value == 1);
+    assert(take(2, &type, &value) && type == OBI_FRAME_DATA && value == 2);
+    assert(take(2, &type, &value) && type == OBI_FRAME_CREDIT && value == 3);
+
+    leave();
+    printf("✅ Batching order test passed\n");
+}
+
+void test_full_spoke() {
+    printf("Testing a batch resumed after a full spoke drains...\n");
+
+    obi_topology_context_t *ctx = join_hub(NULL);
+    for (uint32_t i = 0; i < 2 * SPOKE_SLOTS; i++) {
+        inject(0, OBI_FRAME_DATA, i);
+    }
+    pump();
+    uint32_t values[2 * SPOKE_SLOTS];
+    for (uint32_t i = 0; i < 2 * SPOKE_SLOTS; i++) {
+        values[i] = i;
+    }
+    expect(0, values, SPOKE_SLOTS);
+    pump();
+    expect(0, values + SPOKE_SLOTS, SPOKE_SLOTS);
+
+    obi_topology_metrics_t metrics;
+    assert(obi_topology_get_metrics(ctx, &metrics) == OBI_TOPOLOGY_SUCCESS);
+    assert(metrics.hub_batches == 2 && metrics.relay_drops == 0);
+
+    leave();
+    printf("✅ Full spoke test passed\n");
+}
+
+void test_validation_cache() {
+    printf("Testing batch validation and cached verdicts...\n");
+
+    obi_hub_config_t config = { 8, OBI_HUB_DEFAULT_DELAY_US, reject_odd, NULL, 64 };
+    obi_topology_context_t *ctx = join_hub(&config);
+
+    // One validator call per batch; odd values never reach the spoke
+    for (uint32_t i = 0; i < 8; i++) {
+        inject(0, OBI_FRAME_DATA, i);
+    }
+    pump();
+    expect(0, (const uint32_t[]){ 0, 2, 4, 6 }, 4);
+    assert(validator_calls == 1);
+
+    // A broadcast relayed to every spoke is validated once, even when its two
+    // payloads share a cache bucket under this run's key
+    for (int spoke = 0; spoke < SPOKES; spoke++) {
+        inject(spoke, OBI_FRAME_DATA, 42);
+        inject(spoke, OBI_FRAME_DATA, 43);
+    }
+    pump();
+    for (int spoke = 0; spoke < SPOKES; spoke++) {
+        expect(spoke, (const uint32_t[]){ 42 }, 1);
+    }
+    assert(validator_calls == 2);
+
+    obi_topology_metrics_t metrics;
+    assert(obi_topology_get_metrics(ctx, &metrics) == OBI_TOPOLOGY_SUCCESS);
+    assert(metrics.hub_validated == 10 && metrics.hub_cache_hits == 4);
+    assert(metrics.hub_rejected == 4 + SPOKES && metrics.hub_batched_frames == 4 + SPOKES);
+
+    // Turning aggregation off forwards frame by frame again
+    config.max_batch = 0;
+    assert(obi_topology_set_hub_aggregation(ctx, &config) == OBI_TOPOLOGY_SUCCESS);
+    inject(1, OBI_FRAME_DATA, 7);
+    pump();
+    expect(1, (const uint32_t[]){ 7 }, 1);
+    assert(obi_topology_get_metrics(ctx, &metrics) == OBI_TOPOLOGY_SUCCESS);
+    assert(metrics.hub_batched_frames == 4 + SPOKES && metrics.relayed_frames == 5 + SPOKES);
+
+    leave();
+    printf("✅ Validation cache test passed\n");
+}
+
+int main() {
+    printf("🧪 Running OBI Topology Hub Aggregation Tests\n");
+    printf("=============================================\n");
+
+    test_batching_order();
+    test_full_spoke();
+    test_validation_cache();
+
+    printf("\n✅ All hub aggregation tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,146 @@
+/*
+ * Node Registry Tests
+ * Validates name interning, concurrent registration and the send-by-id path
+ */
+
+#include "obitopology.h"
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <pthread.h>
+
+#define RACE_THREADS 4
+#define RACE_NAMES   32
+
+static int protocol_placeholder;
+
+typedef struct {
+    obi_topology_context_t *ctx;
+    int offset;
+    obi_node_id_t ids[RACE_NAMES];
+} race_worker_t;
+
+// Every worker learns the same names, each starting at a different one
+static void *resolve_all(void *arg) {
+    race_worker_t *worker = arg;
+    char name[32];
+    for (int i = 0; i < RACE_NAMES; i++) {
+        int index = (i + worker->offset) % RACE_NAMES;
+        snprintf(name, sizeof(name), "race-node-%d", index);
+        assert(obi_topology_resolve_node(worker->ctx, name, &worker->ids[index]) == OBI_TOPOLOGY_SUCCESS);
+    }
+    return NULL;
+}
+
+void test_interning() {
+    printf("Testing destination name interning...\n");
+
+    assert(obi_topology_init((obi_protocol_context_t *)&protocol_placeholder) == OBI_TOPOLOGY_SUCCESS);
+    obi_topology_context_t *ctx = obi_topology_get_context();
+    char name[32];
+    obi_node_id_t id;
+
+    // Ids are dense and handed out in registration order
+    for (int i = 0; i < OBI_TOPOLOGY_MAX_NODES; i++) {
+        snprintf(name, sizeof(name), "registry-node-%d", i);
+        assert(obi_topology_resolve_node(ctx, name, &id) == OBI_TOPOLOGY_SUCCESS);
+        assert(id == (obi_node_id_t)i);
+    }
+
+    // Interning is idempotent, whichever entry point sees the name
+    for (int i = 0; i < OBI_TOPOLOGY_MAX_NODES; i++) {
+        snprintf(name, sizeof(name), "registry-node-%d", i);
+        assert(obi_topology_resolve_node(ctx, name, &id) == OBI_TOPOLOGY_SUCCESS);
+        assert(id == (obi_node_id_t)i);
+        assert(obi_topology_add_node(ctx, name, NULL, &id) == OBI_TOPOLOGY_SUCCESS);
+        assert(id == (obi_node_id_t)i);
+    }
+
+    // The registry is full
+    assert(obi_topology_resolve_node(ctx, "registry-overflow", &id) == OBI_TOPOLOGY_ERROR_INVALID_CONFIG);
+
+    obi_topology_cleanup();
+    printf("✅ Interning test passed\n");
+}
+
+void test_concurrent_registration() {
+    printf("Testing registration from concurrent senders...\n");
+
+    assert(obi_topology_init((obi_protocol_context_t *)&protocol_placeholder) == OBI_TOPOLOGY_SUCCESS);
+    obi_topology_context_t *ctx = obi_topology_get_context();
+
+    race_worker_t workers[RACE_THREADS];
+    pthread_t threads[RACE_THREADS];
+    for (int t = 0; t < RACE_THREADS; t++) {
+        workers[t].ctx = ctx;
+        workers[t].offset = t * RACE_NAMES / RACE_THREADS;
+        assert(pthread_create(&threads[t], NULL, resolve_all, &workers[t]) == 0);
+    }
+    for (int t = 0; t < RACE_THREADS; t++) {
+        pthread_join(threads[t], NULL);
+    }
+
+    // One id per name, the same in every thread, and none handed out twice
+    bool taken[RACE_NAMES] = {false};
+    for (int i = 0; i < RACE_NAMES; i++) {
+        obi_node_id_t id = workers[0].ids[i];
+        assert(id < RACE_NAMES && !taken[id]);
+        taken[id] = true;
+        for (int t = 1; t < RACE_THREADS; t++) {
+            assert(workers[t].ids[i] == id);
+        }
+    }
+    obi_node_id_t next;
+    assert(obi_topology_add_node(ctx, "race-late", NULL, &next) == OBI_TOPOLOGY_SUCCESS);
+    assert(next == RACE_NAMES);
+
+    obi_topology_cleanup();
+    printf("✅ Concurrent registration test passed\n");
+}
+
+void test_send_by_id() {
+    printf("Testing send by interned id...\n");
+
+    assert(obi_topology_init((obi_protocol_context_t *)&protocol_placeholder) == OBI_TOPOLOGY_SUCCESS);
+    obi_topology_context_t *ctx = obi_topology_get_context();
+
+    obi_shm_config_t config = { 16, OBI_SHM_DEFAULT_SLOT_SIZE, false };
+    obi_shm_ring_t *sink = NULL;
+    assert(obi_shm_ring_create(OBI_SHM_NAME_PREFIX "registry-sink", &config, &sink) == OBI_SUCCESS);
+
+    obi_node_id_t id;
+    assert(obi_topology_add_node(ctx, "sink", "registry-sink", &id) == OBI_TOPOLOGY_SUCCESS);
+
+    uint8_t payload[] = "interned";
+    obi_buffer_t buffer = { payload, sizeof(payload), sizeof(payload) };
+    assert(obi_topology_send_to(ctx, &buffer, id) == OBI_SUCCESS);
+    assert(obi_topology_send_to(ctx, &buffer, (obi_node_id_t)(id + 1)) == OBI_ERROR_INVALID_INPUT);
+    assert(obi_topology_send_to(ctx, &buffer, OBI_NODE_INVALID) == OBI_ERROR_INVALID_INPUT);
+
+    size_t length = 0;
+    const uint8_t *slot = obi_shm_ring_peek(sink, &length);
+    assert(slot != NULL && length == sizeof(obi_topology_frame_t) + sizeof(payload));
+
+    obi_topology_frame_t frame;
+    memcpy(&frame, slot, sizeof(frame));
+    assert(frame.length == sizeof(payload));
+    assert(frame.destination != 0);
+    assert(memcmp(slot + sizeof(frame), payload, sizeof(payload)) == 0);
+    obi_shm_ring_release(sink);
+
+    obi_topology_cleanup();
+    obi_shm_ring_close(sink);
+    printf("✅ Send by id test passed\n");
+}
+
+int main() {
+    printf("🧪 Running OBI Topology Node Registry Tests\n");
+    printf("===========================================\n");
+
+    test_interning();
+    test_concurrent_registration();
+    test_send_by_id();
+
+    printf("\n✅ All node registry tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,209 @@
+/*
+ * Partitioning Tests
+ * Validates the HYBRID consistent-hash ring: balance, minimal key movement
+ * on membership changes, placement independent of registration order and
+ * lookups through the topology context
+ */
+
+#include "obitopology.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+
+#define PARTITION_KEYS 100000
+
+static int protocol_placeholder;
+static obi_node_id_t owners[PARTITION_KEYS];
+
+static obi_route_graph_t *make_graph(uint32_t nodes) {
+    obi_route_graph_t *graph = calloc(1, sizeof(*graph));
+    graph->node_count = nodes;
+    for (uint32_t i = 0; i < OBI_TOPOLOGY_MAX_NODES; i++) {
+        graph->active[i] = i < nodes;
+        graph->key[i] = 0x9E3779B9u * (i + 1);
+    }
+    return graph;
+}
+
+// Count keys whose owner differs from the last snapshot, then take a new one
+static uint32_t remap(const obi_route_table_t *table, obi_node_id_t *moved_to) {
+    uint32_t moved = 0;
+    for (uint64_t key = 0; key < PARTITION_KEYS; key++) {
+        obi_node_id_t owner = obi_partition_lookup(&table->partition, key);
+        assert(owner != OBI_NODE_INVALID && table->distance[(size_t)owner * table->node_count + owner] == 0);
+        if (owner != owners[key]) {
+            moved++;
+            if (moved_to) {
+                assert(*moved_to == OBI_NODE_INVALID || *moved_to == owner);
+                *moved_to = owner;
+            }
+        }
+        owners[key] = owner;
+    }
+    return moved;
+}
+
+void test_ring_balance_and_movement() {
+    printf("Testing ring balance and key movement on membership changes...\n");
+
+    obi_route_graph_t *graph = make_graph(8);
+    obi_route_table_t *table = obi_route_table_build(graph, OBI_TOPOLOGY_HYBRID);
+    assert(table != NULL && table->partition.size == 8 * OBI_PARTITION_VNODES);
+
+    // Every node gets a fair share of the key space
+    uint32_t counts[8] = {0};
+    memset(owners, 0xFF, sizeof(owners));
+    remap(table, NULL);
+    for (uint32_t key = 0; key < PARTITION_KEYS; key++) {
+        counts[owners[key]]++;
+    }
+    for (int i = 0; i < 8; i++) {
+        assert(counts[i] > PARTITION_KEYS / 8 * 6 / 10 && counts[i] < PARTITION_KEYS / 8 * 14 / 10);
+    }
+
+    // A joining node takes about 1/N of the keys, all of them from others
+    graph->node_count = 9;
+    graph->active[8] = true;
+    obi_route_table_t *grown = obi_route_table_update(table, graph, OBI_TOPOLOGY_HYBRID);
+    obi_node_id_t gained = OBI_NODE_INVALID;
+    uint32_t moved = remap(grown, &gained);
+    assert(gained == 8);
+    assert(moved > PARTITION_KEYS / 20 && moved < PARTITION_KEYS / 5);
+
+    // A leaving node hands over only its own keys
+    uint32_t owned = 0;
+    for (uint32_t key = 0; key < PARTITION_KEYS; key++) {
+        owned += owners[key] == 3;
+    }
+    graph->active[3] = false;
+    obi_route_table_t *shrunk = obi_route_table_update(grown, graph, OBI_TOPOLOGY_HYBRID);
+    for (uint64_t key = 0; key < PARTITION_KEYS; key++) {
+        obi_node_id_t owner = obi_partition_lookup(&shrunk->partition, key);
+        assert(owners[key] == 3 ? owner != 3 : owner == owners[key]);
+    }
+    assert(remap(shrunk, NULL) == owned);
+
+    // Failover drops the failed node from the ring without a rebuild
+    obi_route_table_protect(shrunk, 0);
+    obi_route_table_t *failover = obi_route_table_failover(shrunk, 5);
+    assert(failover != NULL && failover->partition.size == shrunk->partition.size - OBI_PARTITION_VNODES);
+    for (uint64_t key = 0; key < PARTITION_KEYS; key++) {
+        obi_node_id_t owner = obi_partition_lookup(&failover->partition, key);
+        assert(owners[key] == 5 ? owner != 5 : owner == owners[key]);
+    }
+
+    // Other types carry no ring
+    obi_route_table_t *mesh = obi_route_table_build(graph, OBI_TOPOLOGY_MESH);
+    assert(mesh->partition.size == 0 && obi_partition_lookup(&mesh->partition, 1) == OBI_NODE_INVALID);
+
+    obi_route_table_destroy(mesh);
+    obi_route_table_destroy(failover);
+    obi_route_table_destroy(shrunk);
+    obi_route_table_destroy(grown);
+    obi_route_table_destroy(table);
+    free(graph);
+    printf("✅ Ring balance and movement test passed\n");
+}
+
+void test_context_partitioning() {
+    printf("Testing keyed lookups through the topology context...\n");
+
+    assert(obi_topology_init((obi_protocol_context_t *)&protocol_placeholder) == OBI_TOPOLOGY_SUCCESS);
+    obi_topology_context_t *ctx = obi_topology_get_context();
+    obi_node_id_t id, owner;
+    char name[16];
+    for (int i = 0; i < 4; i++) {
+        snprintf(name, sizeof(name), "part-%d", i);
+        assert(obi_topology_add_node(ctx, name, NULL, &id) == OBI_TOPOLOGY_SUCCESS);
+    }
+
+    // Keyed delivery is only defined for HYBRID
+    int value = 7;
+    obi_buffer_t buffer = { (uint8_t *)&value, sizeof(value), sizeof(value) };
+    assert(obi_topology_partition_owner(ctx, 1, &owner) == OBI_TOPOLOGY_ERROR_INVALID_CONFIG);
+    assert(obi_topology_send_keyed(ctx, &buffer, 1, &owner) == OBI_ERROR_INVALID_INPUT);
+    assert(owner == OBI_NODE_INVALID);
+    assert(obi_topology_configure(ctx, OBI_TOPOLOGY_HYBRID) == OBI_TOPOLOGY_SUCCESS);
+
+    // SEC tokens hash to stable keys, and owners stay put until membership changes
+    const char token[] = "sec-token-0042";
+    uint64_t key = obi_topology_partition_key(token, strlen(token));
+    assert(key == obi_topology_partition_key(token, strlen(token)));
+    assert(obi_topology_partition_owner(ctx, key, &owner) == OBI_TOPOLOGY_SUCCESS && owner < 4);
+
+    assert(obi_topology_set_node_active(ctx, owner, false) == OBI_TOPOLOGY_SUCCESS);
+    obi_node_id_t successor;
+    assert(obi_topology_partition_owner(ctx, key, &successor) == OBI_TOPOLOGY_SUCCESS);
+    assert(successor != owner && successor < 4);
+    assert(obi_topology_set_node_active(ctx, owner, true) == OBI_TOPOLOGY_SUCCESS);
+    assert(obi_topology_partition_owner(ctx, key, &successor) == OBI_TOPOLOGY_SUCCESS && successor == owner);
+
+    // Keys the local node owns are left to the caller
+    assert(obi_topology_bind(ctx, "part-0") == OBI_TOPOLOGY_SUCCESS);
+    for (key = 0; ; key++) {
+        assert(obi_topology_partition_owner(ctx, key, &owner) == OBI_TOPOLOGY_SUCCESS);
+        if (owner == 0) {
+            break;
+        }
+    }
+    assert(obi_topology_send_keyed(ctx, &buffer, key, &owner) == OBI_SUCCESS && owner == 0);
+
+    obi_topology_cleanup();
+    printf("✅ Context partitioning test passed\n");
+}
+
+void test_registration_order() {
+    printf("Testing ring placement across registration orders...\n");
+
+    // Two processes that learned the same members in opposite orders
+    obi_topology_context_t *forward = obi_topology_context_create((obi_protocol_context_t *)&protocol_placeholder);
+    obi_topology_context_t *reverse = obi_topology_context_create((obi_protocol_context_t *)&protocol_placeholder);
+    assert(forward != NULL && reverse != NULL);
+    obi_node_id_t id;
+    char name[16];
+    for (int i = 0; i < 6; i++) {
+        snprintf(name, sizeof(name), "order-%d", i);
+        assert(obi_topology_add_node(forward, name, NULL, &id) == OBI_TOPOLOGY_SUCCESS);
+        snprintf(name, sizeof(name), "order-%d", 5 - i);
+        assert(obi_topology_add_node(reverse, name, NULL, &id) == OBI_TOPOLOGY_SUCCESS);
+    }
+    assert(obi_topology_configure(forward, OBI_TOPOLOGY_HYBRID) == OBI_TOPOLOGY_SUCCESS);
+    assert(obi_topology_configure(reverse, OBI_TOPOLOGY_HYBRID) == OBI_TOPOLOGY_SUCCESS);
+
+    // Ids differ between the two, but every key has the same owning member
+    obi_node_id_t renamed[6];
+    for (int i = 0; i < 6; i++) {
+        snprintf(name, sizeof(name), "order-%d", i);
+        assert(obi_topology_resolve_node(forward, name, &id) == OBI_TOPOLOGY_SUCCESS && id == i);
+        assert(obi_topology_resolve_node(reverse, name, &renamed[i]) == OBI_TOPOLOGY_SUCCESS);
+        assert(renamed[i] == 5 - i);
+    }
+    uint32_t counts[6] = {0};
+    for (uint64_t key = 0; key < PARTITION_KEYS; key++) {
+        obi_node_id_t owner, other;
+        assert(obi_topology_partition_owner(forward, key, &owner) == OBI_TOPOLOGY_SUCCESS);
+        assert(obi_topology_partition_owner(reverse, key, &other) == OBI_TOPOLOGY_SUCCESS);
+        assert(owner < 6 && other == renamed[owner]);
+        counts[owner]++;
+    }
+    for (int i = 0; i < 6; i++) {
+        assert(counts[i] > 0);
+    }
+
+    obi_topology_context_destroy(reverse);
+    obi_topology_context_destroy(forward);
+    printf("✅ Registration order test passed\n");
+}
+
+int main() {
+    printf("🧪 Running OBI Topology Partitioning Tests\n");
+    printf("==========================================\n");
+
+    test_ring_balance_and_movement();
+    test_registration_order();
+    test_context_partitioning();
+
+    printf("\n✅ All partitioning tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,132 @@
+/*
+ * Ring Forwarding Tests
+ * Validates that a relay holds a transit frame its successor cannot take
+ * yet, keeps everything behind it in order, and gives up on a stalled or
+ * unreachable next hop
+ */
+
+#define _DEFAULT_SOURCE
+
+#include "obitopology.h"
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <unistd.h>
+
+#define SUCCESSOR_SLOTS 4
+
+static int protocol_placeholder;
+static obi_shm_ring_t *inbound;
+static obi_shm_ring_t *successor;
+
+// Node keys are the FNV-1a hash of the node name
+static uint32_t node_key(const char *name) {
+    uint32_t hash = 2166136261u;
+    while (*name) {
+        hash ^= (uint8_t)*name++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static void inject(const char *destination, uint32_t value) {
+    obi_topology_frame_t frame = {0};
+    frame.length = sizeof(value);
+    frame.type = OBI_FRAME_DATA;
+    frame.source = node_key("ring-a");
+    frame.destination = node_key(destination);
+    obi_shm_reservation_t reservation;
+    uint8_t *slot = obi_shm_ring_reserve(inbound, sizeof(frame) + sizeof(value), &reservation);
+    assert(slot != NULL);
+    memcpy(slot, &frame, sizeof(frame));
+    memcpy(slot + sizeof(frame), &value, sizeof(value));
+    obi_shm_ring_publish(inbound, &reservation, sizeof(frame) + sizeof(value));
+}
+
+// Everything the successor received, checked against the expected run
+static void expect_forwarded(uint32_t first, uint32_t count) {
+    size_t length;
+    const uint8_t *frame;
+    for (uint32_t i = 0; i < count; i++) {
+        frame = obi_shm_ring_peek(successor, &length);
+        assert(frame != NULL && length == sizeof(obi_topology_frame_t) + sizeof(uint32_t));
+        uint32_t value;
+        memcpy(&value, frame + sizeof(obi_topology_frame_t), sizeof(value));
+        assert(value == first + i);
+        obi_shm_ring_release(successor);
+    }
+    assert(obi_shm_ring_peek(successor, &length) == NULL);
+}
+
+static obi_result_t receive(uint32_t *value) {
+    obi_buffer_t buffer = { (uint8_t *)value, 0, sizeof(*value) };
+    return obi_topology_receive_message(obi_topology_get_context(), &buffer);
+}
+
+void test_hold_and_resume() {
+    printf("Testing transit frames held for a full successor...\n");
+
+    assert(obi_topology_init((obi_protocol_context_t *)&protocol_placeholder) == OBI_TOPOLOGY_SUCCESS);
+    obi_topology_context_t *ctx = obi_topology_get_context();
+    obi_node_id_t id;
+    assert(obi_topology_add_node(ctx, "ring-a", NULL, &id) == OBI_TOPOLOGY_SUCCESS);
+    assert(obi_topology_add_node(ctx, "ring-b", NULL, &id) == OBI_TOPOLOGY_SUCCESS);
+    assert(obi_topology_add_node(ctx, "ring-c", NULL, &id) == OBI_TOPOLOGY_SUCCESS);
+    assert(obi_topology_configure(ctx, OBI_TOPOLOGY_RING) == OBI_TOPOLOGY_SUCCESS);
+
+    obi_shm_config_t config = { SUCCESSOR_SLOTS, OBI_SHM_DEFAULT_SLOT_SIZE, false };
+    assert(obi_shm_ring_create(OBI_SHM_NAME_PREFIX "ring-c", &config, &successor) == OBI_SUCCESS);
+    assert(obi_topology_bind(ctx, "ring-b") == OBI_TOPOLOGY_SUCCESS);
+    assert(obi_shm_ring_attach(OBI_SHM_NAME_PREFIX "ring-b", false, &inbound) == OBI_SUCCESS);
+
+    // Ten frames for the successor, then one for us behind them
+    for (uint32_t i = 0; i < 10; i++) {
+        inject("ring-c", i);
+    }
+    inject("ring-b", 99);
+
+    // Each call forwards until the successor is full; our own frame waits its turn
+    uint32_t value = 0;
+    assert(receive(&value) == OBI_ERROR_WOULD_BLOCK);
+    expect_forwarded(0, SUCCESSOR_SLOTS);
+    assert(receive(&value) == OBI_ERROR_WOULD_BLOCK);
+    expect_forwarded(SUCCESSOR_SLOTS, SUCCESSOR_SLOTS);
+    assert(receive(&value) == OBI_SUCCESS && value == 99);
+    expect_forwarded(2 * SUCCESSOR_SLOTS, 10 - 2 * SUCCESSOR_SLOTS);
+
+    obi_topology_metrics_t metrics;
+    assert(obi_topology_get_metrics(ctx, &metrics) == OBI_TOPOLOGY_SUCCESS);
+    assert(metrics.relayed_frames == 10 && metrics.relay_stalls == 2 && metrics.relay_drops == 0);
+
+    // A successor that never drains costs one frame, not the relay
+    for (uint32_t i = 0; i < SUCCESSOR_SLOTS + 1; i++) {
+        inject("ring-c", 100 + i);
+    }
+    inject("ring-b", 7);
+    assert(receive(&value) == OBI_ERROR_WOULD_BLOCK);
+    usleep(110000);
+    assert(receive(&value) == OBI_SUCCESS && value == 7);
+    expect_forwarded(100, SUCCESSOR_SLOTS);
+
+    // So does a next hop with no ring at all
+    inject("ring-a", 8);
+    assert(receive(&value) == OBI_ERROR_WOULD_BLOCK);
+
+    assert(obi_topology_get_metrics(ctx, &metrics) == OBI_TOPOLOGY_SUCCESS);
+    assert(metrics.relay_stalls == 3 && metrics.relay_drops == 2);
+
+    obi_shm_ring_close(inbound);
+    obi_topology_cleanup();
+    obi_shm_ring_close(successor);
+    printf("✅ Hold and resume test passed\n");
+}
+
+int main() {
+    printf("🧪 Running OBI Topology Ring Forwarding Tests\n");
+    printf("=============================================\n");
+
+    test_hold_and_resume();
+
+    printf("\n✅ All ring forwarding tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,278 @@
+/*
+ * Routing Table Tests
+ * Validates next-hop precomputation for each topology type
+ */
+
+#include "obitopology.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+
+static obi_route_graph_t *make_graph(uint32_t nodes) {
+    obi_route_graph_t *graph = calloc(1, sizeof(*graph));
+    graph->node_count = nodes;
+    for (uint32_t i = 0; i < nodes; i++) {
+        graph->active[i] = true;
+    }
+    return graph;
+}
+
+static void link_nodes(obi_route_graph_t *graph, obi_node_id_t a, obi_node_id_t b, uint16_t cost) {
+    graph->link_cost[a][b] = cost;
+    graph->link_cost[b][a] = cost;
+    graph->link_count++;
+}
+
+void test_direct_topologies() {
+    printf("Testing P2P and BUS next hops...\n");
+    
+    obi_route_graph_t *graph = make_graph(8);
+    obi_topology_type_t types[] = { OBI_TOPOLOGY_P2P, OBI_TOPOLOGY_BUS };
+    
+    for (size_t t = 0; t < 2; t++) {
+        obi_route_table_t *table = obi_route_table_build(graph, types[t]);
+        assert(table != NULL);
+        for (obi_node_id_t src = 0; src < 8; src++) {
+            for (obi_node_id_t dst = 0; dst < 8; dst++) {
+                assert(obi_route_next_hop(table, src, dst) == dst);
+            }
+        }
+        obi_route_table_destroy(table);
+    }
+    
+    free(graph);
+    printf("✅ P2P and BUS next hop test passed\n");
+}
+
+void test_ring_routes() {
+    printf("Testing RING next hops take the shorter direction...\n");
+    
+    obi_route_graph_t *graph = make_graph(6);
+    obi_route_table_t *table = obi_route_table_build(graph, OBI_TOPOLOGY_RING);
+    assert(table != NULL);
+    
+    assert(obi_route_next_hop(table, 0, 1) == 1);
+    assert(obi_route_next_hop(table, 0, 2) == 1);
+    assert(obi_route_next_hop(table, 0, 5) == 5);
+    assert(obi_route_next_hop(table, 0, 4) == 5);
+    assert(table->distance[0 * 6 + 3] == 3);
+    obi_route_table_destroy(table);
+    
+    // An inactive node is skipped when closing the ring
+    graph->active[5] = false;
+    table = obi_route_table_build(graph, OBI_TOPOLOGY_RING);
+    assert(obi_route_next_hop(table, 0, 4) == 4);
+    assert(obi_route_next_hop(table, 0, 5) == OBI_NODE_INVALID);
+    obi_route_table_destroy(table);
+    
+    free(graph);
+    printf("✅ RING next hop test passed\n");
+}
+
+void test_star_routes() {
+    printf("Testing STAR routes relay through the hub...\n");
+    
+    obi_route_graph_t *graph = make_graph(5);
+    graph->hub = 2;
+    obi_route_table_t *table = obi_route_table_build(graph, OBI_TOPOLOGY_STAR);
+    
+    assert(obi_route_next_hop(table, 0, 4) == 2);
+    assert(obi_route_next_hop(table, 0, 2) == 2);
+    assert(obi_route_next_hop(table, 2, 4) == 4);
+    obi_route_table_destroy(table);
+    
+    free(graph);
+    printf("✅ STAR next hop test passed\n");
+}
+
+void test_mesh_weighted_routes() {
+    printf("Testing MESH shortest weighted paths...\n");
+    
+    obi_route_graph_t *graph = make_graph(4);
+    link_nodes(graph, 0, 1, 1);
+    link_nodes(graph, 1, 3, 1);
+    link_nodes(graph, 0, 2, 1);
+    link_nodes(graph, 2, 3, 5);
+    
+    obi_route_table_t *table = obi_route_table_build(graph, OBI_TOPOLOGY_MESH);
+    assert(obi_route_next_hop(table, 0, 3) == 1);
+    assert(obi_route_next_hop(table, 2, 3) == 0);
+    assert(table->distance[2 * 4 + 3] == 3);
+    obi_route_table_destroy(table);
+    
+    // Partitioned mesh reports unreachable destinations
+    graph->link_cost[1][3] = graph->link_cost[3][1] = 0;
+    graph->link_cost[2][3] = graph->link_cost[3][2] = 0;
+    graph->link_count -= 2;
+    table = obi_route_table_build(graph, OBI_TOPOLOGY_MESH);
+    assert(obi_route_next_hop(table, 0, 3) == OBI_NODE_INVALID);
+    obi_route_table_destroy(table);
+    
+    free(graph);
+    printf("✅ MESH weighted path test passed\n");
+}
+
+// Incremental tables must agree with a full rebuild on every distance, and
+// every next hop must lie on a shortest path
+static void assert_equivalent(const obi_route_table_t *table, const obi_route_graph_t *graph,
+                              obi_topology_type_t type) {
+    obi_route_table_t *full = obi_route_table_build(graph, type);
+    uint32_t n = full->node_count;
+    assert(table->node_count == n);
+    
+    for (uint32_t s = 0; s < n; s++) {
+        for (uint32_t d = 0; d < n; d++) {
+            uint32_t dist = table->distance[s * n + d];
+            assert(dist == full->distance[s * n + d]);
+            obi_node_id_t hop = table->next_hop[s * n + d];
+            if (dist == OBI_ROUTE_UNREACHABLE) {
+                assert(hop == OBI_NODE_INVALID);
+            } else if (s != d) {
+                assert(full->cost[s * n + hop] + full->distance[hop * n + d] == dist);
+            }
+        }
+    }
+    obi_route_table_destroy(full);
+}
+
+void test_incremental_updates() {
+    printf("Testing incremental updates against full rebuilds...\n");
+    
+    obi_route_graph_t *graph = make_graph(48);
+    srand(7);
+    for (int i = 0; i < 120; i++) {
+        obi_node_id_t a = (obi_node_id_t)(rand() % 48);
+        obi_node_id_t b = (obi_node_id_t)(rand() % 48);
+        if (a != b && graph->link_cost[a][b] == 0) {
+            link_nodes(graph, a, b, (uint16_t)(1 + rand() % 9));
+        }
+    }
+    obi_route_table_t *table = obi_route_table_build(graph, OBI_TOPOLOGY_MESH);
+    
+    for (int step = 0; step < 300; step++) {
+        obi_node_id_t a = (obi_node_id_t)(rand() % graph->node_count);
+        obi_node_id_t b = (obi_node_id_t)(rand() % graph->node_count);
+        switch (rand() % 4) {
+            case 0:  // link cost change, insertion or removal
+                if (a != b) {
+                    uint16_t cost = (uint16_t)(rand() % 10);
+                    if ((graph->link_cost[a][b] == 0) != (cost == 0)) {
+                        graph->link_count += cost ? 1 : -1;
+                    }
+                    graph->link_cost[a][b] = graph->link_cost[b][a] = cost;
+                }
+                break;
+            case 1:  // node failure or recovery
+                graph->active[a] = !graph->active[a];
+                break;
+            case 2:  // node join
+                if (graph->node_count < 64) {
+                    obi_node_id_t id = (obi_node_id_t)graph->node_count++;
+                    graph->active[id] = true;
+                    link_nodes(graph, id, a, (uint16_t)(1 + rand() % 9));
+                }
+                break;
+            default:
+                continue;
+        }
+        
+        obi_route_table_t *next = obi_route_table_update(table, graph, OBI_TOPOLOGY_MESH);
+        assert(next != NULL);
+        assert_equivalent(next, graph, OBI_TOPOLOGY_MESH);
+        obi_route_table_destroy(table);
+        table = next;
+    }
+    obi_route_table_destroy(table);
+    
+    // A topology type change falls back to a full rebuild
+    table = obi_route_table_build(graph, OBI_TOPOLOGY_MESH);
+    obi_route_table_t *next = obi_route_table_update(table, graph, OBI_TOPOLOGY_RING);
+    assert_equivalent(next, graph, OBI_TOPOLOGY_RING);
+    obi_route_table_destroy(table);
+    obi_route_table_destroy(next);
+    
+    free(graph);
+    printf("✅ Incremental update test passed\n");
+}
+
+void test_incremental_locality() {
+    printf("Testing a leaf change only touches affected destinations...\n");
+    
+    // Chain 0-1-...-127; adding a leaf at the end changes one column per row
+    obi_route_graph_t *graph = make_graph(128);
+    for (obi_node_id_t i = 0; i + 1 < 128; i++) {
+        link_nodes(graph, i, (obi_node_id_t)(i + 1), 1);
+    }
+    obi_route_table_t *table = obi_route_table_build(graph, OBI_TOPOLOGY_MESH);
+    uint32_t full_work = table->touched;
+    
+    graph->node_count = 129;
+    graph->active[128] = true;
+    link_nodes(graph, 127, 128, 1);
+    obi_route_table_t *next = obi_route_table_update(table, graph, OBI_TOPOLOGY_MESH);
+    assert_equivalent(next, graph, OBI_TOPOLOGY_MESH);
+    assert(next->touched < full_work / 32);
+    
+    obi_route_table_destroy(table);
+    obi_route_table_destroy(next);
+    free(graph);
+    printf("✅ Incremental locality test passed\n");
+}
+
+void test_backup_hops() {
+    printf("Testing precomputed backup next hops...\n");
+    
+    // 0 reaches 3 through 1; 2 is a node-protecting alternate
+    obi_route_graph_t *graph = make_graph(4);
+    link_nodes(graph, 0, 1, 1);
+    link_nodes(graph, 1, 3, 1);
+    link_nodes(graph, 0, 2, 2);
+    link_nodes(graph, 2, 3, 2);
+    
+    obi_route_table_t *table = obi_route_table_build(graph, OBI_TOPOLOGY_MESH);
+    obi_route_table_protect(table, 0);
+    assert(obi_route_next_hop(table, 0, 3) == 1);
+    assert(table->backup_hop[3] == 2);
+    assert(table->backup_hop[1] == OBI_NODE_INVALID);
+    
+    // Failing 1 redirects its destinations without touching the others
+    obi_route_table_t *failover = obi_route_table_failover(table, 1);
+    assert(failover != NULL);
+    assert(obi_route_next_hop(failover, 0, 3) == 2);
+    assert(obi_route_next_hop(failover, 0, 2) == 2);
+    assert(obi_route_next_hop(failover, 0, 1) == OBI_NODE_INVALID);
+    obi_route_table_destroy(failover);
+    obi_route_table_destroy(table);
+    
+    // An alternate whose own path runs back through the failed hop is rejected
+    free(graph);
+    graph = make_graph(4);
+    link_nodes(graph, 0, 1, 1);
+    link_nodes(graph, 1, 3, 1);
+    link_nodes(graph, 0, 2, 1);
+    link_nodes(graph, 2, 1, 1);
+    table = obi_route_table_build(graph, OBI_TOPOLOGY_MESH);
+    obi_route_table_protect(table, 0);
+    assert(table->backup_hop[3] == OBI_NODE_INVALID);
+    obi_route_table_destroy(table);
+    
+    free(graph);
+    printf("✅ Backup next hop test passed\n");
+}
+
+int main() {
+    printf("🧪 Running OBI Topology Routing Tests\n");
+    printf("=====================================\n");
+    
+    test_direct_topologies();
+    test_ring_routes();
+    test_star_routes();
+    test_mesh_weighted_routes();
+    test_incremental_updates();
+    test_incremental_locality();
+    test_backup_hops();
+    
+    printf("\n✅ All routing tests passed!\n");
+    return 0;
+}
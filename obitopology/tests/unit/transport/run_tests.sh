@@ -0,0 +1,17 @@
+#!/bin/bash
+# Topology Transport Unit Test Runner
+
+set -e
+
+echo "🧪 Running Topology Transport Unit Tests..."
+echo "==========================================="
+
+# Compile and run each transport test
+for test in test_shm_transport test_socket_transport test_uring_transport test_fragmentation test_sim_transport; do
+    gcc -std=c11 -I../../../include -I../../../../obiprotocol/include \
+        $test.c -o $test \
+        -L../../../../dist/lib -l:obitopology.a -lrt -lpthread
+    ./$test
+done
+
+echo "✅ Topology transport unit tests completed"
@@ -0,0 +1,281 @@
+/*
+ * Fragmentation Tests
+ * Validates multi-megabyte sends across processes, in-place views of
+ * reassembled messages, async sends that resume a train stopped by a full
+ * link, and the slot, size and timeout bounds on partial reassembly
+ */
+
+#define _DEFAULT_SOURCE
+
+#include "obitopology.h"
+#include "obitopology_transport.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#define LARGE_MESSAGE  (3u << 20)
+#define MEDIUM_MESSAGE 100000u
+
+static int protocol_placeholder;
+
+static uint8_t pattern(uint32_t index, uint32_t seed) {
+    return (uint8_t)(index * 7 + seed);
+}
+
+static void fill(uint8_t *data, uint32_t length, uint32_t seed) {
+    for (uint32_t i = 0; i < length; i++) {
+        data[i] = pattern(i, seed);
+    }
+}
+
+static void check(const uint8_t *data, uint32_t length, uint32_t seed) {
+    for (uint32_t i = 0; i < length; i++) {
+        assert(data[i] == pattern(i, seed));
+    }
+}
+
+static void run_receiver(void) {
+    assert(obi_topology_init((obi_protocol_context_t *)&protocol_placeholder) == OBI_TOPOLOGY_SUCCESS);
+    obi_topology_context_t *ctx = obi_topology_get_context();
+    assert(obi_topology_bind(ctx, "frag-rx") == OBI_TOPOLOGY_SUCCESS);
+    obi_reassembly_config_t config = { 4u << 20, 2, 1000 };
+    assert(obi_topology_set_reassembly(ctx, &config) == OBI_TOPOLOGY_SUCCESS);
+
+    // The large message arrives as one view straight out of its slot
+    obi_buffer_t view;
+    obi_result_t result;
+    while ((result = obi_topology_receive_view(ctx, &view)) == OBI_ERROR_WOULD_BLOCK) {
+        usleep(100);
+    }
+    assert(result == OBI_SUCCESS && view.size == LARGE_MESSAGE);
+    check(view.data, LARGE_MESSAGE, 1);
+
+    uint8_t small[64];
+    obi_buffer_t buffer = { small, 0, sizeof(small) };
+    while ((result = obi_topology_receive_message(ctx, &buffer)) == OBI_ERROR_WOULD_BLOCK) {
+        usleep(100);
+    }
+    assert(result == OBI_SUCCESS && buffer.size == 4 && memcmp(small, "ping", 4) == 0);
+
+    // A reassembled message waits for a buffer large enough to take it
+    while ((result = obi_topology_receive_message(ctx, &buffer)) == OBI_ERROR_WOULD_BLOCK) {
+        usleep(100);
+    }
+    assert(result == OBI_ERROR_BUFFER_OVERFLOW);
+    uint8_t *large = malloc(MEDIUM_MESSAGE);
+    obi_buffer_t copy = { large, 0, MEDIUM_MESSAGE };
+    assert(obi_topology_receive_message(ctx, &copy) == OBI_SUCCESS && copy.size == MEDIUM_MESSAGE);
+    check(large, MEDIUM_MESSAGE, 2);
+    free(large);
+
+    obi_topology_metrics_t metrics;
+    assert(obi_topology_get_metrics(ctx, &metrics) == OBI_TOPOLOGY_SUCCESS);
+    assert(metrics.reassembled_messages == 2 && metrics.reassembly_drops == 0);
+    obi_topology_cleanup();
+    _exit(0);
+}
+
+void test_large_messages() {
+    printf("Testing multi-megabyte sends across processes...\n");
+
+    pid_t child = fork();
+    assert(child >= 0);
+    if (child == 0) {
+        run_receiver();
+    }
+
+    assert(obi_topology_init((obi_protocol_context_t *)&protocol_placeholder) == OBI_TOPOLOGY_SUCCESS);
+    obi_topology_context_t *ctx = obi_topology_get_context();
+    obi_node_id_t rx;
+    assert(obi_topology_add_node(ctx, "frag-rx", NULL, &rx) == OBI_TOPOLOGY_SUCCESS);
+    assert(obi_topology_bind(ctx, "frag-tx") == OBI_TOPOLOGY_SUCCESS);
+
+    uint8_t *data = malloc(LARGE_MESSAGE);
+    fill(data, LARGE_MESSAGE, 1);
+    obi_buffer_t large = { data, LARGE_MESSAGE, LARGE_MESSAGE };
+    obi_result_t result;
+    while ((result = obi_topology_send_to(ctx, &large, rx)) == OBI_ERROR_NETWORK_FAILURE) {
+        usleep(1000);  // receiver ring not bound yet
+    }
+    assert(result == OBI_SUCCESS);
+
+    obi_buffer_t ping = { (uint8_t *)"ping", 4, 4 };
+    assert(obi_topology_send_to(ctx, &ping, rx) == OBI_SUCCESS);
+    fill(data, MEDIUM_MESSAGE, 2);
+    obi_buffer_t medium = { data, MEDIUM_MESSAGE, MEDIUM_MESSAGE };
+    assert(obi_topology_send_to(ctx, &medium, rx) == OBI_SUCCESS);
+
+    obi_buffer_t oversized = { data, (size_t)OBI_FRAGMENT_MAX_MESSAGE + 1, (size_t)OBI_FRAGMENT_MAX_MESSAGE + 1 };
+    assert(obi_topology_send_to(ctx, &oversized, rx) == OBI_ERROR_BUFFER_OVERFLOW);
+
+    obi_topology_metrics_t metrics;
+    assert(obi_topology_get_metrics(ctx, &metrics) == OBI_TOPOLOGY_SUCCESS);
+    assert(metrics.fragmented_messages == 2);
+
+    int status = 0;
+    waitpid(child, &status, 0);
+    assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    free(data);
+    obi_topology_cleanup();
+    printf("✅ Large message test passed\n");
+}
+
+// Inject one fragment into the local ring, as a remote sender would
+static void inject(obi_shm_ring_t *ring, uint32_t source, uint32_t id, uint32_t total, uint32_t offset,
+                   uint32_t length) {
+    obi_fragment_header_t header = { id, total, offset };
+    obi_topology_frame_t frame = {0};
+    frame.length = (uint32_t)sizeof(header) + length;
+    frame.type = OBI_FRAME_FRAGMENT;
+    frame.source = source;
+    obi_shm_reservation_t reservation;
+    uint8_t *slot = obi_shm_ring_reserve(ring, sizeof(frame) + frame.length, &reservation);
+    assert(slot != NULL);
+    memcpy(slot, &frame, sizeof(frame));
+    memcpy(slot + sizeof(frame), &header, sizeof(header));
+    for (uint32_t i = 0; i < length; i++) {
+        slot[sizeof(frame) + sizeof(header) + i] = pattern(offset + i, id);
+    }
+    obi_shm_ring_publish(ring, &reservation, sizeof(frame) + frame.length);
+}
+
+void test_reassembly_bounds() {
+    printf("Testing reassembly slot, size and timeout bounds...\n");
+
+    assert(obi_topology_init((obi_protocol_context_t *)&protocol_placeholder) == OBI_TOPOLOGY_SUCCESS);
+    obi_topology_context_t *ctx = obi_topology_get_context();
+    assert(obi_topology_bind(ctx, "frag-local") == OBI_TOPOLOGY_SUCCESS);
+    obi_shm_ring_t *ring = NULL;
+    assert(obi_shm_ring_attach(OBI_SHM_NAME_PREFIX "frag-local", false, &ring) == OBI_SUCCESS);
+    obi_reassembly_config_t config = { 1024, 1, 50 };
+    assert(obi_topology_set_reassembly(ctx, &config) == OBI_TOPOLOGY_SUCCESS);
+
+    uint8_t storage[1024];
+    obi_buffer_t buffer = { storage, 0, sizeof(storage) };
+
+    // One slot: a stalled message holds it, the next is refused and its tail ignored
+    inject(ring, 0x3001, 1, 600, 0, 300);
+    inject(ring, 0x3002, 2, 500, 0, 250);
+    inject(ring, 0x3002, 2, 500, 250, 250);
+    assert(obi_topology_receive_message(ctx, &buffer) == OBI_ERROR_WOULD_BLOCK);
+
+    // Once the stalled message times out its slot serves the next one
+    usleep(60000);
+    inject(ring, 0x3002, 3, 400, 0, 200);
+    inject(ring, 0x3002, 3, 400, 200, 200);
+    assert(obi_topology_receive_message(ctx, &buffer) == OBI_SUCCESS && buffer.size == 400);
+    check(storage, 400, 3);
+
+    // Messages beyond max_message are never started
+    inject(ring, 0x3003, 4, 2048, 0, 300);
+    assert(obi_topology_receive_message(ctx, &buffer) == OBI_ERROR_WOULD_BLOCK);
+
+    // Repeated fragments add nothing, so the message completes only with
+    // every byte in place
+    inject(ring, 0x3004, 5, 600, 0, 200);
+    inject(ring, 0x3004, 5, 600, 0, 200);
+    inject(ring, 0x3004, 5, 600, 200, 200);
+    inject(ring, 0x3004, 5, 600, 200, 200);
+    assert(obi_topology_receive_message(ctx, &buffer) == OBI_ERROR_WOULD_BLOCK);
+    inject(ring, 0x3004, 5, 600, 400, 200);
+    assert(obi_topology_receive_message(ctx, &buffer) == OBI_SUCCESS && buffer.size == 600);
+    check(storage, 600, 5);
+
+    // A missing fragment ends the message instead of leaving a hole
+    inject(ring, 0x3004, 6, 600, 0, 200);
+    inject(ring, 0x3004, 6, 600, 400, 200);
+    inject(ring, 0x3004, 6, 600, 200, 200);
+    assert(obi_topology_receive_message(ctx, &buffer) == OBI_ERROR_WOULD_BLOCK);
+
+    obi_topology_metrics_t metrics;
+    assert(obi_topology_get_metrics(ctx, &metrics) == OBI_TOPOLOGY_SUCCESS);
+    assert(metrics.reassembled_messages == 2 && metrics.reassembly_timeouts == 1 &&
+           metrics.reassembly_drops == 3);
+
+    obi_shm_ring_close(ring);
+    obi_topology_cleanup();
+    printf("✅ Reassembly bounds test passed\n");
+}
+
+static int async_completions;
+static obi_result_t async_result;
+
+static void on_sent(void *user, obi_send_handle_t handle, obi_result_t result) {
+    (void)user;
+    (void)handle;
+    async_completions++;
+    async_result = result;
+}
+
+static obi_topology_context_t *join_sim(obi_sim_network_t *network, const char *self) {
+    obi_topology_context_t *ctx = obi_topology_context_create((obi_protocol_context_t *)&protocol_placeholder);
+    assert(ctx != NULL);
+    assert(obi_topology_set_transport(ctx, obi_topology_transport_sim_create(network)) == OBI_TOPOLOGY_SUCCESS);
+    obi_node_id_t id;
+    assert(obi_topology_add_node(ctx, "frag-async-tx", NULL, &id) == OBI_TOPOLOGY_SUCCESS);
+    assert(obi_topology_add_node(ctx, "frag-async-rx", NULL, &id) == OBI_TOPOLOGY_SUCCESS);
+    assert(obi_topology_bind(ctx, self) == OBI_TOPOLOGY_SUCCESS);
+    return ctx;
+}
+
+void test_async_fragments() {
+    printf("Testing an async send resumed across a full link...\n");
+
+    // The link holds 8 frames, so the train stops many times on the way
+    obi_sim_config_t config = { { 0, 0, 0, 0 }, 8, OBI_SIM_DEFAULT_QUEUE_BYTES, 1 };
+    obi_sim_network_t *network = obi_sim_network_create(&config);
+    assert(network != NULL);
+    obi_topology_context_t *sender = join_sim(network, "frag-async-tx");
+    obi_topology_context_t *receiver = join_sim(network, "frag-async-rx");
+    assert(obi_topology_set_reassembly(receiver, NULL) == OBI_TOPOLOGY_SUCCESS);
+
+    uint8_t *data = malloc(MEDIUM_MESSAGE);
+    uint8_t *storage = malloc(MEDIUM_MESSAGE);
+    assert(data && storage);
+    fill(data, MEDIUM_MESSAGE, 9);
+    obi_buffer_t buffer = { data, MEDIUM_MESSAGE, MEDIUM_MESSAGE };
+    obi_send_handle_t handle;
+    assert(obi_topology_send_async(sender, &buffer, 1, OBI_PRIORITY_NORMAL, on_sent, NULL, &handle) == OBI_SUCCESS);
+    obi_buffer_t oversized = { data, OBI_FRAGMENT_MAX_MESSAGE + 1u, OBI_FRAGMENT_MAX_MESSAGE + 1u };
+    assert(obi_topology_send_async(sender, &oversized, 1, OBI_PRIORITY_NORMAL, on_sent, NULL, &handle) ==
+           OBI_ERROR_BUFFER_OVERFLOW);
+
+    obi_buffer_t inbound = { storage, 0, MEDIUM_MESSAGE };
+    obi_result_t result = OBI_ERROR_WOULD_BLOCK;
+    int passes = 0;
+    while (result == OBI_ERROR_WOULD_BLOCK) {
+        assert(obi_topology_run_events(sender, 0, NULL) == OBI_SUCCESS);
+        result = obi_topology_receive_message(receiver, &inbound);
+        assert(++passes < 100000);
+    }
+    assert(result == OBI_SUCCESS && inbound.size == MEDIUM_MESSAGE && passes > 3);
+    check(storage, MEDIUM_MESSAGE, 9);
+    assert(obi_topology_run_events(sender, 0, NULL) == OBI_SUCCESS);
+    assert(async_completions == 1 && async_result == OBI_SUCCESS);
+
+    obi_topology_metrics_t metrics;
+    assert(obi_topology_get_metrics(sender, &metrics) == OBI_TOPOLOGY_SUCCESS);
+    assert(metrics.fragmented_messages == 1);
+
+    obi_topology_context_destroy(receiver);
+    obi_topology_context_destroy(sender);
+    obi_sim_network_destroy(network);
+    free(storage);
+    free(data);
+    printf("✅ Async fragments test passed\n");
+}
+
+int main() {
+    printf("🧪 Running OBI Topology Fragmentation Tests\n");
+    printf("===========================================\n");
+
+    test_large_messages();
+    test_async_fragments();
+    test_reassembly_bounds();
+
+    printf("\n✅ All fragmentation tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,292 @@
+/*
+ * Simulated Transport Tests
+ * Validates link latency, jitter without reordering, repeatable loss,
+ * bandwidth and queue backpressure, runtime link changes, and a RING of
+ * independent contexts running on their own threads
+ */
+
+#define _DEFAULT_SOURCE
+
+#include "obitopology.h"
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <time.h>
+#include <sched.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#define RING_NODES    4
+#define RING_MESSAGES 200
+
+static int protocol_placeholder;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+typedef struct {
+    obi_sim_network_t *network;
+    obi_topology_transport_t *receiver;
+    obi_topology_transport_t *sender;
+    void *peer;
+} pair_t;
+
+static pair_t make_pair(const obi_sim_config_t *config) {
+    pair_t pair;
+    pair.network = obi_sim_network_create(config);
+    assert(pair.network != NULL);
+    pair.receiver = obi_topology_transport_sim_create(pair.network);
+    pair.sender = obi_topology_transport_sim_create(pair.network);
+    assert(pair.sender->ops->connect(pair.sender, "sim-b", &pair.peer) == OBI_ERROR_NETWORK_FAILURE);
+    assert(pair.receiver->ops->bind(pair.receiver, "sim-b") == OBI_SUCCESS);
+    assert(pair.sender->ops->bind(pair.sender, "sim-a") == OBI_SUCCESS);
+    assert(pair.sender->ops->connect(pair.sender, "sim-b", &pair.peer) == OBI_SUCCESS);
+    return pair;
+}
+
+static void free_pair(pair_t *pair) {
+    pair->sender->ops->destroy(pair->sender);
+    pair->receiver->ops->destroy(pair->receiver);
+    obi_sim_network_destroy(pair->network);
+}
+
+static obi_result_t send_value(pair_t *pair, uint32_t value, uint32_t length) {
+    uint8_t payload[1024] = {0};
+    memcpy(payload, &value, sizeof(value));
+    obi_topology_frame_t frame = { .length = length, .type = OBI_FRAME_DATA };
+    return pair->sender->ops->send(pair->sender, pair->peer, &frame, payload);
+}
+
+static obi_result_t receive_value(pair_t *pair, uint32_t *value) {
+    uint8_t payload[1024];
+    obi_topology_frame_t frame;
+    obi_result_t result = pair->receiver->ops->receive(pair->receiver, &frame, payload, sizeof(payload));
+    if (result == OBI_SUCCESS) {
+        memcpy(value, payload, sizeof(*value));
+    }
+    return result;
+}
+
+void test_latency_and_order() {
+    printf("Testing link latency and jitter without reordering...\n");
+
+    obi_sim_config_t config = { { 2000, 1000, 0, 0 }, 64, OBI_SIM_DEFAULT_QUEUE_BYTES, 7 };
+    pair_t pair = make_pair(&config);
+
+    uint64_t started = now_ns();
+    for (uint32_t i = 0; i < 32; i++) {
+        assert(send_value(&pair, i, sizeof(i)) == OBI_SUCCESS);
+    }
+    uint32_t value;
+    assert(receive_value(&pair, &value) == OBI_ERROR_WOULD_BLOCK);
+
+    for (uint32_t expected = 0; expected < 32;) {
+        obi_result_t result = receive_value(&pair, &value);
+        if (result == OBI_ERROR_WOULD_BLOCK) {
+            continue;
+        }
+        assert(result == OBI_SUCCESS && value == expected);
+        if (expected++ == 0) {
+            assert(now_ns() - started >= 2000000ull);
+        }
+    }
+    assert(now_ns() - started < 50000000ull);
+
+    free_pair(&pair);
+    printf("✅ Latency and order test passed\n");
+}
+
+static uint32_t lossy_run(uint64_t seed, obi_sim_stats_t *stats) {
+    obi_sim_config_t config = { { 0, 0, 0, 300000 }, 1024, OBI_SIM_DEFAULT_QUEUE_BYTES, seed };
+    pair_t pair = make_pair(&config);
+    uint32_t delivered = 0;
+    uint32_t value;
+    for (uint32_t i = 0; i < 1000; i++) {
+        assert(send_value(&pair, i, sizeof(i)) == OBI_SUCCESS);
+        while (receive_value(&pair, &value) == OBI_SUCCESS) {
+            delivered++;
+        }
+    }
+    assert(obi_sim_network_get_stats(pair.network, stats) == OBI_SUCCESS);
+    free_pair(&pair);
+    return delivered;
+}
+
+void test_repeatable_loss() {
+    printf("Testing loss rate and repeatable draws...\n");
+
+    obi_sim_stats_t first;
+    obi_sim_stats_t second;
+    uint32_t delivered = lossy_run(42, &first);
+    assert(delivered > 620 && delivered < 780);
+    assert(first.frames_sent == 1000 && first.frames_lost + first.frames_delivered == 1000);
+
+    // The same seed loses exactly the same frames
+    assert(lossy_run(42, &second) == delivered);
+    assert(second.frames_lost == first.frames_lost);
+
+    printf("✅ Repeatable loss test passed\n");
+}
+
+void test_bandwidth_backpressure() {
+    printf("Testing bandwidth and a full link refusing sends...\n");
+
+    obi_sim_config_t config = { { 0, 0, 1000000, 0 }, 8, OBI_SIM_DEFAULT_QUEUE_BYTES, 1 };
+    pair_t pair = make_pair(&config);
+
+    // Eight 1 KiB frames at 1 MB/s take about 8 ms to cross; the ninth does not fit
+    uint64_t started = now_ns();
+    for (uint32_t i = 0; i < 8; i++) {
+        assert(send_value(&pair, i, 1000) == OBI_SUCCESS);
+    }
+    assert(send_value(&pair, 8, 1000) == OBI_ERROR_WOULD_BLOCK);
+    assert(pair.sender->ops->queue_depth(pair.sender, pair.peer) == 8);
+
+    uint32_t value;
+    for (uint32_t expected = 0; expected < 8;) {
+        if (receive_value(&pair, &value) == OBI_SUCCESS) {
+            assert(value == expected++);
+        }
+    }
+    assert(now_ns() - started >= 8000000ull);
+
+    obi_sim_stats_t stats;
+    assert(obi_sim_network_get_stats(pair.network, &stats) == OBI_SUCCESS);
+    assert(stats.frames_refused == 1 && stats.frames_delivered == 8 && stats.bytes_delivered == 8000);
+
+    free_pair(&pair);
+    printf("✅ Bandwidth backpressure test passed\n");
+}
+
+void test_link_changes() {
+    printf("Testing a link cut and restored at runtime...\n");
+
+    pair_t pair = make_pair(NULL);
+    obi_sim_link_config_t cut = { 0, 0, 0, 1000000 };
+    assert(obi_sim_network_set_link(pair.network, "sim-a", "sim-b", &cut) == OBI_SUCCESS);
+    assert(send_value(&pair, 1, sizeof(uint32_t)) == OBI_SUCCESS);
+    uint32_t value;
+    assert(receive_value(&pair, &value) == OBI_ERROR_WOULD_BLOCK);
+
+    assert(obi_sim_network_set_link(pair.network, "sim-a", "sim-b", NULL) == OBI_SUCCESS);
+    assert(send_value(&pair, 2, sizeof(uint32_t)) == OBI_SUCCESS);
+    assert(receive_value(&pair, &value) == OBI_SUCCESS && value == 2);
+
+    // A receiver that goes away takes what was queued for it
+    obi_sim_link_config_t slow = { 100000, 0, 0, 0 };
+    assert(obi_sim_network_set_link(pair.network, "sim-a", "sim-b", &slow) == OBI_SUCCESS);
+    assert(send_value(&pair, 3, sizeof(uint32_t)) == OBI_SUCCESS);
+    pair.receiver->ops->destroy(pair.receiver);
+    pair.receiver = obi_topology_transport_sim_create(pair.network);
+    assert(pair.receiver->ops->bind(pair.receiver, "sim-b") == OBI_SUCCESS);
+    obi_sim_stats_t stats;
+    assert(obi_sim_network_get_stats(pair.network, &stats) == OBI_SUCCESS);
+    assert(stats.frames_lost == 2 && stats.frames_delivered == 1);
+
+    free_pair(&pair);
+    printf("✅ Link changes test passed\n");
+}
+
+typedef struct {
+    obi_sim_network_t *network;
+    uint32_t index;
+    _Atomic uint32_t *bound;
+    _Atomic uint32_t *finished;
+    uint32_t received;
+} ring_node_t;
+
+// One node of the ring: sends two hops round, relays for its neighbours
+static void *run_ring_node(void *arg) {
+    ring_node_t *node = arg;
+    obi_topology_context_t *ctx = obi_topology_context_create((obi_protocol_context_t *)&protocol_placeholder);
+    assert(ctx != NULL);
+    assert(obi_topology_set_transport(ctx, obi_topology_transport_sim_create(node->network)) ==
+           OBI_TOPOLOGY_SUCCESS);
+    char name[16];
+    obi_node_id_t id;
+    for (uint32_t i = 0; i < RING_NODES; i++) {
+        snprintf(name, sizeof(name), "sim-%u", i);
+        assert(obi_topology_add_node(ctx, name, NULL, &id) == OBI_TOPOLOGY_SUCCESS);
+    }
+    assert(obi_topology_configure(ctx, OBI_TOPOLOGY_RING) == OBI_TOPOLOGY_SUCCESS);
+    snprintf(name, sizeof(name), "sim-%u", node->index);
+    assert(obi_topology_bind(ctx, name) == OBI_TOPOLOGY_SUCCESS);
+    atomic_fetch_add(node->bound, 1);
+    while (atomic_load(node->bound) < RING_NODES) {
+        sched_yield();
+    }
+
+    uint32_t sent = 0;
+    bool done = false;
+    while (atomic_load(node->finished) < RING_NODES) {
+        if (sent < RING_MESSAGES) {
+            uint32_t value = node->index * 1000 + sent;
+            obi_buffer_t buffer = { (uint8_t *)&value, sizeof(value), sizeof(value) };
+            if (obi_topology_send_to(ctx, &buffer, (node->index + 2) % RING_NODES) == OBI_SUCCESS) {
+                sent++;
+            }
+        }
+        obi_buffer_t message;
+        if (obi_topology_receive_view(ctx, &message) == OBI_SUCCESS) {
+            uint32_t value;
+            memcpy(&value, message.data, sizeof(value));
+            assert(value == ((node->index + 2) % RING_NODES) * 1000 + node->received);
+            node->received++;
+        } else {
+            sched_yield();
+        }
+        if (!done && sent == RING_MESSAGES && node->received == RING_MESSAGES) {
+            done = true;
+            atomic_fetch_add(node->finished, 1);
+        }
+    }
+
+    obi_topology_context_destroy(ctx);
+    return NULL;
+}
+
+void test_threaded_ring() {
+    printf("Testing a RING of contexts on their own threads...\n");
+
+    obi_sim_config_t config = { { 50, 20, 0, 0 }, 64, OBI_SIM_DEFAULT_QUEUE_BYTES, 3 };
+    obi_sim_network_t *network = obi_sim_network_create(&config);
+    assert(network != NULL);
+    _Atomic uint32_t bound = 0;
+    _Atomic uint32_t finished = 0;
+    ring_node_t nodes[RING_NODES];
+    pthread_t threads[RING_NODES];
+    for (uint32_t i = 0; i < RING_NODES; i++) {
+        nodes[i] = (ring_node_t){ network, i, &bound, &finished, 0 };
+        assert(pthread_create(&threads[i], NULL, run_ring_node, &nodes[i]) == 0);
+    }
+    for (uint32_t i = 0; i < RING_NODES; i++) {
+        pthread_join(threads[i], NULL);
+        assert(nodes[i].received == RING_MESSAGES);
+    }
+
+    // The process-wide context was never involved
+    assert(obi_topology_get_context() == NULL);
+    obi_sim_stats_t stats;
+    assert(obi_sim_network_get_stats(network, &stats) == OBI_SUCCESS);
+    assert(stats.frames_delivered >= 2 * RING_NODES * RING_MESSAGES && stats.frames_lost == 0);
+    obi_sim_network_destroy(network);
+
+    printf("✅ Threaded ring test passed\n");
+}
+
+int main() {
+    printf("🧪 Running OBI Topology Simulated Transport Tests\n");
+    printf("=================================================\n");
+
+    test_latency_and_order();
+    test_repeatable_loss();
+    test_bandwidth_backpressure();
+    test_link_changes();
+    test_threaded_ring();
+
+    printf("\n✅ All simulated transport tests passed!\n");
+    return 0;
+}
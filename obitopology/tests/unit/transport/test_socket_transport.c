@@ -0,0 +1,165 @@
+/*
+ * Socket Transport Tests
+ * Validates batched sendmmsg/writev delivery and recvmmsg draining
+ */
+
+#define _DEFAULT_SOURCE
+
+#include "obitopology.h"
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <unistd.h>
+
+static void exchange(const char *address, int message_count) {
+    obi_socket_config_t config = { .batch_size = 8, .flush_deadline_us = 1000000, .max_datagram = 256 };
+    obi_topology_transport_t *receiver = obi_topology_transport_socket_create(&config);
+    obi_topology_transport_t *sender = obi_topology_transport_socket_create(&config);
+    assert(receiver != NULL && sender != NULL);
+    assert(receiver->ops->bind(receiver, address) == OBI_SUCCESS);
+    
+    void *peer = NULL;
+    assert(sender->ops->connect(sender, address, &peer) == OBI_SUCCESS);
+    
+    int expected = 0;
+    for (int i = 0; i < message_count; i++) {
+        obi_topology_frame_t frame = { .length = sizeof(i), .type = OBI_FRAME_DATA };
+        assert(sender->ops->send(sender, peer, &frame, (const uint8_t *)&i) == OBI_SUCCESS);
+        
+        // Drain as we go so datagram socket buffers never overflow
+        obi_topology_frame_t rx;
+        int value;
+        while (receiver->ops->receive(receiver, &rx, (uint8_t *)&value, sizeof(value)) == OBI_SUCCESS) {
+            assert(value == expected++);
+        }
+    }
+    
+    // A full peer socket leaves the tail queued until the receiver drains
+    obi_result_t flushed;
+    while ((flushed = sender->ops->flush(sender)) != OBI_SUCCESS || expected < message_count) {
+        assert(flushed == OBI_SUCCESS || flushed == OBI_ERROR_WOULD_BLOCK);
+        obi_topology_frame_t rx;
+        int value;
+        obi_result_t result = receiver->ops->receive(receiver, &rx, (uint8_t *)&value, sizeof(value));
+        if (result == OBI_ERROR_WOULD_BLOCK) {
+            continue;
+        }
+        assert(result == OBI_SUCCESS);
+        assert(value == expected++);
+    }
+    
+    obi_socket_stats_t tx_stats;
+    obi_socket_stats_t rx_stats;
+    assert(obi_socket_transport_get_stats(sender, &tx_stats) == OBI_SUCCESS);
+    assert(obi_socket_transport_get_stats(receiver, &rx_stats) == OBI_SUCCESS);
+    assert(tx_stats.messages_sent == (uint64_t)message_count);
+    assert(tx_stats.send_syscalls * 4 <= tx_stats.messages_sent);
+    printf("   %s: %d messages, %llu send syscalls\n", address, message_count,
+           (unsigned long long)tx_stats.send_syscalls);
+    
+    sender->ops->disconnect(sender, peer);
+    sender->ops->destroy(sender);
+    receiver->ops->destroy(receiver);
+}
+
+void test_unix_datagram_batching() {
+    printf("Testing Unix datagram batching...\n");
+    exchange("unix:/tmp/obitopo-test.sock", 1024);
+    printf("✅ Unix datagram batching test passed\n");
+}
+
+void test_udp_loopback_batching() {
+    printf("Testing UDP loopback batching...\n");
+    exchange("udp:127.0.0.1:47811", 1024);
+    printf("✅ UDP loopback batching test passed\n");
+}
+
+void test_tcp_loopback_batching() {
+    printf("Testing TCP loopback writev batching...\n");
+    exchange("tcp:127.0.0.1:47812", 1024);
+    printf("✅ TCP loopback batching test passed\n");
+}
+
+void test_flush_deadline() {
+    printf("Testing flush deadline...\n");
+    
+    obi_socket_config_t config = { .batch_size = 64, .flush_deadline_us = 100, .max_datagram = 256 };
+    obi_topology_transport_t *receiver = obi_topology_transport_socket_create(&config);
+    obi_topology_transport_t *sender = obi_topology_transport_socket_create(&config);
+    assert(receiver->ops->bind(receiver, "unix:/tmp/obitopo-deadline.sock") == OBI_SUCCESS);
+    
+    void *peer = NULL;
+    assert(sender->ops->connect(sender, "unix:/tmp/obitopo-deadline.sock", &peer) == OBI_SUCCESS);
+    
+    int value = 7;
+    obi_topology_frame_t frame = { .length = sizeof(value), .type = OBI_FRAME_DATA };
+    assert(sender->ops->send(sender, peer, &frame, (const uint8_t *)&value) == OBI_SUCCESS);
+    
+    // A lone message stays queued until the deadline passes
+    obi_topology_frame_t rx;
+    int received = 0;
+    assert(receiver->ops->receive(receiver, &rx, (uint8_t *)&received, sizeof(received)) == OBI_ERROR_WOULD_BLOCK);
+    usleep(1000);
+    assert(sender->ops->send(sender, peer, &frame, (const uint8_t *)&value) == OBI_SUCCESS);
+    assert(receiver->ops->receive(receiver, &rx, (uint8_t *)&received, sizeof(received)) == OBI_SUCCESS);
+    assert(received == 7);
+    
+    sender->ops->destroy(sender);
+    receiver->ops->destroy(receiver);
+    printf("✅ Flush deadline test passed\n");
+}
+
+void test_batch_scale() {
+    printf("Testing governance batch widening...\n");
+    
+    obi_socket_config_t config = { .batch_size = 8, .flush_deadline_us = 1000000, .max_datagram = 256 };
+    obi_topology_transport_t *receiver = obi_topology_transport_socket_create(&config);
+    obi_topology_transport_t *sender = obi_topology_transport_socket_create(&config);
+    assert(receiver->ops->bind(receiver, "udp:127.0.0.1:47813") == OBI_SUCCESS);
+    
+    void *peer = NULL;
+    assert(sender->ops->connect(sender, "udp:127.0.0.1:47813", &peer) == OBI_SUCCESS);
+    sender->ops->set_batch_scale(sender, 4);
+    
+    // Four times the configured batch queues before the first sendmmsg
+    int value = 3;
+    obi_topology_frame_t frame = { .length = sizeof(value), .type = OBI_FRAME_DATA };
+    obi_socket_stats_t stats;
+    for (int i = 0; i < 31; i++) {
+        assert(sender->ops->send(sender, peer, &frame, (const uint8_t *)&value) == OBI_SUCCESS);
+    }
+    assert(sender->ops->queue_depth(sender, peer) == 31);
+    assert(obi_socket_transport_get_stats(sender, &stats) == OBI_SUCCESS);
+    assert(stats.send_syscalls == 0);
+    
+    assert(sender->ops->send(sender, peer, &frame, (const uint8_t *)&value) == OBI_SUCCESS);
+    assert(sender->ops->queue_depth(sender, peer) == 0);
+    assert(obi_socket_transport_get_stats(sender, &stats) == OBI_SUCCESS);
+    assert(stats.send_syscalls == 1 && stats.messages_sent == 32);
+    
+    // Back to the configured batch
+    sender->ops->set_batch_scale(sender, 1);
+    for (int i = 0; i < 8; i++) {
+        assert(sender->ops->send(sender, peer, &frame, (const uint8_t *)&value) == OBI_SUCCESS);
+    }
+    assert(obi_socket_transport_get_stats(sender, &stats) == OBI_SUCCESS);
+    assert(stats.send_syscalls == 2);
+    
+    sender->ops->destroy(sender);
+    receiver->ops->destroy(receiver);
+    printf("✅ Governance batch widening test passed\n");
+}
+
+int main() {
+    printf("🧪 Running OBI Topology Socket Transport Tests\n");
+    printf("==============================================\n");
+    
+    test_unix_datagram_batching();
+    test_udp_loopback_batching();
+    test_tcp_loopback_batching();
+    test_flush_deadline();
+    test_batch_scale();
+    
+    printf("\n✅ All socket transport tests passed!\n");
+    return 0;
+}